@@ -412,6 +412,9 @@ LOGICAL					read_complete_config_file
 	if ( !read_crossrefs_info() ) return FALSE;
 	if ( !read_samples_info() )   return FALSE;
 
+	/* Save the compiled configuration for the next process */
+	(void) save_config_snapshot();
+
 	/* Return TRUE if all blocks have been read */
 	return TRUE;
 	}
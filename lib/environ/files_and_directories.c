@@ -57,9 +57,58 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <stdarg.h>
+#include <time.h>
+
+#ifdef MACHINE_PCLINUX
+#define WATCH_DIRS
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stddef.h>
+#endif
 
 #undef DEBUG_FILE_IDENTS
 
+/* Resident catalog of data directories */
+/*  ... the file identifiers in a data directory are parsed once, kept  */
+/*  sorted by valid time, and discarded when the directory changes       */
+typedef	struct
+	{
+	FpaConfigElementStruct	*edef;	/* element of data file */
+	FpaConfigLevelStruct	*ldef;	/* level of data file */
+	FpaConfigFieldStruct	*fdef;	/* field (if recognized) */
+	STRING					vtime;	/* valid timestamp of data file */
+	} DIRIDENT;
+
+typedef	struct
+	{
+	STRING		dir;		/* data directory path */
+	int			wd;			/* inotify watch descriptor (or -1) */
+	dev_t		dev;		/* device and inode of directory */
+	ino_t		ino;
+	time_t		mtime;		/* modification time of directory */
+	long		used;		/* last use (for least recently used) */
+	LOGICAL		listed;		/* have the file identifiers been parsed? */
+	int			nident;		/* number of file identifiers */
+	int			mident;		/* allocated file identifiers */
+	DIRIDENT	*idents;	/* file identifiers sorted by valid time */
+	} DIRCAT;
+
+#define CatNone			0	/* catalog modes */
+#define CatMtime		1
+#define CatWatch		2
+#define MaxCatDirs		32
+
+static	int		CatMode  = -1;
+static	int		CatFd    = -1;
+static	long	CatClock = 0;
+static	int		NumCat   = 0;
+static	DIRCAT	*DirCat  = NullPtr(DIRCAT *);
+#ifdef WATCH_DIRS
+static	pid_t	CatPid   = 0;
+#endif
+
 /* Interface functions */
 /*  ... these are defined in fields_and_directories.h */
 
@@ -76,6 +125,17 @@ static int		data_directory_valid_times(FLD_DESCRIPT *, int, STRING **);
 static int		data_directory_fields(FLD_DESCRIPT *, int,
 													FpaConfigFieldStruct ***);
 
+/* Internal static functions (Data Directory Catalog) */
+static int		catalog_mode(void);
+static DIRCAT	*catalog_directory(STRING);
+static LOGICAL	catalog_remote(STRING);
+static void		catalog_list(DIRCAT *);
+static LOGICAL	catalog_match(DIRIDENT *, FLD_DESCRIPT *, int);
+static int		catalog_vcmp(const void *, const void *);
+static void		catalog_clear(DIRCAT *);
+static void		catalog_remove(int);
+static void		catalog_events(void);
+
 /* Internal static functions (File Identifier Sorting and Matching) */
 static int		strecmp(const void *, const void *);
 static int		strlcmp(const void *, const void *);
@@ -5059,9 +5119,11 @@ static	int			data_directory_valid_times
 	)
 
 	{
-	int							nfiles, ifl, ii;
+	int							nfiles, ifl, ii, nsave;
 	LOGICAL						newformat;
 	STRING						rstamp, dpath, search, *files, vtime;
+	DIRCAT						*dcat;
+	DIRIDENT					*dident;
 	FpaConfigSourceStruct		*sdef;
 	FpaConfigSourceSubStruct	*subdef;
 	FpaConfigSourceIOStruct		*sio;
@@ -5097,6 +5159,29 @@ static	int			data_directory_valid_times
 									subdef->sub_path, rstamp);
 	if ( blank(dpath) ) return NumTimes;
 
+	/* Build list of valid timestamps from the catalog of file identifiers */
+	/*  ... which are sorted by valid time                                 */
+	dcat = catalog_directory(dpath);
+	if ( NotNull(dcat) )
+		{
+		catalog_list(dcat);
+		for ( ii=0; ii<dcat->nident; ii++ )
+			{
+			dident = dcat->idents + ii;
+			if ( !catalog_match(dident, fdesc, macro) ) continue;
+			if ( NumTimes > 0 && same(dident->vtime, TimeList[NumTimes-1]) )
+				continue;
+
+			NumTimes++;
+			TimeList = GETMEM(TimeList, STRING, NumTimes);
+			TimeList[NumTimes-1] = strdup(dident->vtime);
+			}
+
+		if ( NotNull(times) ) *times = TimeList;
+		else                  FREELIST(TimeList, NumTimes);
+		return NumTimes;
+		}
+
 	/* Check for new and old format FPA metafile names */
 	newformat = TRUE;
 	while (TRUE)
@@ -5123,30 +5208,11 @@ static	int			data_directory_valid_times
 					|| (macro & edef->elem_tdep->time_dep) )
 				{
 
-				/* Only save unique valid timestamps */
-				for ( ii=0; ii<NumTimes; ii++ )
-					{
-					if ( same(vtime, TimeList[ii]) ) break;;
-					}
-				if ( ii < NumTimes ) continue;
-
-				/* Only save recognized timestrings */
-				if ( blank(interpret_timestring(vtime, NullString, 0.0)) )
-					{
-					(void) pr_error("Environ",
-						"Unrecognized timestring: \"%s\"\n", SafeStr(vtime));
-					(void) pr_error("Environ", "  in directory: %s\n", dpath);
-					continue;
-					}
-
-				/* Add valid timestamp to list            */
-				/*  ... but only if the list is returned! */
+				/* Add valid timestamp to list */
+				/*  ... duplicates are removed after sorting */
 				NumTimes++;
-				if ( NotNull(times) )
-					{
-					TimeList = GETMEM(TimeList, STRING, NumTimes);
-					TimeList[NumTimes-1] = strdup(vtime);
-					}
+				TimeList = GETMEM(TimeList, STRING, NumTimes);
+				TimeList[NumTimes-1] = strdup(vtime);
 				}
 			}
 
@@ -5155,14 +5221,41 @@ static	int			data_directory_valid_times
 		else             break;
 		}
 
-	/* Return if no valid timestamps saved */
-	if ( NumTimes <= 0 ) return NumTimes;
-
 	/* Sort valid timestamps */
-	qsort((POINTER) TimeList, (size_t) NumTimes, sizeof(STRING), strvcmp);
+	if ( NumTimes > 0 )
+		qsort((POINTER) TimeList, (size_t) NumTimes, sizeof(STRING), strvcmp);
+
+	/* Only save unique valid timestamps */
+	for ( nsave=0, ii=0; ii<NumTimes; ii++ )
+		{
+		if ( nsave > 0 && same(TimeList[ii], TimeList[nsave-1]) )
+			{
+			FREEMEM(TimeList[ii]);
+			continue;
+			}
+		TimeList[nsave++] = TimeList[ii];
+		}
+	NumTimes = nsave;
+
+	/* Only save recognized timestrings */
+	for ( nsave=0, ii=0; ii<NumTimes; ii++ )
+		{
+		if ( blank(interpret_timestring(TimeList[ii], NullString, 0.0)) )
+			{
+			(void) pr_error("Environ",
+				"Unrecognized timestring: \"%s\"\n", SafeStr(TimeList[ii]));
+			(void) pr_error("Environ", "  in directory: %s\n", dpath);
+			FREEMEM(TimeList[ii]);
+			continue;
+			}
+		TimeList[nsave++] = TimeList[ii];
+		}
+	NumTimes = nsave;
 
 	/* Return the list of valid timestamps */
+	if ( NumTimes <= 0 ) FREEMEM(TimeList);
 	if ( NotNull(times) ) *times = TimeList;
+	else                  FREELIST(TimeList, NumTimes);
 	return NumTimes;
 	}
 
@@ -5189,6 +5282,8 @@ static	int			data_directory_fields
 	int							nfiles, ifl, ii;
 	LOGICAL						newformat;
 	STRING						rstamp, dpath, search, *files;
+	DIRCAT						*dcat;
+	DIRIDENT					*dident;
 	FpaConfigSourceStruct		*sdef;
 	FpaConfigSourceSubStruct	*subdef;
 	FpaConfigSourceIOStruct		*sio;
@@ -5226,6 +5321,38 @@ static	int			data_directory_fields
 									subdef->sub_path, rstamp);
 	if ( blank(dpath) ) return NumFields;
 
+	/* Build list of pointers to Field structures from the catalog */
+	/*  of file identifiers                                        */
+	dcat = catalog_directory(dpath);
+	if ( NotNull(dcat) )
+		{
+		catalog_list(dcat);
+		for ( ifl=0; ifl<dcat->nident; ifl++ )
+			{
+			dident = dcat->idents + ifl;
+			if ( IsNull(dident->fdef) ) continue;
+			if ( !catalog_match(dident, fdesc, macro) ) continue;
+
+			/* Only save unique fields */
+			for ( ii=0; ii<NumFields; ii++ )
+				{
+				if ( dident->fdef == FieldList[ii] ) break;
+				}
+			if ( ii < NumFields ) continue;
+
+			NumFields++;
+			FieldList = GETMEM(FieldList, FpaConfigFieldStruct *, NumFields);
+			FieldList[NumFields-1] = dident->fdef;
+			}
+
+		if ( NumFields > 0 )
+			qsort((POINTER) FieldList, (size_t) NumFields,
+								sizeof(FpaConfigFieldStruct *), strecmp);
+		if ( NotNull(fields) ) *fields = FieldList;
+		else                   FREEMEM(FieldList);
+		return NumFields;
+		}
+
 	/* Check for new and old format FPA metafile names */
 	newformat = TRUE;
 	while (TRUE)
@@ -5273,14 +5400,10 @@ static	int			data_directory_fields
 				if ( ii < NumFields ) continue;
 
 				/* Add pointer to Field structure to list */
-				/*  ... but only if the list is returned! */
 				NumFields++;
-				if ( NotNull(fields) )
-					{
-					FieldList = GETMEM(FieldList, FpaConfigFieldStruct *,
-										NumFields);
-					FieldList[NumFields-1] = fdef;
-					}
+				FieldList = GETMEM(FieldList, FpaConfigFieldStruct *,
+									NumFields);
+				FieldList[NumFields-1] = fdef;
 				}
 			}
 
@@ -5290,14 +5413,479 @@ static	int			data_directory_fields
 		}
 
 	/* Sort files according to field element identifiers */
-	qsort((POINTER) FieldList, (size_t) NumFields,
-						sizeof(FpaConfigFieldStruct *), strecmp);
+	if ( NumFields > 0 )
+		qsort((POINTER) FieldList, (size_t) NumFields,
+							sizeof(FpaConfigFieldStruct *), strecmp);
 
 	/* Return the list of pointers to Field structures */
 	if ( NotNull(fields) ) *fields = FieldList;
+	else                   FREEMEM(FieldList);
 	return NumFields;
 	}
 
+/***********************************************************************
+*                                                                      *
+*     STATIC (LOCAL) ROUTINES (Data Directory Catalog)                 *
+*                                                                      *
+*     All the routines after this point are available only within      *
+*     this file.                                                       *
+*                                                                      *
+***********************************************************************/
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ m o d e                                            *
+*                                                                      *
+*   Return the mode for the resident catalog of data directories, set  *
+*   by the FPA_DATA_CATALOG environment variable or the "Data.Catalog" *
+*   advanced feature:                                                  *
+*                                                                      *
+*     "inotify"  directory changes are reported by the kernel (default *
+*                where available), except for directories on network   *
+*                file systems, which are checked as for "mtime"        *
+*     "mtime"    directory modification times are checked on each      *
+*                search                                                *
+*     "none"     every search lists the directory                      *
+*                                                                      *
+***********************************************************************/
+
+static	int			catalog_mode
+
+	(
+	)
+
+	{
+	STRING	mode;
+#	ifdef WATCH_DIRS
+	int		icat;
+
+	/* Start again in a forked process ... the inotify descriptor */
+	/*  would otherwise be shared with the parent                 */
+	if ( CatMode >= 0 && CatPid != getpid() )
+		{
+		for ( icat=NumCat-1; icat>=0; icat-- ) catalog_clear(DirCat + icat);
+		for ( icat=0; icat<NumCat; icat++ ) FREEMEM(DirCat[icat].dir);
+		NumCat = 0;
+		if ( CatFd >= 0 ) (void) close(CatFd);
+		CatFd   = -1;
+		CatMode = -1;
+		}
+#	endif
+
+	if ( CatMode >= 0 ) return CatMode;
+
+	mode = getenv("FPA_DATA_CATALOG");
+	if ( blank(mode) ) mode = get_feature_mode("Data.Catalog");
+
+#	ifdef WATCH_DIRS
+	CatMode = CatWatch;
+#	else
+	CatMode = CatMtime;
+#	endif
+	if ( blank(mode) || same_ic(mode, "inotify") ) ;
+	else if ( same_ic(mode, "mtime") ) CatMode = CatMtime;
+	else if ( same_ic(mode, "none") )  CatMode = CatNone;
+	else
+		{
+		(void) fprintf(stderr, "[catalog_mode]");
+		(void) fprintf(stderr, " Unknown Data.Catalog mode \"%s\"\n", mode);
+		}
+
+#	ifdef WATCH_DIRS
+	/* Changes are read from a non-blocking inotify descriptor */
+	/*  ... or directory modification times if none available  */
+	CatPid = getpid();
+	if ( CatMode == CatWatch )
+		{
+		CatFd = inotify_init();
+		if ( CatFd < 0 ) CatMode = CatMtime;
+		else
+			{
+			(void) fcntl(CatFd, F_SETFL, fcntl(CatFd, F_GETFL) | O_NONBLOCK);
+			(void) fcntl(CatFd, F_SETFD, FD_CLOEXEC);
+			}
+		}
+#	endif
+
+	return CatMode;
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ d i r e c t o r y                                  *
+*                                                                      *
+*   Return the catalog for a data directory, with the file identifiers *
+*   discarded if the directory has changed.  No catalog is returned if *
+*   the directory cannot be catalogued at present.                     *
+*                                                                      *
+***********************************************************************/
+
+static	DIRCAT		*catalog_directory
+
+	(
+	STRING		dpath		/* data directory path */
+	)
+
+	{
+	int			icat, iold;
+	struct stat	sbuf;
+	DIRCAT		*dcat;
+
+	if ( catalog_mode() == CatNone ) return NullPtr(DIRCAT *);
+
+	/* Discard identifiers for directories that have changed */
+	catalog_events();
+
+	for ( icat=0; icat<NumCat; icat++ )
+		{
+		if ( same(DirCat[icat].dir, dpath) ) break;
+		}
+
+	/* Forget directories that have gone ... or been replaced */
+	if ( stat(dpath, &sbuf) != 0 || !S_ISDIR(sbuf.st_mode) )
+		{
+		if ( icat < NumCat ) catalog_remove(icat);
+		return NullPtr(DIRCAT *);
+		}
+	if ( icat < NumCat && ( DirCat[icat].dev != sbuf.st_dev
+							|| DirCat[icat].ino != sbuf.st_ino ) )
+		{
+		catalog_remove(icat);
+		icat = NumCat;
+		}
+
+	/* Add a new directory ... replacing the least recently used */
+	if ( icat >= NumCat )
+		{
+		if ( NumCat >= MaxCatDirs )
+			{
+			for ( iold=0, icat=1; icat<NumCat; icat++ )
+				{
+				if ( DirCat[icat].used < DirCat[iold].used ) iold = icat;
+				}
+			catalog_remove(iold);
+			}
+		if ( IsNull(DirCat) ) DirCat = INITMEM(DIRCAT, MaxCatDirs);
+
+		icat = NumCat++;
+		dcat = DirCat + icat;
+		dcat->dir     = strdup(dpath);
+		dcat->wd      = -1;
+		dcat->dev     = sbuf.st_dev;
+		dcat->ino     = sbuf.st_ino;
+		dcat->mtime   = sbuf.st_mtime;
+		dcat->listed  = FALSE;
+		dcat->nident  = 0;
+		dcat->mident  = 0;
+		dcat->idents  = NullPtr(DIRIDENT *);
+
+		/* Watch the directory before it is first listed */
+		/*  ... unless changes may be made from another host */
+#		ifdef WATCH_DIRS
+		if ( CatFd >= 0 && !catalog_remote(dpath) )
+			dcat->wd = inotify_add_watch(CatFd, dpath,
+							IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+							| IN_DELETE_SELF | IN_MOVE_SELF);
+#		endif
+		}
+
+	dcat = DirCat + icat;
+	dcat->used = ++CatClock;
+
+	/* Check the modification time for directories not being watched */
+	/*  ... but changes within the same second cannot be detected     */
+	if ( dcat->wd < 0 )
+		{
+		if ( dcat->mtime != sbuf.st_mtime )
+			{
+			catalog_clear(dcat);
+			dcat->mtime = sbuf.st_mtime;
+			}
+		if ( time(NullPtr(time_t *)) - sbuf.st_mtime < 2 )
+			return NullPtr(DIRCAT *);
+		}
+
+	return dcat;
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ r e m o t e                                        *
+*                                                                      *
+*   Is a data directory on a network file system, where changes made   *
+*   from another host are not reported by inotify?                     *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL		catalog_remote
+
+	(
+	STRING		dpath		/* data directory path */
+	)
+
+	{
+#	ifdef WATCH_DIRS
+	struct statfs	fsbuf;
+
+	if ( statfs(dpath, &fsbuf) != 0 ) return TRUE;
+	switch ( (unsigned long) fsbuf.f_type )
+		{
+		case 0x6969UL:		/* NFS */
+		case 0x517BUL:		/* SMB */
+		case 0xFF534D42UL:	/* CIFS */
+		case 0xFE534D42UL:	/* SMB2 */
+		case 0x564CUL:		/* NCP */
+		case 0x73757245UL:	/* CODA */
+		case 0x5346414FUL:	/* AFS */
+		case 0x01021997UL:	/* 9P */
+		case 0x00C36400UL:	/* CEPH */
+		case 0x0BD00BD0UL:	/* LUSTRE */
+		case 0x47504653UL:	/* GPFS */
+		case 0x01161970UL:	/* GFS2 */
+		case 0x7461636FUL:	/* OCFS2 */
+		case 0x65735546UL:	/* FUSE (sshfs and the like) */
+			return TRUE;
+		}
+#	endif
+
+	return FALSE;
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ l i s t                                            *
+*   c a t a l o g _ m a t c h                                          *
+*   c a t a l o g _ v c m p                                            *
+*                                                                      *
+*   Parse the file identifiers of the new and old format metafiles in  *
+*   a data directory (once for each change to the directory), and      *
+*   match them against a field descriptor.                             *
+*                                                                      *
+***********************************************************************/
+
+static	void		catalog_list
+
+	(
+	DIRCAT		*dcat		/* data directory catalog */
+	)
+
+	{
+	int							nfiles, ifl;
+	LOGICAL						newformat;
+	STRING						*files, vtime;
+	FpaConfigElementStruct		*edef;
+	FpaConfigLevelStruct		*ldef;
+	DIRIDENT					*dident;
+
+	if ( IsNull(dcat) || dcat->listed ) return;
+
+	/* Check for new and old format FPA metafile names */
+	newformat = TRUE;
+	while (TRUE)
+		{
+		nfiles = dirlist(dcat->dir, (newformat)? MetaSearchAll: SearchMetaAll,
+							&files);
+		for ( ifl=0; ifl<nfiles; ifl++ )
+			{
+
+			/* Parse the filename to return element, level and valid time */
+			if ( !parse_file_identifier(files[ifl], &edef, &ldef, &vtime) )
+				continue;
+			if ( blank(vtime) ) continue;
+
+			if ( dcat->nident >= dcat->mident )
+				{
+				dcat->mident = MAX(2*dcat->mident, 64);
+				dcat->idents = GETMEM(dcat->idents, DIRIDENT, dcat->mident);
+				}
+			dident = dcat->idents + dcat->nident++;
+			dident->edef  = edef;
+			dident->ldef  = ldef;
+			dident->vtime = strdup(vtime);
+
+			/* Set pointer to Field structure from element and level */
+			dident->fdef = identify_field(edef->name, ldef->name);
+			if ( IsNull(dident->fdef) )
+				{
+				(void) pr_error("Environ",
+					"Unrecognized field: \"%s\" \"%s\"\n",
+					SafeStr(edef->name), SafeStr(ldef->name));
+				(void) pr_error("Environ", "  in directory: %s\n", dcat->dir);
+				}
+			}
+
+		/* Reset format type */
+		if ( newformat ) newformat = FALSE;
+		else             break;
+		}
+
+	/* Sort file identifiers by valid time */
+	if ( dcat->nident > 1 )
+		qsort((POINTER) dcat->idents, (size_t) dcat->nident,
+								sizeof(DIRIDENT), catalog_vcmp);
+	dcat->listed = TRUE;
+	}
+
+/**********************************************************************/
+
+static	LOGICAL		catalog_match
+
+	(
+	DIRIDENT		*dident,	/* file identifier */
+	FLD_DESCRIPT	*fdesc,		/* pointer to field descriptor */
+	int				macro		/* enumerated time dependence to match */
+	)
+
+	{
+
+	/* Match the element, level and valid time that are set */
+	if ( NotNull(fdesc->edef) && dident->edef != fdesc->edef ) return FALSE;
+	if ( NotNull(fdesc->ldef) && dident->ldef != fdesc->ldef ) return FALSE;
+	if ( !blank(fdesc->vtime)
+			&& !matching_tstamps(dident->vtime, fdesc->vtime) ) return FALSE;
+
+	/* Check for special case for matching all time dependence types */
+	/*  or try to match the time dependence macro                    */
+	if ( !(macro ^ FpaC_TIMEDEP_ANY) ) return TRUE;
+	return (LOGICAL) ( (macro & dident->edef->elem_tdep->time_dep) != 0 );
+	}
+
+/**********************************************************************/
+
+static	int			catalog_vcmp
+
+	(
+	const void		*a,			/* pointer to first file identifier */
+	const void		*b			/* pointer to second file identifier */
+	)
+
+	{
+	int		cmp;
+
+	/* Compare valid timestamps, then element and level names */
+	cmp = strcmp(((DIRIDENT *) a)->vtime, ((DIRIDENT *) b)->vtime);
+	if ( cmp != 0 ) return cmp;
+	cmp = strcmp(((DIRIDENT *) a)->edef->name, ((DIRIDENT *) b)->edef->name);
+	if ( cmp != 0 ) return cmp;
+	return strcmp(((DIRIDENT *) a)->ldef->name, ((DIRIDENT *) b)->ldef->name);
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ c l e a r                                          *
+*   c a t a l o g _ r e m o v e                                        *
+*                                                                      *
+*   Discard the file identifiers for a data directory, or remove the   *
+*   directory from the catalog.                                        *
+*                                                                      *
+***********************************************************************/
+
+static	void		catalog_clear
+
+	(
+	DIRCAT		*dcat		/* data directory catalog */
+	)
+
+	{
+	int			ii;
+
+	if ( IsNull(dcat) ) return;
+
+	for ( ii=0; ii<dcat->nident; ii++ ) FREEMEM(dcat->idents[ii].vtime);
+	FREEMEM(dcat->idents);
+	dcat->nident = 0;
+	dcat->mident = 0;
+	dcat->listed = FALSE;
+	}
+
+/**********************************************************************/
+
+static	void		catalog_remove
+
+	(
+	int			icat		/* position in catalog */
+	)
+
+	{
+	int			jcat;
+
+	if ( icat < 0 || icat >= NumCat ) return;
+
+	catalog_clear(DirCat + icat);
+
+	/* Remove the watch ... unless shared with another path */
+#	ifdef WATCH_DIRS
+	if ( CatFd >= 0 && DirCat[icat].wd >= 0 )
+		{
+		for ( jcat=0; jcat<NumCat; jcat++ )
+			{
+			if ( jcat != icat && DirCat[jcat].wd == DirCat[icat].wd ) break;
+			}
+		if ( jcat >= NumCat ) (void) inotify_rm_watch(CatFd, DirCat[icat].wd);
+		}
+#	endif
+
+	FREEMEM(DirCat[icat].dir);
+	for ( jcat=icat+1; jcat<NumCat; jcat++ ) DirCat[jcat-1] = DirCat[jcat];
+	NumCat--;
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c a t a l o g _ e v e n t s                                        *
+*                                                                      *
+*   Read pending inotify events and discard the file identifiers for   *
+*   each data directory that has changed.                              *
+*                                                                      *
+***********************************************************************/
+
+static	void		catalog_events
+
+	(
+	)
+
+	{
+#	ifdef WATCH_DIRS
+	int						nread, pos, icat;
+	struct inotify_event	*event;
+
+	/* Buffer for inotify events (aligned for the event structure) */
+	static	union
+		{
+		struct inotify_event	event;
+		char					buf[4096];
+		} Events;
+
+	if ( CatFd < 0 ) return;
+
+	while ( (nread = read(CatFd, Events.buf, sizeof(Events.buf))) > 0 )
+		{
+		for ( pos=0; pos+(int)sizeof(struct inotify_event)<=nread;
+				pos += sizeof(struct inotify_event) + event->len )
+			{
+			event = (struct inotify_event *) (Events.buf + pos);
+
+			/* Events were lost ... so discard everything */
+			if ( event->mask & IN_Q_OVERFLOW )
+				{
+				for ( icat=0; icat<NumCat; icat++ ) catalog_clear(DirCat + icat);
+				continue;
+				}
+
+			/* Forget directories that have gone ... or discard identifiers */
+			for ( icat=NumCat-1; icat>=0; icat-- )
+				{
+				if ( DirCat[icat].wd != event->wd ) continue;
+				if ( event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF) )
+					catalog_remove(icat);
+				else
+					catalog_clear(DirCat + icat);
+				}
+			}
+		}
+#	endif
+	}
+
 /***********************************************************************
 *                                                                      *
 *     STATIC (LOCAL) ROUTINES (File Sorting and Matching)              *
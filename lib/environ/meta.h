@@ -59,6 +59,8 @@
 #define	META_LATLON 1
 #define META_OLDFMT 2
 #define META_DOMAX  4
+#define META_BINARY 8
+#define META_BINZIP 16
 
 #define	MetaRetainPlot			"RetainPlot"
 #define	MetaNoRetainPlot		"NoRetainPlot"
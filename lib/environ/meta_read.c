@@ -50,6 +50,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 #ifdef MACHINE_PCLINUX
 #include <zlib.h>
 #endif
@@ -76,6 +77,7 @@ static	LOGICAL	UseProj;
 static	LOGICAL	UseArea;
 static	LOGICAL	UseCal;
 static	LOGICAL	UseGust;
+static	LOGICAL	UseBinary;
 
 /* Routines used for converting between structures */
 static	void	surface_to_MKS(SURFACE, STRING, STRING);
@@ -100,6 +102,8 @@ static	LOGICAL	get_subfields(FILE *, int *, STRING **, STRING **);
 static	LOGICAL	get_bgval(FILE *, CAL);
 static	LOGICAL	get_bspline(FILE *, SURFACE *);
 static	LOGICAL	get_bspline2D(FILE *, SURFACE *);
+static	LOGICAL	get_bspline_bin(FILE *, SURFACE *, int);
+static	LOGICAL	skip_bspline_bin(FILE *);
 static	LOGICAL	get_grid(FILE *, SURFACE *);
 static	LOGICAL	get_grid2D(FILE *, SURFACE *);
 static	LOGICAL	get_raster(FILE *, RASTER *, BITMASK);
@@ -689,6 +693,18 @@ METAFILE	read_metafile
 			define_fld_data(fld, "surface", (ITEM) sfc);
 			}
 
+		/* B-spline surface stored as binary (revision 4.0) */
+		else if (UseBinary &&
+					(same(cmd, "bsplinebin") || same(cmd, "bspline2Dbin")))
+			{
+			mreset = TRUE;
+			if (!get_bspline_bin(fp, &sfc, same(cmd, "bsplinebin")? 1: 2))
+				continue;
+			fld = make_mf_field(meta, "surface", NullString, entity,
+															element, level);
+			define_fld_data(fld, "surface", (ITEM) sfc);
+			}
+
 		/* Compressed Raster data */
 		else if (same(cmd, "raster"))
 			{
@@ -1224,6 +1240,12 @@ LOGICAL	read_meta_info
 			List[Nlist-1].value = strdup(value);
 			}
 
+		/* Skip binary surface data */
+		else if (same(cmd, "bsplinebin") || same(cmd, "bspline2Dbin"))
+			{
+			if (!skip_bspline_bin(fp)) break;
+			}
+
 		/* Ignore anything else */
 		else
 			{
@@ -1409,6 +1431,12 @@ int		search_meta_fields
 				}
 			}
 
+		/* Skip binary surface data */
+		else if (same(cmd, "bsplinebin") || same(cmd, "bspline2Dbin"))
+			{
+			if (!skip_bspline_bin(fp)) break;
+			}
+
 		/* Ignore anything else */
 		else
 			{
@@ -1572,6 +1600,12 @@ int		search_link_fields
 				}
 			}
 
+		/* Skip binary surface data */
+		else if (same(cmd, "bsplinebin") || same(cmd, "bspline2Dbin"))
+			{
+			if (!skip_bspline_bin(fp)) break;
+			}
+
 		/* Ignore anything else */
 		else
 			{
@@ -2095,6 +2129,7 @@ static	void	set_revision_info
 	UseArea     = (LOGICAL) ((rev1==1 && rev2>=5) || rev1>=2);
 	UseCal      = (LOGICAL) (rev1>=2);
 	UseGust     = (LOGICAL) (rev1>=2);
+	UseBinary   = (LOGICAL) (rev1>=4);
 	}
 
 
@@ -3014,6 +3049,172 @@ static LOGICAL	get_bspline2D
 
 /**********************************************************************/
 
+/* Binary surface format (metafile revision 4.0):                      */
+/*                                                                     */
+/*   bsplinebin   raw|zlib nbytes m n x0 y0 orient gridlen             */
+/*   bspline2Dbin raw|zlib nbytes m n x0 y0 orient gridlen             */
+/*                                                                     */
+/* followed on the next line by nbytes of data, which (once            */
+/* uncompressed) holds the m*n control vertices as little-endian       */
+/* 32-bit floats in MKS units.  For 2D surfaces all the U components   */
+/* are followed by all the V components.  The whole block is read      */
+/* with a single fread(), rather than parsed one value at a time.      */
+
+static LOGICAL	get_bspline_bin
+
+		(
+		FILE	*fp,
+		SURFACE	*sfc,
+		int		ncomp
+		)
+
+	{
+	int		m, n, ncv, icv;
+	long	nbytes, insize;
+	char	comp[20], org1[20], org2[20];
+	POINT	origin;
+	float	orient, gridlen;
+	float	*cvbuf;
+	UNCHAR	*bytes, tmp;
+	union	{ int i; UNCHAR c[sizeof(int)]; } order;
+
+	*sfc = NullSfc;
+
+	if ( !getfileline(fp, line, ncl) )                       return FALSE;
+	strcpy_arg(comp, line, &status);			if (!status) return FALSE;
+	insize     = int_arg(line, &status);		if (!status) return FALSE;
+	m          = int_arg(line, &status);		if (!status) return FALSE;
+	n          = int_arg(line, &status);		if (!status) return FALSE;
+	strcpy_arg(org1, line, &status);			if (!status) return FALSE;
+	strcpy_arg(org2, line, &status);			if (!status) return FALSE;
+	orient     = float_arg(line, &status);		if (!status) return FALSE;
+	gridlen    = float_arg(line, &status);		if (!status) return FALSE;
+	if (!meta_point(org1, org2, origin))                     return FALSE;
+
+	/* The data block must be read or the rest of the file is lost */
+	/*  ... so check the sizes before anything is allocated          */
+	/*  (compressed data is never much larger than the raw data)     */
+	if (m <= 0 || n <= 0 || ncomp <= 0
+			|| m > INT_MAX / (int) sizeof(float) / ncomp / n)
+		{
+		(void) pr_error("Metafile", "Bad binary spline size in metafile\n");
+		BailOut = TRUE;
+		return FALSE;
+		}
+	ncv    = m * n;
+	nbytes = (long) ncv * ncomp * sizeof(float);
+	if (insize <= 0 || insize > nbytes + nbytes/1000 + 64)
+		{
+		(void) pr_error("Metafile", "Bad binary spline size in metafile\n");
+		BailOut = TRUE;
+		return FALSE;
+		}
+	cvbuf = INITMEM(float, ncv*ncomp);
+	bytes = (UNCHAR *) cvbuf;
+
+	/* Read control vertex values directly */
+	if (same(comp, "raw"))
+		{
+		if (insize != nbytes
+				|| fread((void *) bytes, 1, (size_t) nbytes, fp)
+														!= (size_t) nbytes)
+			{
+			FREEMEM(cvbuf);
+			(void) pr_error("Metafile",
+				"Spline vertex count mismatch in metafile\n");
+			BailOut = TRUE;
+			return FALSE;
+			}
+		}
+
+	/* Read and uncompress control vertex values */
+	else if (same(comp, "zlib"))
+		{
+#		ifdef MACHINE_PCLINUX
+		UNCHAR	*srcbuf;
+		uLongf	dstsize;
+		LOGICAL	ok;
+
+		srcbuf  = INITMEM(UNCHAR, insize);
+		dstsize = (uLongf) nbytes;
+		ok = (LOGICAL) (fread((void *) srcbuf, 1, (size_t) insize, fp)
+															== (size_t) insize);
+		if (ok) ok = (LOGICAL) (uncompress((Bytef *) bytes, &dstsize,
+								(Bytef *) srcbuf, (uLong) insize) == Z_OK);
+		if (ok) ok = (LOGICAL) (dstsize == (uLongf) nbytes);
+		FREEMEM(srcbuf);
+		if (!ok)
+			{
+			FREEMEM(cvbuf);
+			(void) pr_error("Metafile",
+				"Corrupted compressed spline in metafile\n");
+			BailOut = TRUE;
+			return FALSE;
+			}
+#		else
+		FREEMEM(cvbuf);
+		pr_error("Metafile",
+			"Reading zlib compressed data is not available on this machine.\n");
+		BailOut = TRUE;
+		return FALSE;
+#		endif
+		}
+
+	else
+		{
+		FREEMEM(cvbuf);
+		(void) pr_error("Metafile",
+			"Unknown binary spline encoding \"%s\" in metafile\n", comp);
+		BailOut = TRUE;
+		return FALSE;
+		}
+
+	/* Data are stored little-endian */
+	order.i = 1;
+	if (order.c[0] != 1)
+		{
+		for (icv=0; icv<nbytes; icv+=4)
+			{
+			tmp = bytes[icv];   bytes[icv]   = bytes[icv+3]; bytes[icv+3] = tmp;
+			tmp = bytes[icv+1]; bytes[icv+1] = bytes[icv+2]; bytes[icv+2] = tmp;
+			}
+		}
+
+	/* Construct the surface */
+	*sfc = create_surface();
+	if (ncomp == 1)
+		define_surface_spline(*sfc, m, n, &BaseMap, origin, orient,
+					gridlen, cvbuf, n);
+	else
+		define_surface_spline_2D(*sfc, m, n, &BaseMap, origin, orient,
+					gridlen, cvbuf, cvbuf+ncv, n);
+	define_surface_units(*sfc, &MKS_UNITS);
+	remap_surface(*sfc, &NewMap, &BaseMap);
+	FREEMEM(cvbuf);
+	return TRUE;
+	}
+
+/**********************************************************************/
+
+static LOGICAL	skip_bspline_bin
+
+		(
+		FILE	*fp
+		)
+
+	{
+	char	comp[20];
+	long	insize;
+
+	if ( !getfileline(fp, line, ncl) )                       return FALSE;
+	strcpy_arg(comp, line, &status);			if (!status) return FALSE;
+	insize     = int_arg(line, &status);		if (!status) return FALSE;
+	if (insize <= 0)                                         return FALSE;
+	return (LOGICAL) (fseek(fp, insize, SEEK_CUR) == 0);
+	}
+
+/**********************************************************************/
+
 static LOGICAL	get_grid
 
 	(
@@ -47,6 +47,7 @@
 #include <fpa_macros.h>
 #include <fpa_types.h>
 
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #ifdef MACHINE_PCLINUX
@@ -66,6 +67,13 @@ static	LOGICAL		OldFmt  = FALSE;
 static	LOGICAL		LLmode  = FALSE;
 static	MAP_PROJ	*LLproj = NullMapProj;
 static	LOGICAL		DoMax   = FALSE;
+static	LOGICAL		BinFmt  = FALSE;
+static	LOGICAL		BinZip  = FALSE;
+
+/* Binary surface output (set for each metafile) */
+static	LOGICAL		PutBin  = FALSE;
+static	LOGICAL		PutZip  = FALSE;
+static	void		set_meta_binary(void);
 /* Modes:
 	x-y vs lat-lon
 	x-y precision/digits/preset units
@@ -89,6 +97,7 @@ static	LOGICAL	put_entity(FILE *, STRING, STRING, STRING, int, STRING *,
 static	LOGICAL	put_bgval(FILE *, STRING, ITEM);
 static	LOGICAL	put_bspline(FILE *, SURFACE, double);
 static	LOGICAL	put_bspline2D(FILE *, SURFACE, double);
+static	LOGICAL	put_bspline_bin(FILE *, SURFACE);
 static	LOGICAL	put_raster(FILE *, RASTER);
 static	LOGICAL	put_mask(FILE *, BITMASK);
 static	LOGICAL	put_area_bound(FILE *, AREA);
@@ -166,6 +175,8 @@ void		backup_metafile
  * - META_LATLON
  * - META_OLDFMT
  * - META_DOMAX
+ * - META_BINARY
+ * - META_BINZIP
  *
  *	@param[in]	name	metafile name
  *	@param[in]  meta	METAFILE object
@@ -185,16 +196,26 @@ void		write_metafile_special
 	if (mode & META_LATLON) LLmode = True;
 	if (mode & META_OLDFMT) OldFmt = True;
 	if (mode & META_DOMAX)  DoMax  = True;
+	if (mode & META_BINARY) BinFmt = True;
+	if (mode & META_BINZIP) BinFmt = BinZip = True;
 	write_metafile(name, meta, maxdig);
 	LLmode = FALSE;
 	OldFmt = FALSE;
 	DoMax  = FALSE;
+	BinFmt = FALSE;
+	BinZip = FALSE;
 	}
 
 /**********************************************************************/
 
 /**********************************************************************/
 /** Write the contents of the given METAFILE to a given metafile.
+ *
+ * Surfaces are normally written as text.  If the environment variable
+ * FPA_METAFILE_FORMAT or the "Metafile.Format" advanced feature is
+ * set to "binary" (or "binary-zlib" for compressed output), surfaces
+ * are written as binary blocks of control vertices instead (metafile
+ * revision 4.0).
  *
  *	@param[in]	name	metafile name
  *	@param[in]  meta	METAFILE object
@@ -277,6 +298,7 @@ void		write_metafile
 
 	/* Write start-up information */
 	set_meta_maxdig(maxdig);
+	set_meta_binary();
 	(void) put_comment(fp, "MSRB Metafile Standard");
 	(void) put_rev(fp);
 	(void) put_comment(fp, "");
@@ -323,9 +345,11 @@ void		write_metafile
 
 			switch (sfc->sp.dim)
 				{
-				case DimScalar:		(void) put_bspline(fp, sfc, precision);
+				case DimScalar:		if (PutBin) (void) put_bspline_bin(fp, sfc);
+									else (void) put_bspline(fp, sfc, precision);
 									break;
-				case DimVector2D:	(void) put_bspline2D(fp, sfc, precision);
+				case DimVector2D:	if (PutBin) (void) put_bspline_bin(fp, sfc);
+									else (void) put_bspline2D(fp, sfc, precision);
 									break;
 				}
 			}
@@ -856,6 +880,46 @@ static	int		nint_uscale
 	return NINT(value);
 	}
 
+/***********************************************************************
+*                                                                      *
+*      s e t _ m e t a _ b i n a r y                                   *
+*                                                                      *
+*      Decide whether surfaces in this metafile are written as binary  *
+*      blocks, from the write_metafile_special() mode, or else from    *
+*      FPA_METAFILE_FORMAT or the "Metafile.Format" advanced feature.  *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL	DefSet = FALSE;
+static	LOGICAL	DefBin = FALSE;
+static	LOGICAL	DefZip = FALSE;
+
+static	void	set_meta_binary(void)
+
+	{
+	STRING	mode;
+
+	if (!DefSet)
+		{
+		mode = getenv("FPA_METAFILE_FORMAT");
+		if (blank(mode)) mode = get_feature_mode("Metafile.Format");
+
+		if (blank(mode) || same_ic(mode, "text"))
+			DefBin = DefZip = FALSE;
+		else if (same_ic(mode, "binary"))
+			DefBin = TRUE;
+		else if (same_ic(mode, "binary-zlib"))
+			DefBin = DefZip = TRUE;
+		else
+			(void) pr_warning("Metafile",
+				"Unknown metafile format \'%s\'.  Using text.\n", mode);
+		DefSet = TRUE;
+		}
+
+	PutBin = (LOGICAL) (!OldFmt && (BinFmt || DefBin));
+	PutZip = (LOGICAL) (PutBin && (BinZip || (!BinFmt && DefZip)));
+	}
+
 /***********************************************************************
 *                                                                      *
 *      p u t _ c o m m e n t                                           *
@@ -867,6 +931,7 @@ static	int		nint_uscale
 *      p u t _ b g v a l                                               *
 *      p u t _ b s p l i n e                                           *
 *      p u t _ b s p l i n e 2 D                                       *
+*      p u t _ b s p l i n e _ b i n                                   *
 *      p u t _ a r e a _ b o u n d                                     *
 *      p u t _ a r e a _ h o l e                                       *
 *      p u t _ a r e a _ d i v i d e                                   *
@@ -887,6 +952,7 @@ static	int		nint_uscale
 
 static	const	STRING	Blank  = "\"\"";
 static	const	STRING	Rev    = "3.0";
+static	const	STRING	BinRev = "4.0";
 static	const	STRING	OldRev = "1.5";
 
 static LOGICAL	put_comment
@@ -910,7 +976,7 @@ static LOGICAL	put_rev
 	)
 
 	{
-	(void) fprintf(fp, " rev %s", (OldFmt)? OldRev: Rev);
+	(void) fprintf(fp, " rev %s", (OldFmt)? OldRev: (PutBin)? BinRev: Rev);
 	(void) fprintf(fp, "\n");
 	return TRUE;
 	}
@@ -1242,6 +1308,121 @@ static LOGICAL	put_bspline2D
 	return TRUE;
 	}
 
+/**********************************************************************/
+
+/* Binary surface format (metafile revision 4.0):                      */
+/*                                                                     */
+/*   bsplinebin   raw|zlib nbytes m n x0 y0 orient gridlen             */
+/*   bspline2Dbin raw|zlib nbytes m n x0 y0 orient gridlen             */
+/*                                                                     */
+/* followed on the next line by nbytes of data, which (once            */
+/* uncompressed) holds the m*n control vertices as little-endian       */
+/* 32-bit floats in MKS units, without rounding to the precision of    */
+/* the element.  For 2D surfaces all the U components are followed by  */
+/* all the V components.                                               */
+
+static LOGICAL	put_bspline_bin
+
+	(
+	FILE	*fp,
+	SURFACE	sfc
+	)
+
+	{
+	float	*vbuf, *cvs;
+	int		m, n, ncv, ncomp, icomp, icv;
+	long	nbytes, outsize;
+	double	val, factor, offset;
+	UNCHAR	*bytes, *outbuf, tmp;
+	LOGICAL	swap;
+	STRING	comp;
+	union	{ int i; UNCHAR c[sizeof(int)]; } order;
+
+	if (!sfc) return FALSE;
+	switch (sfc->sp.dim)
+		{
+		case DimScalar:		ncomp = 1;	break;
+		case DimVector2D:	ncomp = 2;	break;
+		default:			return FALSE;
+		}
+	m = sfc->sp.m;
+	n = sfc->sp.n;
+	factor = sfc->units.factor;
+	offset = sfc->units.offset;
+
+	/* Convert control vertices to MKS units in one block */
+	ncv  = m*n;
+	vbuf = INITMEM(float, ncv*ncomp);
+	for (icomp=0; icomp<ncomp; icomp++)
+		{
+		if (ncomp == 1)     cvs = sfc->sp.cvs[0];
+		else if (icomp==0)  cvs = sfc->sp.cvx[0];
+		else                cvs = sfc->sp.cvy[0];
+		for (icv=0; icv<ncv; icv++)
+			{
+			val = cvs[icv];
+			if (offset != 0) val -= offset;
+			if (factor != 1) val /= factor;
+			vbuf[icomp*ncv + icv] = (float) val;
+			}
+		}
+
+	/* Store as little-endian */
+	order.i = 1;
+	swap    = (LOGICAL) (order.c[0] != 1);
+	nbytes  = (long) ncv * ncomp * sizeof(float);
+	bytes   = (UNCHAR *) vbuf;
+	if (swap)
+		{
+		for (icv=0; icv<nbytes; icv+=4)
+			{
+			tmp = bytes[icv];   bytes[icv]   = bytes[icv+3]; bytes[icv+3] = tmp;
+			tmp = bytes[icv+1]; bytes[icv+1] = bytes[icv+2]; bytes[icv+2] = tmp;
+			}
+		}
+
+	/* Compress if requested */
+	comp    = "raw";
+	outbuf  = bytes;
+	outsize = nbytes;
+#	ifdef MACHINE_PCLINUX
+	if (PutZip)
+		{
+		uLongf	destsize;
+
+		destsize = compressBound((uLong) nbytes);
+		outbuf   = INITMEM(UNCHAR, destsize);
+		if (compress((Bytef *) outbuf, &destsize, (Bytef *) bytes,
+				(uLong) nbytes) == Z_OK)
+			{
+			comp    = "zlib";
+			outsize = (long) destsize;
+			}
+		else
+			{
+			FREEMEM(outbuf);
+			outbuf = bytes;
+			}
+		}
+#	endif
+
+	(void) fprintf(fp, " %s", (ncomp == 1)? "bsplinebin": "bspline2Dbin");
+	(void) fprintf(fp, " %s", comp);
+	(void) fprintf(fp, " %ld", outsize);
+	(void) fprintf(fp, " %d", m);
+	(void) fprintf(fp, " %d", n);
+	(void) put_point(fp, sfc->sp.origin);
+	(void) fprintf(fp, " %s", fformat(sfc->sp.orient, 2));
+	(void) fprintf(fp, " %s", fformat(meta_scale(sfc->sp.gridlen), 3));
+	(void) fprintf(fp, "\n");
+	(void) fwrite((void *) outbuf, 1, (size_t) outsize, fp);
+	(void) fprintf(fp, "\n");
+
+	if (outbuf != bytes) FREEMEM(outbuf);
+	FREEMEM(vbuf);
+	return TRUE;
+	}
+
 static LOGICAL  put_mask
 
 	(
@@ -48,6 +48,17 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Compiled configuration snapshots need fmemopen() and mmap() */
+#if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+#	define CONFIG_SNAPSHOT
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#	include <fcntl.h>
+#endif
 
 /* Interface functions                     */
 /*  ... these are defined in read_config.h */
@@ -59,6 +70,11 @@ static LOGICAL	pop_config_file_name(void);
 static LOGICAL	pop_config_file_pointer(FILE **);
 static LOGICAL	current_config_file_name(STRING *);
 
+/* Internal static functions (Compiled Configuration Snapshot) */
+static FILE		*snapshot_file_open(STRING);
+static void		snapshot_file_close(FILE *);
+static LOGICAL	snapshot_block_skip(FILE *);
+
 /* Local variables for reading configuration files */
 typedef	char	SCLine[FPAC_MAX_LENGTH];
 static			SCLine	CfgLine = "";		/* general line reading buffer */
@@ -67,6 +83,80 @@ static	const	STRING	Comment	= "#";		/* comment line character(s) */
 static	const	int		Nccl    = sizeof(SCLine) - 1;
 											/* size of general buffers - 1 */
 
+#ifdef CONFIG_SNAPSHOT
+/* Local variables for the compiled configuration snapshot */
+/*  ... the snapshot file holds a header, a table of records (one for */
+/*  each configuration file) and then the file names, compiled lines  */
+/*  and block skip tables, each aligned to a multiple of 8 bytes      */
+#define	SnapMagic		"FPACSNAP"
+#define	SnapVersion		1
+#define	SnapAlign(n)	( ((n) + 7L) & ~7L )
+
+typedef	struct
+	{
+	char	magic[8];		/* identifies a snapshot file */
+	int		version;		/* snapshot format version */
+	int		nfiles;			/* number of configuration files */
+	char	revision[32];	/* software revision that wrote the snapshot */
+	} SNAP_HEADER;
+
+typedef	struct
+	{
+	long	name;			/* offset of configuration file name */
+	long	mtime;			/* modification time of configuration file */
+	long	size;			/* size of configuration file */
+	long	text;			/* offset of compiled lines */
+	long	ntext;			/* length of compiled lines */
+	long	skip;			/* offset of block skip table */
+	long	nskip;			/* number of block skip table entries */
+	} SNAP_RECORD;
+
+typedef	struct
+	{
+	long	from;			/* location just after a "{" line */
+	long	to;				/* location just after the matching "}" line */
+	} SNAP_SKIP;
+
+typedef	enum
+	{
+	SnapUnknown,			/* not yet checked against configuration file */
+	SnapCompiled,			/* compiled lines match configuration file */
+	SnapTextFile			/* configuration file must be read as text */
+	} SNAP_STATE;
+
+typedef	struct
+	{
+	STRING		name;		/* configuration file name */
+	long		mtime;		/* modification time of configuration file */
+	long		size;		/* size of configuration file */
+	char		*text;		/* compiled lines */
+	long		ntext;		/* length of compiled lines */
+	SNAP_SKIP	*skip;		/* block skip table (sorted on "from") */
+	long		nskip;		/* number of block skip table entries */
+	LOGICAL		owned;		/* compiled here rather than mapped? */
+	SNAP_STATE	state;		/* how this configuration file is read */
+	} SNAP_ENTRY;
+
+static	int			SnapEnabled  = -1;		/* snapshot in use (-1: unknown) */
+static	STRING		SnapPath     = NullString;
+static	char		*SnapMap     = NullPtr(char *);
+static	size_t		SnapMapSize  = 0;
+static	LOGICAL		SnapDirty    = FALSE;	/* newly compiled files to save? */
+static	int			NumSnap      = 0;
+static	SNAP_ENTRY	*SnapList    = NullPtr(SNAP_ENTRY *);
+static	int			NumSnapFiles = 0;		/* open snapshot streams */
+static	int			MaxSnapFiles = 0;
+static	FILE		**SnapFiles  = NullPtr(FILE **);
+static	int			*SnapFileEnt = NullPtr(int *);
+
+static	LOGICAL		snapshot_enabled(void);
+static	void		load_config_snapshot(void);
+static	int			find_snapshot_entry(STRING);
+static	LOGICAL		snapshot_entry_current(SNAP_ENTRY *);
+static	LOGICAL		compile_config_file(SNAP_ENTRY *);
+static	int			compare_snapshot_skip(const void *, const void *);
+#endif /* CONFIG_SNAPSHOT */
+
 /***********************************************************************
 *                                                                      *
 *   f i r s t _ c o n f i g _ f i l e _ o p e n                        *
@@ -160,8 +250,11 @@ LOGICAL				config_file_open
 		return FALSE;
 		}
 
-	/* Try to open the named configuration file */
-	if ( IsNull( fp = fopen(cfgname, "r") ) )
+	/* Try to open the named configuration file               */
+	/*  ... reading the compiled snapshot if one is available */
+	fp = snapshot_file_open(cfgname);
+	if ( IsNull(fp) ) fp = fopen(cfgname, "r");
+	if ( IsNull(fp) )
 		{
 		(void) pr_error("Environ",
 				"\"%s\" config file cannot be opened\n", cfgname);
@@ -232,6 +325,7 @@ void				config_file_close
 	if ( NotNull(fpcfg) )
 		{
 		(void) pop_config_file_name();
+		(void) snapshot_file_close(*fpcfg);
 		(void) fclose(*fpcfg);
 		*fpcfg = NullPtr(FILE *);
 		}
@@ -423,6 +517,10 @@ LOGICAL				skip_config_file_block
 		return TRUE;
 		}
 
+	/* Jump straight to the end of the block if the compiled */
+	/*  snapshot of this configuration file knows where it is */
+	if ( snapshot_block_skip(*fpcfg) ) return TRUE;
+
 	/* Continue reading the configuration file line by line */
 	/*  ... until end of block is encountered               */
 	numbrace = 1;
@@ -583,6 +681,142 @@ LOGICAL				config_file_location
 	return TRUE;
 	}
 
+/***********************************************************************
+*                                                                      *
+*   s a v e _ c o n f i g _ s n a p s h o t                            *
+*                                                                      *
+***********************************************************************/
+
+/**********************************************************************/
+/** This function saves the compiled configuration snapshot.
+ *
+ * The snapshot holds the valid lines of each configuration file read
+ * so far (comments removed and continuation lines joined), along with
+ * the location of the end of each block, so that later processes can
+ * read the configuration without parsing the text files again.
+ * Nothing is written unless a configuration file has been compiled
+ * since the snapshot was last loaded or saved, or if the snapshot is
+ * disabled by the "Config.Snapshot" advanced feature.
+ *
+ * @return True if the snapshot is current.
+ **********************************************************************/
+LOGICAL				save_config_snapshot
+
+	(
+	)
+
+	{
+#	ifdef CONFIG_SNAPSHOT
+	int			nn, nrec;
+	long		offset;
+	LOGICAL		*keep, ok;
+	STRING		tmpname;
+	FILE		*fp;
+	SNAP_ENTRY	*entry;
+	SNAP_HEADER	header;
+	SNAP_RECORD	*records;
+
+	static	const	char	Pad[8] = { 0 };
+
+	/* Nothing to do if the snapshot is off or already current */
+	if ( !snapshot_enabled() ) return FALSE;
+	if ( !SnapDirty )          return TRUE;
+
+	/* Keep compiled files, and files from the previous snapshot that */
+	/*  have not been opened yet but still match the text file        */
+	keep = INITMEM(LOGICAL, NumSnap);
+	for ( nrec=0, nn=0; nn<NumSnap; nn++ )
+		{
+		entry    = SnapList + nn;
+		keep[nn] = (LOGICAL) ( entry->state == SnapCompiled
+						|| ( entry->state == SnapUnknown
+								&& snapshot_entry_current(entry) ) );
+		if ( keep[nn] ) nrec++;
+		}
+
+	/* Set the records and the location of everything they refer to */
+	records = INITMEM(SNAP_RECORD, nrec);
+	offset  = SnapAlign((long) (sizeof(SNAP_HEADER) + nrec*sizeof(SNAP_RECORD)));
+	for ( nrec=0, nn=0; nn<NumSnap; nn++ )
+		{
+		if ( !keep[nn] ) continue;
+		entry = SnapList + nn;
+		records[nrec].name  = offset;
+		offset += SnapAlign((long) strlen(entry->name) + 1);
+		records[nrec].mtime = entry->mtime;
+		records[nrec].size  = entry->size;
+		records[nrec].text  = offset;
+		records[nrec].ntext = entry->ntext;
+		offset += SnapAlign(entry->ntext);
+		records[nrec].skip  = offset;
+		records[nrec].nskip = entry->nskip;
+		offset += entry->nskip * (long) sizeof(SNAP_SKIP);
+		nrec++;
+		}
+
+	(void) memset((void *) &header, 0, sizeof(SNAP_HEADER));
+	(void) memcpy(header.magic, SnapMagic, sizeof(header.magic));
+	(void) strncpy(header.revision, FpaRevision, sizeof(header.revision)-1);
+	header.version = SnapVersion;
+	header.nfiles  = nrec;
+
+	/* Write a private copy and rename it into place, so that other */
+	/*  processes only ever see a complete snapshot                 */
+	tmpname = INITMEM(char, strlen(SnapPath) + 16);
+	(void) sprintf(tmpname, "%s.%d", SnapPath, (int) getpid());
+	ok = FALSE;
+	if ( NotNull( fp = fopen(tmpname, "w") ) )
+		{
+		ok = (LOGICAL) ( fwrite((void *) &header, sizeof(SNAP_HEADER), 1, fp) == 1 );
+		if ( ok && nrec > 0 )
+			ok = (LOGICAL) ( fwrite((void *) records, sizeof(SNAP_RECORD),
+							(size_t) nrec, fp) == (size_t) nrec );
+		offset = (long) (sizeof(SNAP_HEADER) + nrec*sizeof(SNAP_RECORD));
+		ok = ok && ( fwrite(Pad, 1, (size_t) (SnapAlign(offset) - offset), fp)
+							== (size_t) (SnapAlign(offset) - offset) );
+		for ( nn=0; ok && nn<NumSnap; nn++ )
+			{
+			if ( !keep[nn] ) continue;
+			entry  = SnapList + nn;
+			offset = (long) strlen(entry->name) + 1;
+			ok = ( fwrite(entry->name, 1, (size_t) offset, fp) == (size_t) offset )
+				&& ( fwrite(Pad, 1, (size_t) (SnapAlign(offset) - offset), fp)
+							== (size_t) (SnapAlign(offset) - offset) );
+			offset = entry->ntext;
+			ok = ok && ( fwrite(entry->text, 1, (size_t) offset, fp) == (size_t) offset )
+				&& ( fwrite(Pad, 1, (size_t) (SnapAlign(offset) - offset), fp)
+							== (size_t) (SnapAlign(offset) - offset) );
+			if ( ok && entry->nskip > 0 )
+				ok = (LOGICAL) ( fwrite((void *) entry->skip, sizeof(SNAP_SKIP),
+							(size_t) entry->nskip, fp) == (size_t) entry->nskip );
+			}
+		if ( fclose(fp) != 0 ) ok = FALSE;
+		if ( ok && rename(tmpname, SnapPath) != 0 ) ok = FALSE;
+		if ( !ok ) (void) unlink(tmpname);
+		}
+
+	if ( ok )
+		{
+		(void) pr_status("Environ",
+				"Saved config snapshot \"%s\" (%d files)\n", SnapPath, nrec);
+		SnapDirty = FALSE;
+		}
+	else
+		{
+		(void) pr_warning("Environ",
+				"Cannot save config snapshot \"%s\"\n", SnapPath);
+		}
+
+	FREEMEM(tmpname);
+	FREEMEM(records);
+	FREEMEM(keep);
+	return ok;
+
+#	else
+	return FALSE;
+#	endif /* CONFIG_SNAPSHOT */
+	}
+
 /***********************************************************************
 *                                                                      *
 *     STATIC (LOCAL) ROUTINES (Configuration File Push and Pop)        *
@@ -784,3 +1018,506 @@ static	LOGICAL		current_config_file_name
 	if ( NotNull(cfgname) ) *cfgname = ConfigNames[NumConfigFiles - 1];
 	return TRUE;
 	}
+
+/***********************************************************************
+*                                                                      *
+*     STATIC (LOCAL) ROUTINES (Compiled Configuration Snapshot)        *
+*                                                                      *
+*     All the routines after this point are available only within      *
+*     this file.                                                       *
+*                                                                      *
+***********************************************************************/
+
+/***********************************************************************
+*                                                                      *
+*   s n a p s h o t _ f i l e _ o p e n                                *
+*   s n a p s h o t _ f i l e _ c l o s e                              *
+*   s n a p s h o t _ b l o c k _ s k i p                              *
+*                                                                      *
+*   These functions read configuration files from the compiled         *
+*   snapshot.  A compiled file is opened as a memory stream over its   *
+*   valid lines, so that file locations saved while reading remain    *
+*   usable with fseek().  Whether a file is read from the snapshot or  *
+*   as text is decided the first time it is opened, and never changes  *
+*   within a process, since saved file locations depend on it.         *
+*                                                                      *
+***********************************************************************/
+
+static	FILE		*snapshot_file_open
+
+	(
+	STRING		cfgname		/* configuration file name */
+	)
+
+	{
+#	ifdef CONFIG_SNAPSHOT
+	int			nn;
+	FILE		*fp;
+	SNAP_ENTRY	*entry;
+
+	/* Only absolute file names identify the same file in every process */
+	if ( !snapshot_enabled() )            return NullPtr(FILE *);
+	if ( blank(cfgname) || *cfgname != '/' ) return NullPtr(FILE *);
+
+	/* Find (or add) the configuration file in the snapshot list */
+	nn = find_snapshot_entry(cfgname);
+	if ( nn < 0 )
+		{
+		nn       = NumSnap++;
+		SnapList = GETMEM(SnapList, SNAP_ENTRY, NumSnap);
+		(void) memset((void *) (SnapList + nn), 0, sizeof(SNAP_ENTRY));
+		SnapList[nn].name  = strdup(cfgname);
+		SnapList[nn].owned = TRUE;
+		SnapList[nn].state = SnapUnknown;
+		}
+	entry = SnapList + nn;
+
+	/* Decide how to read the configuration file the first time through */
+	/*  ... and compile it now if the snapshot is missing or out of date */
+	if ( entry->state == SnapUnknown )
+		{
+		if ( snapshot_entry_current(entry) )
+			{
+			entry->state = SnapCompiled;
+			}
+		else if ( compile_config_file(entry) )
+			{
+			entry->state = SnapCompiled;
+			SnapDirty    = TRUE;
+			}
+		else
+			{
+			entry->state = SnapTextFile;
+			}
+		}
+	if ( entry->state != SnapCompiled ) return NullPtr(FILE *);
+
+	/* Open a stream over the compiled lines */
+	fp = fmemopen((void *) entry->text, (size_t) entry->ntext, "r");
+	if ( IsNull(fp) )
+		{
+		entry->state = SnapTextFile;
+		return NullPtr(FILE *);
+		}
+
+	/* Remember which configuration file the stream belongs to */
+	if ( NumSnapFiles >= MaxSnapFiles )
+		{
+		MaxSnapFiles += 8;
+		SnapFiles   = GETMEM(SnapFiles,   FILE *, MaxSnapFiles);
+		SnapFileEnt = GETMEM(SnapFileEnt, int,    MaxSnapFiles);
+		}
+	SnapFiles[NumSnapFiles]   = fp;
+	SnapFileEnt[NumSnapFiles] = nn;
+	NumSnapFiles++;
+	return fp;
+
+#	else
+	return NullPtr(FILE *);
+#	endif /* CONFIG_SNAPSHOT */
+	}
+
+/**********************************************************************/
+
+static	void		snapshot_file_close
+
+	(
+	FILE		*fp			/* configuration file pointer */
+	)
+
+	{
+#	ifdef CONFIG_SNAPSHOT
+	int			nn;
+
+	for ( nn=0; nn<NumSnapFiles; nn++ )
+		{
+		if ( SnapFiles[nn] != fp ) continue;
+		NumSnapFiles--;
+		SnapFiles[nn]   = SnapFiles[NumSnapFiles];
+		SnapFileEnt[nn] = SnapFileEnt[NumSnapFiles];
+		return;
+		}
+#	endif /* CONFIG_SNAPSHOT */
+	}
+
+/**********************************************************************/
+
+static	LOGICAL		snapshot_block_skip
+
+	(
+	FILE		*fp			/* configuration file pointer */
+	)
+
+	{
+#	ifdef CONFIG_SNAPSHOT
+	int			nn;
+	SNAP_SKIP	key, *skip;
+	SNAP_ENTRY	*entry;
+
+	/* Only streams over compiled lines have a block skip table */
+	for ( nn=0; nn<NumSnapFiles; nn++ )
+		if ( SnapFiles[nn] == fp ) break;
+	if ( nn >= NumSnapFiles ) return FALSE;
+	entry = SnapList + SnapFileEnt[nn];
+	if ( entry->nskip <= 0 ) return FALSE;
+
+	/* Find the block that starts here and move to the end of it */
+	key.from = ftell(fp);
+	skip = (SNAP_SKIP *) bsearch((void *) &key, (void *) entry->skip,
+					(size_t) entry->nskip, sizeof(SNAP_SKIP), compare_snapshot_skip);
+	if ( IsNull(skip) ) return FALSE;
+	return (LOGICAL) ( fseek(fp, skip->to, SEEK_SET) == 0 );
+
+#	else
+	return FALSE;
+#	endif /* CONFIG_SNAPSHOT */
+	}
+
+#ifdef CONFIG_SNAPSHOT
+/***********************************************************************
+*                                                                      *
+*   s n a p s h o t _ e n a b l e d                                    *
+*   l o a d _ c o n f i g _ s n a p s h o t                            *
+*   f i n d _ s n a p s h o t _ e n t r y                              *
+*   s n a p s h o t _ e n t r y _ c u r r e n t                        *
+*                                                                      *
+*   The snapshot file is given by the FPA_CONFIG_SNAPSHOT environment  *
+*   variable or the "Config.Snapshot" advanced feature ("none" turns   *
+*   it off), relative to the home directory.  It is mapped into memory *
+*   once, and each configuration file in it is checked against the     *
+*   modification time and size of the text file when first opened.    *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL		snapshot_enabled
+
+	(
+	)
+
+	{
+	STRING		mode;
+
+	if ( SnapEnabled < 0 )
+		{
+		SnapEnabled = FALSE;
+		mode = getenv("FPA_CONFIG_SNAPSHOT");
+		if ( blank(mode) ) mode = get_feature_mode("Config.Snapshot");
+		if ( !blank(mode) && !same_ic(mode, "none") )
+			{
+			SnapPath    = strdup(pathname(home_directory(), mode));
+			SnapEnabled = TRUE;
+			(void) load_config_snapshot();
+			}
+		}
+	return (LOGICAL) SnapEnabled;
+	}
+
+/**********************************************************************/
+
+static	void		load_config_snapshot
+
+	(
+	)
+
+	{
+	int			fd, nn;
+	long		size;
+	struct stat	sbuf;
+	void		*map;
+	SNAP_HEADER	*header;
+	SNAP_RECORD	*rec;
+	SNAP_ENTRY	*entry;
+
+	/* Map the whole snapshot file */
+	fd = open(SnapPath, O_RDONLY);
+	if ( fd < 0 ) return;
+	if ( fstat(fd, &sbuf) != 0 || sbuf.st_size < (off_t) sizeof(SNAP_HEADER) )
+		{
+		(void) close(fd);
+		return;
+		}
+	size = (long) sbuf.st_size;
+	map  = mmap(NULL, (size_t) size, PROT_READ, MAP_PRIVATE, fd, 0);
+	(void) close(fd);
+	if ( map == MAP_FAILED ) return;
+	SnapMap     = (char *) map;
+	SnapMapSize = (size_t) size;
+
+	/* Ignore snapshots from another format or software revision */
+	header = (SNAP_HEADER *) SnapMap;
+	if ( memcmp(header->magic, SnapMagic, sizeof(header->magic)) != 0
+			|| header->version != SnapVersion
+			|| header->revision[sizeof(header->revision)-1] != '\0'
+			|| !same(header->revision, FpaRevision)
+			|| header->nfiles < 0
+			|| size < (long) (sizeof(SNAP_HEADER)
+							+ header->nfiles*sizeof(SNAP_RECORD)) )
+		{
+		(void) pr_warning("Environ",
+				"Ignoring old or damaged config snapshot \"%s\"\n", SnapPath);
+		(void) munmap(map, SnapMapSize);
+		SnapMap     = NullPtr(char *);
+		SnapMapSize = 0;
+		return;
+		}
+
+	/* Set up a list entry for each configuration file in the snapshot */
+	rec      = (SNAP_RECORD *) (SnapMap + sizeof(SNAP_HEADER));
+	SnapList = INITMEM(SNAP_ENTRY, header->nfiles);
+	for ( nn=0; nn<header->nfiles; nn++, rec++ )
+		{
+
+		/* Check that everything lies within the snapshot file */
+		if ( rec->name < 0 || rec->name >= size
+				|| IsNull(memchr(SnapMap + rec->name, '\0',
+								(size_t) (size - rec->name)))
+				|| rec->text < 0 || rec->ntext <= 0
+				|| rec->text > size - rec->ntext
+				|| rec->skip < 0 || rec->skip % (long) sizeof(long) != 0
+				|| rec->nskip < 0
+				|| rec->nskip > (size - rec->skip) / (long) sizeof(SNAP_SKIP) )
+			{
+			(void) pr_warning("Environ",
+					"Ignoring damaged config snapshot \"%s\"\n", SnapPath);
+			FREEMEM(SnapList);
+			NumSnap = 0;
+			return;
+			}
+
+		entry        = SnapList + NumSnap++;
+		entry->name  = SnapMap + rec->name;
+		entry->mtime = rec->mtime;
+		entry->size  = rec->size;
+		entry->text  = SnapMap + rec->text;
+		entry->ntext = rec->ntext;
+		entry->skip  = (SNAP_SKIP *) (SnapMap + rec->skip);
+		entry->nskip = rec->nskip;
+		entry->owned = FALSE;
+		entry->state = SnapUnknown;
+		}
+
+	(void) pr_status("Environ",
+			"Using config snapshot \"%s\" (%d files)\n", SnapPath, NumSnap);
+	}
+
+/**********************************************************************/
+
+static	int			find_snapshot_entry
+
+	(
+	STRING		cfgname		/* configuration file name */
+	)
+
+	{
+	int			nn;
+
+	for ( nn=0; nn<NumSnap; nn++ )
+		if ( same(cfgname, SnapList[nn].name) ) return nn;
+	return -1;
+	}
+
+/**********************************************************************/
+
+static	LOGICAL		snapshot_entry_current
+
+	(
+	SNAP_ENTRY	*entry		/* configuration file in snapshot */
+	)
+
+	{
+	struct stat	sbuf;
+
+	if ( IsNull(entry->text) )                    return FALSE;
+	if ( stat(entry->name, &sbuf) != 0 )          return FALSE;
+	if ( (long) sbuf.st_mtime != entry->mtime )   return FALSE;
+	if ( (long) sbuf.st_size  != entry->size )    return FALSE;
+	return TRUE;
+	}
+
+/***********************************************************************
+*                                                                      *
+*   c o m p i l e _ c o n f i g _ f i l e                              *
+*                                                                      *
+*   Compile a configuration file into the lines that                   *
+*   read_config_file_line() would see, before language tokens are      *
+*   stripped and "include" lines are followed, and find the end of     *
+*   each block that can be skipped without reading it.  Blocks that    *
+*   hold "include" lines or language tokens are always read, since     *
+*   what they contain depends on other files or on the language.       *
+*   Files with lines that would be read differently from the compiled  *
+*   lines (over long or unfinished continuation lines) are not         *
+*   compiled, and are always read as text.                             *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL		compile_config_file
+
+	(
+	SNAP_ENTRY	*entry		/* configuration file in snapshot */
+	)
+
+	{
+	FILE		*fp;
+	struct stat	sbuf;
+	SCLine		line, word;
+	STRING		buffer, arg;
+	int			size, rem, nopen, mopen, nn;
+	long		ntext, mtext, nskip, mskip;
+	char		*text;
+	LOGICAL		ok, poison, *keep;
+	long		*from;
+	SNAP_SKIP	*skip;
+
+	if ( IsNull( fp = fopen(entry->name, "r") ) ) return FALSE;
+	if ( fstat(fileno(fp), &sbuf) != 0 )
+		{
+		(void) fclose(fp);
+		return FALSE;
+		}
+
+	text  = NullPtr(char *);
+	ntext = mtext = 0;
+	skip  = NullPtr(SNAP_SKIP *);
+	nskip = mskip = 0;
+	from  = NullPtr(long *);
+	keep  = NullPtr(LOGICAL *);
+	nopen = mopen = 0;
+
+	/* Read the file exactly as read_config_file_line() does */
+	ok     = TRUE;
+	size   = 0;
+	buffer = line;
+	rem    = Nccl;
+	while ( getvalidline(fp, buffer, rem, Comment)
+				&& (size = strlen(line)) > 0 )
+		{
+
+		/* Join continuation lines */
+		if ( line[size-1] == '\\' )
+			{
+			line[size-1] = ' ';
+			buffer = line + size;
+			rem    = Nccl - size;
+			if ( rem > 0 ) continue;
+			ok = FALSE;
+			break;
+			}
+
+		/* A line made of just a continuation would lose its leading blank */
+		if ( line[0] == ' ' )
+			{
+			ok = FALSE;
+			break;
+			}
+
+		/* Add the line to the compiled lines */
+		if ( ntext + size + 1 > mtext )
+			{
+			mtext = MAX(2*mtext, ntext + size + 4096);
+			text  = GETMEM(text, char, mtext);
+			}
+		(void) memcpy(text + ntext, line, (size_t) size);
+		ntext += size;
+		text[ntext++] = '\n';
+
+		/* Blocks holding "include" lines or language tokens cannot be */
+		/*  skipped ... and note that this includes the current block  */
+		poison = (LOGICAL) ( NotNull(strstr(line, "<*"))
+							|| same_start_ic(line, FpaCincludeFile) );
+		if ( poison )
+			{
+			for ( nn=0; nn<nopen; nn++ ) keep[nn] = FALSE;
+			}
+
+		/* Match the open and close brackets */
+		(void) strcpy(word, line);
+		arg = string_arg(word);
+		if ( same(arg, FpaCopenBrace) )
+			{
+			if ( nopen >= mopen )
+				{
+				mopen += 16;
+				from   = GETMEM(from, long,    mopen);
+				keep   = GETMEM(keep, LOGICAL, mopen);
+				}
+			from[nopen] = ntext;
+			keep[nopen] = (LOGICAL) !poison;
+			nopen++;
+			}
+		else if ( same(arg, FpaCcloseBrace) && nopen > 0 )
+			{
+			nopen--;
+			if ( keep[nopen] )
+				{
+				if ( nskip >= mskip )
+					{
+					mskip += 64;
+					skip   = GETMEM(skip, SNAP_SKIP, mskip);
+					}
+				skip[nskip].from = from[nopen];
+				skip[nskip].to   = ntext;
+				nskip++;
+				}
+			}
+
+		/* Reset the line reading buffer to read the next line */
+		size   = 0;
+		buffer = line;
+		rem    = Nccl;
+		}
+
+	/* An unfinished continuation at the end is returned on its own */
+	if ( size > 0 )  ok = FALSE;
+	if ( ntext <= 0 ) ok = FALSE;
+	(void) fclose(fp);
+	FREEMEM(from);
+	FREEMEM(keep);
+	if ( !ok )
+		{
+		FREEMEM(text);
+		FREEMEM(skip);
+		return FALSE;
+		}
+
+	/* Blocks are found in order of their ends, so sort on their starts */
+	if ( nskip > 1 )
+		qsort((void *) skip, (size_t) nskip, sizeof(SNAP_SKIP),
+				compare_snapshot_skip);
+
+	/* Replace any compiled lines taken from an older snapshot */
+	if ( entry->owned && entry->text != NullPtr(char *) )
+		{
+		FREEMEM(entry->text);
+		FREEMEM(entry->skip);
+		}
+	else if ( !entry->owned )
+		{
+		entry->name = strdup(entry->name);
+		}
+	entry->mtime = (long) sbuf.st_mtime;
+	entry->size  = (long) sbuf.st_size;
+	entry->text  = text;
+	entry->ntext = ntext;
+	entry->skip  = skip;
+	entry->nskip = nskip;
+	entry->owned = TRUE;
+	return TRUE;
+	}
+
+/**********************************************************************/
+
+static	int			compare_snapshot_skip
+
+	(
+	const void	*skip1,
+	const void	*skip2
+	)
+
+	{
+	long		from1, from2;
+
+	from1 = ((const SNAP_SKIP *) skip1)->from;
+	from2 = ((const SNAP_SKIP *) skip2)->from;
+	return ( from1 < from2 )? -1: ( from1 > from2 )? 1: 0;
+	}
+#endif /* CONFIG_SNAPSHOT */
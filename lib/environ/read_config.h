@@ -72,6 +72,7 @@ STRING	read_config_file_line(FILE **fpcfg);
 LOGICAL	skip_config_file_block(FILE **fpcfg);
 LOGICAL	skip_to_end_of_block(FILE **fpcfg);
 LOGICAL	config_file_location(FILE *fpcfg, STRING *cfgname, long int *position);
+LOGICAL	save_config_snapshot(void);
 
 
 /* Now it has been included */
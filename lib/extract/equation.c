@@ -111,11 +111,29 @@ typedef struct
 static	int				NumLookup = 0;
 static	LOOKUP_TABLE	*Lookups  = NullPtr(LOOKUP_TABLE *);
 
+/* Structure for holding an equation compiled into steps */
+typedef struct
+	{
+	int				nstep;
+	int				mstep;
+	FpaEQTN_STEP	*steps;
+	} EQTN_PROGRAM;
+
 /* Interface functions                  */
 /*  ... these are defined in equation.h */
 
 /* Internal static functions (Evaluating Equation Strings) */
 static FpaEQTN_DATA	*evaluate_equation(STRING);
+static LOGICAL		compile_equation(STRING, EQTN_PROGRAM *, int *);
+static int			compile_operand(STRING, STRING, EQTN_PROGRAM *);
+static int			compile_operator(EQTN_PROGRAM *, int, char *, int);
+static int			add_equation_step(EQTN_PROGRAM *, char, int, int,
+													FpaEQTN_DATA *, LOGICAL);
+static void			drop_equation_steps(EQTN_PROGRAM *, int);
+static short		equation_step_type(char, short, short);
+static FpaEQTN_DATA	*run_equation_steps(EQTN_PROGRAM *, int);
+static LOGICAL		chain_equation_steps(EQTN_PROGRAM *, int, short,
+													EQTN_PROGRAM *);
 static FpaEQTN_DATA	*evaluate_name(STRING);
 static FpaEQTN_DATA	*evaluate_operator(FpaEQTN_DATA *, char *, FpaEQTN_DATA *);
 static FpaEQTN_DATA	*evaluate_bracket(FpaEQTN_DATA *, FpaEQTN_DATA *);
@@ -173,6 +191,13 @@ static LOGICAL		valid_units_and_equation(STRING, STRING);
 static void			save_equation_defaults(FpaEQUATION_DEFAULTS *);
 static void			restore_equation_defaults(FpaEQUATION_DEFAULTS *);
 
+/* Internal static functions (Sub-expression Cache) */
+static void			push_subexpression_cache(STRING);
+static void			pop_subexpression_cache(void);
+static FpaEQTN_DATA	*find_subexpression(STRING);
+static LOGICAL		save_subexpression(STRING, FpaEQTN_DATA *);
+static LOGICAL		same_subexpression_defaults(FpaEQUATION_DEFAULTS *);
+
 /* Internal static functions (Endless Loop in Equations) */
 static void			reset_endless_loop(void);
 static void			push_endless_loop(STRING);
@@ -1761,7 +1786,9 @@ FIELD				calculate_equation
 
 	/* Evaluate the equation string                       */
 	/*  ... and convert evaluated Object to SPLINE Object */
+	(void) push_subexpression_cache(inebuf);
 	pfield  = evaluate_equation(inebuf);
+	(void) pop_subexpression_cache();
 	pspline = convert_eqtn_data(FpaEQT_Spline, pfield);
 
 	/* Error message if problem evaluating equation string */
@@ -2734,7 +2761,9 @@ VLIST				*retrieve_vlist_by_equation
 
 	/* Evaluate the equation string                      */
 	/*  ... and convert evaluated Object to VLIST Object */
+	(void) push_subexpression_cache(inebuf);
 	pfield = evaluate_equation(inebuf);
+	(void) pop_subexpression_cache();
 	pvlist = convert_eqtn_data(FpaEQT_Vlist, pfield);
 
 	/* Error message if problem evaluating equation string */
@@ -4311,6 +4340,10 @@ int					checked_valid_time_list_free
  *** return pointer to structure determined by parsing an equation  ***
  ***  into structures to evaluate, two structures and an operator,  ***
  ***  or a function applied to zero or more arguments               ***
+ *** Note that the equation is first compiled into a list of steps  ***
+ ***  (evaluating all fields, constants and functions), and then    ***
+ ***  the arithmetic operators are applied in as few passes over    ***
+ ***  the data as possible                                          ***
  ***                                                                ***
  **********************************************************************/
 
@@ -4320,56 +4353,88 @@ static	FpaEQTN_DATA	*evaluate_equation
 	STRING			buf			/* string containing equation */
 	)
 
+	{
+	int				root;
+	EQTN_PROGRAM	prog;
+	FpaEQTN_DATA	*pfield;
+
+	/* Return Null pointer if no string to evaluate */
+	if ( blank(buf) ) return NullPtr(FpaEQTN_DATA *);
+
+	/* Compile the equation into steps ... and evaluate them */
+	prog.nstep = 0;
+	prog.mstep = 0;
+	prog.steps = NullPtr(FpaEQTN_STEP *);
+	if ( compile_equation(buf, &prog, &root) )
+		pfield = run_equation_steps(&prog, root);
+	else
+		pfield = NullPtr(FpaEQTN_DATA *);
+
+	/* Free space used by the steps (and any unused structures) */
+	(void) drop_equation_steps(&prog, 0);
+	FREEMEM(prog.steps);
+
+	/* Return pointer to evaluated structure */
+	return pfield;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** c o m p i l e _ e q u a t i o n                                ***
+ ***                                                                ***
+ *** add steps for an equation string to a list of steps, and set   ***
+ ***  the step that returns the result (or -1 if nothing to do)     ***
+ *** Note that fields, constants and functions are evaluated as     ***
+ ***  the steps are added, and arithmetic operators are added as    ***
+ ***  steps to apply later                                          ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	LOGICAL			compile_equation
+
+	(
+	STRING			buf,		/* string containing equation */
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	int				*root		/* step that returns result */
+	)
+
 	{
 	char			xbuf[MAX_BCHRS];
 	char			*pfop, *pnop;
 	char			lbuf[MAX_BCHRS], rbuf[MAX_BCHRS];
-	FpaEQTN_DATA	*plfld, *prfld, *pfield;
+	int				lstep, rstep, pstep;
 
-	/* Return Null pointer if no string to evaluate */
-	if ( blank(buf) ) return NullPtr(FpaEQTN_DATA *);
+	/* Nothing to do if no string to evaluate */
+	*root = -1;
+	if ( blank(buf) ) return TRUE;
 
 	/* Expand equation by generic substitution of fields (if required) */
-	if ( !generic_expansion(buf, xbuf) ) return NullPtr(FpaEQTN_DATA *);
-
-	/* Initialize pointers to structures */
-	plfld = NullPtr(FpaEQTN_DATA *);
-	prfld = NullPtr(FpaEQTN_DATA *);
+	if ( !generic_expansion(buf, xbuf) ) return FALSE;
 
 	/* Identify location of first operator */
 	pfop = get_fop(xbuf, lbuf);
 
 	/* Evaluate left side of equation ... except for function */
 	/*  operators, where left side is function name           */
+	lstep = -1;
 	if (*pfop != '[')
 		{
 		if ( DebugMode )
 			{
 			dprintf(stdout, "  Evaluation of:  >%s<\n", SafeStr(lbuf));
 			}
-		plfld = evaluate_name(lbuf);
+		lstep = compile_operand(lbuf, NullString, prog);
 
-		/* Return Null pointer if error in name evaluation */
-		if ( !blank(lbuf) && IsNull(plfld) ) return NullPtr(FpaEQTN_DATA *);
-		if ( DebugMode )
-			{
-			if ( NotNull(plfld) )
-				{
-				dprintf(stdout, "    Result Object type: %d", plfld->Type);
-				dprintf(stdout, "   from:  >%s<\n", SafeStr(lbuf));
-				dprintf(stdout, "         at: <%lx>\n", (unsigned long) plfld);
-				}
-			else
-				{
-				dprintf(stdout, "    Result Object type: 0");
-				dprintf(stdout, "   from:  >%s<\n", SafeStr(lbuf));
-				dprintf(stdout, "         at: <%lx>\n", (unsigned long) plfld);
-				}
-			}
+		/* Return FALSE if error in name evaluation */
+		if ( !blank(lbuf) && lstep < 0 ) return FALSE;
 		}
 
 	/* Return now if no operator was found */
-	if (*pfop == '\0') return plfld;
+	if (*pfop == '\0')
+		{
+		*root = lstep;
+		return TRUE;
+		}
 
 	/* If operators found, continue until no more found */
 	do
@@ -4377,60 +4442,445 @@ static	FpaEQTN_DATA	*evaluate_equation
 		/* Identify location of next operator */
 		pnop = get_nop(pfop, xbuf, rbuf);
 
-		/* Calculation for all operators except function operators */
+		/* Add steps for all operators except function operators */
 		if (*pfop != '[')
 			{
-			prfld = evaluate_equation(rbuf);
+			if ( !compile_equation(rbuf, prog, &rstep) ) return FALSE;
 			if ( DebugMode )
 				{
-				dprintf(stdout, "  Calculation:  <%lx>  %c", (unsigned long) plfld, *pfop);
-				dprintf(stdout, "  <%lx>\n", (unsigned long) prfld);
+				dprintf(stdout, "  Calculation:  step %d  %c  step %d\n",
+						lstep, *pfop, rstep);
 				}
-			pfield = evaluate_operator(plfld, pfop, prfld);
+			pstep = compile_operator(prog, lstep, pfop, rstep);
 
-			/* Free space used by work structures */
-			(void) free_eqtn_data(plfld);
-			(void) free_eqtn_data(prfld);
-
-			/* Return Null pointer if error in operator calculation */
-			if ( IsNull(pfield) ) return NullPtr(FpaEQTN_DATA *);
-			if ( DebugMode )
-				{
-				dprintf(stdout, "    Result Object type: %d",
-						pfield->Type);
-				dprintf(stdout, "   from:  >%s<  %c  >%s<\n",
-						SafeStr(lbuf), *pfop, SafeStr(rbuf));
-				dprintf(stdout, "         at: <%lx>\n", (unsigned long) pfield);
-				}
+			/* Return FALSE if error in operator calculation */
+			if ( pstep < 0 ) return FALSE;
 			}
 
-		/* Calculation for function operators */
+		/* Evaluate function operators (replacing anything to the left) */
 		else
 			{
-			pfield = evaluate_function(lbuf, rbuf);
+			if ( lstep >= 0 )
+				(void) drop_equation_steps(prog, prog->steps[lstep].first);
+			pstep = compile_operand(lbuf, rbuf, prog);
 
-			/* Return Null pointer if error in function calculation */
-			if ( IsNull(pfield) )
-				{
-				(void) free_eqtn_data(plfld);
-				return NullPtr(FpaEQTN_DATA *);
-				}
-			if ( DebugMode )
-				{
-				dprintf(stdout, "    Result Object type: %d", pfield->Type);
-				dprintf(stdout, "   from:  >%s<  of  >%s<\n",
-						SafeStr(lbuf), SafeStr(rbuf));
-				dprintf(stdout, "         at: <%lx>\n", (unsigned long) pfield);
-				}
+			/* Return FALSE if error in function calculation */
+			if ( pstep < 0 ) return FALSE;
 			}
 
 		/* Go on to next operator ... until no more found */
-		pfop = pnop;
-		plfld = pfield;
+		pfop  = pnop;
+		lstep = pstep;
 		} while (*pfop != '\0');
 
-	/* Return pointer to evaluated structure */
-	return pfield;
+	/* Set step that returns the result */
+	*root = pstep;
+	return TRUE;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** c o m p i l e _ o p e r a n d                                  ***
+ ***                                                                ***
+ *** add a step for a constant or field name, or for a function     ***
+ ***  applied to its arguments, and return the step (or -1)         ***
+ *** Note that the evaluated structure is taken from (or saved in)  ***
+ ***  the sub-expression cache where possible                       ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	int				compile_operand
+
+	(
+	STRING			lbuf,		/* string containing constant or field name */
+								/*  (or function name)                      */
+	STRING			rbuf,		/* string containing function arguments */
+								/*  (or Null if not a function)         */
+	EQTN_PROGRAM	*prog		/* list of steps */
+	)
+
+	{
+	char			kbuf[MAX_BCHRS];
+	LOGICAL			shared;
+	FpaEQTN_DATA	*pfld;
+
+	/* Return immediately if nothing to evaluate */
+	if ( blank(lbuf) && IsNull(rbuf) ) return -1;
+
+	/* Set the sub-expression string (if it fits) */
+	kbuf[0] = '\0';
+	if ( IsNull(rbuf) )
+		(void) safe_strcpy(kbuf, lbuf);
+	else if ( strlen(lbuf) + strlen(rbuf) + 3 <= MAX_BCHRS )
+		{
+		(void) strcpy(kbuf, lbuf);
+		(void) strcat(kbuf, "[");
+		(void) strcat(kbuf, rbuf);
+		(void) strcat(kbuf, "]");
+		}
+
+	/* Use a sub-expression that has already been evaluated */
+	pfld   = (blank(kbuf))? NullPtr(FpaEQTN_DATA *): find_subexpression(kbuf);
+	shared = NotNull(pfld);
+
+	/* Otherwise evaluate the constant, field name or function */
+	if ( !shared )
+		{
+		if ( IsNull(rbuf) ) pfld = evaluate_name(lbuf);
+		else                pfld = evaluate_function(lbuf, rbuf);
+		if ( IsNull(pfld) ) return -1;
+		if ( !blank(kbuf) ) shared = save_subexpression(kbuf, pfld);
+		}
+
+	if ( DebugMode )
+		{
+		dprintf(stdout, "    Result Object type: %d", pfld->Type);
+		dprintf(stdout, "   from:  >%s<", SafeStr(lbuf));
+		if ( NotNull(rbuf) ) dprintf(stdout, "  of  >%s<", rbuf);
+		dprintf(stdout, "\n         at: <%lx>", (unsigned long) pfld);
+		dprintf(stdout, "%s\n", (shared)? "  (shared)": "");
+		}
+
+	/* Add a step for the evaluated structure */
+	return add_equation_step(prog, '\0', -1, -1, pfld, shared);
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** c o m p i l e _ o p e r a t o r                                ***
+ ***                                                                ***
+ *** add a step for an operator applied to two steps, and return    ***
+ ***  the step (or -1 for errors)                                   ***
+ *** Note that arithmetic operators (+ - * /) are added as steps to ***
+ ***  apply later, while powers (and anything unusual) are applied  ***
+ ***  at once and added as a step for the resulting structure       ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	int				compile_operator
+
+	(
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	int				lstep,		/* step to left of operator (or -1) */
+	char			*pop,		/* pointer to operator */
+	int				rstep		/* step to right of operator (or -1) */
+	)
+
+	{
+	int				first;
+	FpaEQTN_STEP	*plstep;
+	FpaEQTN_DATA	*plfld, *prfld, *pfield;
+
+	/* Add steps for arithmetic operators */
+	if (*pop == '+' || *pop == '-' || *pop == '*' || *pop == '/')
+		{
+		if ( lstep < 0 || rstep < 0 ) return -1;
+		return add_equation_step(prog, *pop, lstep, rstep,
+				NullPtr(FpaEQTN_DATA *), FALSE);
+		}
+
+	/* Use steps within brackets if no unary + or - ... */
+	/*  or multiply them by the unary + or -            */
+	if ( *pop == '(' && rstep >= 0 )
+		{
+		if ( lstep < 0 ) return rstep;
+		plstep = &prog->steps[lstep];
+		if ( plstep->op == '\0' && plstep->data->Type == FpaEQT_Scalar
+				&& ( plstep->data->Data.scalr.sval == 1.0
+					|| plstep->data->Data.scalr.sval == -1.0 ) )
+			return add_equation_step(prog, '*', lstep, rstep,
+					NullPtr(FpaEQTN_DATA *), FALSE);
+		}
+
+	/* Otherwise evaluate the steps on both sides of the operator */
+	/*  and replace them with the evaluated structure             */
+	if ( lstep >= 0 )      first = prog->steps[lstep].first;
+	else if ( rstep >= 0 ) first = prog->steps[rstep].first;
+	else                   first = prog->nstep;
+	plfld = run_equation_steps(prog, lstep);
+	prfld = run_equation_steps(prog, rstep);
+	(void) drop_equation_steps(prog, first);
+
+	/* Note that the work structures are consumed */
+	pfield = evaluate_operator(plfld, pop, prfld);
+	if ( IsNull(pfield) ) return -1;
+	return add_equation_step(prog, '\0', -1, -1, pfield, FALSE);
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** a d d _ e q u a t i o n _ s t e p                              ***
+ *** d r o p _ e q u a t i o n _ s t e p s                          ***
+ ***                                                                ***
+ *** add a step (an operator or a structure) to a list of steps,    ***
+ ***  or drop steps from the end of the list                        ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	int				add_equation_step
+
+	(
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	char			op,			/* operator (or '\0' for a structure) */
+	int				lstep,		/* step to left of operator */
+	int				rstep,		/* step to right of operator */
+	FpaEQTN_DATA	*pfld,		/* structure (if not an operator) */
+	LOGICAL			shared		/* structure is in sub-expression cache? */
+	)
+
+	{
+	FpaEQTN_STEP	*pstep;
+
+	/* Allocate space for another step (if required) */
+	if ( prog->nstep >= prog->mstep )
+		{
+		prog->mstep += 16;
+		prog->steps  = GETMEM(prog->steps, FpaEQTN_STEP, prog->mstep);
+		}
+
+	/* Set the step ... which includes the steps to the left and  */
+	/*  right of an operator (if these are in the same list)      */
+	pstep = &prog->steps[prog->nstep];
+	pstep->op     = op;
+	pstep->first  = prog->nstep;
+	pstep->left   = lstep;
+	pstep->right  = rstep;
+	pstep->data   = pfld;
+	pstep->shared = shared;
+	if ( op == '\0' )
+		pstep->type = pfld->Type;
+	else if ( lstep >= 0 && rstep >= 0 )
+		{
+		pstep->type  = equation_step_type(op, prog->steps[lstep].type,
+												prog->steps[rstep].type);
+		pstep->first = prog->steps[lstep].first;
+		}
+	else
+		pstep->type = 0;
+
+	/* Return the step */
+	return prog->nstep++;
+	}
+
+static	void			drop_equation_steps
+
+	(
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	int				first		/* first step to drop */
+	)
+
+	{
+	int				ii;
+	FpaEQTN_STEP	*pstep;
+
+	/* Free structures that were not used (or shared) */
+	for ( ii=first; ii<prog->nstep; ii++ )
+		{
+		pstep = &prog->steps[ii];
+		if ( pstep->op == '\0' && !pstep->shared )
+			(void) free_eqtn_data(pstep->data);
+		}
+
+	/* Reset the number of steps */
+	if ( first < prog->nstep ) prog->nstep = first;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** e q u a t i o n _ s t e p _ t y p e                            ***
+ ***                                                                ***
+ *** return type of structure that an arithmetic operator returns   ***
+ ***  for the given types of structure (or 0 if these structures    ***
+ ***  cannot be combined)                                           ***
+ *** Note that this follows oper_plus(), oper_minus(), oper_mult()  ***
+ ***  and oper_divn(), where SPLINE Objects are combined with       ***
+ ***  SCALAR Objects (or added to SPLINE Objects) directly, but are ***
+ ***  converted to GRID Objects otherwise                           ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	short			equation_step_type
+
+	(
+	char			op,			/* operator (one of + - * /) */
+	short			ltype,		/* type of structure to left of operator */
+	short			rtype		/* type of structure to right of operator */
+	)
+
+	{
+	LOGICAL			lsurf, rsurf;
+
+	/* SCALAR Objects */
+	if ( ltype == FpaEQT_Scalar && rtype == FpaEQT_Scalar )
+		return FpaEQT_Scalar;
+
+	/* VLIST Objects combine only with VLIST or SCALAR Objects */
+	if ( ltype == FpaEQT_Vlist || rtype == FpaEQT_Vlist )
+		{
+		if ( (ltype == FpaEQT_Vlist || ltype == FpaEQT_Scalar)
+				&& (rtype == FpaEQT_Vlist || rtype == FpaEQT_Scalar) )
+			return FpaEQT_Vlist;
+		return 0;
+		}
+
+	/* SPLINE Objects with SCALAR Objects ... except as divisor */
+	if ( ltype == FpaEQT_Spline && rtype == FpaEQT_Scalar )
+		return FpaEQT_Spline;
+	if ( ltype == FpaEQT_Scalar && rtype == FpaEQT_Spline && op != '/' )
+		return FpaEQT_Spline;
+
+	/* SPLINE Objects are added to or subtracted from each other */
+	/* Note that oper_plus() and oper_minus() return GRID Objects */
+	/*  if the spline dimensions do not agree                     */
+	if ( ltype == FpaEQT_Spline && rtype == FpaEQT_Spline
+			&& (op == '+' || op == '-') )
+		return FpaEQT_Spline;
+
+	/* Everything else is done with GRID Objects */
+	lsurf = (LOGICAL) (ltype == FpaEQT_Grid || ltype == FpaEQT_Spline);
+	rsurf = (LOGICAL) (rtype == FpaEQT_Grid || rtype == FpaEQT_Spline);
+	if ( (lsurf || ltype == FpaEQT_Scalar) && (rsurf || rtype == FpaEQT_Scalar) )
+		return FpaEQT_Grid;
+	return 0;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** r u n _ e q u a t i o n _ s t e p s                            ***
+ ***                                                                ***
+ *** return pointer to structure calculated from a step (and all    ***
+ ***  the steps it depends on)                                      ***
+ *** Note that all the arithmetic operators that return the same    ***
+ ***  type of structure are gathered into one chain, and applied    ***
+ ***  together (one row at a time) by oper_chain()                  ***
+ *** Note that the structures in the steps are consumed (unless     ***
+ ***  they are held in the sub-expression cache)                    ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	FpaEQTN_DATA	*run_equation_steps
+
+	(
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	int				root		/* step to evaluate (or -1) */
+	)
+
+	{
+	FpaEQTN_STEP	*pstep;
+	FpaEQTN_DATA	*pfield, *plfld, *prfld;
+	EQTN_PROGRAM	chain;
+
+	/* Return Null pointer if nothing to evaluate */
+	if ( root < 0 ) return NullPtr(FpaEQTN_DATA *);
+
+	/* Return the structure for a constant, field name or function */
+	/*  ... or a copy if it is held in the sub-expression cache    */
+	pstep = &prog->steps[root];
+	if ( pstep->op == '\0' )
+		{
+		if ( pstep->shared ) return copy_eqtn_data(pstep->data);
+		pfield = pstep->data;
+		pstep->data = NullPtr(FpaEQTN_DATA *);
+		return pfield;
+		}
+
+	/* Apply a chain of operators that return the same type of */
+	/*  structure in a single pass                              */
+	if ( pstep->type != 0 )
+		{
+		chain.nstep = 0;
+		chain.mstep = 0;
+		chain.steps = NullPtr(FpaEQTN_STEP *);
+		if ( chain_equation_steps(prog, root, pstep->type, &chain) )
+			{
+			pfield = oper_chain(chain.nstep, chain.steps);
+			}
+		else
+			{
+			(void) drop_equation_steps(&chain, 0);
+			pfield = NullPtr(FpaEQTN_DATA *);
+			}
+		FREEMEM(chain.steps);
+		return pfield;
+		}
+
+	/* Otherwise apply the operator to the evaluated structures */
+	/*  on each side (to report the errors)                     */
+	/* Note that the work structures are consumed (either freed */
+	/*  or reused for the result)                               */
+	plfld = run_equation_steps(prog, pstep->left);
+	prfld = run_equation_steps(prog, pstep->right);
+	return oper_inplace(pstep->op, plfld, prfld);
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** c h a i n _ e q u a t i o n _ s t e p s                        ***
+ ***                                                                ***
+ *** add the operators that return the given type of structure      ***
+ ***  (in postfix order) to a chain of steps ... evaluating any     ***
+ ***  other steps as structures for the chain                       ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	LOGICAL			chain_equation_steps
+
+	(
+	EQTN_PROGRAM	*prog,		/* list of steps */
+	int				root,		/* step to add to chain */
+	short			type,		/* type of structure returned by chain */
+	EQTN_PROGRAM	*chain		/* chain of steps */
+	)
+
+	{
+	LOGICAL			shared;
+	FpaEQTN_STEP	*pstep;
+	FpaEQTN_DATA	*pfld, *ptemp;
+
+	/* Add operators that return the same type of structure (or */
+	/*  SCALAR Objects) ... after the steps on each side         */
+	pstep = &prog->steps[root];
+	if ( pstep->op != '\0'
+			&& (pstep->type == type || pstep->type == FpaEQT_Scalar) )
+		{
+		if ( !chain_equation_steps(prog, pstep->left,  type, chain) )
+			return FALSE;
+		if ( !chain_equation_steps(prog, pstep->right, type, chain) )
+			return FALSE;
+		(void) add_equation_step(chain, pstep->op, -1, -1,
+				NullPtr(FpaEQTN_DATA *), FALSE);
+		return TRUE;
+		}
+
+	/* Take the structure for a constant, field name or function */
+	/*  ... or evaluate any other operator                       */
+	if ( pstep->op == '\0' )
+		{
+		pfld   = pstep->data;
+		shared = pstep->shared;
+		if ( !shared ) pstep->data = NullPtr(FpaEQTN_DATA *);
+		}
+	else
+		{
+		pfld   = run_equation_steps(prog, root);
+		shared = FALSE;
+		}
+	if ( IsNull(pfld) ) return FALSE;
+
+	/* Convert SPLINE Objects to GRID Objects at the default grid */
+	/*  dimensions, as the operator functions do                  */
+	if ( type == FpaEQT_Grid && pfld->Type == FpaEQT_Spline )
+		{
+		ptemp = convert_eqtn_data(FpaEQT_Grid, pfld);
+		if ( !shared ) (void) free_eqtn_data(pfld);
+		if ( IsNull(ptemp) ) return FALSE;
+		pfld   = ptemp;
+		shared = FALSE;
+		}
+
+	/* Add the structure to the chain */
+	(void) add_equation_step(chain, '\0', -1, -1, pfld, shared);
+	return TRUE;
 	}
 
 /**********************************************************************
@@ -4494,13 +4944,11 @@ static	FpaEQTN_DATA	*evaluate_name
 		return pfld;
 		}
 
-	/* Otherwise, multiply unary value and evaluated structure, */
-	/*  free space used by work structures, and return pointer  */
+	/* Otherwise, multiply unary value and evaluated structure */
+	/*  (reusing the work structures), and return pointer      */
 	else
 		{
-		pfldmn = oper_mult(plmn, pfld);
-		(void) free_eqtn_data(plmn);
-		(void) free_eqtn_data(pfld);
+		pfldmn = oper_inplace('*', plmn, pfld);
 		return pfldmn;
 		}
 	}
@@ -4511,6 +4959,8 @@ static	FpaEQTN_DATA	*evaluate_name
  ***                                                                ***
  *** return pointer to structure calculated from two structures     ***
  ***  and an operator                                               ***
+ *** Note that both structures are consumed ... the arithmetic      ***
+ ***  operators overwrite one of them with the result               ***
  ***                                                                ***
  **********************************************************************/
 
@@ -4525,25 +4975,15 @@ static	FpaEQTN_DATA	*evaluate_operator
 	{
 	FpaEQTN_DATA	*pfield;
 
-	if (*pop == '+')
+	if (*pop == '+' || *pop == '-' || *pop == '*' || *pop == '/')
 		{
-		pfield = oper_plus(plfld, prfld);
-		}
-	else if (*pop == '-')
-		{
-		pfield = oper_minus(plfld, prfld);
-		}
-	else if (*pop == '*')
-		{
-		pfield = oper_mult(plfld, prfld);
-		}
-	else if (*pop == '/')
-		{
-		pfield = oper_divn(plfld, prfld);
+		pfield = oper_inplace(*pop, plfld, prfld);
 		}
 	else if (*pop == '^')
 		{
 		pfield = oper_power(plfld, prfld);
+		(void) free_eqtn_data(plfld);
+		(void) free_eqtn_data(prfld);
 		}
 	else if (*pop == '(')
 		{
@@ -4554,6 +4994,8 @@ static	FpaEQTN_DATA	*evaluate_operator
 	/* Error message for unrecognizable operator */
 		(void) fprintf(stderr, "[evaluate_operator]");
 		(void) fprintf(stderr, " Unrecognizable operator: %c\n", *pop);
+		(void) free_eqtn_data(plfld);
+		(void) free_eqtn_data(prfld);
 		return NullPtr(FpaEQTN_DATA *);
 		}
 
@@ -4569,6 +5011,7 @@ static	FpaEQTN_DATA	*evaluate_operator
  ***  structure is Null) or to first structure multiplied by second ***
  ***  structure (if first structure is unary + or -)                ***
  *** Note that first structure must be Null or unary + or -         ***
+ *** Note that both structures are consumed                         ***
  ***                                                                ***
  **********************************************************************/
 
@@ -4583,7 +5026,11 @@ static	FpaEQTN_DATA	*evaluate_bracket
 	FpaEQTN_DATA	*pfield;
 
 	/* Return Null if missing structure to evaluate */
-	if ( IsNull(prfld) ) return NullPtr(FpaEQTN_DATA *);
+	if ( IsNull(prfld) )
+		{
+		(void) free_eqtn_data(plfld);
+		return NullPtr(FpaEQTN_DATA *);
+		}
 
 	/* Error message for non-unary structure to left of brackets */
 	if ( plfld )
@@ -4597,17 +5044,19 @@ static	FpaEQTN_DATA	*evaluate_bracket
 			(void) fprintf(stderr, "  Object type: %d\n", plfld->Type);
 			(void) fprintf(stderr, "     at: <%lx>\n", (unsigned long) plfld);
 			(void) debug_eqtn_data(plfld);
+			(void) free_eqtn_data(plfld);
+			(void) free_eqtn_data(prfld);
 			return NullPtr(FpaEQTN_DATA *);
 			}
 		}
 
-	/* Make copy of structure within brackets if no unary + or - */
+	/* Use structure within brackets if no unary + or - */
 	if ( IsNull(plfld) )
-		pfield = copy_eqtn_data(prfld);
+		pfield = prfld;
 
 	/* Otherwise, multiply unary value and structure within brackets */
 	else
-		pfield = oper_mult(plfld, prfld);
+		pfield = oper_inplace('*', plfld, prfld);
 
 	/* Return pointer to calculated structure */
 	return pfield;
@@ -4787,13 +5236,11 @@ static	FpaEQTN_DATA	*evaluate_function
 		}
 
 	/* Otherwise, multiply unary value and evaluated */
-	/*  structure, free space used by structures,    */
+	/*  structure (reusing the work structures),     */
 	/*  and return pointer                           */
 	else
 		{
-		pfieldmn = oper_mult(plmn, pfield);
-		(void) free_eqtn_data(plmn);
-		(void) free_eqtn_data(pfield);
+		pfieldmn = oper_inplace('*', plmn, pfield);
 		return pfieldmn;
 		}
 }
@@ -8158,6 +8605,190 @@ static	void			restore_equation_defaults
 	FpaEqtnDefs.posEval    = olddef->posEval;
 	}
 
+/***********************************************************************
+*                                                                      *
+*     STATIC (LOCAL) ROUTINES (Sub-expression Cache)                   *
+*                                                                      *
+*     All the routines after this point are available only within      *
+*     this file.                                                       *
+*                                                                      *
+***********************************************************************/
+
+/**********************************************************************
+ ***                                                                ***
+ *** p u s h _ s u b e x p r e s s i o n _ c a c h e                ***
+ *** p o p _ s u b e x p r e s s i o n _ c a c h e                  ***
+ *** f i n d _ s u b e x p r e s s i o n                            ***
+ *** s a v e _ s u b e x p r e s s i o n                            ***
+ ***                                                                ***
+ *** hold fields or functions that occur more than once in an       ***
+ ***  equation, so that each is evaluated only once                 ***
+ *** Note that each embedded equation has its own scope, and that   ***
+ ***  a sub-expression is only reused with the same Equation        ***
+ ***  Defaults (source, times, levels, and so on)                   ***
+ ***                                                                ***
+ **********************************************************************/
+
+/* Storage for evaluated sub-expressions */
+typedef struct
+	{
+	int						scope;	/* scope (embedded equation) */
+	STRING					expr;	/* sub-expression string */
+	FpaEQUATION_DEFAULTS	defs;	/* Equation Defaults when evaluated */
+	FpaEQTN_DATA			*data;	/* evaluated sub-expression */
+	} SUBEXPR;
+
+/* Maximum number of sub-expressions held for each equation */
+#define MaxSubexpr 16
+
+static	int		SubexprScope = 0;
+static	STRING	*SubexprEqtn = NullStringList;
+static	int		NumSubexpr   = 0;
+static	SUBEXPR	*Subexprs    = NullPtr(SUBEXPR *);
+
+static	void			push_subexpression_cache
+
+	(
+	STRING			inebuf		/* input equation for field */
+	)
+
+	{
+
+	/* Add another scope */
+	SubexprScope++;
+
+	/* Save the equation (without blanks) for this scope */
+	SubexprEqtn = GETMEM(SubexprEqtn, STRING, SubexprScope);
+	SubexprEqtn[SubexprScope-1] = strdup(inebuf);
+	remove_blanks(SubexprEqtn[SubexprScope-1]);
+	}
+
+static	void			pop_subexpression_cache
+
+	(
+	)
+
+	{
+	SUBEXPR		*psub;
+
+	/* Return immediately if no scope */
+	if ( SubexprScope < 1 ) return;
+
+	/* Free the sub-expressions held in this scope */
+	while ( NumSubexpr > 0 && Subexprs[NumSubexpr-1].scope >= SubexprScope )
+		{
+		psub = &Subexprs[--NumSubexpr];
+		FREEMEM(psub->expr);
+		(void) free_eqtn_data(psub->data);
+		}
+
+	/* Free the equation and remove the scope */
+	FREEMEM(SubexprEqtn[SubexprScope-1]);
+	SubexprScope--;
+	}
+
+static	FpaEQTN_DATA	*find_subexpression
+
+	(
+	STRING			expr		/* sub-expression string */
+	)
+
+	{
+	int			nn;
+	SUBEXPR		*psub;
+
+	/* Search the sub-expressions held in this scope */
+	for ( nn=NumSubexpr-1; nn>=0; nn-- )
+		{
+		psub = &Subexprs[nn];
+		if ( psub->scope != SubexprScope ) break;
+		if ( same(psub->expr, expr) && same_subexpression_defaults(&psub->defs) )
+			return psub->data;
+		}
+
+	/* Not found */
+	return NullPtr(FpaEQTN_DATA *);
+	}
+
+static	LOGICAL			save_subexpression
+
+	(
+	STRING			expr,		/* sub-expression string */
+	FpaEQTN_DATA	*pfld		/* evaluated sub-expression */
+	)
+
+	{
+	int			nn, nsub;
+	STRING		pexpr;
+	SUBEXPR		*psub;
+
+	/* Nothing to save outside an equation ... or for constants */
+	if ( SubexprScope < 1 ) return FALSE;
+	if ( IsNull(pfld) || pfld->Type == FpaEQT_Scalar ) return FALSE;
+
+	/* Limit the number of sub-expressions held in this scope */
+	for ( nsub=0, nn=NumSubexpr-1; nn>=0; nn-- )
+		{
+		if ( Subexprs[nn].scope != SubexprScope ) break;
+		nsub++;
+		}
+	if ( nsub >= MaxSubexpr ) return FALSE;
+
+	/* Only save sub-expressions that occur more than once */
+	for ( nn=0, pexpr=SubexprEqtn[SubexprScope-1];
+			NotNull(pexpr = strstr(pexpr, expr)); pexpr++ ) nn++;
+	if ( nn < 2 ) return FALSE;
+
+	/* Save the sub-expression ... and the defaults used to evaluate it */
+	NumSubexpr++;
+	Subexprs = GETMEM(Subexprs, SUBEXPR, NumSubexpr);
+	psub = &Subexprs[NumSubexpr-1];
+	psub->scope        = SubexprScope;
+	psub->expr         = strdup(expr);
+	psub->defs         = FpaEqtnDefs;
+	psub->defs.posEval = NullPointList;
+	psub->data         = pfld;
+	return TRUE;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** s a m e _ s u b e x p r e s s i o n _ d e f a u l t s          ***
+ ***                                                                ***
+ *** check if global Equation Defaults match those used to evaluate ***
+ ***  a sub-expression                                              ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	LOGICAL			same_subexpression_defaults
+
+	(
+	FpaEQUATION_DEFAULTS	*defs		/* Equation Defaults to check */
+	)
+
+	{
+
+	/* Check information used in FLD_DESCRIPT structures */
+	if ( !same(defs->path,      FpaEqtnDefs.path) )      return FALSE;
+	if ( !same(defs->source,    FpaEqtnDefs.source) )    return FALSE;
+	if ( !same(defs->subsource, FpaEqtnDefs.subsource) ) return FALSE;
+	if ( !same(defs->rtime,     FpaEqtnDefs.rtime) )     return FALSE;
+	if ( !same(defs->vtime,     FpaEqtnDefs.vtime) )     return FALSE;
+	if ( !same(defs->lvl,       FpaEqtnDefs.lvl) )       return FALSE;
+	if ( !same(defs->uprlvl,    FpaEqtnDefs.uprlvl) )    return FALSE;
+	if ( !same(defs->lwrlvl,    FpaEqtnDefs.lwrlvl) )    return FALSE;
+
+	/* Check strings to use in generic equations */
+	if ( !same(defs->genfld,    FpaEqtnDefs.genfld) )    return FALSE;
+	if ( !same(defs->genmod,    FpaEqtnDefs.genmod) )    return FALSE;
+
+	/* Check information for point evaluations */
+	if ( defs->pointeval  != FpaEqtnDefs.pointeval )     return FALSE;
+	if ( defs->subgrid    != FpaEqtnDefs.subgrid )       return FALSE;
+	if ( defs->numposEval != FpaEqtnDefs.numposEval )    return FALSE;
+	return TRUE;
+	}
+
 /***********************************************************************
 *                                                                      *
 *     STATIC (LOCAL) ROUTINES (Endless Loop in Equations)              *
@@ -8592,8 +9223,6 @@ static	void	test_evaluate_operator
 		(void) fprintf(stderr, "  Result Object type: 0\n");
 		(void) fprintf(stderr, "     at: <%x>\n", pfield);
 		}
-	(void) free_eqtn_data(plfld);
-	(void) free_eqtn_data(prfld);
 	(void) free_eqtn_data(pfield);
 	}
 
@@ -115,6 +115,27 @@ typedef struct FpaEQTN_FUNC_struct
 	const	FpaENAM		Enam;	/**< pointer to non-UNIX function name */
 	} FpaEQTN_FUNC;
 
+/* Define FpaEQTN_STEP Object */
+/**
+ * One step of an equation compiled for evaluation.  Steps are kept
+ * in postfix order, so that each operator follows its operands.  An
+ * operand step holds an evaluated structure (a field, constant or
+ * function result), while an operator step applies an arithmetic
+ * operator (+ - * /) to the results of two earlier steps.
+ **/
+typedef struct FpaEQTN_STEP_struct
+	{
+	char			op;		/**< operator (+ - * /) or '\0' for operand */
+	short			type;	/**< type of data resulting from this step
+								  (0 if types cannot be combined) */
+	int				first;	/**< first step of this sub-expression */
+	int				left;	/**< step for first operand of operator */
+	int				right;	/**< step for second operand of operator */
+	FpaEQTN_DATA	*data;	/**< structure for operand */
+	LOGICAL			shared;	/**< structure for operand is held in the
+								  sub-expression cache (never freed) */
+	} FpaEQTN_STEP;
+
 
 #if defined(EQUATION_MAIN) || defined(EQUATION_OPER) || defined(EQUATION_DATA)
 
@@ -185,6 +206,11 @@ typedef struct FpaEQTN_FLDS_struct
 	FLD_DESCRIPT	descript;	/**< field descriptor for field search */
 	MAP_PROJ		mproj;		/**< map projection for saved field */
 	FIELD			fld;		/**< saved field of data */
+	unsigned long	hash;		/**< hash of field descriptor */
+	int				next;		/**< next field in hash chain (or free list) */
+	long			size;		/**< approximate memory used by field */
+	long			used;		/**< access stamp for least recently used */
+	LOGICAL			keep;		/**< supplied field (never discarded) */
 } FpaEQTN_FLDS;
 
 
@@ -241,6 +267,8 @@ FIELD			field_from_equation_database(FLD_DESCRIPT *fdesc);
 void			replace_field_in_equation_database(FLD_DESCRIPT *fdesc,
 						MAP_PROJ *mproj, FIELD fld);
 void			delete_field_in_equation_database(FLD_DESCRIPT *fdesc);
+void			equation_database_statistics(void);
+int				equation_database_descriptors(FLD_DESCRIPT **fdescs);
 FpaEQTN_DATA	*init_eqtn_data(short type);
 void			free_eqtn_data(FpaEQTN_DATA *pfld);
 FpaEQTN_DATA	*copy_eqtn_data(FpaEQTN_DATA *pfld);
@@ -263,6 +291,9 @@ FpaEQTN_DATA		*oper_plus(FpaEQTN_DATA *plfld, FpaEQTN_DATA *prfld);
 FpaEQTN_DATA		*oper_minus(FpaEQTN_DATA *plfld, FpaEQTN_DATA *prfld);
 FpaEQTN_DATA		*oper_mult(FpaEQTN_DATA *plfld, FpaEQTN_DATA *prfld);
 FpaEQTN_DATA		*oper_divn(FpaEQTN_DATA *plfld, FpaEQTN_DATA *prfld);
+FpaEQTN_DATA		*oper_inplace(char op, FpaEQTN_DATA *plfld,
+						FpaEQTN_DATA *prfld);
+FpaEQTN_DATA		*oper_chain(int nstep, FpaEQTN_STEP *steps);
 
 
 /* Now it has been included */
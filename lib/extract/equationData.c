@@ -70,6 +70,13 @@ static int			add_field_to_equation_database(FLD_DESCRIPT *, MAP_PROJ *,
 static FIELD		vector_field_from_equation_database(FLD_DESCRIPT *);
 static FIELD		xycomp_field_from_equation_database(FLD_DESCRIPT *);
 static FIELD		default_field_from_equation_database(FLD_DESCRIPT *);
+static unsigned long	equation_database_hash(FLD_DESCRIPT *);
+static void			link_equation_database_field(int);
+static void			unlink_equation_database_field(int);
+static void			remove_equation_database_field(int);
+static void			trim_equation_database(void);
+static long			equation_database_limit(void);
+static long			equation_field_size(FIELD);
 
 /**********************************************************************
  ***                                                                ***
@@ -83,9 +90,28 @@ static FIELD		default_field_from_equation_database(FLD_DESCRIPT *);
  **********************************************************************/
 
 /* Storage locations for fields in Equation Database Objects */
+/*  ... fields are found through a hash table on the field descriptor, */
+/*  and empty locations are kept on a free list for re-use             */
 static	int				NumEqtnFlds  = 0;
-static	int				LastEqtnFld  = -1;
+static	int				FreeEqtnFld  = -1;
 static	FpaEQTN_FLDS	*FpaEqtnFlds = NullPtr(FpaEQTN_FLDS *);
+static	int				NumEqtnHash  = 0;
+static	int				NumEqtnLive  = 0;
+static	int				*EqtnHash    = NullPtr(int *);
+
+/* Least recently used fields are discarded when the fields held use  */
+/*  more memory than the limit ... but never fields used since the    */
+/*  start of the current request, or fields supplied by the caller    */
+static	long			EqtnClock    = 0;
+static	long			EqtnPinned   = 0;
+static	long			EqtnMemory   = 0;
+static	long			EqtnLimit    = -1;
+
+/* Statistics for the Equation Database */
+static	long			EqtnHits     = 0;
+static	long			EqtnMisses   = 0;
+static	long			EqtnReads    = 0;
+static	long			EqtnDiscards = 0;
 
 
 /*********************************************************************/
@@ -102,19 +128,89 @@ void				clear_equation_database
 	/* Return now if nothing to clear */
 	if ( NumEqtnFlds <= 0 ) return;
 
+	if ( DebugMode ) (void) equation_database_statistics();
+
 	/* Initialize each FpaEQTN_FLDS storage structure in Equation Database */
 	for ( inum=0; inum<NumEqtnFlds; inum++ )
 		{
 		(void) init_equation_database_field(&FpaEqtnFlds[inum]);
 		}
 
-	/* Now free all FpaEQTN_FLDS storage structures */
+	/* Now free all FpaEQTN_FLDS storage structures and the hash table */
 	FREEMEM(FpaEqtnFlds);
 	FpaEqtnFlds = NullPtr(FpaEQTN_FLDS *);
+	FREEMEM(EqtnHash);
+	EqtnHash    = NullPtr(int *);
 
 	/* Reset counters */
 	NumEqtnFlds = 0;
-	LastEqtnFld = NumEqtnFlds - 1;
+	FreeEqtnFld = -1;
+	NumEqtnHash = 0;
+	NumEqtnLive = 0;
+	EqtnMemory  = 0;
+	}
+
+/**********************************************************************/
+
+/*********************************************************************/
+/** Report usage of the global Equation Database.
+ *
+ * The memory limit (in Mb) for fields held in the Equation Database
+ * is given by the FPA_EQUATION_CACHE environment variable or the
+ * "Equation.Cache" advanced feature (0 for no limit).
+ *********************************************************************/
+void				equation_database_statistics
+
+	(
+	)
+
+	{
+	long		limit;
+
+	limit = equation_database_limit();
+	(void) fprintf(stdout, "[equation_database] Fields: %d  Memory: %ld kb",
+			NumEqtnLive, EqtnMemory/1024);
+	if ( limit > 0 ) (void) fprintf(stdout, " of %ld kb\n", limit/1024);
+	else             (void) fprintf(stdout, " (no limit)\n");
+	(void) fprintf(stdout, "[equation_database] Hits: %ld  Misses: %ld",
+			EqtnHits, EqtnMisses);
+	(void) fprintf(stdout, "  Metafile reads: %ld  Discards: %ld\n",
+			EqtnReads, EqtnDiscards);
+	}
+
+/**********************************************************************/
+
+/*********************************************************************/
+/** List the fields read from metafiles that are held in the global
+ *  Equation Database.
+ *
+ *	@param[out]	**fdescs	list of field descriptors
+ * 	@return Number of field descriptors in list. You will need to
+ * 			free the list when you are finished with it.
+ *********************************************************************/
+int					equation_database_descriptors
+
+	(
+	FLD_DESCRIPT	**fdescs
+	)
+
+	{
+	int			inum, nfds;
+
+	/* Return now if no list */
+	if ( IsNull(fdescs) ) return 0;
+	*fdescs = NullPtr(FLD_DESCRIPT *);
+	if ( NumEqtnLive <= 0 ) return 0;
+
+	/* Copy the field descriptors (but not supplied fields) */
+	*fdescs = INITMEM(FLD_DESCRIPT, NumEqtnLive);
+	for ( nfds=0, inum=0; inum<NumEqtnFlds; inum++ )
+		{
+		if ( IsNull(FpaEqtnFlds[inum].fld) ) continue;
+		if ( FpaEqtnFlds[inum].keep )        continue;
+		(void) copy_fld_descript(&(*fdescs)[nfds++], &FpaEqtnFlds[inum].descript);
+		}
+	return nfds;
 	}
 
 /**********************************************************************/
@@ -145,6 +241,9 @@ FIELD				field_from_equation_database
 	fdef = get_field_info(fdesc->edef->name, fdesc->ldef->name);
 	if ( IsNull(fdef) ) return NullFld;
 
+	/* Fields used from here on are needed until this request is done */
+	EqtnPinned = EqtnClock + 1;
+
 	/* Set the type of field (if already defined) */
 	if ( fdesc->fmacro != FpaCnoMacro ) fieldmacro = fdesc->fmacro;
 
@@ -231,17 +330,23 @@ void	replace_field_in_equation_database
 								FpaF_END_OF_LIST);
 
 	/* If field is in Equation Database we will need to replace it */
+	EqtnPinned = EqtnClock + 1;
 	inum = find_field_in_equation_database(&descript);
 	if ( inum >= 0 )
 		{
 		(void) copy_fld_descript(&FpaEqtnFlds[inum].descript, &descript);
 		(void) copy_map_projection(&FpaEqtnFlds[inum].mproj, mproj);
-		FpaEqtnFlds[inum].fld = fld;
+		FpaEqtnFlds[inum].fld  = fld;
+		EqtnMemory -= FpaEqtnFlds[inum].size;
+		FpaEqtnFlds[inum].size = equation_field_size(fld);
+		EqtnMemory += FpaEqtnFlds[inum].size;
+		FpaEqtnFlds[inum].keep = TRUE;
 		return;
 		}
 
-	/* Otherwise add it */
-	(void) add_field_to_equation_database(&descript, mproj, fld);
+	/* Otherwise add it (and keep it, since it cannot be read again) */
+	inum = add_field_to_equation_database(&descript, mproj, fld);
+	if ( inum >= 0 ) FpaEqtnFlds[inum].keep = TRUE;
 	}
 
 /**********************************************************************/
@@ -292,8 +397,8 @@ void	delete_field_in_equation_database
 	inum = find_field_in_equation_database(&descript);
 	if ( inum < 0 ) return;
 
-	/* Remove it (empty it so it can't be found) */
-	(void) init_equation_database_field(&FpaEqtnFlds[inum]);
+	/* Remove it */
+	(void) remove_equation_database_field(inum);
 	}
 
 /**********************************************************************
@@ -739,40 +844,31 @@ static int		find_field_in_equation_database
 	)
 
 	{
-	int		inum, istart;
+	int				inum;
+	unsigned long	hash;
 
 	/* Return if no field descriptor */
 	if ( IsNull(fdesc) ) return -1;
 
-	/* Check fields in Equation Database */
-	/* Begin with last one used */
-	/*  ... then check to the end of the list */
-	/*  ... the start at the beginning if still not found */
-	/* First time - start at the beginning */
-	istart = ( LastEqtnFld < 0 )? 0: LastEqtnFld;
-
-	/* Start from last one */
-	for ( inum=istart; inum<NumEqtnFlds; inum++ )
+	/* Check fields in Equation Database with the same hash */
+	if ( NumEqtnHash > 0 )
 		{
-		if ( same_fld_descript_no_map(&FpaEqtnFlds[inum].descript, fdesc) )
+		hash = equation_database_hash(fdesc);
+		for ( inum=EqtnHash[hash & (NumEqtnHash-1)]; inum>=0;
+				inum=FpaEqtnFlds[inum].next )
 			{
-			LastEqtnFld = inum;
-			return inum;
-			}
-		}
-
-	/* Start from the beginning */
-	for ( inum=0; inum<istart; inum++ )
-		{
-		if ( same_fld_descript_no_map(&FpaEqtnFlds[inum].descript, fdesc) )
-			{
-			LastEqtnFld = inum;
-			return inum;
+			if ( FpaEqtnFlds[inum].hash != hash ) continue;
+			if ( same_fld_descript_no_map(&FpaEqtnFlds[inum].descript, fdesc) )
+				{
+				FpaEqtnFlds[inum].used = ++EqtnClock;
+				EqtnHits++;
+				return inum;
+				}
 			}
 		}
 
 	/* Not found */
-	LastEqtnFld = -1;
+	EqtnMisses++;
 	return -1;
 	}
 
@@ -805,6 +901,7 @@ static int		get_field_for_equation_database
 	/*  definition but no grid definition!                    */
 	dprintf(stdout, "  Reading metafile: \"%s\"\n", SafeStr(metapath));
 	meta = read_metafile(metapath, NullMapProj);
+	EqtnReads++;
 
 	/* Error message if problem reading named metafile */
 	if ( IsNull(meta) )
@@ -905,31 +1002,367 @@ static int		add_field_to_equation_database
 	)
 
 	{
-	LastEqtnFld = -1;
+	int			inum;
 
 	/* Return if no field descriptor or map projection or field */
 	if ( IsNull(fdesc) ) return -1;
 	if ( IsNull(mproj) ) return -1;
 	if ( IsNull(fld) )   return -1;
 
-	/* Save the field in the Equation Database */
-	LastEqtnFld = NumEqtnFlds++;
-	FpaEqtnFlds = GETMEM(FpaEqtnFlds, FpaEQTN_FLDS, NumEqtnFlds);
+	/* Re-use an empty location in the Equation Database */
+	if ( FreeEqtnFld >= 0 )
+		{
+		inum        = FreeEqtnFld;
+		FreeEqtnFld = FpaEqtnFlds[inum].next;
+		}
 
-	(void) copy_fld_descript(&FpaEqtnFlds[LastEqtnFld].descript, fdesc);
-	(void) copy_map_projection(&FpaEqtnFlds[LastEqtnFld].mproj, mproj);
-	FpaEqtnFlds[LastEqtnFld].fld = fld;
+	/* Otherwise add a new location */
+	else
+		{
+		inum        = NumEqtnFlds++;
+		FpaEqtnFlds = GETMEM(FpaEqtnFlds, FpaEQTN_FLDS, NumEqtnFlds);
+		}
+
+	/* Save the field in the Equation Database */
+	(void) copy_fld_descript(&FpaEqtnFlds[inum].descript, fdesc);
+	(void) copy_map_projection(&FpaEqtnFlds[inum].mproj, mproj);
+	FpaEqtnFlds[inum].fld = fld;
 
 	/* Add a grid definition to the map projection */
 	/*  if the field is a surface                  */
 	if ( fld->ftype == FtypeSfc )
 		{
 		(void) set_grid_from_surface(fld->data.sfc,
-				&FpaEqtnFlds[LastEqtnFld].mproj);
+				&FpaEqtnFlds[inum].mproj);
 		}
 
+	/* Enter the field in the hash table */
+	FpaEqtnFlds[inum].hash = equation_database_hash(fdesc);
+	FpaEqtnFlds[inum].size = equation_field_size(fld);
+	FpaEqtnFlds[inum].used = ++EqtnClock;
+	FpaEqtnFlds[inum].keep = FALSE;
+	EqtnMemory += FpaEqtnFlds[inum].size;
+	(void) link_equation_database_field(inum);
+
+	/* Discard least recently used fields if over the memory limit */
+	(void) trim_equation_database();
+
 	/* Return the location of the field in the Equation Database */
-	return LastEqtnFld;
+	return inum;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** e q u a t i o n _ d a t a b a s e _ h a s h                    ***
+ ***                                                                ***
+ *** returns a hash of the parts of a field descriptor compared by  ***
+ *** same_fld_descript_no_map() ... note that timestamps are hashed ***
+ *** by the time they represent, since matching timestamps may be   ***
+ *** written in different forms                                     ***
+ ***                                                                ***
+ *** l i n k _ e q u a t i o n _ d a t a b a s e _ f i e l d        ***
+ *** u n l i n k _ e q u a t i o n _ d a t a b a s e _ f i e l d    ***
+ ***                                                                ***
+ *** add or remove a field from the hash table                      ***
+ ***                                                                ***
+ *** r e m o v e _ e q u a t i o n _ d a t a b a s e _ f i e l d    ***
+ *** t r i m _ e q u a t i o n _ d a t a b a s e                    ***
+ ***                                                                ***
+ *** remove a field from the global Equation Database, or remove    ***
+ *** least recently used fields until under the memory limit        ***
+ ***                                                                ***
+ **********************************************************************/
+
+#define EQTN_HASH_MIX(hash, value) \
+			( ((hash) ^ (unsigned long) (value)) * 16777619UL )
+
+static unsigned long	equation_database_hash
+
+	(
+	FLD_DESCRIPT	*fdesc	/* pointer to field descriptor */
+	)
+
+	{
+	int				nn, year, jday, hour, minute;
+	LOGICAL			local, mins;
+	STRING			tstamp;
+	unsigned long	hash;
+
+	hash = 2166136261UL;
+	hash = EQTN_HASH_MIX(hash, fdesc->sdef);
+	hash = EQTN_HASH_MIX(hash, fdesc->subdef);
+	hash = EQTN_HASH_MIX(hash, fdesc->edef);
+	hash = EQTN_HASH_MIX(hash, fdesc->ldef);
+	hash = EQTN_HASH_MIX(hash, fdesc->fdef);
+	hash = EQTN_HASH_MIX(hash, fdesc->fmacro);
+
+	for ( nn=0; nn<2; nn++ )
+		{
+		tstamp = ( nn == 0 )? fdesc->rtime: fdesc->vtime;
+		if ( blank(tstamp) )
+			hash = EQTN_HASH_MIX(hash, 0);
+		else if ( !parse_tstamp(tstamp, &year, &jday, &hour, &minute,
+					&local, &mins) )
+			hash = EQTN_HASH_MIX(hash, 1);
+		else
+			hash = EQTN_HASH_MIX(hash,
+					2 + local + 2*mdif(2000, 1, 0, 0, year, jday, hour, minute));
+		}
+
+	return hash;
+	}
+
+/**********************************************************************/
+
+static void		link_equation_database_field
+
+	(
+	int		inum	/* location in Equation Database */
+	)
+
+	{
+	int		jnum, ihash;
+
+	/* Double the hash table when it fills up */
+	if ( NumEqtnLive >= NumEqtnHash )
+		{
+		NumEqtnHash = ( NumEqtnHash > 0 )? 2*NumEqtnHash: 64;
+		EqtnHash    = GETMEM(EqtnHash, int, NumEqtnHash);
+		for ( ihash=0; ihash<NumEqtnHash; ihash++ ) EqtnHash[ihash] = -1;
+
+		/* Re-enter the fields already in the hash table */
+		for ( jnum=0; jnum<NumEqtnFlds; jnum++ )
+			{
+			if ( jnum == inum || IsNull(FpaEqtnFlds[jnum].fld) ) continue;
+			ihash = (int) (FpaEqtnFlds[jnum].hash & (NumEqtnHash-1));
+			FpaEqtnFlds[jnum].next = EqtnHash[ihash];
+			EqtnHash[ihash]        = jnum;
+			}
+		}
+
+	ihash = (int) (FpaEqtnFlds[inum].hash & (NumEqtnHash-1));
+	FpaEqtnFlds[inum].next = EqtnHash[ihash];
+	EqtnHash[ihash]        = inum;
+	NumEqtnLive++;
+	}
+
+/**********************************************************************/
+
+static void		unlink_equation_database_field
+
+	(
+	int		inum	/* location in Equation Database */
+	)
+
+	{
+	int		*pnum;
+
+	if ( NumEqtnHash <= 0 ) return;
+
+	for ( pnum=&EqtnHash[FpaEqtnFlds[inum].hash & (NumEqtnHash-1)];
+			*pnum>=0; pnum=&FpaEqtnFlds[*pnum].next )
+		{
+		if ( *pnum != inum ) continue;
+		*pnum = FpaEqtnFlds[inum].next;
+		NumEqtnLive--;
+		return;
+		}
+	}
+
+/**********************************************************************/
+
+static void		remove_equation_database_field
+
+	(
+	int		inum	/* location in Equation Database */
+	)
+
+	{
+
+	/* Remove the field from the hash table and free it */
+	(void) unlink_equation_database_field(inum);
+	EqtnMemory -= FpaEqtnFlds[inum].size;
+	(void) init_equation_database_field(&FpaEqtnFlds[inum]);
+	FpaEqtnFlds[inum].size = 0;
+	FpaEqtnFlds[inum].keep = FALSE;
+
+	/* Add the empty location to the free list */
+	FpaEqtnFlds[inum].next = FreeEqtnFld;
+	FreeEqtnFld            = inum;
+	}
+
+/**********************************************************************/
+
+static void		trim_equation_database
+
+	(
+	)
+
+	{
+	int		inum, iold;
+	long	limit;
+
+	limit = equation_database_limit();
+	if ( limit <= 0 ) return;
+
+	while ( EqtnMemory > limit )
+		{
+
+		/* Find the least recently used field that can be discarded */
+		iold = -1;
+		for ( inum=0; inum<NumEqtnFlds; inum++ )
+			{
+			if ( IsNull(FpaEqtnFlds[inum].fld) )         continue;
+			if ( FpaEqtnFlds[inum].keep )                continue;
+			if ( FpaEqtnFlds[inum].used >= EqtnPinned )  continue;
+			if ( iold < 0 || FpaEqtnFlds[inum].used < FpaEqtnFlds[iold].used )
+				iold = inum;
+			}
+		if ( iold < 0 ) return;
+
+		dprintf(stdout, "  Discarding field: \"%s %s\" from \"%s %s\" at \"%s\"\n",
+				SafeStr(FpaEqtnFlds[iold].descript.edef->name),
+				SafeStr(FpaEqtnFlds[iold].descript.ldef->name),
+				SafeStr(FpaEqtnFlds[iold].descript.sdef->name),
+				SafeStr(FpaEqtnFlds[iold].descript.subdef->name),
+				SafeStr(FpaEqtnFlds[iold].descript.vtime));
+		(void) remove_equation_database_field(iold);
+		EqtnDiscards++;
+		}
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** e q u a t i o n _ d a t a b a s e _ l i m i t                  ***
+ ***                                                                ***
+ *** returns the memory limit (in bytes) for fields held in the     ***
+ *** global Equation Database, given (in Mb) by the                 ***
+ *** FPA_EQUATION_CACHE environment variable or the                 ***
+ *** "Equation.Cache" advanced feature (0 for no limit)             ***
+ ***                                                                ***
+ *** e q u a t i o n _ f i e l d _ s i z e                          ***
+ ***                                                                ***
+ *** returns the approximate memory used by a field                 ***
+ ***                                                                ***
+ **********************************************************************/
+
+static long		equation_database_limit
+
+	(
+	)
+
+	{
+	STRING	mode;
+	int		mbytes;
+
+	if ( EqtnLimit < 0 )
+		{
+		mode = getenv("FPA_EQUATION_CACHE");
+		if ( blank(mode) ) mode = get_feature_mode("Equation.Cache");
+
+		mbytes = 256;
+		if ( !blank(mode) && sscanf(mode, "%d", &mbytes) != 1 )
+			{
+			(void) fprintf(stderr, "[equation_database_limit]");
+			(void) fprintf(stderr, " Unknown Equation.Cache size \"%s\"\n",
+					mode);
+			mbytes = 256;
+			}
+		EqtnLimit = (long) MAX(mbytes, 0) * 1024L * 1024L;
+		}
+
+	return EqtnLimit;
+	}
+
+/**********************************************************************/
+
+static long		equation_field_size
+
+	(
+	FIELD	fld		/* field in Equation Database */
+	)
+
+	{
+	int			ii, jj;
+	long		size;
+	SURFACE		sfc;
+	SET			set;
+	PLOT		plot;
+	RASTER		raster;
+	CURVE		curve;
+	AREA		area;
+
+	if ( IsNull(fld) ) return 0;
+	size = (long) sizeof(*fld);
+
+	switch ( fld->ftype )
+		{
+
+		/* Spline control vertices and patches */
+		case FtypeSfc:
+			sfc = fld->data.sfc;
+			if ( IsNull(sfc) ) break;
+			size += (long) sfc->sp.m * sfc->sp.n * (long) sizeof(float)
+						* ( (sfc->sp.dim == DimVector2D)? 3: 1 );
+			if ( IsNull(sfc->patches) ) break;
+			for ( ii=0; ii<sfc->nupatch; ii++ )
+				for ( jj=0; jj<sfc->nvpatch; jj++ )
+					if ( NotNull(sfc->patches[ii][jj]) )
+						size += (long) sizeof(struct PATCH_struct);
+			break;
+
+		/* Items, and points in curves and area boundaries */
+		case FtypeSet:
+			set = fld->data.set;
+			if ( IsNull(set) ) break;
+			for ( ii=0; ii<set->num; ii++ )
+				{
+				if ( same(set->type, "curve") )
+					{
+					size += (long) sizeof(struct CURVE_struct);
+					curve = (CURVE) set->list[ii];
+					if ( NotNull(curve) && NotNull(curve->line) )
+						size += (long) curve->line->numpts * (long) sizeof(POINT);
+					}
+				else if ( same(set->type, "area") )
+					{
+					size += (long) sizeof(struct AREA_struct);
+					area = (AREA) set->list[ii];
+					if ( IsNull(area) || IsNull(area->bound) ) continue;
+					if ( NotNull(area->bound->boundary) )
+						size += (long) area->bound->boundary->numpts
+									* (long) sizeof(POINT);
+					for ( jj=0; jj<area->bound->numhole; jj++ )
+						size += (long) area->bound->holes[jj]->numpts
+									* (long) sizeof(POINT);
+					}
+				else
+					{
+					size += (long) sizeof(struct SPOT_struct);
+					}
+				}
+			break;
+
+		/* Plot points and sub-field values */
+		case FtypePlot:
+			plot = fld->data.plot;
+			if ( IsNull(plot) ) break;
+			size += (long) plot->numpts * (long) sizeof(POINT)
+						* ( 1 + plot->nsubs );
+			break;
+
+		/* Raster grid */
+		case FtypeRaster:
+			raster = fld->data.raster;
+			if ( IsNull(raster) ) break;
+			size += (long) raster->ncol * raster->nrow * raster->bpp;
+			break;
+
+		default:
+			break;
+		}
+
+	return size;
 	}
 
 /**********************************************************************
@@ -86,6 +86,11 @@ static FpaEQTN_DATA	*oper_lwrprs();
 static FpaEQTN_DATA	*oper_sunang();
 static FpaEQTN_DATA	*oper_sundist();
 
+/* Internal static functions (Mathematical Symbols) */
+static LOGICAL		oper_zero_divisor(int, const float *);
+static void			oper_values(char, int, float *,
+									const float *, float, const float *, float);
+
 /***********************************************************************
 *                                                                      *
 *     Routines to identify UNIX or user defined functions              *
@@ -1262,6 +1267,416 @@ FpaEQTN_DATA		*oper_divn
 	return pfield;
 	}
 
+/**********************************************************************
+ ***                                                                ***
+ *** o p e r _ i n p l a c e                                        ***
+ ***                                                                ***
+ ***                                                                ***
+ **********************************************************************/
+
+/*********************************************************************/
+/** Apply an arithmetic operator (+ - * /) to two work structures,
+ * overwriting one of them with the result rather than copying it.
+ *
+ * Both structures are consumed: the one that is not returned is
+ * freed.  This avoids allocating and filling a new GRID or VLIST
+ * Object for each operator while evaluating an equation, so each
+ * operator makes a single pass over the data.  Combinations of
+ * Objects that must be converted (or that are in error) are passed
+ * on to oper_plus(), oper_minus(), oper_mult() or oper_divn().
+ *
+ *	@param[in]	op			operator (one of + - * /)
+ *	@param[in]	*plfld		first structure (A) (consumed)
+ *	@param[in]	*prfld		second structure (B) (consumed)
+ * 	@return Pointer to structure calculated from the first and
+ * 			second structures (C). You will need to free this
+ * 			memory when you are finished with it.
+ *********************************************************************/
+FpaEQTN_DATA		*oper_inplace
+
+	(
+	char			op,
+	FpaEQTN_DATA	*plfld,
+	FpaEQTN_DATA	*prfld
+	)
+
+	{
+	int				iiy, iiu;
+	float			lscl, rscl;
+	GRID			*lgrid, *rgrid, *ogrid;
+	SPLINE			*ospln;
+	VLIST			*lvlst, *rvlst, *ovlst;
+	FpaEQTN_DATA	*pfield, *pother;
+
+	/* Return Null if missing structures to evaluate */
+	if ( IsNull(plfld) || IsNull(prfld) )
+		{
+		(void) free_eqtn_data(plfld);
+		(void) free_eqtn_data(prfld);
+		return NullPtr(FpaEQTN_DATA *);
+		}
+
+	/* Identify the structure to overwrite ... the same one the */
+	/*  operator functions would have copied                    */
+	pfield = NullPtr(FpaEQTN_DATA *);
+	lscl   = (plfld->Type == FpaEQT_Scalar)? plfld->Data.scalr.sval: 0.0;
+	rscl   = (prfld->Type == FpaEQT_Scalar)? prfld->Data.scalr.sval: 0.0;
+	lgrid  = (plfld->Type == FpaEQT_Grid)?  &plfld->Data.gridd: NullPtr(GRID *);
+	rgrid  = (prfld->Type == FpaEQT_Grid)?  &prfld->Data.gridd: NullPtr(GRID *);
+	lvlst  = (plfld->Type == FpaEQT_Vlist)? &plfld->Data.vlist: NullPtr(VLIST *);
+	rvlst  = (prfld->Type == FpaEQT_Vlist)? &prfld->Data.vlist: NullPtr(VLIST *);
+	if ( op != '+' && op != '-' && op != '*' && op != '/' )
+		{
+		/* Not an operator handled here */
+		}
+	else if ( plfld->Type == FpaEQT_Scalar && prfld->Type == FpaEQT_Scalar )
+		{
+		if ( op != '/' || rscl != 0.0 ) pfield = prfld;
+		}
+	else if ( plfld->Type == FpaEQT_Scalar && prfld->Type == FpaEQT_Grid )
+		{
+		pfield = prfld;
+		if ( op == '/' )
+			{
+			for ( iiy=0; iiy<rgrid->ny; iiy++ )
+				if ( oper_zero_divisor(rgrid->nx, rgrid->gval[iiy]) )
+					pfield = NullPtr(FpaEQTN_DATA *);
+			}
+		}
+	else if ( plfld->Type == FpaEQT_Grid && prfld->Type == FpaEQT_Scalar )
+		{
+		if ( op != '/' || rscl != 0.0 ) pfield = plfld;
+		}
+	else if ( plfld->Type == FpaEQT_Grid && prfld->Type == FpaEQT_Grid )
+		{
+		if ( same_grid_size(lgrid, rgrid) ) pfield = plfld;
+		if ( NotNull(pfield) && op == '/' )
+			{
+			for ( iiy=0; iiy<rgrid->ny; iiy++ )
+				if ( oper_zero_divisor(rgrid->nx, rgrid->gval[iiy]) )
+					pfield = NullPtr(FpaEQTN_DATA *);
+			}
+		}
+	else if ( plfld->Type == FpaEQT_Spline && prfld->Type == FpaEQT_Scalar )
+		{
+		if ( op != '/' || rscl != 0.0 ) pfield = plfld;
+		}
+	else if ( plfld->Type == FpaEQT_Scalar && prfld->Type == FpaEQT_Spline )
+		{
+		/* Division by a SPLINE Object is done on a GRID Object */
+		if ( op != '/' ) pfield = prfld;
+		}
+	else if ( plfld->Type == FpaEQT_Vlist && prfld->Type == FpaEQT_Vlist )
+		{
+		if ( same_vlist_points(lvlst, rvlst) ) pfield = plfld;
+		if ( NotNull(pfield) && op == '/'
+				&& oper_zero_divisor(rvlst->numpts, rvlst->val) )
+			pfield = NullPtr(FpaEQTN_DATA *);
+		}
+	else if ( plfld->Type == FpaEQT_Vlist && prfld->Type == FpaEQT_Scalar )
+		{
+		if ( op != '/' || rscl != 0.0 ) pfield = plfld;
+		}
+	else if ( plfld->Type == FpaEQT_Scalar && prfld->Type == FpaEQT_Vlist )
+		{
+		pfield = prfld;
+		if ( op == '/' && oper_zero_divisor(rvlst->numpts, rvlst->val) )
+			pfield = NullPtr(FpaEQTN_DATA *);
+		}
+
+	/* Pass everything else on to the operator functions */
+	if ( IsNull(pfield) )
+		{
+		switch (op)
+			{
+			case '+':	pfield = oper_plus(plfld, prfld);	break;
+			case '-':	pfield = oper_minus(plfld, prfld);	break;
+			case '*':	pfield = oper_mult(plfld, prfld);	break;
+			case '/':	pfield = oper_divn(plfld, prfld);	break;
+			default:	pfield = NullPtr(FpaEQTN_DATA *);	break;
+			}
+		(void) free_eqtn_data(plfld);
+		(void) free_eqtn_data(prfld);
+		return pfield;
+		}
+
+	/* Otherwise overwrite the data in place */
+	pother = (pfield == plfld)? prfld: plfld;
+	switch (pfield->Type)
+		{
+		case FpaEQT_Scalar:
+			oper_values(op, 1, &pfield->Data.scalr.sval,
+						NullPtr(float *), lscl, NullPtr(float *), rscl);
+			break;
+
+		case FpaEQT_Grid:
+			ogrid = &pfield->Data.gridd;
+			for ( iiy=0; iiy<ogrid->ny; iiy++ )
+				oper_values(op, ogrid->nx, ogrid->gval[iiy],
+						(lgrid)? lgrid->gval[iiy]: NullPtr(float *), lscl,
+						(rgrid)? rgrid->gval[iiy]: NullPtr(float *), rscl);
+			break;
+
+		case FpaEQT_Spline:
+			ospln = &pfield->Data.splne;
+			for ( iiu=0; iiu<ospln->m; iiu++ )
+				oper_values(op, ospln->n, ospln->cvs[iiu],
+						(pfield == plfld)? ospln->cvs[iiu]: NullPtr(float *), lscl,
+						(pfield == prfld)? ospln->cvs[iiu]: NullPtr(float *), rscl);
+			break;
+
+		case FpaEQT_Vlist:
+			ovlst = &pfield->Data.vlist;
+			oper_values(op, ovlst->numpts, ovlst->val,
+						(lvlst)? lvlst->val: NullPtr(float *), lscl,
+						(rvlst)? rvlst->val: NullPtr(float *), rscl);
+			break;
+		}
+
+	/* Free the structure that was not overwritten */
+	(void) free_eqtn_data(pother);
+	return pfield;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** o p e r _ c h a i n                                            ***
+ ***                                                                ***
+ ***                                                                ***
+ **********************************************************************/
+
+/*********************************************************************/
+/** Apply a chain of arithmetic operators (+ - * /) to a list of
+ * work structures.
+ *
+ * The steps are in postfix order, so each operator is applied to the
+ * results of the two operands (or operators) before it.  If every
+ * operand is a SCALAR Object, or a GRID, SPLINE or VLIST Object of the
+ * same dimensions, the whole chain is evaluated one row at a time in a
+ * single pass over the data, and no intermediate Objects are built.
+ * Otherwise the operators are applied one at a time by oper_inplace().
+ *
+ * Note that the steps must only combine Objects in the same way as
+ * oper_plus(), oper_minus(), oper_mult() and oper_divn() would, for
+ * example, adding SPLINE Objects but not multiplying them.
+ *
+ * Operand structures are consumed (either freed or reused for the
+ * result) unless they are flagged as shared.
+ *
+ *	@param[in]	nstep		number of steps
+ *	@param[in]	*steps		list of operand and operator steps
+ * 	@return Pointer to structure calculated from the chain of
+ * 			operators. You will need to free this memory when you
+ * 			are finished with it.
+ *********************************************************************/
+FpaEQTN_DATA		*oper_chain
+
+	(
+	int				nstep,
+	FpaEQTN_STEP	*steps
+	)
+
+	{
+	int				ii, nn, ndepth, iiy, nrow, ncol;
+	short			type;
+	LOGICAL			fused;
+	float			*sval, *rows, *orow, *oval;
+	const float		**rvals;
+	FpaEQTN_DATA	*pbase, *pfield, *pdata, *pl, *pr, **pstack;
+	FpaEQTN_STEP	*pstep;
+
+	/* Check the chain of operators and the Objects in each operand */
+	pbase  = NullPtr(FpaEQTN_DATA *);
+	pfield = NullPtr(FpaEQTN_DATA *);
+	fused  = TRUE;
+	ndepth = 0;
+	for ( nn=ii=0; ii<nstep; ii++ )
+		{
+		pstep = &steps[ii];
+		if ( pstep->op != '\0' )
+			{
+			if ( nn < 2 ) break;
+			nn--;
+			continue;
+			}
+		if ( ++nn > ndepth ) ndepth = nn;
+		pdata = pstep->data;
+		if ( IsNull(pdata) ) break;
+		switch (pdata->Type)
+			{
+			case FpaEQT_Scalar:
+				break;
+
+			case FpaEQT_Grid:
+				if ( IsNull(pbase) ) pbase = pdata;
+				else if ( pbase->Type != FpaEQT_Grid
+						|| !same_grid_size(&pbase->Data.gridd,
+											&pdata->Data.gridd) )
+					fused = FALSE;
+				break;
+
+			case FpaEQT_Spline:
+				if ( IsNull(pbase) ) pbase = pdata;
+				else if ( pbase->Type != FpaEQT_Spline
+						|| !same_spline_size(&pbase->Data.splne,
+											&pdata->Data.splne) )
+					fused = FALSE;
+				break;
+
+			case FpaEQT_Vlist:
+				if ( IsNull(pbase) ) pbase = pdata;
+				else if ( pbase->Type != FpaEQT_Vlist
+						|| !same_vlist_points(&pbase->Data.vlist,
+											&pdata->Data.vlist) )
+					fused = FALSE;
+				break;
+
+			default:
+				fused = FALSE;
+				break;
+			}
+		}
+
+	/* Error message for incomplete chain of operators */
+	if ( ii < nstep || nn != 1 )
+		{
+		(void) fprintf(stderr, "[oper_chain] Incomplete chain of operators\n");
+		for ( ii=0; ii<nstep; ii++ )
+			if ( steps[ii].op == '\0' && !steps[ii].shared )
+				(void) free_eqtn_data(steps[ii].data);
+		return NullPtr(FpaEQTN_DATA *);
+		}
+
+	/* Apply the operators one at a time if the Objects cannot */
+	/*  be combined row by row                                 */
+	if ( !fused )
+		{
+		pstack = INITMEM(FpaEQTN_DATA *, ndepth);
+		for ( nn=ii=0; ii<nstep; ii++ )
+			{
+			pstep = &steps[ii];
+			if ( pstep->op == '\0' )
+				{
+				pstack[nn++] = (pstep->shared)? copy_eqtn_data(pstep->data):
+												pstep->data;
+				}
+			else
+				{
+				pr = pstack[--nn];
+				pl = pstack[--nn];
+				pstack[nn++] = oper_inplace(pstep->op, pl, pr);
+				}
+			}
+		pfield = pstack[0];
+		FREEMEM(pstack);
+		return pfield;
+		}
+
+	/* Set the result dimensions from the GRID, SPLINE or VLIST Objects */
+	type = (NotNull(pbase))? pbase->Type: FpaEQT_Scalar;
+	nrow = (type == FpaEQT_Grid)?   pbase->Data.gridd.ny:
+		   (type == FpaEQT_Spline)? pbase->Data.splne.m: 1;
+	ncol = (type == FpaEQT_Grid)?   pbase->Data.gridd.nx:
+		   (type == FpaEQT_Spline)? pbase->Data.splne.n:
+		   (type == FpaEQT_Vlist)?  pbase->Data.vlist.numpts: 1;
+
+	/* Reuse an operand structure for the result ... or copy one */
+	for ( ii=0; ii<nstep; ii++ )
+		{
+		pstep = &steps[ii];
+		if ( pstep->op != '\0' || pstep->data->Type != type ) continue;
+		if ( IsNull(pbase) ) pbase = pstep->data;
+		if ( !pstep->shared )
+			{
+			pfield = pstep->data;
+			break;
+			}
+		}
+	if ( IsNull(pfield) ) pfield = copy_eqtn_data(pbase);
+
+	/* Set up a stack of rows (or values) for intermediate results */
+	rows  = INITMEM(float, ndepth*ncol);
+	rvals = INITMEM(const float *, ndepth);
+	sval  = INITMEM(float, ndepth);
+
+	/* Evaluate the whole chain of operators for each row */
+	for ( iiy=0; iiy<nrow; iiy++ )
+		{
+		orow = (type == FpaEQT_Grid)?   pfield->Data.gridd.gval[iiy]:
+			   (type == FpaEQT_Spline)? pfield->Data.splne.cvs[iiy]:
+			   (type == FpaEQT_Vlist)?  pfield->Data.vlist.val: NullPtr(float *);
+		for ( nn=ii=0; ii<nstep; ii++ )
+			{
+			pstep = &steps[ii];
+
+			/* Add the row (or value) of each operand to the stack */
+			if ( pstep->op == '\0' )
+				{
+				pdata = pstep->data;
+				sval[nn]  = 0.0;
+				rvals[nn] = NullPtr(const float *);
+				if ( pdata->Type == FpaEQT_Scalar )
+					sval[nn] = pdata->Data.scalr.sval;
+				else if ( pdata->Type == FpaEQT_Grid )
+					rvals[nn] = pdata->Data.gridd.gval[iiy];
+				else if ( pdata->Type == FpaEQT_Spline )
+					rvals[nn] = pdata->Data.splne.cvs[iiy];
+				else
+					rvals[nn] = pdata->Data.vlist.val;
+				nn++;
+				continue;
+				}
+
+			/* Apply each operator to the top two rows (or values) */
+			nn -= 2;
+			if ( pstep->op == '/'
+					&& ( (rvals[nn+1] && oper_zero_divisor(ncol, rvals[nn+1]))
+						|| (!rvals[nn+1] && sval[nn+1] == 0.0) ) )
+				break;
+			if ( rvals[nn] || rvals[nn+1] )
+				{
+				/* The last operator fills the result row directly */
+				oval = (ii == nstep-1)? orow: rows + nn*ncol;
+				oper_values(pstep->op, ncol, oval,
+						rvals[nn], sval[nn], rvals[nn+1], sval[nn+1]);
+				rvals[nn] = oval;
+				}
+			else
+				{
+				oper_values(pstep->op, 1, &sval[nn],
+						NullPtr(float *), sval[nn], NullPtr(float *), sval[nn+1]);
+				}
+			nn++;
+			}
+		if ( ii < nstep ) break;
+		}
+
+	/* Set the result for a chain of SCALAR Objects */
+	if ( type == FpaEQT_Scalar ) pfield->Data.scalr.sval = sval[0];
+
+	/* Free the operand structures that were not reused */
+	for ( ii=0; ii<nstep; ii++ )
+		{
+		pstep = &steps[ii];
+		if ( pstep->op == '\0' && !pstep->shared && pstep->data != pfield )
+			(void) free_eqtn_data(pstep->data);
+		}
+	FREEMEM(rows);
+	FREEMEM(rvals);
+	FREEMEM(sval);
+
+	/* Error message for division by zero */
+	if ( iiy < nrow )
+		{
+		(void) fprintf(stderr, "[oper_chain] Divide by zero\n");
+		(void) free_eqtn_data(pfield);
+		return NullPtr(FpaEQTN_DATA *);
+		}
+
+	/* Return pointer to calculated structure */
+	return pfield;
+	}
+
 /***********************************************************************
 *                                                                      *
 *     STATIC (LOCAL) ROUTINES (Non-UNIX Functions)                     *
@@ -3675,3 +4090,108 @@ static	FpaEQTN_DATA	*oper_sundist
 	/* Return pointer to evaluated structure */
 	return pfield;
 	}
+
+/***********************************************************************
+*                                                                      *
+*     STATIC (LOCAL) ROUTINES (Mathematical Symbols)                   *
+*                                                                      *
+***********************************************************************/
+
+/**********************************************************************
+ ***                                                                ***
+ *** o p e r _ z e r o _ d i v i s o r                              ***
+ ***                                                                ***
+ *** check a row of values for a zero divisor                       ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	LOGICAL		oper_zero_divisor
+
+	(
+	int			num,		/* number of values */
+	const float	*vals		/* row of values */
+	)
+
+	{
+	int			nn;
+
+	for ( nn=0; nn<num; nn++ )
+		if ( vals[nn] == 0.0 ) return TRUE;
+	return FALSE;
+	}
+
+/**********************************************************************
+ ***                                                                ***
+ *** o p e r _ v a l u e s                                          ***
+ ***                                                                ***
+ *** apply an arithmetic operator to a row of values, where either  ***
+ ***  operand may be a row of values or a scalar value (if the row  ***
+ ***  is missing)                                                   ***
+ *** Note that the result row may be the same as either operand    ***
+ ***  row, and that divisors have already been checked for zero     ***
+ ***                                                                ***
+ **********************************************************************/
+
+static	void		oper_values
+
+	(
+	char		op,			/* operator (one of + - * /) */
+	int			num,		/* number of values */
+	float		*out,		/* row of result values */
+	const float	*lvals,		/* row of first operand values (or Null) */
+	float		lscl,		/* first operand value (if lvals is Null) */
+	const float	*rvals,		/* row of second operand values (or Null) */
+	float		rscl		/* second operand value (if rvals is Null) */
+	)
+
+	{
+	int			nn;
+
+	/* Separate loops for each case keep the inner loops simple */
+	switch (op)
+		{
+		case '+':
+			if ( lvals && rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] + rvals[nn];
+			else if ( lvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] + rscl;
+			else if ( rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl + rvals[nn];
+			else
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl + rscl;
+			break;
+
+		case '-':
+			if ( lvals && rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] - rvals[nn];
+			else if ( lvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] - rscl;
+			else if ( rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl - rvals[nn];
+			else
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl - rscl;
+			break;
+
+		case '*':
+			if ( lvals && rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] * rvals[nn];
+			else if ( lvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] * rscl;
+			else if ( rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl * rvals[nn];
+			else
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl * rscl;
+			break;
+
+		case '/':
+			if ( lvals && rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] / rvals[nn];
+			else if ( lvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lvals[nn] / rscl;
+			else if ( rvals )
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl / rvals[nn];
+			else
+				for ( nn=0; nn<num; nn++ ) out[nn] = lscl / rscl;
+			break;
+		}
+	}
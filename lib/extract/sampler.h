@@ -97,6 +97,9 @@ int		fpa_sampler_empty_point(void);
 int		fpa_sampler_add_point(STRING lat, STRING lon);
 
 int		fpa_sampler_evaluate(void);
+int		fpa_sampler_sample(int nprog, const int *progs,
+				int nfld, const STRING *elems, const STRING *levels,
+				int npt, const STRING *lats, const STRING *lons);
 STRING	fpa_sampler_get_value(int iprog, int ifld, int ipt);
 
 /* Functions in sampler_old.c retained for compatibility */
@@ -40,6 +40,8 @@ static	int		debug = FALSE;
 
 static	int		chid  = -1;					/* Channel identifier */
 static	char	query[5000];				/* Query buffer */
+static	STRING	lquery = NullString;		/* Query buffer for lists */
+static	size_t	lqsize = 0;					/* Size of list query buffer */
 static	int		qtype;						/* Query message type */
 static	STRING	reply;						/* Pointer to reply buffer */
 static	int		rtype;						/* Reply message type */
@@ -49,6 +51,8 @@ static	LOGICAL	valid;						/* Success indicator */
 static	int		nTplus = 0;					/* Number of prog times */
 static	int		nField = 0;					/* Number of fields */
 static	int		nPoint = 0;					/* Number of points */
+static	int		mField = 0;					/* Number held in Elem/Level */
+static	int		mPoint = 0;					/* Number held in Lats/Lons */
 static	int		nValue = 0;					/* Number of values */
 static	int		*Tplus = NullInt;			/* List of prog-times */
 static	STRING	*Elem  = NullStringList;	/* List of elements */
@@ -67,6 +71,14 @@ static	int		TOnormal = 1800;
 static	int		TOlong   = 3600;
 #endif
 
+/* Internal functions */
+static	STRING	tplus_query(int, const int *);
+static	STRING	pair_query(int, const STRING *, const STRING *);
+static	void	save_tplus(int, const int *);
+static	void	save_field(int, const STRING *, const STRING *);
+static	void	save_point(int, const STRING *, const STRING *);
+static	int		save_values(STRING);
+
 /***********************************************************************
 *                                                                      *
 *     f p a _ s a m p l e r _ c o n n e c t                            *
@@ -91,10 +103,17 @@ int		fpa_sampler_connect
 	/* See if already connected */
 	if (chid >= 0) return SUCCESS;
 
-	/* Start up the Depiction Sampler Server */
-	(void) system("sampler startup");
+	/* Connect to a running Depiction Sampler Server, or start one up */
+	/* The server sets up its communications channel before "sampler  */
+	/*  startup" returns, so it can be connected to right away        */
+	chid = connect_server(CHNAME);
+	if (chid < 0)
+		{
+		(void) system("sampler startup");
+		chid = connect_server(CHNAME);
+		}
 
-	/* Keep trying to connect until successful */
+	/* Keep trying to connect to a server that is slow to start up */
 	while (chid < 0)
 		{
 		if (tries-- < 0) return PROBLEM;
@@ -373,8 +392,6 @@ int		fpa_sampler_tplus
 	)
 
 	{
-	int		iprog;
-
 	nTplus = 0;
 
 	/* Make sure Depiction Sampler has been started up */
@@ -385,15 +402,11 @@ int		fpa_sampler_tplus
 
 	/* Construct query request */
 	qtype = SAMPQueryCode(SAMP_TPLUS);
-	(void) sprintf(query,"%d:", nprog);
-	for (iprog=0; iprog<nprog; iprog++)
-		{
-		(void) sprintf(query+strlen(query), " %d", progs[iprog]);
-		}
+	(void) tplus_query(nprog, progs);
 
 	/* Send the message to the Depiction Sampler and get the reply */
-	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,query);
-	status = query_server(chid,qtype,query,&rtype,&reply,TOnormal);
+	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,lquery);
+	status = query_server(chid,qtype,lquery,&rtype,&reply,TOnormal);
 	if (status < 0)
 		{
 		/* Problem with communications - disconnect */
@@ -405,13 +418,7 @@ int		fpa_sampler_tplus
 	/* Interpret the reply */
 	if (SAMPReply(rtype) != SAMP_VALID) return FAILURE;
 
-	nTplus = nprog;
-	if (progs == Tplus) return nTplus;
-	Tplus  = GETMEM(Tplus, int, nTplus);
-	for (iprog=0; iprog<nprog; iprog++)
-		{
-		Tplus[iprog] = progs[iprog];
-		}
+	save_tplus(nprog, progs);
 	return nTplus;
 	}
 
@@ -540,8 +547,6 @@ int		fpa_sampler_field
 	)
 
 	{
-	int		ifld;
-
 	nField = 0;
 
 	/* Make sure Depiction Sampler has been started up */
@@ -552,15 +557,11 @@ int		fpa_sampler_field
 
 	/* Construct query request */
 	qtype = SAMPQueryCode(SAMP_FIELD);
-	(void) sprintf(query,"%d:", nfld);
-	for (ifld=0; ifld<nfld; ifld++)
-		{
-		(void) sprintf(query+strlen(query), " '%s' '%s'", elems[ifld], levels[ifld]);
-		}
+	(void) pair_query(nfld, elems, levels);
 
 	/* Send the message to the Depiction Sampler and get the reply */
-	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,query);
-	status = query_server(chid,qtype,query,&rtype,&reply,TOnormal);
+	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,lquery);
+	status = query_server(chid,qtype,lquery,&rtype,&reply,TOnormal);
 	if (status < 0)
 		{
 		/* Problem with communications - disconnect */
@@ -572,17 +573,7 @@ int		fpa_sampler_field
 	/* Interpret the reply */
 	if (SAMPReply(rtype) != SAMP_VALID) return FAILURE;
 
-	nField = nfld;
-	if (elems == Elem && levels == Level) return nField;
-	FREELIST(Elem,  nField);
-	FREELIST(Level, nField);
-	Elem  = GETMEM(Elem,  STRING, nField);
-	Level = GETMEM(Level, STRING, nField);
-	for (ifld=0; ifld<nfld; ifld++)
-		{
-		Elem[ifld]  = strdup(elems[ifld]);
-		Level[ifld] = strdup(levels[ifld]);
-		}
+	save_field(nfld, elems, levels);
 	return nField;
 	}
 
@@ -623,6 +614,7 @@ int		fpa_sampler_add_field
 	Level = GETMEM(Level, STRING, nField);
 	Elem[nField-1]  = strdup(elem);
 	Level[nField-1] = strdup(level);
+	mField = nField;
 
 	return fpa_sampler_field(nField, Elem, Level);
 	}
@@ -653,8 +645,6 @@ int		fpa_sampler_point
 	)
 
 	{
-	int		ipt;
-
 	nPoint = 0;
 
 	/* Make sure Depiction Sampler has been started up */
@@ -665,15 +655,11 @@ int		fpa_sampler_point
 
 	/* Construct query request */
 	qtype = SAMPQueryCode(SAMP_POINT);
-	(void) sprintf(query,"%d:", npt);
-	for (ipt=0; ipt<npt; ipt++)
-		{
-		(void) sprintf(query+strlen(query), " '%s' '%s'", lats[ipt], lons[ipt]);
-		}
+	(void) pair_query(npt, lats, lons);
 
 	/* Send the message to the Depiction Sampler and get the reply */
-	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,query);
-	status = query_server(chid,qtype,query,&rtype,&reply,TOnormal);
+	if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,lquery);
+	status = query_server(chid,qtype,lquery,&rtype,&reply,TOnormal);
 	if (status < 0)
 		{
 		/* Problem with communications - disconnect */
@@ -685,17 +671,7 @@ int		fpa_sampler_point
 	/* Interpret the reply */
 	if (SAMPReply(rtype) != SAMP_VALID) return FAILURE;
 
-	nPoint = npt;
-	if (lats == Lats && lons == Lons) return nPoint;
-	FREELIST(Lats, nPoint);
-	FREELIST(Lons, nPoint);
-	Lats = GETMEM(Lats, STRING, nField);
-	Lons = GETMEM(Lons, STRING, nField);
-	for (ipt=0; ipt<npt; ipt++)
-		{
-		Lats[ipt] = strdup(lats[ipt]);
-		Lons[ipt] = strdup(lons[ipt]);
-		}
+	save_point(npt, lats, lons);
 	return nPoint;
 	}
 
@@ -736,6 +712,7 @@ int		fpa_sampler_add_point
 	Lons = GETMEM(Lons, STRING, nPoint);
 	Lats[nPoint-1] = strdup(lat);
 	Lons[nPoint-1] = strdup(lon);
+	mPoint = nPoint;
 
 	return fpa_sampler_point(nPoint, Lats, Lons);
 	}
@@ -756,8 +733,6 @@ int		fpa_sampler_add_point
 int		fpa_sampler_evaluate(void)
 
 	{
-	int		nval, ival;
-
 	/* Clean out the current value buffer */
 	FREELIST(Value, nValue);
 	nValue = 0;
@@ -782,21 +757,128 @@ int		fpa_sampler_evaluate(void)
 
 	/* Interpret the reply */
 	if (SAMPReply(rtype) != SAMP_VALID) return FAILURE;
+	return save_values(reply);
+	}
 
-	/* Check number of values */
-	nval = int_arg(reply,&valid);
-	if (nval != nTplus*nField*nPoint) return FAILURE;
+/***********************************************************************
+*                                                                      *
+*     f p a _ s a m p l e r _ s a m p l e                              *
+*                                                                      *
+***********************************************************************/
 
-	/* Allocate value buffer */
-	nValue = nval;
-	Value  = GETMEM(Value,STRING,nValue);
-	if (reply[0] == ':') reply[0] = ' ';
-	for (ival=0; ival<nValue; ival++)
+/*********************************************************************/
+/** Instruct the Depiction Sampler Program to evaluate the FPA data
+ * for the current source and run-time at the given prog-times,
+ * fields and points.
+ *
+ * This does the work of fpa_sampler_tplus(), fpa_sampler_field(),
+ * fpa_sampler_point() and fpa_sampler_evaluate() together, sending
+ * all four requests before waiting for the replies, so that a batch
+ * of samples costs one exchange with the Depiction Sampler Program.
+ * The values are retrieved with fpa_sampler_get_value().
+ *
+ *	@param[in]	nprog		Number of progs
+ *	@param[in]	*progs		List of prog times
+ *	@param[in]	nfld		Number of fields
+ *	@param[in] 	*elems		List of element names
+ *	@param[in] 	*levels		List of level names
+ *	@param[in]	npt			Number of points
+ *	@param[in] 	*lats		List of Lats
+ *	@param[in] 	*lons		List of Lons
+ * 	@return Either the total number of values, or failure.
+ *********************************************************************/
+int		fpa_sampler_sample
+
+	(
+	int				nprog,
+	const int		*progs,
+	int				nfld,
+	const STRING	*elems,
+	const STRING	*levels,
+	int				npt,
+	const STRING	*lats,
+	const STRING	*lons
+	)
+
+	{
+	int		iq;
+	STRING	qtext;
+	LOGICAL	ok;
+
+	static	const	SAMPQUERY	Queries[] =
+		{ SAMP_TPLUS, SAMP_FIELD, SAMP_POINT, SAMP_EVALUATE };
+	static	const	int			NumQueries = sizeof(Queries)/sizeof(SAMPQUERY);
+
+	/* Clean out the current lists and value buffer */
+	FREELIST(Value, nValue);
+	nValue = 0;
+	nTplus = 0;
+	nField = 0;
+	nPoint = 0;
+
+	/* Make sure Depiction Sampler has been started up */
+	if (chid < 0) return PROBLEM;
+
+	/* Return if no prog times, fields or points */
+	if (!progs || !elems || !levels || !lats || !lons) return PROBLEM;
+
+	/* Send all the query requests ... */
+	for (iq=0; iq<NumQueries; iq++)
 		{
-		Value[ival] = strdup_arg(reply);
+		qtype = SAMPQueryCode(Queries[iq]);
+		switch (Queries[iq])
+			{
+			case SAMP_TPLUS:	qtext = tplus_query(nprog, progs);
+								break;
+			case SAMP_FIELD:	qtext = pair_query(nfld, elems, levels);
+								break;
+			case SAMP_POINT:	qtext = pair_query(npt, lats, lons);
+								break;
+			default:			(void) sprintf(query," ");
+								qtext = query;
+								break;
+			}
+
+		if (debug) (void) printf(" Sending query: %d '%s'\n",qtype,qtext);
+		status = send_server(chid,qtype,qtext);
+		if (status < 0)
+			{
+			/* Problem with communications - disconnect */
+			status = fpa_sampler_disconnect();
+			return PROBLEM;
+			}
 		}
 
-	return nval;
+	/* ... then collect the replies (in the same order) */
+	ok = TRUE;
+	for (iq=0; iq<NumQueries; iq++)
+		{
+		status = receive_server(chid,&rtype,&reply,
+								(Queries[iq] == SAMP_EVALUATE)? TOlong: TOnormal);
+		if (status < 0)
+			{
+			/* Problem with communications - disconnect */
+			status = fpa_sampler_disconnect();
+			return PROBLEM;
+			}
+		if (debug) (void) printf("Received reply: %d '%s'\n",rtype,reply);
+
+		/* Interpret the reply */
+		if (SAMPReply(rtype) != SAMP_VALID) ok = FALSE;
+		if (!ok) continue;
+		switch (Queries[iq])
+			{
+			case SAMP_TPLUS:	save_tplus(nprog, progs);
+								break;
+			case SAMP_FIELD:	save_field(nfld, elems, levels);
+								break;
+			case SAMP_POINT:	save_point(npt, lats, lons);
+								break;
+			default:			break;
+			}
+		}
+	if (!ok) return FAILURE;
+	return save_values(reply);
 	}
 
 /***********************************************************************
@@ -841,3 +923,187 @@ STRING	fpa_sampler_get_value
 
 	return Value[ichart];
 	}
+
+/***********************************************************************
+*                                                                      *
+*     t p l u s _ q u e r y                                            *
+*     p a i r _ q u e r y                                              *
+*                                                                      *
+*     Construct list query requests in the list query buffer, which    *
+*     is enlarged as needed for long lists.                            *
+*                                                                      *
+***********************************************************************/
+
+static	STRING	tplus_query
+
+	(
+	int			nprog,
+	const int	*progs
+	)
+
+	{
+	int		iprog;
+	size_t	nc, size;
+
+	/* Make sure the query buffer is big enough */
+	size = 16 + 12*MAX(nprog, 0);
+	if (size > lqsize)
+		{
+		lqsize = size;
+		lquery = GETMEM(lquery, char, lqsize);
+		}
+
+	nc = sprintf(lquery,"%d:", nprog);
+	for (iprog=0; iprog<nprog; iprog++)
+		{
+		nc += sprintf(lquery+nc, " %d", progs[iprog]);
+		}
+	return lquery;
+	}
+
+/**********************************************************************/
+
+static	STRING	pair_query
+
+	(
+	int				num,
+	const STRING	*alist,
+	const STRING	*blist
+	)
+
+	{
+	int		i;
+	size_t	nc, size;
+
+	/* Make sure the query buffer is big enough */
+	size = 16;
+	for (i=0; i<num; i++)
+		{
+		size += strlen(SafeStr(alist[i])) + strlen(SafeStr(blist[i])) + 6;
+		}
+	if (size > lqsize)
+		{
+		lqsize = size;
+		lquery = GETMEM(lquery, char, lqsize);
+		}
+
+	nc = sprintf(lquery,"%d:", num);
+	for (i=0; i<num; i++)
+		{
+		nc += sprintf(lquery+nc, " '%s' '%s'",
+						SafeStr(alist[i]), SafeStr(blist[i]));
+		}
+	return lquery;
+	}
+
+/***********************************************************************
+*                                                                      *
+*     s a v e _ t p l u s                                              *
+*     s a v e _ f i e l d                                              *
+*     s a v e _ p o i n t                                              *
+*     s a v e _ v a l u e s                                            *
+*                                                                      *
+*     Keep the lists accepted by the Depiction Sampler Program, and    *
+*     the values it returns.                                           *
+*                                                                      *
+***********************************************************************/
+
+static	void	save_tplus
+
+	(
+	int			nprog,
+	const int	*progs
+	)
+
+	{
+	int		iprog;
+
+	nTplus = nprog;
+	if (progs == Tplus) return;
+	Tplus  = GETMEM(Tplus, int, nTplus);
+	for (iprog=0; iprog<nprog; iprog++)
+		{
+		Tplus[iprog] = progs[iprog];
+		}
+	}
+
+/**********************************************************************/
+
+static	void	save_field
+
+	(
+	int				nfld,
+	const STRING	*elems,
+	const STRING	*levels
+	)
+
+	{
+	int		ifld;
+
+	nField = nfld;
+	if (elems == Elem && levels == Level) return;
+	FREELIST(Elem,  mField);
+	FREELIST(Level, mField);
+	mField = nField;
+	Elem   = GETMEM(Elem,  STRING, mField);
+	Level  = GETMEM(Level, STRING, mField);
+	for (ifld=0; ifld<nfld; ifld++)
+		{
+		Elem[ifld]  = strdup(elems[ifld]);
+		Level[ifld] = strdup(levels[ifld]);
+		}
+	}
+
+/**********************************************************************/
+
+static	void	save_point
+
+	(
+	int				npt,
+	const STRING	*lats,
+	const STRING	*lons
+	)
+
+	{
+	int		ipt;
+
+	nPoint = npt;
+	if (lats == Lats && lons == Lons) return;
+	FREELIST(Lats, mPoint);
+	FREELIST(Lons, mPoint);
+	mPoint = nPoint;
+	Lats   = GETMEM(Lats, STRING, mPoint);
+	Lons   = GETMEM(Lons, STRING, mPoint);
+	for (ipt=0; ipt<npt; ipt++)
+		{
+		Lats[ipt] = strdup(lats[ipt]);
+		Lons[ipt] = strdup(lons[ipt]);
+		}
+	}
+
+/**********************************************************************/
+
+static	int		save_values
+
+	(
+	STRING	vreply
+	)
+
+	{
+	int		nval, ival;
+
+	/* Check number of values */
+	nval = int_arg(vreply,&valid);
+	if (nval != nTplus*nField*nPoint) return FAILURE;
+
+	/* Allocate value buffer */
+	nValue = nval;
+	Value  = GETMEM(Value,STRING,nValue);
+	if (vreply[0] == ':') vreply[0] = ' ';
+	for (ival=0; ival<nValue; ival++)
+		{
+		Value[ival] = strdup_arg(vreply);
+		}
+
+	return nval;
+	}
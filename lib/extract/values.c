@@ -645,9 +645,9 @@ LOGICAL				extract_areaset_attribs
 	FLD_DESCRIPT			descript;
 	FpaConfigFieldStruct	*fdef;
 	SET						areas;
-	LOGICAL					valid;
-	SUBAREA					sub;
-	CAL						cal;
+	LOGICAL					*valid;
+	SUBAREA					sub, *subs;
+	CAL						cal, *acals;
 
 	/* List of CAL structs duplicated from unique subareas */
 	static	CAL		*SaveCals = NullCalPtr;
@@ -736,13 +736,19 @@ LOGICAL				extract_areaset_attribs
 		return FALSE;
 		}
 
+	/* Extract parameters from first enclosing subarea in areaset field */
+	/*  ... for all positions at once                                  */
+	valid = INITMEM(LOGICAL, npos);
+	subs  = INITMEM(SUBAREA, npos);
+	acals = INITMEM(CAL,     npos);
+	(void) eval_areaset_points(areas, npos, ppos, PickFirst, valid, subs, acals);
+
 	/* Loop through all positions and extract areaset values */
 	for ( ipos=0; ipos<npos; ipos++ )
 		{
-
-		/* Extract parameters from first enclosing subarea in areaset field */
-		valid = eval_areaset(areas, ppos[ipos], PickFirst, &sub, &cal);
-		if ( !valid ) continue;
+		if ( !valid[ipos] ) continue;
+		sub = subs[ipos];
+		cal = acals[ipos];
 
 		/* Find if this subarea (Null is background) is already in */
 		/* the internal list - if not, add it */
@@ -762,6 +768,9 @@ LOGICAL				extract_areaset_attribs
 		/* Set pointer in return list */
 		cals[ipos] = SaveCals[isave];
 		}
+	FREEMEM(valid);
+	FREEMEM(subs);
+	FREEMEM(acals);
 
 	/* Free space used by SET Object */
 	areas = destroy_set(areas);
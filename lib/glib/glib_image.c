@@ -80,6 +80,40 @@ static int      raster_queue_max = 0;
 static int      raster_queue_len = 0;
 static ImagePtr *raster_queue    = NULL;
 
+/* Polar radar lookup tables. For each pixel of a display raster the table
+ * holds the offset of the (theta,range) element of the source data that maps
+ * into it, so that the raster is built without any trigonometry. A table
+ * only depends on the radar geometry and the display transform, so it stays
+ * valid from one radar scan to the next until the display changes. The runs
+ * of pixels in each row are those found by affine_run().
+ */
+typedef struct {
+	float         inv[6];        /* inverse affine from display to source */
+	int           dw, dh;        /* display raster size */
+	int           ow, oh;        /* source image size */
+	int           range, theta;  /* number of range and theta bins */
+	float         rscale;        /* range bin size */
+	float         tscale;        /* theta bin size */
+	int           *x0, *x1;      /* run of pixels in each display row */
+	int           *row;          /* start of each display row in index */
+	int           *index;        /* source element of each pixel (-1 if none) */
+	LOGICAL       filled;        /* has the index been worked out? */
+	unsigned long used;          /* when the table was last used */
+} POLAR_MAP;
+
+/* Lookup tables kept in memory. The least recently used is replaced when
+ * the list is full, except that while a synthetic image is being created
+ * the tables used for it are kept and the list grows instead, so that a
+ * composite of many radars keeps a table for each of them.
+ */
+#define MAX_POLAR_MAPS 64
+static int           npolar_maps  = 0;
+static int           mpolar_maps  = 0;
+static POLAR_MAP     **polar_maps = NULL;
+static unsigned long polar_used   = 0;
+static unsigned long polar_pass   = 0;
+static int           polar_pinned = 0;
+
 
 /* Brigntness settings for image types. Note that if the list of image
  * types changes in glib_private.h this will have to change as well.
@@ -106,10 +140,14 @@ static void    affine_run            (int*,int*,const int,const int,const int,co
 static void    blend_image           (ImagePtr, const ImagePtr);
 static void    calculate_geometry    (ImagePtr);
 static void    clear_raster_queue    (void);
+static void    clear_polar_maps      (void);
 static void    combine_image         (ImagePtr, const ImagePtr);
 static void    copy_image            (ImagePtr, const ImagePtr);
 static LOGICAL create_image          (ImagePtr);
 static LOGICAL create_raster         (ImagePtr);
+static POLAR_MAP *get_polar_map      (ImagePtr, const float affine[6], LOGICAL);
+static void    prepare_polar_maps    (ImagePtr);
+static void    release_polar_maps    (void);
 static void    remove_store_file     (ImagePtr);
 static STRING  file_encode_base64    (FILE*);
 static float   get_brightness_factor (ImagePtr);
@@ -273,6 +311,9 @@ void glImageDestroyAll( void )
 	/* Free reprojected image working directory list */
 	_xgl_free_reprojection_data();
 
+	/* Free polar radar lookup tables */
+	clear_polar_maps();
+
 	/* Remove all image files */
 	(void) snprintf(pid, 32, "^i%d-", getpid());
 	nlist = dirlist(Xgl.work_directory, pid, &list);
@@ -2504,6 +2545,7 @@ static LOGICAL create_blended_image( ImagePtr im )
 		im->changed = TRUE;
 	}
 
+	prepare_polar_maps(im);
 	for( n = 0; n < im->info.synth->nsrc; n++ )
 	{
 		imf = im->info.synth->src[n];
@@ -2521,6 +2563,7 @@ static LOGICAL create_blended_image( ImagePtr im )
 			count++;
 		}
 	}
+	release_polar_maps();
 
 	if(count > 0 && write_store_file(im))
 		im->changed = FALSE;
@@ -2544,6 +2587,7 @@ static LOGICAL create_combined_image( ImagePtr im )
 		im->changed = TRUE;
 	}
 
+	prepare_polar_maps(im);
 	for( n = 0; n < im->info.synth->nsrc; n++ )
 	{
 		imf = im->info.synth->src[n];
@@ -2554,6 +2598,7 @@ static LOGICAL create_combined_image( ImagePtr im )
 			count++;
 		}
 	}
+	release_polar_maps();
 
 	if(count > 0 && write_store_file(im))
 		im->changed = FALSE;
@@ -2814,6 +2859,223 @@ static int lutcmp(const void *a1, const void *a2)
 
 
 
+/* Work out the source element for each pixel of a polar radar lookup table.
+ * The source position is found exactly as it always has been, so the table
+ * gives the same raster as the direct calculation.
+ */
+static void fill_polar_map(POLAR_MAP *map)
+{
+	int   x, y, radius, theta, *ip;
+	float dx, dy, dist, bear, offset;
+
+	offset = map->range * map->rscale;
+	for (y = 0; y < map->dh; y++)
+	{
+		ip = map->index + map->row[y];
+		for (x = map->x0[y]; x < map->x1[y]; x++, ip++)
+		{
+			dx = x * map->inv[0] + y * map->inv[2] + map->inv[4] - offset;
+			dy = x * map->inv[1] + y * map->inv[3] + map->inv[5] - offset;
+			if(fabsf(dx) < 0.000001)
+			{
+				dist = fabsf(dy);
+				bear = (dy<0)? 180.:0.;
+			}
+			else if(dx < 0)
+			{
+				dist = SQRT(dx*dx + dy*dy);
+				bear = 270. - ATAN(-dy/dx)*180./M_PI;
+			}
+			else
+			{
+				dist = SQRT(dx*dx + dy*dy);
+				bear = 90. - ATAN(-dy/dx)*180./M_PI;
+			}
+			*ip    = -1;
+			radius = (int)floorf(dist/map->rscale + .5);
+			if(radius < map->range)
+			{
+				theta = (int)floorf(bear/map->tscale + .5) % map->theta;
+				*ip   = (theta * map->range) + radius;
+			}
+		}
+	}
+	map->filled = TRUE;
+}
+
+
+/* Worker job to fill one of a list of polar radar lookup tables.
+ */
+static void fill_polar_map_job(int job, int worker, POINTER data)
+{
+	fill_polar_map(((POLAR_MAP **)data)[job]);
+}
+
+
+/* Free all of the polar radar lookup tables.
+ */
+static void clear_polar_maps(void)
+{
+	int n;
+
+	for(n = 0; n < npolar_maps; n++)
+	{
+		FREEMEM(polar_maps[n]->x0);
+		FREEMEM(polar_maps[n]->x1);
+		FREEMEM(polar_maps[n]->row);
+		FREEMEM(polar_maps[n]->index);
+		FREEMEM(polar_maps[n]);
+	}
+	FREEMEM(polar_maps);
+	npolar_maps  = 0;
+	mpolar_maps  = 0;
+	polar_pinned = 0;
+}
+
+
+/* Find the polar radar lookup table for the given image and display transform.
+ * If there is none a new table is set up, replacing the least recently used
+ * one if need be (but never one in use for the synthetic image being
+ * created). The new table is only filled in if fill is TRUE, so that the
+ * caller may fill a number of them at the same time.
+ */
+static POLAR_MAP *get_polar_map(ImagePtr im, const float affine[6], LOGICAL fill)
+{
+	int       n, y, nold, nindex;
+	float     inv[6];
+	POLAR_MAP *map;
+
+	invert_affine(inv, affine);
+
+	for(n = 0; n < npolar_maps; n++)
+	{
+		map = polar_maps[n];
+		if(memcmp((void *)map->inv, (void *)inv, sizeof(inv)) != 0) continue;
+		if(map->dw != im->dw || map->dh != im->dh)                    continue;
+		if(map->ow != im->ow || map->oh != im->oh)                    continue;
+		if(map->range  != im->info.radar->range)                      continue;
+		if(map->theta  != im->info.radar->theta)                      continue;
+		if(map->rscale != im->info.radar->rscale)                     continue;
+		if(map->tscale != im->info.radar->tscale)                     continue;
+		map->used = ++polar_used;
+		if(fill && !map->filled) fill_polar_map(map);
+		return map;
+	}
+
+	/* Replace the least recently used table if the list is full */
+	map = NULL;
+	if(npolar_maps >= MAX_POLAR_MAPS)
+	{
+		for(nold = 0, n = 1; n < npolar_maps; n++)
+		{
+			if(polar_maps[n]->used < polar_maps[nold]->used) nold = n;
+		}
+		if(polar_pinned <= 0 || polar_maps[nold]->used <= polar_pass)
+		{
+			map = polar_maps[nold];
+			FREEMEM(map->x0);
+			FREEMEM(map->x1);
+			FREEMEM(map->row);
+			FREEMEM(map->index);
+		}
+	}
+
+	/* Otherwise add a new table */
+	if(!map)
+	{
+		if(npolar_maps >= mpolar_maps)
+		{
+			mpolar_maps = MAX(mpolar_maps*2, MAX_POLAR_MAPS);
+			polar_maps  = GETMEM(polar_maps, POLAR_MAP *, mpolar_maps);
+		}
+		map = INITMEM(POLAR_MAP, 1);
+		polar_maps[npolar_maps++] = map;
+	}
+
+	(void) memcpy((void *)map->inv, (void *)inv, sizeof(inv));
+	map->dw     = im->dw;
+	map->dh     = im->dh;
+	map->ow     = im->ow;
+	map->oh     = im->oh;
+	map->range  = im->info.radar->range;
+	map->theta  = im->info.radar->theta;
+	map->rscale = im->info.radar->rscale;
+	map->tscale = im->info.radar->tscale;
+	map->filled = FALSE;
+	map->used   = ++polar_used;
+
+	/* The runs are cheap to find so are done here */
+	map->x0  = INITMEM(int, map->dh);
+	map->x1  = INITMEM(int, map->dh);
+	map->row = INITMEM(int, map->dh);
+	for(nindex = 0, y = 0; y < map->dh; y++)
+	{
+		map->x0[y] = 0;
+		map->x1[y] = map->dw;
+		affine_run(&map->x0[y], &map->x1[y], y, map->ow, map->oh, inv);
+		if(map->x1[y] < map->x0[y]) map->x1[y] = map->x0[y];
+		map->row[y] = nindex;
+		nindex += map->x1[y] - map->x0[y];
+	}
+	map->index = INITMEM(int, MAX(nindex,1));
+
+	if(fill) fill_polar_map(map);
+	return map;
+}
+
+
+/* A synthetic image may hold many polar radars, such as a national radar
+ * composite. Set up the lookup tables of any polar radar that will need to
+ * be generated and fill the new ones on the worker threads, one radar to a
+ * job, before the images are created one by one. The tables used are kept
+ * until release_polar_maps() is called once the images are done.
+ */
+static void prepare_polar_maps(ImagePtr im)
+{
+	int       n, m, nmap;
+	float     coef[6];
+	ImagePtr  imf;
+	POLAR_MAP *map, **maps;
+
+	/* Synthetic images may be nested, so the tables are kept from the
+	 * start of the outermost one
+	 */
+	if(polar_pinned++ <= 0) polar_pass = polar_used;
+
+	if(im->info.synth->nsrc <= 0) return;
+
+	maps = INITMEM(POLAR_MAP *, im->info.synth->nsrc);
+	for(nmap = 0, n = 0; n < im->info.synth->nsrc; n++)
+	{
+		imf = im->info.synth->src[n];
+		if(!imf || imf->type != FileImage || imf->raster)                    continue;
+		if(imf->group != RadarGroup || imf->encoding != ImageEncodingPolarURP) continue;
+		if(IsNull(imf->info.radar))                                          continue;
+		if(imf->opstat == ImageNotVisible || imf->opstat == ImageOnDisk)     continue;
+
+		_xgl_affine_coef(coef, imf->sx, imf->sy, imf->ra, imf->tx, imf->ty );
+		map = get_polar_map(imf, coef, FALSE);
+		if(map->filled) continue;
+
+		/* Radars with the same geometry share a table, filled only once */
+		for(m = 0; m < nmap; m++) if(maps[m] == map) break;
+		if(m >= nmap) maps[nmap++] = map;
+	}
+	if(nmap > 0) (void) run_worker_jobs(nmap, fill_polar_map_job, (POINTER) maps);
+	FREEMEM(maps);
+}
+
+
+/* The polar radar lookup tables used for a synthetic image may be replaced
+ * again once the image has been created.
+ */
+static void release_polar_maps(void)
+{
+	if(polar_pinned > 0) polar_pinned--;
+}
+
+
+
 /*  Affine transform source RGB image. If there is colour mapping to be done we do it
  *  here as it saves another run through the raster.
  *
@@ -2847,19 +3109,28 @@ static int lutcmp(const void *a1, const void *a2)
 static void transform_image( ImagePtr im, const UNCHAR *src, const UNCHAR *mask, 
 								const int src_width, const int src_height, const float affine[6])
 {
-	int     x, y, src_x, src_y, run_x0, run_x1, radius, theta, pos_p;
+	int     x, y, src_x, src_y, run_x0, run_x1, pos_p;
 	int     src_rowstride, dst_rowstride;
-	float   dx, dy, inv[6], dist, bear, offset;
+	float   dx, dy, inv[6];
 	glCOLOR cmap[256];
 	UNCHAR  *dst_p, *dst_linestart;
 	const UNCHAR *src_p;
 
 	float bfactor = get_brightness_factor(im);
 
-	/* Polar radar images are a special case
+	/* Polar radar images are a special case. The source element for each
+	 * pixel comes from the lookup table for this radar and display.
 	 */
 	if(im->group == RadarGroup && im->encoding == ImageEncodingPolarURP)
 	{
+		int       *ip;
+		POLAR_MAP *map;
+
+		map = get_polar_map(im, affine, TRUE);
+
+		dst_rowstride = im->dw * RASTER_BPP;
+		dst_linestart = im->raster;
+
 		if(im->rast_fmt == FloatType)
 		{
 			float      val, *farray;
@@ -2868,45 +3139,18 @@ static void transform_image( ImagePtr im, const UNCHAR *src, const UNCHAR *mask,
 
 			if(!get_data_lut(im, &dlut, &nluts, bfactor)) return;
 
-			invert_affine(inv, affine);
-
-			dst_rowstride = im->dw * RASTER_BPP;
-			dst_linestart = im->raster;
-
 			lutsize = sizeof(glLUTCOLOR);
-			offset  = im->info.radar->range * im->info.radar->rscale;
 			farray  = (float *)src;
 
 			for (y = 0; y < im->dh; y++)
 			{
-				run_x0 = 0;
-				run_x1 = im->dw;
-				affine_run (&run_x0, &run_x1, y, src_width, src_height, inv);
-				dst_p = dst_linestart + run_x0 * RASTER_BPP;
-				for (x = run_x0; x < run_x1; x++)
+				ip    = map->index + map->row[y];
+				dst_p = dst_linestart + map->x0[y] * RASTER_BPP;
+				for (x = map->x0[y]; x < map->x1[y]; x++, ip++)
 				{
-					dx = x * inv[0] + y * inv[2] + inv[4] - offset;
-					dy = x * inv[1] + y * inv[3] + inv[5] - offset;
-					if(fabsf(dx) < 0.000001)
-					{
-						dist = fabsf(dy);
-						bear = (dy<0)? 180.:0.;
-					}
-					else if(dx < 0)
-					{
-						dist = SQRT(dx*dx + dy*dy);
-						bear = 270. - ATAN(-dy/dx)*180./M_PI;
-					}
-					else
-					{
-						dist = SQRT(dx*dx + dy*dy);
-						bear = 90. - ATAN(-dy/dx)*180./M_PI;
-					}
-					radius = (int)floorf(dist/im->info.radar->rscale + .5);
-					if(radius < im->info.radar->range)
+					if(*ip >= 0)
 					{
-						theta  = (int)floorf(bear/im->info.radar->tscale + .5) % im->info.radar->theta;
-						val = farray[(theta * im->info.radar->range) + radius];
+						val = farray[*ip];
 						lptr = (glLUTCOLOR *)bsearch((void*)&val,(void*)dlut,nluts,lutsize,lutcmp);
 						if(lptr)
 						{
@@ -2923,45 +3167,18 @@ static void transform_image( ImagePtr im, const UNCHAR *src, const UNCHAR *mask,
 		}
 		else
 		{
-			invert_affine(inv, affine);
-
-			dst_rowstride = im->dw * RASTER_BPP;
-			dst_linestart = im->raster;
-
 			_xgl_get_image_cmap(im, cmap);
 			scale_cmap_brightness(cmap, bfactor);
 
-			offset = im->info.radar->range * im->info.radar->rscale;
 			for (y = 0; y < im->dh; y++)
 			{
-				run_x0 = 0;
-				run_x1 = im->dw;
-				affine_run (&run_x0, &run_x1, y, src_width, src_height, inv);
-				dst_p = dst_linestart + run_x0 * RASTER_BPP;
-				for (x = run_x0; x < run_x1; x++)
+				ip    = map->index + map->row[y];
+				dst_p = dst_linestart + map->x0[y] * RASTER_BPP;
+				for (x = map->x0[y]; x < map->x1[y]; x++, ip++)
 				{
-					dx = x * inv[0] + y * inv[2] + inv[4] - offset;
-					dy = x * inv[1] + y * inv[3] + inv[5] - offset;
-					if(fabsf(dx) < 0.000001)
-					{
-						dist = fabsf(dy);
-						bear = (dy<0)? 180.:0.;
-					}
-					else if(dx < 0)
-					{
-						dist = SQRT(dx*dx + dy*dy);
-						bear = 270. - ATAN(-dy/dx)*180./M_PI;
-					}
-					else
-					{
-						dist = SQRT(dx*dx + dy*dy);
-						bear = 90. - ATAN(-dy/dx)*180./M_PI;
-					}
-					radius = (int)floorf(dist/im->info.radar->rscale + .5);
-					if(radius < im->info.radar->range)
+					if(*ip >= 0)
 					{
-						theta  = (int)floorf(bear/im->info.radar->tscale + .5) % im->info.radar->theta;
-						src_p = src + (theta * im->info.radar->range) + radius;
+						src_p = src + *ip;
 						dst_p[0] = cmap[*src_p].red;
 						dst_p[1] = cmap[*src_p].green;
 						dst_p[2] = cmap[*src_p].blue;
@@ -38,6 +38,33 @@ static int     nwdlist = 0;
 static STRING *wdlist  = NULL;
 
 
+/* A reprojection map gives, for each pixel of a target raster, the source
+ * pixel that maps into it. A satellite or radar loop reprojects every frame
+ * between the same pair of projections, so the map is worked out once and
+ * each frame is then just a gather of source pixels. For bilinear maps the
+ * lower left pixel of the surrounding 2x2 block and the weights of the
+ * pixels to the right and above are kept as well.
+ */
+typedef struct {
+	MAP_PROJ      src;          /* source projection, with raster size */
+	MAP_PROJ      target;       /* target projection, with raster size */
+	LOGICAL       bilinear;     /* are the bilinear weights defined? */
+	int           npix;         /* number of target pixels */
+	int           *index;       /* nearest source pixel (-1 if none) */
+	int           *corner;      /* lower left pixel of 2x2 block (-1 if none) */
+	UNCHAR        *wx, *wy;     /* weight of right and upper pixels (of 256) */
+	unsigned long used;         /* when the map was last used */
+} REPROJ_MAP;
+
+/* Reprojection maps kept in memory. The least recently used is replaced
+ * when the list is full.
+ */
+#define MAX_REPROJ_MAPS 8
+static int           nmaps    = 0;
+static REPROJ_MAP    *maplist = NULL;
+static unsigned long mapused  = 0;
+
+
 
 /* Given a target projection, determine a set of new projection parameters
  * for a given source projection that will map into the area of the target. 
@@ -147,6 +174,179 @@ static LOGICAL define_reprojected_map_definition( MAP_PROJ *src_proj, MAP_PROJ *
 }
 
 
+/* The method used to reproject data images. This is "nearest" to use the
+ * nearest source pixel (the default) or "bilinear" to interpolate between
+ * the surrounding source pixels for continuous-valued single byte images.
+ * It is given by the FPA_IMAGE_REPROJECT environment variable or by the
+ * "Image.Reproject" advanced feature.
+ */
+static LOGICAL reproject_bilinear(void)
+{
+	STRING mode;
+
+	static int bilinear = -1;
+
+	if (bilinear < 0)
+	{
+		mode = getenv("FPA_IMAGE_REPROJECT");
+		if (blank(mode)) mode = get_feature_mode("Image.Reproject");
+
+		bilinear = FALSE;
+		if (same_ic(mode, "bilinear"))
+			bilinear = TRUE;
+		else if (!blank(mode) && !same_ic(mode, "nearest"))
+			pr_warning(ActiveModule, "Supported Image.Reproject Modes: nearest bilinear\n");
+	}
+	return (LOGICAL) bilinear;
+}
+
+
+/* Free the contents of a reprojection map.
+ */
+static void free_reprojection_map(REPROJ_MAP *map)
+{
+	FREEMEM(map->index);
+	FREEMEM(map->corner);
+	FREEMEM(map->wx);
+	FREEMEM(map->wy);
+	map->npix = 0;
+}
+
+
+/* Work out the reprojection map between the given pair of projections. This
+ * is the slow part of a reprojection, as every target pixel must be taken
+ * back into the source projection.
+ *
+ * Note that the map definition has its origin in the lower left corner while
+ * the raster is the upper left. Thus the reversal on the vertical axis.
+ */
+static void build_reprojection_map(REPROJ_MAP *map)
+{
+	int      ix, iy, sx, sy, bx, by, ndx, snx, sny, tnx, tny;
+	float    pux, puy, upx, upy, u, v;
+	POINT    *srcpos, *dstpos;
+	LOGICAL  *valid;
+	MAP_PROJ *src_proj    = &map->src;
+	MAP_PROJ *target_proj = &map->target;
+
+	snx = src_proj->grid.nx;
+	sny = src_proj->grid.ny;
+	tnx = target_proj->grid.nx;
+	tny = target_proj->grid.ny;
+
+	map->index = INITMEM(int, map->npix);
+	if (map->bilinear)
+	{
+		map->corner = INITMEM(int, map->npix);
+		map->wx     = INITMEM(UNCHAR, map->npix);
+		map->wy     = INITMEM(UNCHAR, map->npix);
+	}
+
+	/*  pixels per source length */
+	pux = (float)snx / src_proj->definition.xlen;
+	puy = (float)sny / src_proj->definition.ylen;
+
+	/* length per target pixel */
+	upx = target_proj->definition.xlen / (float)tnx;
+	upy = target_proj->definition.ylen / (float)tny;
+
+	/* The target positions are transformed a row at a time */
+	srcpos = INITMEM(POINT, tnx);
+	dstpos = INITMEM(POINT, tnx);
+	valid  = INITMEM(LOGICAL, tnx);
+
+	for ( iy = 0; iy < tny; iy++ )
+	{
+		ndx = (tny - iy - 1) * tnx;
+		for ( ix = 0; ix < tnx; ix++ )
+		{
+			dstpos[ix][X] = (float)ix * upx;
+			dstpos[ix][Y] = (float)iy * upy;
+		}
+		(void) pos_to_pos_array(target_proj, tnx, dstpos, src_proj, srcpos, valid);
+
+		for ( ix = 0; ix < tnx; ix++, ndx++ )
+		{
+			map->index[ndx] = -1;
+			if (map->bilinear)
+			{
+				map->corner[ndx] = -1;
+				map->wx[ndx]     = 0;
+				map->wy[ndx]     = 0;
+			}
+
+			if (!valid[ix]) continue;
+
+			sx = (int)(srcpos[ix][X] * pux);
+			sy = (int)(srcpos[ix][Y] * puy);
+			if (sx < 0 || sx >= snx || sy < 0 || sy >= sny) continue;
+			map->index[ndx] = (sny-sy-1)*snx + sx;
+			if (!map->bilinear) continue;
+
+			/* The 2x2 block of pixel centres around the source position */
+			u  = srcpos[ix][X] * pux - 0.5;
+			v  = srcpos[ix][Y] * puy - 0.5;
+			bx = (int) floor(u);
+			by = (int) floor(v);
+			if (bx < 0 || bx+1 >= snx || by < 0 || by+1 >= sny) continue;
+			map->corner[ndx] = (sny-by-1)*snx + bx;
+			map->wx[ndx]     = (UNCHAR) MIN(NINT((u - bx) * 256.), 255);
+			map->wy[ndx]     = (UNCHAR) MIN(NINT((v - by) * 256.), 255);
+		}
+	}
+
+	FREEMEM(srcpos);
+	FREEMEM(dstpos);
+	FREEMEM(valid);
+}
+
+
+/* Find the reprojection map between the given pair of projections. It may
+ * already be in memory, or else it must be worked out.
+ */
+static REPROJ_MAP *get_reprojection_map(MAP_PROJ *src_proj, MAP_PROJ *target_proj, LOGICAL bilinear)
+{
+	int        n, nold;
+	REPROJ_MAP *map;
+
+	for (n = 0; n < nmaps; n++)
+	{
+		map = maplist + n;
+		if (!LogicalAgree(map->bilinear, bilinear))          continue;
+		if (!same_map_projection(&map->src, src_proj))       continue;
+		if (!same_map_projection(&map->target, target_proj)) continue;
+		map->used = ++mapused;
+		return map;
+	}
+
+	/* Use a new slot or replace the least recently used map */
+	if (nmaps < MAX_REPROJ_MAPS)
+	{
+		if (!maplist) maplist = INITMEM(REPROJ_MAP, MAX_REPROJ_MAPS);
+		map = maplist + nmaps++;
+	}
+	else
+	{
+		for (nold = 0, n = 1; n < nmaps; n++)
+		{
+			if (maplist[n].used < maplist[nold].used) nold = n;
+		}
+		map = maplist + nold;
+		free_reprojection_map(map);
+	}
+
+	(void) memset((void *)map, 0, sizeof(REPROJ_MAP));
+	copy_map_projection(&map->src,    src_proj);
+	copy_map_projection(&map->target, target_proj);
+	map->bilinear = bilinear;
+	map->npix     = target_proj->grid.nx * target_proj->grid.ny;
+	map->used     = ++mapused;
+
+	build_reprojection_map(map);
+	return map;
+}
+
+
 /* Reproject a raster.
  *
  * For the source:
@@ -155,6 +355,7 @@ static LOGICAL define_reprojected_map_definition( MAP_PROJ *src_proj, MAP_PROJ *
  * param[in]	src_raster raster as an unsigned char array
  * param[in]	src_mask   array of size one bit per pixel of the source raster
  * param[in]	src_bpp    bytes per pixel (value between 1 and 4)
+ * param[in]	bilinear   interpolate between source pixels? (only for src_bpp 1)
  *
  * For the target:
  *
@@ -174,6 +375,8 @@ static LOGICAL define_reprojected_map_definition( MAP_PROJ *src_proj, MAP_PROJ *
  *         of NULL means that all of the source pixels are available.
  *         A target_mask of NULL means that no target mask is to be
  *         generated.
+ *      4. With bilinear interpolation a target pixel takes the nearest
+ *         source pixel if any of the surrounding pixels are masked out.
  *
  */
 static void reproject
@@ -182,6 +385,7 @@ static void reproject
 	UNCHAR *src_raster, 
 	UNCHAR *src_mask,
 	int src_bpp,
+	LOGICAL bilinear,
 	MAP_PROJ *target_proj, 
 	UNCHAR *target_pixel_init,
 	UNCHAR **target_raster, 
@@ -190,12 +394,12 @@ static void reproject
 	int    *target_mask_size
 	)
 {
-	int      ix, iy, dpx, sx, sy, size;
-	float    pux, puy, upx, upy;
-	UNCHAR   *dp, *sp, *raster;
-	POINT	 srcpos, dstpos;
-	UNCHAR   *mask = (UNCHAR*)NULL;
-	int      mask_len = 0;
+	int        n, p, c, snx, size, npix;
+	int        wx, wy, v0, v1;
+	UNCHAR     *dp, *sp, *raster;
+	UNCHAR     *mask = (UNCHAR*)NULL;
+	int        mask_len = 0;
+	REPROJ_MAP *map;
 
 	if (!target_raster) return;
 
@@ -252,53 +456,76 @@ static void reproject
 		(void) memset(mask, 0, mask_len);
 	}
 
-	/*  pixels per source length */
-	pux = (float)src_proj->grid.nx  / src_proj->definition.xlen;
-	puy = (float)src_proj->grid.ny / src_proj->definition.ylen;
+	/* Copy in whatever pixels are required from the source */
+	bilinear = (LOGICAL) (bilinear && src_bpp == 1);
+	map  = get_reprojection_map(src_proj, target_proj, bilinear);
+	npix = map->npix;
+	snx  = src_proj->grid.nx;
+	switch (src_bpp)
+	{
+		case 1:
+			for (n = 0; n < npix; n++)
+			{
+				if ((p = map->index[n]) >= 0) raster[n] = src_raster[p];
+			}
+			break;
 
-	/* length per target pixel */
-	upx = target_proj->definition.xlen / (float)target_proj->grid.nx;
-	upy = target_proj->definition.ylen / (float)target_proj->grid.ny;
+		case 2:
+			for (n = 0; n < npix; n++)
+			{
+				if ((p = map->index[n]) < 0) continue;
+				raster[2*n]   = src_raster[2*p];
+				raster[2*n+1] = src_raster[2*p+1];
+			}
+			break;
 
+		case 3:
+			for (n = 0; n < npix; n++)
+			{
+				if ((p = map->index[n]) < 0) continue;
+				raster[3*n]   = src_raster[3*p];
+				raster[3*n+1] = src_raster[3*p+1];
+				raster[3*n+2] = src_raster[3*p+2];
+			}
+			break;
 
-	/* Scan the new projected area and copy in whatever pixels
-	 * are required from the source. Note that the map definition
-	 * has its origin in the lower left corner while the raster
-	 * is the upper left. Thus the reversal on the vertical axis.
+		case 4:
+			for (n = 0; n < npix; n++)
+			{
+				if ((p = map->index[n]) < 0) continue;
+				raster[4*n]   = src_raster[4*p];
+				raster[4*n+1] = src_raster[4*p+1];
+				raster[4*n+2] = src_raster[4*p+2];
+				raster[4*n+3] = src_raster[4*p+3];
+			}
+			break;
+	}
+
+	/* Replace the nearest pixel with the bilinear interpolation wherever the
+	 * surrounding pixels are all available. The pixel above the lower left
+	 * one is the previous raster row.
 	 */
-	for ( iy = 0; iy < target_proj->grid.ny; iy++ )
+	if (bilinear)
 	{
-		int ndx = (target_proj->grid.ny - iy - 1) * target_proj->grid.nx;
-		dpx = ndx * src_bpp;
-		dstpos[Y] = (float)iy * upy;
+		for (n = 0; n < npix; n++)
+		{
+			if ((c = map->corner[n]) < 0) continue;
+			if (src_mask != NULL && !(MASK_BIT_SET(src_mask,c)     && MASK_BIT_SET(src_mask,c+1) &&
+			                          MASK_BIT_SET(src_mask,c-snx) && MASK_BIT_SET(src_mask,c-snx+1))) continue;
+			wx = map->wx[n];
+			wy = map->wy[n];
+			v0 = (256-wx) * src_raster[c]     + wx * src_raster[c+1];
+			v1 = (256-wx) * src_raster[c-snx] + wx * src_raster[c-snx+1];
+			raster[n] = (UNCHAR) (((256-wy) * v0 + wy * v1 + 32768) >> 16);
+		}
+	}
 
-		for ( ix = 0; ix < target_proj->grid.nx; ix++ )
+	if (mask != NULL)
+	{
+		for (n = 0; n < npix; n++)
 		{
-			dstpos[X] = (float)ix * upx;
-			if (pos_to_pos(target_proj,dstpos,src_proj,srcpos))
-			{
-				sx = (int)(srcpos[X] * pux);
-				sy = (int)(srcpos[Y] * puy);
-				if (sx >= 0 && sx < src_proj->grid.nx && sy >= 0 && sy < src_proj->grid.ny)
-				{
-					int p = ((src_proj->grid.ny-sy-1)*src_proj->grid.nx + sx);
-					dp  = raster + dpx;
-					sp  = src_raster + p * src_bpp;
-					switch (src_bpp)
-					{
-						case 4: *dp++ = *sp++;
-						case 3: *dp++ = *sp++;
-						case 2: *dp++ = *sp++;
-						case 1: *dp++ = *sp++;
-					}
-					if (mask != NULL && (src_mask == NULL || MASK_BIT_SET(src_mask,p)))
-					{
-						p = ndx + ix;
-						SET_MASK_BIT(mask,p);
-					}
-				}
-			}
-			dpx += src_bpp;
+			if ((p = map->index[n]) < 0) continue;
+			if (src_mask == NULL || MASK_BIT_SET(src_mask,p)) SET_MASK_BIT(mask,n);
 		}
 	}
 
@@ -455,18 +682,18 @@ static LOGICAL reproject_image( ImagePtr im, MAP_PROJ *target_proj)
 			if(im->group == DataGroup)
 			{
 				bpp = im->info.grid->bpp;
-				reproject(&im->mproj_org, src_raster, src_mask, bpp, &new, NULL, &raster, NULL, &mask, &mask_size);
+				reproject(&im->mproj_org, src_raster, src_mask, bpp, reproject_bilinear(), &new, NULL, &raster, NULL, &mask, &mask_size);
 			}
 			else if(im->bands == TripleBand)
 			{
 				UNCHAR pixel_init[] = {T_RED, T_GREEN, T_BLUE};
 				bpp = TripleBand;
-				reproject(&im->mproj_org, src_raster, src_mask, bpp, &new, pixel_init, &raster, NULL, NULL, NULL);
+				reproject(&im->mproj_org, src_raster, src_mask, bpp, FALSE, &new, pixel_init, &raster, NULL, NULL, NULL);
 			}
 			else
 			{
 				bpp = im->bands;
-				reproject(&im->mproj_org, src_raster, src_mask, bpp, &new, NULL, &raster, NULL, &mask, &mask_size);
+				reproject(&im->mproj_org, src_raster, src_mask, bpp, FALSE, &new, NULL, &raster, NULL, &mask, &mask_size);
 			}
 			FREEMEM(src_raster);
 			FREEMEM(src_mask);
@@ -621,6 +848,13 @@ LOGICAL _xgl_rpg_raster(ImagePtr im, UNCHAR **raster, UNCHAR **mask)
 
 void _xgl_free_reprojection_data(void)
 {
+	int n;
+
 	FREELIST(wdlist, nwdlist);
 	nwdlist = 0;
+
+	for (n = 0; n < nmaps; n++)
+		free_reprojection_map(maplist + n);
+	FREEMEM(maplist);
+	nmaps = 0;
 }
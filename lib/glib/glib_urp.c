@@ -69,6 +69,66 @@ static STRING mygetline( FILE *fp, STRING line, int ncl, LOGICAL *pound_start)
 }
 
 
+/* Convert the AsciiFloat value at the start of the given string. A radar
+ * scan holds range*theta of these, so the usual case of a plain decimal
+ * number of no more than 15 digits is done here directly. The mantissa and
+ * the power of ten are then both exact as doubles and the result is rounded
+ * only once, exactly as strtod() would do it. Anything else is passed on to
+ * strtod(). As with strtod() end is set to ptr if there is no value.
+ */
+static float ascii_float(STRING ptr, STRING *end)
+{
+	int     nd, ex, ev;
+	double  val;
+	LOGICAL neg, eneg;
+	STRING  s, t;
+
+	static const double ptens[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	s = ptr;
+	while (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r') s++;
+
+	neg = (LOGICAL) (*s == '-');
+	if (*s == '-' || *s == '+') s++;
+
+	val = 0.0;
+	nd  = 0;
+	ex  = 0;
+	for ( ; *s >= '0' && *s <= '9'; s++, nd++) val = val * 10.0 + (*s - '0');
+	if (*s == 'x' || *s == 'X') return (float) strtod(ptr, end);
+	if (*s == '.')
+	{
+		for (s++; *s >= '0' && *s <= '9'; s++, nd++, ex--) val = val * 10.0 + (*s - '0');
+	}
+	if (nd == 0 || nd > 15) return (float) strtod(ptr, end);
+
+	/* An exponent only counts if it has digits */
+	if (*s == 'e' || *s == 'E')
+	{
+		t    = s + 1;
+		eneg = (LOGICAL) (*t == '-');
+		if (*t == '-' || *t == '+') t++;
+		if (*t >= '0' && *t <= '9')
+		{
+			for (ev = 0; *t >= '0' && *t <= '9'; t++)
+			{
+				if (ev < 1000) ev = ev * 10 + (*t - '0');
+			}
+			ex += (eneg)? -ev: ev;
+			s   = t;
+		}
+	}
+	if (ex < -22 || ex > 22) return (float) strtod(ptr, end);
+
+	val = (ex < 0)? val / ptens[-ex]: val * ptens[ex];
+	*end = s;
+	return (float) ((neg)? -val: val);
+}
+
+
 static enum IMAGE_ENCODING urp_file_type(STRING fname)
 {
 	char   buf[51];
@@ -611,7 +671,7 @@ LOGICAL _xgl_get_polar_urp_raster(ImagePtr im, UNCHAR **rast)
 	}
 	errstr = nodata;
 	if (!ptr) goto err5;
-	raster = MEM(UNCHAR, size);
+	raster = MEM(UNCHAR, size+1);
 	errstr = nomem;
 	if (!raster) goto err5;
 	/*
@@ -621,6 +681,9 @@ LOGICAL _xgl_get_polar_urp_raster(ImagePtr im, UNCHAR **rast)
 	errstr = noread;
 	if(fread(raster, 1, (size_t) size, fp) != (size_t) size) goto err5;
 
+	/* Terminate so that an AsciiFloat parse cannot run off the end */
+	raster[size] = '\0';
+
 	/* If the elements are ascii float then the raster will need to be
 	 * parsed into an array of float values and the raster will then
 	 * be set to this array.
@@ -637,13 +700,18 @@ LOGICAL _xgl_get_polar_urp_raster(ImagePtr im, UNCHAR **rast)
 		ptr = (STRING)raster;
 		for( n = 0; n < size; n++ )
 		{
-			array[n] = (float)strtod(ptr, &s);
+			array[n] = ascii_float(ptr, &s);
 			if(s == ptr)
 			{
 				array[n] = 0.0;
 				break;
 			}
-			p = strchr(ptr,',');
+			if (*s == ',')
+			{
+				ptr = s + 1;
+				continue;
+			}
+			p = strchr(s,',');
 			if (!p) break;
 			ptr = p + 1;
 		}
@@ -45,6 +45,102 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Spatial index of an area set (see area_set_index()):                */
+/*  - bounding boxes of each area and subarea, with an R-tree of the    */
+/*    area boxes, to find the areas that might contain a point          */
+/*  - cell grids over each boundary, built once an area or subarea has  */
+/*    been tested often, to settle most point tests without walking     */
+/*    the boundary                                                      */
+#define IndexFanout	8	/* children per R-tree node */
+#define GridTests	16	/* full point tests before building a cell grid */
+#define GridMinSide	4	/* smallest number of cells on each side */
+#define GridMaxSide	64	/* largest number of cells on each side */
+
+/* Cell status in a cell grid */
+#define CellFree	0	/* not yet classified */
+#define CellEdge	1	/* boundary passes through (or near) cell */
+#define CellInside	2	/* whole cell is inside */
+#define CellOutside	3	/* whole cell is outside */
+
+typedef	struct
+	{
+	BOX		box;		/* extent of grid */
+	int		nx, ny;		/* number of cells */
+	float	dx, dy;		/* size of each cell */
+	char	*cells;		/* status of each cell */
+	} AGRID;
+
+typedef	struct
+	{
+	LOGICAL	empty;		/* no points to test against? */
+	BOX		box;		/* bounding box of all points */
+	int		ntest;		/* number of full point tests so far */
+	AGRID	*grid;		/* cell grid (built after GridTests tests) */
+	} AENTRY;
+
+typedef	struct
+	{
+	AREA	area;		/* area in set */
+	unsigned long	sig;	/* signature of area boundary, holes and divides */
+	AENTRY	bound;		/* entry for boundary (and holes and divides) */
+	SUBAREA	*subareas;	/* subarea list for subarea entries */
+	int		nsub;		/* number of subarea entries */
+	unsigned long	ssig;	/* signature of subarea segments */
+	AENTRY	*subs;		/* entries for each subarea */
+	} AINDEX;
+
+typedef	struct
+	{
+	BOX		box;		/* bounding box of children */
+	LOGICAL	leaf;		/* children are areas rather than nodes? */
+	int		first;		/* first child in list of references */
+	int		num;		/* number of children */
+	} ANODE;
+
+typedef	struct
+	{
+	ITEM	*list;		/* area list when index was built */
+	int		num;		/* number of areas when index was built */
+	long	stamp;		/* line edit stamp when index was built */
+	float	tol;		/* tolerance for distances to boxes */
+	AINDEX	*areas;		/* index entries for each area */
+	ANODE	*nodes;		/* R-tree nodes */
+	int		nnode;
+	int		*refs;		/* children of R-tree nodes */
+	int		nref;
+	int		root;		/* root node (-1 if no boxes) */
+	} SINDEX;
+
+typedef	struct
+	{
+	float	x, y;		/* centre of box */
+	int		id;			/* area or node */
+	} STRITEM;
+
+static	SINDEX	*area_set_index(SET, LOGICAL *);
+static	SINDEX	*build_set_index(SET);
+static	LOGICAL	valid_set_index(SINDEX *, SET);
+static	void	build_set_rtree(SINDEX *);
+static	int		str_xcmp(const void *, const void *);
+static	int		str_ycmp(const void *, const void *);
+static	void	search_set_rtree(SINDEX *, int, POINT, int *, int *);
+static	int		area_candidates(SET, SINDEX *, POINT, int *);
+static	unsigned long	area_signature(AREA);
+static	unsigned long	subarea_signature(AREA);
+static	void	add_box_points(BOX *, LOGICAL *, POINT *, int);
+static	int		subarea_ring(SUBAREA, POINT **);
+static	AENTRY	*subarea_entries(AINDEX *, AREA, LOGICAL);
+static	void	free_area_entries(AINDEX *);
+static	LOGICAL	area_encloses(AREA, AENTRY *, POINT, LOGICAL);
+static	LOGICAL	subarea_encloses(SUBAREA, AENTRY *, POINT, LOGICAL);
+static	AGRID	*build_grid(const BOX *, int, POINT **, int *, AREA, SUBAREA);
+static	AGRID	*free_grid(AGRID *);
+static	int		grid_cell(AGRID *, POINT);
+static	float	box_distance(const BOX *, POINT);
+static	SUBAREA	find_subarea(SET, SINDEX *, LOGICAL, int *, POINT, PICK,
+						float *, LOGICAL *, AREA *);
+static	LOGICAL	subarea_value(SET, SUBAREA, SUBAREA *, ATTRIB_LIST *);
+
 static	LOGICAL	pick_better(PICK, float, float);
 static	LOGICAL	pick_better
 	(
@@ -66,6 +162,7 @@ static	LOGICAL	pick_better
 /***********************************************************************
 *                                                                      *
 *     e v a l _ a r e a s e t                                          *
+*     e v a l _ a r e a s e t _ p o i n t s                            *
 *     e v a l _ a r e a s e t _ l i s t   (You free the lists)         *
 *                                                                      *
 ***********************************************************************/
@@ -92,7 +189,6 @@ LOGICAL	eval_areaset
 
 	{
 	SUBAREA	a;
-	AREA b;
 
 	/* Set to reasonable default values */
 	if (sub)  *sub = NullSubArea;
@@ -102,25 +198,74 @@ LOGICAL	eval_areaset
 
 	/* Find the first enclosing subarea */
 	a = enclosing_subarea(set, pos, mode, NullFloat, NullChar, NullAreaPtr);
-	if (NotNull(a) && NotNull(a->attrib))
+	return subarea_value(set, a, sub, att);
+	}
+
+/**********************************************************************/
+
+/***********************************************************************/
+/**	Evaluate area set at a list of points.
+ *
+ * This gives the same results as calling eval_areaset() for each
+ * point, but the spatial index of the set is only checked once.
+ *
+ * @param[in]	set		area set to search.
+ * @param[in]	npos	number of points.
+ * @param[in]	*ppos	list of points to search for.
+ * @param[in]	mode	pick/order mode.
+ * @param[out]	*valid	is there a value at each point?
+ * @param[out]	*subs	first subarea containing each point.
+ * @param[out]	*atts	attributes for subarea containing each point.
+ * @return Number of points with a value.
+ ***********************************************************************/
+int		eval_areaset_points
+
+	(
+	SET			set,
+	int			npos,
+	POINT		*ppos,
+	PICK		mode,
+	LOGICAL		*valid,
+	SUBAREA		*subs,
+	ATTRIB_LIST	*atts
+	)
+
+	{
+	int			ipos, nvalid, *cand;
+	LOGICAL		grow, ok;
+	SUBAREA		a, *sub;
+	ATTRIB_LIST	*att;
+	SINDEX		*si;
+
+	/* Set to reasonable default values */
+	for (ipos=0; ipos<npos; ipos++)
 		{
-		if (sub) *sub = a;
-		if (att) *att = a->attrib;
-		return TRUE;
+		if (valid) valid[ipos] = FALSE;
+		if (subs)  subs[ipos]  = NullSubArea;
+		if (atts)  atts[ipos]  = NullAttribList;
 		}
+	if (!set)   return 0;
+	if (!ppos)  return 0;
 
-	/* If not found, get background value */
-	b = (AREA) set->bgnd;
-	if (NotNull(b) && NotNull(b->attrib))
+	/* Check the spatial index once for all the points */
+	si   = area_set_index(set, &grow);
+	cand = (set->num > 0)? INITMEM(int, set->num): NullInt;
+
+	for (nvalid=0, ipos=0; ipos<npos; ipos++)
 		{
-		/* Null area indicates background */
-		if (sub) *sub = NullSubArea;
-		if (att) *att = b->attrib;
-		return TRUE;
+		sub = (subs)? subs + ipos: NullSubAreaList;
+		att = (atts)? atts + ipos: NullAttribListPtr;
+		a   = NullSubArea;
+		if (set->num > 0)
+			a = find_subarea(set, si, grow, cand, ppos[ipos], mode,
+						NullFloat, NullChar, NullAreaPtr);
+		ok  = subarea_value(set, a, sub, att);
+		if (valid) valid[ipos] = ok;
+		if (ok)    nvalid++;
 		}
 
-	/* No enclosing areas and no background */
-	return FALSE;
+	FREEMEM(cand);
+	return nvalid;
 	}
 
 /**********************************************************************/
@@ -224,6 +369,8 @@ AREA	closest_area
 	int		iarea;
 	AREA	area;
 	POINT	q;
+	LOGICAL	grow;
+	SINDEX	*si;
 
 	AREA	BestArea = NullArea;
 	float	BestDist = -1;
@@ -244,8 +391,19 @@ AREA	closest_area
 	if (set->num <= 0) return NullArea;
 
 	/* Examine all areas in the mosaic */
+	si = area_set_index(set, &grow);
 	for (iarea=0; iarea<set->num; iarea++)
 		{
+		/* Skip areas that cannot be closer than the closest so far */
+		/* (a negative best distance can never be replaced) */
+		if (si && BestArea)
+			{
+			if (BestDist < 0) break;
+			if (si->areas[iarea].bound.empty) continue;
+			if (box_distance(&si->areas[iarea].bound.box, p)
+					> 1.01*BestDist + si->tol) continue;
+			}
+
 		area = (AREA) set->list[iarea];
 		MemTyp = area_closest_feature(area, p, &Dist, q, &Member, &Span);
 		if ((!BestArea) || ((Dist >= 0) && (Dist < BestDist)))
@@ -294,10 +452,10 @@ AREA	enclosing_area
 	)
 
 	{
-	int		iarea;
-	float	dist;
-	LOGICAL	inside;
+	int		iarea, ic, nc, *cand;
+	LOGICAL	grow;
 	AREA	area;
+	SINDEX	*si;
 
 	AREA	BestArea = NullArea;
 	float	BestSize = -1;
@@ -313,13 +471,17 @@ AREA	enclosing_area
 	if (!set)          return NullArea;
 	if (set->num <= 0) return NullArea;
 
-	/* Examine all areas in the set until one is found */
-	for (iarea=0; iarea<set->num; iarea++)
+	/* Examine all areas in the set that might contain the point */
+	/* until one is found */
+	si   = area_set_index(set, &grow);
+	cand = INITMEM(int, set->num);
+	nc   = area_candidates(set, si, p, cand);
+	for (ic=0; ic<nc; ic++)
 		{
-		area = (AREA) set->list[iarea];
-		area_test_point(area, p, &dist, NullPoint, NULL, NullInt,
-						NullInt, &inside);
-		if (!inside && dist != 0.0) continue;
+		iarea = cand[ic];
+		area  = (AREA) set->list[iarea];
+		if (!area_encloses(area, (si)? &si->areas[iarea].bound: NULL, p, grow))
+			continue;
 
 		area_properties(area, &Clock, &Size, NullFloat);
 		if ((!BestArea) || pick_better(mode, BestSize, Size))
@@ -328,9 +490,10 @@ AREA	enclosing_area
 			BestSize = Size;
 			if (size)  *size  = Size;
 			if (cwise) *cwise = Clock;
-			if (mode == PickFirst) return BestArea;
+			if (mode == PickFirst) break;
 			}
 		}
+	FREEMEM(cand);
 
 	/* Return the smallest enclosing area */
 	return BestArea;
@@ -360,10 +523,10 @@ int		enclosing_area_list
 	)
 
 	{
-	int		iarea;
-	float	dist;
-	LOGICAL	inside;
+	int		iarea, ic, nc, *cand;
+	LOGICAL	grow;
 	AREA	area;
+	SINDEX	*si;
 
 	AREA	*List = NullAreaList;
 	int		Num   = 0;
@@ -375,13 +538,16 @@ int		enclosing_area_list
 	if (!p)   return -1;
 	if (!set) return -1;
 
-	/* Examine all areas in the set */
-	for (iarea=0; iarea<set->num; iarea++)
+	/* Examine all areas in the set that might contain the point */
+	si   = area_set_index(set, &grow);
+	cand = (set->num > 0)? INITMEM(int, set->num): NullInt;
+	nc   = (set->num > 0)? area_candidates(set, si, p, cand): 0;
+	for (ic=0; ic<nc; ic++)
 		{
-		area = (AREA) set->list[iarea];
-		area_test_point(area, p, &dist, NullPoint, NULL, NullInt,
-						NullInt, &inside);
-		if (!inside && dist != 0.0) continue;
+		iarea = cand[ic];
+		area  = (AREA) set->list[iarea];
+		if (!area_encloses(area, (si)? &si->areas[iarea].bound: NULL, p, grow))
+			continue;
 
 		Num++;
 		if (list)
@@ -390,6 +556,7 @@ int		enclosing_area_list
 			List[Num-1] = area;
 			}
 		}
+	FREEMEM(cand);
 
 	/* Reorder according to given mode */
 	if (list && Num>0 && mode!=PickFirst)
@@ -580,61 +747,27 @@ SUBAREA	enclosing_subarea
 	)
 
 	{
-	int		iarea, isub, nsub;
-	float	dist;
-	LOGICAL	inside;
-	AREA	area;
+	int		*cand;
+	LOGICAL	grow;
 	SUBAREA	sub;
-
-	AREA	BestArea = NullArea;
-	SUBAREA	BestSub  = NullSubArea;
-	float	BestSize = -1;
-	float	Size;
-	LOGICAL	Clock;
+	SINDEX	*si;
 
 	/* Set to reasonable default values */
 	if (size)   *size   = -1;
 	if (cwise)  *cwise  = FALSE;
-	if (parent) *parent = BestArea;
+	if (parent) *parent = NullArea;
 
 	/* Return if mosaic doesn't exist */
 	if (!p)            return NullSubArea;
 	if (!set)          return NullSubArea;
 	if (set->num <= 0) return NullSubArea;
 
-	/* Examine all areas in the set until one is found */
-	for (iarea=0; iarea<set->num; iarea++)
-		{
-		area = (AREA) set->list[iarea];
-		area_test_point(area, p, &dist, NullPoint, NULL, NullInt,
-						NullInt, &inside);
-		if (!inside && dist != 0.0) continue;
-
-		build_area_subareas(area);
-		nsub = area->numdiv + 1;
-		for (isub=0; isub<nsub; isub++)
-			{
-			sub = area->subareas[isub];
-			subarea_test_point(sub, p, &dist, NullPoint, NullInt, NullInt,
-								&inside);
-			if (!inside && dist != 0.0) continue;
-
-			subarea_properties(sub, &Clock, &Size, NullFloat);
-			if ((!BestSub) || pick_better(mode, BestSize, Size))
-				{
-				BestArea = area;
-				BestSub  = sub;
-				BestSize = Size;
-				if (size)   *size   = Size;
-				if (cwise)  *cwise  = Clock;
-				if (parent) *parent = BestArea;
-				if (mode == PickFirst) return BestSub;
-				}
-			}
-		}
-
-	/* Return smallest subarea */
-	return BestSub;
+	/* Examine the areas that might contain the point */
+	si   = area_set_index(set, &grow);
+	cand = INITMEM(int, set->num);
+	sub  = find_subarea(set, si, grow, cand, p, mode, size, cwise, parent);
+	FREEMEM(cand);
+	return sub;
 	}
 
 /**********************************************************************/
@@ -661,11 +794,12 @@ int		enclosing_subarea_list
 	)
 
 	{
-	int		iarea, isub, nsub;
-	float	dist;
-	LOGICAL	inside;
+	int		iarea, isub, nsub, ic, nc, *cand;
+	LOGICAL	grow;
 	AREA	area;
 	SUBAREA	sub;
+	SINDEX	*si;
+	AENTRY	*subs;
 
 	SUBAREA	*List = NullSubAreaList;
 	int		Num   = 0;
@@ -677,22 +811,25 @@ int		enclosing_subarea_list
 	if (!p)   return -1;
 	if (!set) return -1;
 
-	/* Examine all areas in the set */
-	for (iarea=0; iarea<set->num; iarea++)
+	/* Examine all areas in the set that might contain the point */
+	si   = area_set_index(set, &grow);
+	cand = (set->num > 0)? INITMEM(int, set->num): NullInt;
+	nc   = (set->num > 0)? area_candidates(set, si, p, cand): 0;
+	for (ic=0; ic<nc; ic++)
 		{
-		area = (AREA) set->list[iarea];
-		area_test_point(area, p, &dist, NullPoint, NULL, NullInt,
-						NullInt, &inside);
-		if (!inside && dist != 0.0) continue;
+		iarea = cand[ic];
+		area  = (AREA) set->list[iarea];
+		if (!area_encloses(area, (si)? &si->areas[iarea].bound: NULL, p, grow))
+			continue;
 
 		build_area_subareas(area);
+		subs = (si)? subarea_entries(&si->areas[iarea], area, grow): NULL;
 		nsub = area->numdiv + 1;
 		for (isub=0; isub<nsub; isub++)
 			{
 			sub = area->subareas[isub];
-			subarea_test_point(sub, p, &dist, NullPoint, NullInt, NullInt,
-								&inside);
-			if (!inside && dist != 0.0) continue;
+			if (!subarea_encloses(sub, (subs)? subs+isub: NULL, p, grow))
+				continue;
 
 			Num++;
 			if (list)
@@ -702,6 +839,7 @@ int		enclosing_subarea_list
 				}
 			}
 		}
+	FREEMEM(cand);
 
 	/* Reorder according to given mode */
 	if (list && Num>0 && mode!=PickFirst)
@@ -809,3 +947,1006 @@ LOGICAL	reorder_areas
 	FREEMEM(sortlist);
 	return TRUE;
 	}
+
+/***********************************************************************
+*                                                                      *
+*      f r e e _ s e t _ i n d e x                                     *
+*                                                                      *
+***********************************************************************/
+
+/***********************************************************************/
+/**	Free the spatial index of the given set, if one has been built.
+ *
+ * The index is built again the next time it is needed.  It is checked
+ * against the set before each use, so this is only needed to release
+ * the memory.
+ *
+ * @param[in]	set		set to free the index of.
+ ***********************************************************************/
+void	free_set_index
+
+	(
+	SET		set
+	)
+
+	{
+	int		iarea;
+	SINDEX	*si;
+
+	if (!set)         return;
+	if (!set->sindex) return;
+
+	si = (SINDEX *) set->sindex;
+	for (iarea=0; iarea<si->num; iarea++)
+		{
+		(void) free_grid(si->areas[iarea].bound.grid);
+		free_area_entries(&si->areas[iarea]);
+		}
+	FREEMEM(si->areas);
+	FREEMEM(si->nodes);
+	FREEMEM(si->refs);
+	FREEMEM(si);
+	set->sindex = NullPointer;
+	}
+
+/***********************************************************************
+*                                                                      *
+*    STATIC (LOCAL) ROUTINES:                                          *
+*                                                                      *
+***********************************************************************/
+
+/***********************************************************************
+*                                                                      *
+*      a r e a _ s e t _ i n d e x                                     *
+*      b u i l d _ s e t _ i n d e x                                   *
+*      v a l i d _ s e t _ i n d e x                                   *
+*                                                                      *
+*      Return the spatial index of the given area set, building it     *
+*      first if the set or any of its areas has changed since it was   *
+*      last built.                                                     *
+*                                                                      *
+*      Jobs running on worker threads may share the set, so they only  *
+*      use an index that is already up to date, and do not add to it.  *
+*                                                                      *
+***********************************************************************/
+
+static	SINDEX	*area_set_index
+
+	(
+	SET		set,
+	LOGICAL	*grow	/* can index be added to? */
+	)
+
+	{
+	SINDEX	*si;
+
+	*grow = FALSE;
+	if (!set)                      return NULL;
+	if (set->num <= 0)             return NULL;
+	if (!same(set->type, "area"))  return NULL;
+
+	si = (SINDEX *) set->sindex;
+	*grow = (LOGICAL) !in_worker_thread();
+	if (si && valid_set_index(si, set)) return si;
+	if (!*grow) return NULL;
+
+	free_set_index(set);
+	si = build_set_index(set);
+	set->sindex = (POINTER) si;
+	return si;
+	}
+
+/**********************************************************************/
+
+static	SINDEX	*build_set_index
+
+	(
+	SET		set
+	)
+
+	{
+	int		iarea, ihole, idiv;
+	float	big;
+	AREA	area;
+	AENTRY	*ae;
+	SINDEX	*si;
+
+	si = INITMEM(SINDEX, 1);
+	si->list  = set->list;
+	si->num   = set->num;
+	si->stamp = line_edit_stamp();
+	si->areas = INITMEM(AINDEX, set->num);
+	si->nodes = NullPtr(ANODE *);
+	si->nnode = 0;
+	si->refs  = NullInt;
+	si->nref  = 0;
+	si->root  = -1;
+
+	/* Box each area around its boundary, holes and divides */
+	big = 0;
+	for (iarea=0; iarea<set->num; iarea++)
+		{
+		area = (AREA) set->list[iarea];
+		si->areas[iarea].area     = area;
+		si->areas[iarea].sig      = area_signature(area);
+		si->areas[iarea].subareas = NullSubAreaList;
+		si->areas[iarea].nsub     = 0;
+		si->areas[iarea].ssig     = 0;
+		si->areas[iarea].subs     = NullPtr(AENTRY *);
+
+		ae = &si->areas[iarea].bound;
+		ae->empty = TRUE;
+		ae->ntest = 0;
+		ae->grid  = NullPtr(AGRID *);
+		if (!area) continue;
+		if (area->bound)
+			{
+			if (area->bound->boundary)
+				add_box_points(&ae->box, &ae->empty,
+						area->bound->boundary->points,
+						area->bound->boundary->numpts);
+			for (ihole=0; ihole<area->bound->numhole; ihole++)
+				{
+				if (!area->bound->holes[ihole]) continue;
+				add_box_points(&ae->box, &ae->empty,
+						area->bound->holes[ihole]->points,
+						area->bound->holes[ihole]->numpts);
+				}
+			}
+		for (idiv=0; idiv<area->numdiv; idiv++)
+			{
+			if (!area->divlines[idiv]) continue;
+			add_box_points(&ae->box, &ae->empty,
+					area->divlines[idiv]->points,
+					area->divlines[idiv]->numpts);
+			}
+		if (ae->empty) continue;
+		big = MAX(big, fabs(ae->box.left));
+		big = MAX(big, fabs(ae->box.right));
+		big = MAX(big, fabs(ae->box.bottom));
+		big = MAX(big, fabs(ae->box.top));
+		}
+
+	/* Distances measured from the boundaries may be slightly less */
+	/* than those measured from the boxes, due to round-off */
+	si->tol = 1e-5*big + 1e-4;
+
+	build_set_rtree(si);
+	return si;
+	}
+
+/**********************************************************************/
+
+static	LOGICAL	valid_set_index
+
+	(
+	SINDEX	*si,
+	SET		set
+	)
+
+	{
+	int		iarea;
+	AREA	area;
+
+	if (si->list  != set->list)          return FALSE;
+	if (si->num   != set->num)           return FALSE;
+	if (si->stamp != line_edit_stamp())  return FALSE;
+
+	/* Check for areas that were replaced or given new lines */
+	for (iarea=0; iarea<set->num; iarea++)
+		{
+		area = (AREA) set->list[iarea];
+		if (area != si->areas[iarea].area)             return FALSE;
+		if (area_signature(area) != si->areas[iarea].sig) return FALSE;
+		}
+	return TRUE;
+	}
+
+/***********************************************************************
+*                                                                      *
+*      b u i l d _ s e t _ r t r e e                                   *
+*      s e a r c h _ s e t _ r t r e e                                 *
+*      a r e a _ c a n d i d a t e s                                   *
+*                                                                      *
+*      Pack the area boxes into an R-tree, one level at a time, by     *
+*      sorting the boxes into vertical slices by their x centres, and  *
+*      then grouping them within each slice by their y centres         *
+*      (Sort-Tile-Recursive packing).                                  *
+*                                                                      *
+***********************************************************************/
+
+static	void	build_set_rtree
+
+	(
+	SINDEX	*si
+	)
+
+	{
+	int		iarea, n, nnext, ngroup, nslice, nper, lo, hi, ic, nc, jc;
+	LOGICAL	leaf;
+	BOX		*box;
+	ANODE	*node;
+	STRITEM	*items, *next;
+
+	if (si->num <= 0) return;
+
+	/* Start with the non-empty area boxes */
+	items = INITMEM(STRITEM, si->num);
+	for (n=0, iarea=0; iarea<si->num; iarea++)
+		{
+		if (si->areas[iarea].bound.empty) continue;
+		box = &si->areas[iarea].bound.box;
+		items[n].x  = (box->left + box->right) / 2;
+		items[n].y  = (box->bottom + box->top) / 2;
+		items[n].id = iarea;
+		n++;
+		}
+
+	/* Group each level into the nodes of the next level up */
+	leaf = TRUE;
+	while (n > 0)
+		{
+		ngroup = (n + IndexFanout - 1) / IndexFanout;
+		nslice = (int) ceil(sqrt((double) ngroup));
+		nper   = nslice * IndexFanout;
+		qsort((POINTER) items, (size_t) n, sizeof(STRITEM), str_xcmp);
+
+		next  = INITMEM(STRITEM, n);
+		nnext = 0;
+		for (lo=0; lo<n; lo+=nper)
+			{
+			hi = MIN(lo+nper, n);
+			qsort((POINTER) (items+lo), (size_t) (hi-lo), sizeof(STRITEM),
+					str_ycmp);
+			for (ic=lo; ic<hi; ic+=IndexFanout)
+				{
+				nc = MIN(IndexFanout, hi-ic);
+				si->nodes = GETMEM(si->nodes, ANODE, si->nnode+1);
+				si->refs  = GETMEM(si->refs, int, si->nref+nc);
+				node = si->nodes + si->nnode;
+				node->leaf  = leaf;
+				node->first = si->nref;
+				node->num   = nc;
+				for (jc=0; jc<nc; jc++)
+					{
+					si->refs[si->nref+jc] = items[ic+jc].id;
+					box = (leaf)? &si->areas[items[ic+jc].id].bound.box:
+								  &si->nodes[items[ic+jc].id].box;
+					if (jc == 0) copy_box(&node->box, box);
+					else
+						{
+						node->box.left   = MIN(node->box.left,   box->left);
+						node->box.right  = MAX(node->box.right,  box->right);
+						node->box.bottom = MIN(node->box.bottom, box->bottom);
+						node->box.top    = MAX(node->box.top,    box->top);
+						}
+					}
+				si->nref += nc;
+
+				next[nnext].x  = (node->box.left + node->box.right) / 2;
+				next[nnext].y  = (node->box.bottom + node->box.top) / 2;
+				next[nnext].id = si->nnode++;
+				nnext++;
+				}
+			}
+
+		FREEMEM(items);
+		items = next;
+		n     = nnext;
+		leaf  = FALSE;
+		if (n == 1)
+			{
+			si->root = items[0].id;
+			break;
+			}
+		}
+	FREEMEM(items);
+	}
+
+/**********************************************************************/
+
+static	int		str_xcmp
+
+	(
+	const void	*p1,
+	const void	*p2
+	)
+
+	{
+	const STRITEM	*s1 = (const STRITEM *) p1;
+	const STRITEM	*s2 = (const STRITEM *) p2;
+
+	if (s1->x < s2->x) return -1;
+	if (s1->x > s2->x) return  1;
+	return s1->id - s2->id;
+	}
+
+/**********************************************************************/
+
+static	int		str_ycmp
+
+	(
+	const void	*p1,
+	const void	*p2
+	)
+
+	{
+	const STRITEM	*s1 = (const STRITEM *) p1;
+	const STRITEM	*s2 = (const STRITEM *) p2;
+
+	if (s1->y < s2->y) return -1;
+	if (s1->y > s2->y) return  1;
+	return s1->id - s2->id;
+	}
+
+/**********************************************************************/
+
+static	void	search_set_rtree
+
+	(
+	SINDEX	*si,
+	int		inode,
+	POINT	p,
+	int		*cand,
+	int		*ncand
+	)
+
+	{
+	int		ic, id;
+	ANODE	*node;
+
+	node = si->nodes + inode;
+	if (!inside_box(&node->box, p)) return;
+
+	for (ic=0; ic<node->num; ic++)
+		{
+		id = si->refs[node->first + ic];
+		if (!node->leaf)
+			search_set_rtree(si, id, p, cand, ncand);
+		else if (inside_box(&si->areas[id].bound.box, p))
+			cand[(*ncand)++] = id;
+		}
+	}
+
+/**********************************************************************/
+
+/* List the areas whose boxes contain the point, in set order */
+static	int		area_candidates
+
+	(
+	SET		set,
+	SINDEX	*si,
+	POINT	p,
+	int		*cand
+	)
+
+	{
+	int		nc, ic, jc, id;
+
+	/* Without an index, every area is a candidate */
+	if (!si)
+		{
+		for (ic=0; ic<set->num; ic++) cand[ic] = ic;
+		return set->num;
+		}
+
+	nc = 0;
+	if (si->root >= 0) search_set_rtree(si, si->root, p, cand, &nc);
+
+	/* Put back into set order (there are usually only a few) */
+	for (ic=1; ic<nc; ic++)
+		{
+		id = cand[ic];
+		for (jc=ic; jc>0 && cand[jc-1]>id; jc--) cand[jc] = cand[jc-1];
+		cand[jc] = id;
+		}
+	return nc;
+	}
+
+/***********************************************************************
+*                                                                      *
+*      a r e a _ s i g n a t u r e                                     *
+*      s u b a r e a _ s i g n a t u r e                               *
+*                                                                      *
+*      Summarize the lines used by an area (or its subareas), so that  *
+*      the index can tell when any of them has been replaced.  Changes *
+*      to the points of a line are caught by the line edit stamp.      *
+*                                                                      *
+***********************************************************************/
+
+#define SigMix(sig, val) ((sig)*31 + (unsigned long) (val))
+
+static	unsigned long	area_signature
+
+	(
+	AREA	area
+	)
+
+	{
+	int				i;
+	LINE			line;
+	unsigned long	sig;
+
+	sig = SigMix(0, area);
+	if (!area) return sig;
+
+	sig = SigMix(sig, area->bound);
+	if (area->bound)
+		{
+		line = area->bound->boundary;
+		sig  = SigMix(sig, line);
+		if (line) sig = SigMix(SigMix(sig, line->points), line->numpts);
+		sig  = SigMix(SigMix(sig, area->bound->holes), area->bound->numhole);
+		for (i=0; i<area->bound->numhole; i++)
+			{
+			line = area->bound->holes[i];
+			sig  = SigMix(sig, line);
+			if (line) sig = SigMix(SigMix(sig, line->points), line->numpts);
+			}
+		}
+	sig = SigMix(SigMix(sig, area->divlines), area->numdiv);
+	for (i=0; i<area->numdiv; i++)
+		{
+		line = area->divlines[i];
+		sig  = SigMix(sig, line);
+		if (line) sig = SigMix(SigMix(sig, line->points), line->numpts);
+		}
+	return sig;
+	}
+
+/**********************************************************************/
+
+static	unsigned long	subarea_signature
+
+	(
+	AREA	area
+	)
+
+	{
+	int				isub, iseg;
+	SUBAREA			sub;
+	SEGMENT			seg;
+	unsigned long	sig;
+
+	sig = SigMix(0, area->subareas);
+	if (!area->subareas) return sig;
+
+	for (isub=0; isub<=area->numdiv; isub++)
+		{
+		sub = area->subareas[isub];
+		sig = SigMix(sig, sub);
+		if (!sub) continue;
+		sig = SigMix(SigMix(sig, sub->segments), sub->numseg);
+		for (iseg=0; iseg<sub->numseg; iseg++)
+			{
+			seg = sub->segments[iseg];
+			sig = SigMix(sig, seg);
+			if (!seg) continue;
+			sig = SigMix(SigMix(SigMix(sig, seg->line), seg->ips), seg->ipe);
+			sig = SigMix(sig, seg->flags);
+			}
+		}
+	return sig;
+	}
+
+/***********************************************************************
+*                                                                      *
+*      a d d _ b o x _ p o i n t s                                     *
+*      s u b a r e a _ r i n g                                         *
+*      s u b a r e a _ e n t r i e s                                   *
+*      f r e e _ a r e a _ e n t r i e s                               *
+*                                                                      *
+***********************************************************************/
+
+static	void	add_box_points
+
+	(
+	BOX		*box,
+	LOGICAL	*empty,
+	POINT	*points,
+	int		numpts
+	)
+
+	{
+	int		ip;
+
+	for (ip=0; ip<numpts; ip++)
+		{
+		if (*empty)
+			{
+			box->left  = box->right = points[ip][X];
+			box->bottom = box->top  = points[ip][Y];
+			*empty = FALSE;
+			continue;
+			}
+		box->left   = MIN(box->left,   points[ip][X]);
+		box->right  = MAX(box->right,  points[ip][X]);
+		box->bottom = MIN(box->bottom, points[ip][Y]);
+		box->top    = MAX(box->top,    points[ip][Y]);
+		}
+	}
+
+/**********************************************************************/
+
+/* Collect the points visited by subarea_test_point(), in order */
+static	int		subarea_ring
+
+	(
+	SUBAREA	sub,
+	POINT	**ring
+	)
+
+	{
+	int		iseg, np, ip, ips, ipe, nring;
+	SEGMENT	seg;
+	LINE	line;
+
+	*ring = NullPointList;
+	nring = 0;
+	for (iseg=0; iseg<sub->numseg; iseg++)
+		{
+		seg = sub->segments[iseg];
+		if (IsNull(seg)) continue;
+		line = seg->line;
+		if (IsNull(line) || line->numpts <= 0) continue;
+
+		np  = line->numpts;
+		ips = seg->ips;
+		ipe = seg->ipe;
+		if (ipe < ips) ipe += np;
+		*ring = GETMEM(*ring, POINT, nring + ipe - ips + 1);
+		if (seg_forward(seg))
+			{
+			for (ip=ips; ip<=ipe; ip++)
+				copy_point((*ring)[nring++], line->points[ip%np]);
+			}
+		else
+			{
+			for (ip=ipe; ip>=ips; ip--)
+				copy_point((*ring)[nring++], line->points[ip%np]);
+			}
+		}
+	return nring;
+	}
+
+/**********************************************************************/
+
+static	AENTRY	*subarea_entries
+
+	(
+	AINDEX	*ai,
+	AREA	area,
+	LOGICAL	grow
+	)
+
+	{
+	int				isub, nring;
+	unsigned long	ssig;
+	POINT			*ring;
+	AENTRY			*ae;
+
+	if (!area->subareas) return NULL;
+
+	ssig = subarea_signature(area);
+	if (ai->subs && ai->subareas == area->subareas
+			&& ai->nsub == area->numdiv+1 && ai->ssig == ssig) return ai->subs;
+	if (!grow) return NULL;
+
+	/* Box each subarea around its segments */
+	free_area_entries(ai);
+	ai->subareas = area->subareas;
+	ai->nsub     = area->numdiv + 1;
+	ai->ssig     = ssig;
+	ai->subs     = INITMEM(AENTRY, ai->nsub);
+	for (isub=0; isub<ai->nsub; isub++)
+		{
+		ae = ai->subs + isub;
+		ae->empty = TRUE;
+		ae->ntest = 0;
+		ae->grid  = NullPtr(AGRID *);
+		if (!area->subareas[isub]) continue;
+		nring = subarea_ring(area->subareas[isub], &ring);
+		add_box_points(&ae->box, &ae->empty, ring, nring);
+		FREEMEM(ring);
+		}
+	return ai->subs;
+	}
+
+/**********************************************************************/
+
+static	void	free_area_entries
+
+	(
+	AINDEX	*ai
+	)
+
+	{
+	int		isub;
+
+	for (isub=0; isub<ai->nsub; isub++)
+		(void) free_grid(ai->subs[isub].grid);
+	FREEMEM(ai->subs);
+	ai->subareas = NullSubAreaList;
+	ai->nsub     = 0;
+	ai->ssig     = 0;
+	}
+
+/***********************************************************************
+*                                                                      *
+*      a r e a _ e n c l o s e s                                       *
+*      s u b a r e a _ e n c l o s e s                                 *
+*                                                                      *
+*      Does the area (or subarea) enclose the point, or is the point   *
+*      on its boundary?  The index entry (if any) is used to skip the  *
+*      full point test where it can, and is given a cell grid once it  *
+*      has needed enough full tests.                                   *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL	area_encloses
+
+	(
+	AREA	area,
+	AENTRY	*ae,
+	POINT	p,
+	LOGICAL	grow
+	)
+
+	{
+	int		ihole, nring, *nrpts;
+	float	dist;
+	LOGICAL	inside;
+	POINT	**rings;
+
+	if (ae)
+		{
+		if (ae->empty)            return FALSE;
+		if (!inside_box(&ae->box, p)) return FALSE;
+		switch (grid_cell(ae->grid, p))
+			{
+			case CellInside:	return TRUE;
+			case CellOutside:	return FALSE;
+			}
+		}
+
+	area_test_point(area, p, &dist, NullPoint, NULL, NullInt, NullInt,
+					&inside);
+
+	/* Grid the boundary and holes once the area is tested often */
+	if (ae && grow && !ae->grid && ++ae->ntest == GridTests && area->bound)
+		{
+		nring = area->bound->numhole + 1;
+		rings = INITMEM(POINT *, nring);
+		nrpts = INITMEM(int, nring);
+		get_line_points(area->bound->boundary, &rings[0], &nrpts[0], NullInt);
+		for (ihole=0; ihole<area->bound->numhole; ihole++)
+			get_line_points(area->bound->holes[ihole], &rings[ihole+1],
+					&nrpts[ihole+1], NullInt);
+		ae->grid = build_grid(&ae->box, nring, rings, nrpts, area, NullSubArea);
+		FREEMEM(rings);
+		FREEMEM(nrpts);
+		}
+
+	return (LOGICAL) (inside || dist == 0.0);
+	}
+
+/**********************************************************************/
+
+static	LOGICAL	subarea_encloses
+
+	(
+	SUBAREA	sub,
+	AENTRY	*ae,
+	POINT	p,
+	LOGICAL	grow
+	)
+
+	{
+	int		nring;
+	float	dist;
+	LOGICAL	inside;
+	POINT	*ring;
+
+	if (ae)
+		{
+		if (ae->empty)            return FALSE;
+		if (!inside_box(&ae->box, p)) return FALSE;
+		switch (grid_cell(ae->grid, p))
+			{
+			case CellInside:	return TRUE;
+			case CellOutside:	return FALSE;
+			}
+		}
+
+	subarea_test_point(sub, p, &dist, NullPoint, NullInt, NullInt, &inside);
+
+	/* Grid the subarea boundary once the subarea is tested often */
+	if (ae && grow && !ae->grid && ++ae->ntest == GridTests)
+		{
+		nring = subarea_ring(sub, &ring);
+		ae->grid = build_grid(&ae->box, 1, &ring, &nring, NullArea, sub);
+		FREEMEM(ring);
+		}
+
+	return (LOGICAL) (inside || dist == 0.0);
+	}
+
+/***********************************************************************
+*                                                                      *
+*      b u i l d _ g r i d                                             *
+*      f r e e _ g r i d                                               *
+*      g r i d _ c e l l                                               *
+*                                                                      *
+*      A cell grid covers the box around a boundary.  Each span of the *
+*      boundary (padded a little, to allow for round-off) marks the    *
+*      cells it might pass through.  Each group of connected unmarked  *
+*      cells is then wholly inside or wholly outside, which is decided *
+*      by a full point test at one cell centre.                        *
+*                                                                      *
+***********************************************************************/
+
+static	AGRID	*build_grid
+
+	(
+	const BOX	*box,
+	int			nring,	/* number of point rings */
+	POINT		**rings,/* points in each ring */
+	int			*nrpts,	/* number of points in each ring */
+	AREA		area,	/* area to test (or) */
+	SUBAREA		sub		/* subarea to test */
+	)
+
+	{
+	int		ir, ip, jp, npts, side, ncell, ic, jc, ix, iy;
+	int		ix0, ix1, iy0, iy1, nq, iq, *queue;
+	float	width, height, padx, pady, dist;
+	float	xa, ya, xb, yb;
+	LOGICAL	inside;
+	char	status;
+	POINT	pc;
+	AGRID	*grid;
+
+	width  = box->right - box->left;
+	height = box->top   - box->bottom;
+	if (width <= 0 || height <= 0) return NullPtr(AGRID *);
+
+	/* Size the grid from the number of points */
+	for (npts=0, ir=0; ir<nring; ir++) npts += nrpts[ir];
+	if (npts <= 0) return NullPtr(AGRID *);
+	side = (int) sqrt((double) (2*npts)) + 1;
+	side = MAX(side, GridMinSide);
+	side = MIN(side, GridMaxSide);
+
+	grid = INITMEM(AGRID, 1);
+	copy_box(&grid->box, box);
+	grid->nx    = side;
+	grid->ny    = side;
+	grid->dx    = width  / side;
+	grid->dy    = height / side;
+	ncell       = side * side;
+	grid->cells = INITMEM(char, ncell);
+	(void) memset(grid->cells, CellFree, (size_t) ncell);
+
+	padx = 0.01*grid->dx + 1e-5*(fabs(box->left) + fabs(box->right))  + 1e-4;
+	pady = 0.01*grid->dy + 1e-5*(fabs(box->bottom) + fabs(box->top)) + 1e-4;
+
+	/* Mark the cells crossed by each span (including the closing span) */
+	for (ir=0; ir<nring; ir++)
+		{
+		for (ip=0; ip<nrpts[ir]; ip++)
+			{
+			jp = (ip+1) % nrpts[ir];
+			xa = rings[ir][ip][X];	ya = rings[ir][ip][Y];
+			xb = rings[ir][jp][X];	yb = rings[ir][jp][Y];
+			ix0 = (int) floor((MIN(xa, xb) - padx - box->left)   / grid->dx);
+			ix1 = (int) floor((MAX(xa, xb) + padx - box->left)   / grid->dx);
+			iy0 = (int) floor((MIN(ya, yb) - pady - box->bottom) / grid->dy);
+			iy1 = (int) floor((MAX(ya, yb) + pady - box->bottom) / grid->dy);
+			ix0 = MAX(ix0, 0);	ix1 = MIN(ix1, side-1);
+			iy0 = MAX(iy0, 0);	iy1 = MIN(iy1, side-1);
+			for (iy=iy0; iy<=iy1; iy++)
+				for (ix=ix0; ix<=ix1; ix++)
+					grid->cells[iy*side + ix] = CellEdge;
+			}
+		}
+
+	/* Classify each group of connected free cells from one cell centre */
+	queue = INITMEM(int, ncell);
+	for (ic=0; ic<ncell; ic++)
+		{
+		if (grid->cells[ic] != CellFree) continue;
+
+		ix = ic % side;
+		iy = ic / side;
+		set_point(pc, box->left   + (ix + 0.5)*grid->dx,
+					  box->bottom + (iy + 0.5)*grid->dy);
+		if (area) area_test_point(area, pc, &dist, NullPoint, NULL, NullInt,
+								NullInt, &inside);
+		else      subarea_test_point(sub, pc, &dist, NullPoint, NullInt,
+								NullInt, &inside);
+		if (dist <= 0) status = CellEdge;
+		else           status = (inside)? CellInside: CellOutside;
+
+		/* Flood the group with the same status */
+		grid->cells[ic] = status;
+		queue[0] = ic;
+		for (nq=1, iq=0; iq<nq; iq++)
+			{
+			jc = queue[iq];
+			ix = jc % side;
+			iy = jc / side;
+			if (ix > 0      && grid->cells[jc-1] == CellFree)
+				{ grid->cells[jc-1] = status;    queue[nq++] = jc-1; }
+			if (ix < side-1 && grid->cells[jc+1] == CellFree)
+				{ grid->cells[jc+1] = status;    queue[nq++] = jc+1; }
+			if (iy > 0      && grid->cells[jc-side] == CellFree)
+				{ grid->cells[jc-side] = status; queue[nq++] = jc-side; }
+			if (iy < side-1 && grid->cells[jc+side] == CellFree)
+				{ grid->cells[jc+side] = status; queue[nq++] = jc+side; }
+			}
+		}
+	FREEMEM(queue);
+	return grid;
+	}
+
+/**********************************************************************/
+
+static	AGRID	*free_grid
+
+	(
+	AGRID	*grid
+	)
+
+	{
+	if (!grid) return NullPtr(AGRID *);
+	FREEMEM(grid->cells);
+	FREEMEM(grid);
+	return NullPtr(AGRID *);
+	}
+
+/**********************************************************************/
+
+static	int		grid_cell
+
+	(
+	AGRID	*grid,
+	POINT	p
+	)
+
+	{
+	float	x, y;
+
+	if (!grid) return CellEdge;
+
+	x = (p[X] - grid->box.left)   / grid->dx;
+	y = (p[Y] - grid->box.bottom) / grid->dy;
+	if (x < 0 || x >= grid->nx) return CellEdge;
+	if (y < 0 || y >= grid->ny) return CellEdge;
+	return grid->cells[(int) y * grid->nx + (int) x];
+	}
+
+/**********************************************************************/
+
+static	float	box_distance
+
+	(
+	const BOX	*box,
+	POINT		p
+	)
+
+	{
+	float	dx, dy;
+
+	dx = 0;
+	dy = 0;
+	if      (p[X] < box->left)   dx = box->left - p[X];
+	else if (p[X] > box->right)  dx = p[X] - box->right;
+	if      (p[Y] < box->bottom) dy = box->bottom - p[Y];
+	else if (p[Y] > box->top)    dy = p[Y] - box->top;
+	return (float) sqrt((double) (dx*dx + dy*dy));
+	}
+
+/***********************************************************************
+*                                                                      *
+*      f i n d _ s u b a r e a                                         *
+*      s u b a r e a _ v a l u e                                       *
+*                                                                      *
+***********************************************************************/
+
+/* Find the first enclosing subarea, as in enclosing_subarea() */
+static	SUBAREA	find_subarea
+
+	(
+	SET		set,
+	SINDEX	*si,
+	LOGICAL	grow,
+	int		*cand,
+	POINT	p,
+	PICK	mode,
+	float	*size,
+	LOGICAL	*cwise,
+	AREA	*parent
+	)
+
+	{
+	int		iarea, isub, nsub, ic, nc;
+	AREA	area;
+	SUBAREA	sub;
+	AENTRY	*subs;
+
+	AREA	BestArea = NullArea;
+	SUBAREA	BestSub  = NullSubArea;
+	float	BestSize = -1;
+	float	Size;
+	LOGICAL	Clock;
+
+	nc = area_candidates(set, si, p, cand);
+	for (ic=0; ic<nc; ic++)
+		{
+		iarea = cand[ic];
+		area  = (AREA) set->list[iarea];
+		if (!area_encloses(area, (si)? &si->areas[iarea].bound: NULL, p, grow))
+			continue;
+
+		build_area_subareas(area);
+		subs = (si)? subarea_entries(&si->areas[iarea], area, grow): NULL;
+		nsub = area->numdiv + 1;
+		for (isub=0; isub<nsub; isub++)
+			{
+			sub = area->subareas[isub];
+			if (!subarea_encloses(sub, (subs)? subs+isub: NULL, p, grow))
+				continue;
+
+			subarea_properties(sub, &Clock, &Size, NullFloat);
+			if ((!BestSub) || pick_better(mode, BestSize, Size))
+				{
+				BestArea = area;
+				BestSub  = sub;
+				BestSize = Size;
+				if (size)   *size   = Size;
+				if (cwise)  *cwise  = Clock;
+				if (parent) *parent = BestArea;
+				if (mode == PickFirst) return BestSub;
+				}
+			}
+		}
+
+	/* Return smallest subarea */
+	return BestSub;
+	}
+
+/**********************************************************************/
+
+/* Return the value of an area set for the given enclosing subarea */
+static	LOGICAL	subarea_value
+
+	(
+	SET			set,
+	SUBAREA		a,
+	SUBAREA		*sub,
+	ATTRIB_LIST	*att
+	)
+
+	{
+	AREA	b;
+
+	if (NotNull(a) && NotNull(a->attrib))
+		{
+		if (sub) *sub = a;
+		if (att) *att = a->attrib;
+		return TRUE;
+		}
+
+	/* If not found, get background value */
+	b = (AREA) set->bgnd;
+	if (NotNull(b) && NotNull(b->attrib))
+		{
+		/* Null area indicates background */
+		if (sub) *sub = NullSubArea;
+		if (att) *att = b->attrib;
+		return TRUE;
+		}
+
+	/* No enclosing areas and no background */
+	return FALSE;
+	}
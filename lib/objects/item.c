@@ -1642,6 +1642,7 @@ LOGICAL		reproject_item
 					(void) copy_point(line->points[ip], tpos);
 					}
 				}
+			touch_line(NullLine);
 			/* >>> Don't worry about visible areas yet */
 			}
 		}
@@ -1671,6 +1672,7 @@ LOGICAL		reproject_item
 			(void) pos_to_pos(smproj, line->points[ip], tmproj, tpos);
 			(void) copy_point(line->points[ip], tpos);
 			}
+		touch_line(line);
 		}
 	else if (same(type,"label"))
 		{
@@ -1780,6 +1782,7 @@ LOGICAL	offset_item
 				line->points[ip][Y] += yoff;
 				}
 			}
+		touch_line(NullLine);
 		/* >>> Don't worry about visible areas yet */
 		}
 	else if (same(type,"barb"))
@@ -1809,6 +1812,7 @@ LOGICAL	offset_item
 				line->points[ip][X] += xoff;
 				line->points[ip][Y] += yoff;
 				}
+			touch_line(line);
 			}
 		}
 	else if (same(type,"label"))
@@ -1919,6 +1923,7 @@ LOGICAL	scale_item
 				line->points[ip][Y] *= yscale;
 				}
 			}
+		touch_line(NullLine);
 		/* >>> Don't worry about visible areas yet */
 		}
 	else if (same(type,"barb"))
@@ -1948,6 +1953,7 @@ LOGICAL	scale_item
 				line->points[ip][X] *= xscale;
 				line->points[ip][Y] *= yscale;
 				}
+			touch_line(line);
 			}
 		}
 	else if (same(type,"label"))
@@ -43,6 +43,9 @@
 
 int		LineCount = 0;
 
+/* Edit stamp for line geometry (see touch_line()) */
+static	long	LineStamp = 0;
+
 /***********************************************************************
 *                                                                      *
 *      c r e a t e _ l i n e                                           *
@@ -128,6 +131,7 @@ void	empty_line
 
 	/* Zero the point counter */
 	line->numpts = 0;
+	touch_line(line);
 	}
 
 /***********************************************************************
@@ -311,6 +315,7 @@ LINE	append_line_pdir
 		(fwd)? i2++: i2--;
 		}
 
+	touch_line(l1);
 	return l1;
 	}
 
@@ -356,6 +361,7 @@ void	condense_line
 		}
 
 	line->numpts = tp;
+	touch_line(line);
 	}
 
 /***********************************************************************
@@ -390,6 +396,7 @@ void	reverse_line
 		copy_point(p[rp], p[ip]);
 		copy_point(p[ip], ptemp);
 		}
+	touch_line(line);
 	}
 
 /***********************************************************************
@@ -495,6 +502,7 @@ void	save_line_plist
 /***********************************************************************
 *                                                                      *
 *      a d d _ p o i n t _ t o _ l i n e                               *
+*      a d d _ p o i n t s _ t o _ l i n e                             *
 *                                                                      *
 ***********************************************************************/
 /*********************************************************************/
@@ -534,5 +542,96 @@ void	add_point_to_line
 		copy_point(line->points[last], p);
 		}
 
+	touch_line(line);
 	return;
 	}
+
+/*********************************************************************/
+/** Add a list of points to the end of a line.
+ *
+ *	@param[in] 	line	line to add points to
+ *	@param[in] 	*points	buffer of points to add
+ *	@param[in] 	numpts	number of points
+ *********************************************************************/
+
+void	add_points_to_line
+
+	(
+	LINE	line,
+	POINT	*points,
+	int		numpts
+	)
+
+	{
+	int		i, nnew, nn, ioff;
+	POINT	*pp;
+
+	/* Do nothing if not there */
+	if (!points) return;
+	if (!line)   return;
+	if (numpts <= 0) return;
+
+	/* Allocate more room in one go if necessary */
+	/* (protect points in case they are from the same buffer) */
+	nnew = line->numpts + numpts;
+	if (nnew > line->maxpts)
+		{
+		ioff = -1;
+		if (line->points && points >= line->points
+				&& points < line->points + line->numpts)
+			ioff = (int) (points - line->points);
+		nn = (nnew-1)%DELTA_POINTS + 1;
+		line->maxpts = nnew + DELTA_POINTS - nn;
+		line->points = GETMEM(line->points, POINT, line->maxpts);
+		if (ioff >= 0) points = line->points + ioff;
+		}
+
+	/* Copy the points onto the end of the line */
+	pp = line->points + line->numpts;
+	for (i=0; i<numpts; i++)
+		copy_point(pp[i], points[i]);
+	line->numpts = nnew;
+	touch_line(line);
+	}
+
+/***********************************************************************
+*                                                                      *
+*      t o u c h _ l i n e                                             *
+*      l i n e _ e d i t _ s t a m p                                   *
+*                                                                      *
+***********************************************************************/
+/*********************************************************************/
+/** Record that the points of the given line have been changed.
+ *
+ * Routines that move or replace line points in place call this, so
+ * that geometry cached from lines (such as the spatial index of an
+ * area set) can tell that it must be rebuilt.
+ *
+ *	@param[in] 	line	line that was changed (or NullLine for several)
+ *********************************************************************/
+
+void	touch_line
+
+	(
+	LINE	line
+	)
+
+	{
+	LineStamp++;
+	}
+
+/*********************************************************************/
+/** Return the current line edit stamp.
+ *
+ * The stamp changes whenever touch_line() is called, so a copy of it
+ * taken when cached geometry is built tells whether any line has been
+ * changed since.
+ *
+ *  @return Current line edit stamp.
+ *********************************************************************/
+
+long	line_edit_stamp(void)
+
+	{
+	return LineStamp;
+	}
@@ -84,6 +84,9 @@ void	get_line_points(LINE line, POINT **points, int *numpts, int *maxpts);
 void	get_line_plist(LINE line, POINT *pbuf, int *numpts, int *bufpts);
 void	save_line_plist(LINE line, POINT *points, int numpts);
 void	add_point_to_line(LINE line, POINT p);
+void	add_points_to_line(LINE line, POINT *points, int numpts);
+void	touch_line(LINE line);
+long	line_edit_stamp(void);
 
 /* Declare all functions in line_oper.c */
 LOGICAL	line_closed(LINE line);
@@ -1696,6 +1696,7 @@ LOGICAL	scale_line
 		line->points[ip][Y] *= sy;
 		}
 
+	touch_line(line);
 	return TRUE;
 	}
 
@@ -1728,6 +1729,7 @@ LOGICAL	translate_line
 		line->points[ip][Y] += dy;
 		}
 
+	touch_line(line);
 	return TRUE;
 	}
 
@@ -1768,6 +1770,7 @@ LOGICAL	rotate_line
 		line->points[ip][Y] = x*sa + y*ca + ref[Y];
 		}
 
+	touch_line(line);
 	return TRUE;
 	}
 
@@ -38,6 +38,19 @@
 *     in this source file.  The remaining modules are found in source  *
 *     files prefixed with "pipe_".                                     *
 *                                                                      *
+*     The state of each module is kept in a pipe context.  Each thread *
+*     uses the default context unless it has been given its own with   *
+*     set_pipe_context(), so that separate threads can run separate    *
+*     pipes at the same time.  (The upper level graphics functions     *
+*     used by the echo and disp modules are shared.)                   *
+*                                                                      *
+*     Arrays of points can also be passed along the pipe.  Modules     *
+*     that can work on a whole array at once have an array put         *
+*     function.  For the rest, the points are passed one at a time,    *
+*     and the output is collected so that it can be passed along to    *
+*     the following modules as an array.  Either way, the output is    *
+*     identical to passing each point along the pipe separately.       *
+*                                                                      *
 *     (c) Copyright 1988 Environment Canada (AES)                      *
 *     Version 8 (c) Copyright 2011 Environment Canada                  *
 *                                                                      *
@@ -57,9 +70,191 @@
 *                                                                      *
 ***********************************************************************/
 
-#define PIPE_INIT
 #include "pipeP.h"
 
+#include <tools/tools.h>
+#include <fpa_getmem.h>
+
+#include <pthread.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* Default pipe, and the pipe used by each thread */
+static	struct PIPE_CONTEXT_struct	DefaultPipe;
+static	pthread_once_t				PipeOnce = PTHREAD_ONCE_INIT;
+static	pthread_key_t				PipeKey;
+
+static	void	init_pipe_context(PIPE_CONTEXT);
+static	void	pipe_once_init(void);
+static	double	pipe_clock(void);
+
+/***********************************************************************
+*                                                                      *
+*     c r e a t e _ p i p e _ c o n t e x t                            *
+*     d e s t r o y _ p i p e _ c o n t e x t                          *
+*     s e t _ p i p e _ c o n t e x t                                  *
+*     g e t _ p i p e _ c o n t e x t                                  *
+*                                                                      *
+***********************************************************************/
+
+/**********************************************************************/
+/** Create a new pipe context, with all modules disabled.
+ *
+ *	@return	The new pipe context.  You will need to destroy this
+ * 			object when you are finished with it.
+ **********************************************************************/
+PIPE_CONTEXT	create_pipe_context(void)
+
+	{
+	PIPE_CONTEXT	ctx;
+
+	/* Start from the same (empty) state as the default pipe */
+	ctx = INITMEM(struct PIPE_CONTEXT_struct, 1);
+	(void) memset((POINTER) ctx, 0, sizeof(struct PIPE_CONTEXT_struct));
+	init_pipe_context(ctx);
+	return ctx;
+	}
+
+/**********************************************************************/
+/** Destroy a pipe context and the buffers held by its modules.
+ *
+ * The context must not be in use by any thread.
+ *
+ *	@param[in]	ctx	pipe context to destroy
+ *	@return	NullPtr
+ **********************************************************************/
+PIPE_CONTEXT	destroy_pipe_context
+
+	(
+	PIPE_CONTEXT	ctx
+	)
+
+	{
+	pnode	*p;
+
+	if (!ctx)               return NullPtr(PIPE_CONTEXT);
+	if (ctx == &DefaultPipe) return NullPtr(PIPE_CONTEXT);
+
+	for (p=&ctx->Npipe; p<=&ctx->Nmeta; p++)
+		FREEMEM(p->out);
+	ctx_clean_buffer(ctx);
+	ctx_clean_spline(ctx);
+	ctx_clean_meta(ctx);
+	while (ctx->save.istack > 0)
+		{
+		ctx_clean_save(ctx);
+		ctx->save.istack--;
+		}
+	ctx_clean_save(ctx);
+	FREEMEM(ctx);
+	return NullPtr(PIPE_CONTEXT);
+	}
+
+/**********************************************************************/
+/** Use the given pipe context for all pipe calls made by the calling
+ * thread.
+ *
+ *	@param[in]	ctx	pipe context (NULL for the default context)
+ *	@return	The pipe context previously used by this thread (NULL
+ * 			for the default context).
+ **********************************************************************/
+PIPE_CONTEXT	set_pipe_context
+
+	(
+	PIPE_CONTEXT	ctx
+	)
+
+	{
+	PIPE_CONTEXT	prev;
+
+	(void) pthread_once(&PipeOnce, pipe_once_init);
+	prev = (PIPE_CONTEXT) pthread_getspecific(PipeKey);
+	if (ctx == &DefaultPipe) ctx = NullPtr(PIPE_CONTEXT);
+	(void) pthread_setspecific(PipeKey, (POINTER) ctx);
+	return prev;
+	}
+
+/**********************************************************************/
+/** Get the pipe context used by the calling thread.
+ *
+ *	@return	The pipe context used by this thread (NULL for the
+ * 			default context).
+ **********************************************************************/
+PIPE_CONTEXT	get_pipe_context(void)
+
+	{
+	(void) pthread_once(&PipeOnce, pipe_once_init);
+	return (PIPE_CONTEXT) pthread_getspecific(PipeKey);
+	}
+
+/* Pipe context to be used by the calling thread */
+PIPE_CONTEXT	current_pipe(void)
+
+	{
+	PIPE_CONTEXT	ctx;
+
+	(void) pthread_once(&PipeOnce, pipe_once_init);
+	ctx = (PIPE_CONTEXT) pthread_getspecific(PipeKey);
+	return (ctx)? ctx: &DefaultPipe;
+	}
+
+/**********************************************************************/
+
+static	void	pipe_once_init(void)
+
+	{
+	(void) pthread_key_create(&PipeKey, NULL);
+	init_pipe_context(&DefaultPipe);
+	}
+
+/* Set up the initial pipe connections */
+static	void	set_pnode(pnode *p, LOGICAL enabled, PUTfn put, FLUSHfn flush,
+						pnode *next1, pnode *next2)
+
+	{
+	p->enabled = enabled;
+	p->put     = put;
+	p->flush   = flush;
+	p->next1   = next1;
+	p->next2   = next2;
+	p->putn    = (PUTNfn) 0;
+	}
+
+static	void	init_pipe_context
+
+	(
+	PIPE_CONTEXT	ctx
+	)
+
+	{
+	set_pnode(&ctx->Npipe,   TRUE,  ctx_put_pipe,   ctx_flush_pipe,
+				&ctx->Nfilter, NullPn);
+	set_pnode(&ctx->Nfilter, FALSE, ctx_put_filter, ctx_flush_filter,
+				&ctx->Nbuffer, NullPn);
+	set_pnode(&ctx->Nbuffer, FALSE, ctx_put_buffer, ctx_flush_buffer,
+				&ctx->Necho,   &ctx->Nspline);
+	set_pnode(&ctx->Nspline, FALSE, ctx_put_spline, ctx_flush_spline,
+				&ctx->Ndisp,   &ctx->Nclip);
+	set_pnode(&ctx->Nclip,   FALSE, ctx_put_clip,   ctx_flush_clip,
+				&ctx->Nfill,   NullPn);
+	set_pnode(&ctx->Nfill,   FALSE, ctx_put_fill,   ctx_flush_fill,
+				&ctx->Nsave,   &ctx->Nmeta);
+	set_pnode(&ctx->Necho,   FALSE, ctx_put_echo,   ctx_flush_echo,
+				NullPn,        NullPn);
+	set_pnode(&ctx->Ndisp,   FALSE, ctx_put_disp,   ctx_flush_disp,
+				NullPn,        NullPn);
+	set_pnode(&ctx->Nsave,   FALSE, ctx_put_save,   ctx_flush_save,
+				NullPn,        NullPn);
+	set_pnode(&ctx->Nmeta,   FALSE, ctx_put_meta,   ctx_flush_meta,
+				NullPn,        NullPn);
+
+	/* Modules that can work on an array at a time */
+	ctx->Nbuffer.putn = ctx_putn_buffer;
+	ctx->Nclip.putn   = ctx_putn_clip;
+	ctx->Nsave.putn   = ctx_putn_save;
+	ctx->Nmeta.putn   = ctx_putn_meta;
+	}
+
 /***********************************************************************
 *                                                                      *
 *     r e s e t _ p i p e                                              *
@@ -75,53 +270,69 @@
 void	reset_pipe(void)
 
 	{
+	PIPE_CONTEXT	ctx = current_pipe();
+
 	/* Turn everything off except pipe itself */
-	disable_module(Pfilter);
-	disable_module(Pbuffer);
-	disable_module(Pecho);
-	disable_module(Pspline);
-	disable_module(Pdisp);
-	disable_module(Pclip);
-	disable_module(Pfill);
-	disable_module(Psave);
-	disable_module(Pmeta);
+	disable_module(&ctx->Nfilter);
+	disable_module(&ctx->Nbuffer);
+	disable_module(&ctx->Necho);
+	disable_module(&ctx->Nspline);
+	disable_module(&ctx->Ndisp);
+	disable_module(&ctx->Nclip);
+	disable_module(&ctx->Nfill);
+	disable_module(&ctx->Nsave);
+	disable_module(&ctx->Nmeta);
 
 	/* Get rid of garbage */
-	enable_module(Ppipe);
-	flush_module(Ppipe);
+	enable_module(&ctx->Npipe);
+	flush_module(ctx, &ctx->Npipe);
 	}
 
 void	put_pipe(float x, float y)
-	{ put_next(Ppipe,x,y); }
+	{ ctx_put_pipe(current_pipe(),x,y); }
 
 
 void	point_pipe(POINT p)
-	{ put_next(Ppipe,p[X],p[Y]); }
+	{ ctx_put_pipe(current_pipe(),p[X],p[Y]); }
 
 
 void	flush_pipe(void)
-	{ flush_next(Ppipe); }
+	{ ctx_flush_pipe(current_pipe()); }
 
 
 void	line_pipe(LINE line)
 	{
-	int	i;
-	float	x, y;
+	PIPE_CONTEXT	ctx;
 
 	/* If no line given do nothing */
 	if (!line) return;
 
-	/* Pass each point from line to pipe */
-	for (i=0; i<line->numpts; i++)
-		{
-		x = line->points[i][X];
-		y = line->points[i][Y];
-		put_next(Ppipe,x,y);
-		}
-	flush_next(Ppipe);
+	/* Pass the points from line to pipe */
+	ctx = current_pipe();
+	put_next_array(ctx,&ctx->Npipe,line->points,line->numpts);
+	flush_next(ctx,&ctx->Npipe);
 	}
 
 
+void	points_pipe(POINT *pts, int npts)
+	{
+	PIPE_CONTEXT	ctx;
+
+	/* If no points given do nothing */
+	if (!pts || npts <= 0) return;
+
+	/* Pass the points to pipe (without terminating the stream) */
+	ctx = current_pipe();
+	put_next_array(ctx,&ctx->Npipe,pts,npts);
+	}
+
+void	ctx_put_pipe(PIPE_CONTEXT ctx, float x, float y)
+	{ put_next(ctx,&ctx->Npipe,x,y); }
+
+void	ctx_flush_pipe(PIPE_CONTEXT ctx)
+	{ flush_next(ctx,&ctx->Npipe); }
+
+
 /***********************************************************************
 *                                                                      *
 *       e n a b l e _ m o d u l e                                      *
@@ -130,6 +341,8 @@ void	line_pipe(LINE line)
 *         f l u s h _ m o d u l e                                      *
 *             p u t _ n e x t                                          *
 *         f l u s h _ n e x t                                          *
+*       p u t _ m o d u l e _ a r r a y                                *
+*           p u t _ n e x t _ a r r a y                                *
 *                                                                      *
 *     Pipe management routines.                                        *
 *                                                                      *
@@ -141,38 +354,195 @@ void enable_module(pnode *p)
 void disable_module(pnode *p)
 { if(p) p->enabled = FALSE; }
 
-void put_module(pnode *p, float x, float y)
+void put_module(PIPE_CONTEXT ctx, pnode *p, float x, float y)
 	{
 	if (!p) return;
-	if (p->enabled) p->put(x,y);
+	if (p->enabled)
+		{
+		if (ctx->stats) p->npts++;
+		p->put(ctx,x,y);
+		}
 	else	{
-		put_module(p->next1,x,y);
-		put_module(p->next2,x,y);
+		put_module(ctx,p->next1,x,y);
+		put_module(ctx,p->next2,x,y);
 		}
 	}
 
-void flush_module(pnode *p)
+void flush_module(PIPE_CONTEXT ctx, pnode *p)
 	{
 	if (!p) return;
-	if (p->enabled) p->flush();
+	if (p->enabled) p->flush(ctx);
 	else	{
-		flush_module(p->next1);
-		flush_module(p->next2);
+		flush_module(ctx,p->next1);
+		flush_module(ctx,p->next2);
 		}
 	}
 
-void put_next(pnode *p, float x, float y)
+void put_next(PIPE_CONTEXT ctx, pnode *p, float x, float y)
 	{
 	if (!p) return;
-	put_module(p->next1,x,y);
-	put_module(p->next2,x,y);
+
+	/* Collect output while this module is working on an array */
+	if (p->batch)
+		{
+		if (p->nout >= p->mout)
+			{
+			p->mout = MAX(2*p->mout, 256);
+			p->out  = GETMEM(p->out, POINT, p->mout);
+			}
+		p->out[p->nout][X] = x;
+		p->out[p->nout][Y] = y;
+		p->nout++;
+		return;
+		}
+
+	put_module(ctx,p->next1,x,y);
+	put_module(ctx,p->next2,x,y);
 	}
 
-void flush_next(pnode *p)
+void flush_next(PIPE_CONTEXT ctx, pnode *p)
 	{
 	if (!p) return;
-	flush_module(p->next1);
-	flush_module(p->next2);
+	if (p->nout > 0) drain_next(ctx,p);
+	flush_module(ctx,p->next1);
+	flush_module(ctx,p->next2);
+	}
+
+void put_module_array(PIPE_CONTEXT ctx, pnode *p, POINT *pts, int npts)
+	{
+	int		i;
+	double	start = 0, outer = 0, elapsed;
+
+	if (!p)        return;
+	if (npts <= 0) return;
+	if (!p->enabled)
+		{
+		put_module_array(ctx,p->next1,pts,npts);
+		put_module_array(ctx,p->next2,pts,npts);
+		return;
+		}
+
+	if (ctx->stats)
+		{
+		p->npts += npts;
+		p->ncall++;
+		start = pipe_clock();
+		outer = ctx->inner;
+		ctx->inner = 0;
+		}
+
+	/* Pass the whole array if the module can handle it */
+	if (p->putn) p->putn(ctx,pts,npts);
+
+	/* Otherwise pass one point at a time and collect the output */
+	else	{
+		p->batch = TRUE;
+		for (i=0; i<npts; i++)
+			p->put(ctx,pts[i][X],pts[i][Y]);
+		p->batch = FALSE;
+		if (p->nout > 0) drain_next(ctx,p);
+		}
+
+	/* Keep time spent in this module apart from the following ones */
+	if (ctx->stats)
+		{
+		elapsed     = pipe_clock() - start;
+		p->time    += elapsed - ctx->inner;
+		ctx->inner  = outer + elapsed;
+		}
+	}
+
+void put_next_array(PIPE_CONTEXT ctx, pnode *p, POINT *pts, int npts)
+	{
+	int		i;
+
+	if (!p)        return;
+	if (npts <= 0) return;
+
+	/* Collect output while this module is working on an array */
+	if (p->batch)
+		{
+		for (i=0; i<npts; i++)
+			put_next(ctx,p,pts[i][X],pts[i][Y]);
+		return;
+		}
+
+	put_module_array(ctx,p->next1,pts,npts);
+	put_module_array(ctx,p->next2,pts,npts);
+	}
+
+/* Pass collected output along to the following modules */
+void drain_next(PIPE_CONTEXT ctx, pnode *p)
+	{
+	int		npts;
+	LOGICAL	batch;
+
+	npts     = p->nout;
+	batch    = p->batch;
+	p->nout  = 0;
+	p->batch = FALSE;
+	put_module_array(ctx,p->next1,p->out,npts);
+	put_module_array(ctx,p->next2,p->out,npts);
+	p->batch = batch;
+	}
+
+
+/***********************************************************************
+*                                                                      *
+*       e n a b l e _ p i p e _ s t a t s                              *
+*     d i s a b l e _ p i p e _ s t a t s                              *
+*       r e p o r t _ p i p e _ s t a t s                              *
+*                                                                      *
+*     Count the points passed to each module, and the time spent in    *
+*     each module when passing arrays of points (not including time    *
+*     spent in the modules that follow it).                            *
+*                                                                      *
+***********************************************************************/
+
+void	enable_pipe_stats(void)
+	{
+	PIPE_CONTEXT	ctx = current_pipe();
+	pnode			*p;
+
+	for (p=&ctx->Npipe; p<=&ctx->Nmeta; p++)
+		{
+		p->npts  = 0;
+		p->ncall = 0;
+		p->time  = 0;
+		}
+	ctx->inner = 0;
+	ctx->stats = TRUE;
+	}
+
+void	disable_pipe_stats(void)
+	{
+	current_pipe()->stats = FALSE;
+	}
+
+void	report_pipe_stats(void)
+	{
+	PIPE_CONTEXT	ctx = current_pipe();
+	pnode			*p;
+	int				i;
+
+	static	STRING	names[] = { "pipe", "filter", "buffer", "echo", "spline",
+								"disp", "clip", "fill", "save", "meta" };
+
+	pr_info("Pipe", "Module     Points   Arrays   Time (msec)\n");
+	for (i=0, p=&ctx->Npipe; p<=&ctx->Nmeta; i++, p++)
+		{
+		if (p->npts <= 0) continue;
+		pr_info("Pipe", "%-8s %8ld %8ld %13.3f\n",
+				names[i], p->npts, p->ncall, p->time*1000.0);
+		}
+	}
+
+static	double	pipe_clock(void)
+	{
+	struct timeval	tv;
+
+	(void) gettimeofday(&tv, NULL);
+	return (double) tv.tv_sec + (double) tv.tv_usec / 1.0e6;
 	}
 
 
@@ -52,13 +52,29 @@
 /* We need various include files */
 #include "metafile.h"
 
+/* Graphics pipe context - the state of each module in one pipe */
+/* (the pipe functions below operate on the calling thread's context) */
+typedef struct PIPE_CONTEXT_struct	*PIPE_CONTEXT;
+
 /* Declare external functions in pipe.c */
 
+PIPE_CONTEXT	create_pipe_context(void);	/**< Create a new pipe */
+PIPE_CONTEXT	destroy_pipe_context(PIPE_CONTEXT ctx);
+											/**< Destroy a pipe */
+PIPE_CONTEXT	set_pipe_context(PIPE_CONTEXT ctx);
+											/**< Use given pipe in this thread */
+PIPE_CONTEXT	get_pipe_context(void);		/**< Pipe used in this thread */
+
 void	reset_pipe(void);			/**< Disable all modules */
 void	line_pipe(LINE line);		/**< Process an entire set of points */
 void	point_pipe(POINT pos);		/**< Put next point into pipe */
 void	put_pipe(float x, float y); /**< Put next point (x, y) into pipe */
 void	flush_pipe(void);			/**< Terminate current point stream (pen-up) */
+void	points_pipe(POINT *pts, int npts);
+									/**< Put an array of points into pipe */
+void	enable_pipe_stats(void);	/**< Start collecting module statistics */
+void	disable_pipe_stats(void);	/**< Stop collecting module statistics */
+void	report_pipe_stats(void);	/**< Report module statistics */
 void	provide_pipe_colour_fn(void (*)(COLOUR colour, HILITE hilite));
 void	provide_pipe_lstyle_fn(void (*)(LSTYLE style,
 						float width, float length));
@@ -126,8 +126,9 @@
 #include "pipe.h"
 
 /* Define "put" and "flush" function pointer types */
-typedef void	(*PUTfn)(float, float);
-typedef void	(*FLUSHfn)(void);
+typedef void	(*PUTfn)(PIPE_CONTEXT, float, float);
+typedef void	(*FLUSHfn)(PIPE_CONTEXT);
+typedef void	(*PUTNfn)(PIPE_CONTEXT, POINT *, int);
 
 /* Structure to manage pipe connections */
 typedef struct pnode_struct
@@ -137,50 +138,158 @@ typedef struct pnode_struct
 	FLUSHfn				flush;		/* flush function pointer */
 	struct pnode_struct	*next1;		/* next operation */
 	struct pnode_struct	*next2;		/* next operation */
+
+	/* Passing arrays of points */
+	PUTNfn				putn;		/* array put function (if any) */
+	LOGICAL				batch;		/* collect output for next operations? */
+	POINT				*out;		/* collected output points */
+	int					nout;		/* number of collected points */
+	int					mout;		/* allocated collected points */
+
+	/* Statistics */
+	long				npts;		/* number of points received */
+	long				ncall;		/* number of arrays received */
+	double				time;		/* time spent on arrays (seconds) */
 	} pnode;
 
 #define NullPn (pnode *)(0)
 
-/* Set up the initial pipe connections (must be defined in reverse order) */
-#ifdef PIPE_INIT
-static pnode  Nmeta   = { FALSE, put_meta,   flush_meta,  NullPn,   NullPn   };
-static pnode  Nsave   = { FALSE, put_save,   flush_save,  NullPn,   NullPn   };
-static pnode  Ndisp   = { FALSE, put_disp,   flush_disp,  NullPn,   NullPn   };
-static pnode  Necho   = { FALSE, put_echo,   flush_echo,  NullPn,   NullPn   };
-static pnode  Nfill   = { FALSE, put_fill,   flush_fill,  &Nsave,   &Nmeta   };
-static pnode  Nclip   = { FALSE, put_clip,   flush_clip,  &Nfill,   NullPn   };
-static pnode  Nspline = { FALSE, put_spline, flush_spline,&Ndisp,   &Nclip   };
-static pnode  Nbuffer = { FALSE, put_buffer, flush_buffer,&Necho,   &Nspline };
-static pnode  Nfilter = { FALSE, put_filter, flush_filter,&Nbuffer, NullPn   };
-static pnode  Npipe   = { TRUE,  put_pipe,   flush_pipe,  &Nfilter, NullPn   };
-#endif
-
-#undef GLOBAL
-#ifdef PIPE_INIT
-#	define GLOBAL GLOBAL_INIT
-#else
-#	define GLOBAL GLOBAL_EXTERN
-#endif
-
-/* Set up pointers to the pipe connections */
-GLOBAL(pnode *,	Ppipe,		&Npipe);
-GLOBAL(pnode *,	Pfilter,	&Nfilter);
-GLOBAL(pnode *,	Pbuffer,	&Nbuffer);
-GLOBAL(pnode *,	Pspline,	&Nspline);
-GLOBAL(pnode *,	Pclip,		&Nclip);
-GLOBAL(pnode *,	Pfill,		&Nfill);
-GLOBAL(pnode *,	Pecho,		&Necho);
-GLOBAL(pnode *,	Pdisp,		&Ndisp);
-GLOBAL(pnode *,	Psave,		&Nsave);
-GLOBAL(pnode *,	Pmeta,		&Nmeta);
-
-/* Declare internal functions */
+/* Flags and shared parameters for filter module */
+typedef struct
+	{
+	LOGICAL	new;			/* start new point stream */
+	LOGICAL	out;			/* has a point been output yet? */
+	float	res;			/* filter resolution */
+	float	ang;			/* filter angle */
+	float	s;				/* accumulated arc length from anchor point */
+	float	a;				/* accumulated angle from anchor point */
+	float	ao;				/* anchor angle */
+	float	xo, yo;			/* anchor point */
+	float	xp, yp;			/* previous point recalled */
+	} PIPE_FILTER;
+
+/* Flags and shared parameters for buffer module */
+typedef struct
+	{
+	LINE	line;			/* buffered points */
+	} PIPE_BUFFER;
+
+/* Flags and shared parameters for spline module */
+typedef struct
+	{
+	float	ds, tau, per, amp, eps;
+	LOGICAL	clsd, saved;
+	int		np;
+	float	s;
+	float	xfirst, xsecond, xthird, xclose;
+	float	yfirst, ysecond, ythird, yclose;
+	float	xa,ya,sa, txa,tya,tsa;
+	float	xb,yb,sb, txb,tyb,tsb;
+	float	xc,yc,sc, txc,tyc,tsc;
+	float	axl,bxl,cxl,dxl, ayl,byl,cyl,dyl;
+	float	axr,bxr,cxr,dxr, ayr,byr,cyr,dyr;
+
+	/* Buffers for generating a segment at a time */
+	float	*sbuf;
+	POINT	*pbuf;
+	int		mbuf;
+
+	/* Scallop parameters */
+	LOGICAL	swave, scallop;
+	float	xo, yo, so, freq, ampl;
+	} PIPE_SPLINE;
+
+/* Flags and shared parameters for clip module */
+typedef struct
+	{
+	LOGICAL	new;			/* new line */
+	LOGICAL	out;			/* at least one point has been output */
+	LOGICAL	poly;			/* polygon mode (include corner points) */
+	LOGICAL	closd;			/* close mode (close last to first points) */
+	LOGICAL	debug;
+	float	xp, yp;
+	float	xq, yq;
+	float	xmin, ymin;
+	float	xmax, ymax;
+	} PIPE_CLIP;
+
+/* Flags and shared parameters for fill module */
+typedef struct
+	{
+	LOGICAL	new;			/* start new point stream */
+	float	res;			/* fill resolution */
+	float	xo, yo;			/* anchor point */
+	} PIPE_FILL;
+
+/* Flags and shared parameters for echo module */
+typedef struct
+	{
+	COLOUR	colour;
+	} PIPE_ECHO;
+
+/* Flags and shared parameters for disp module */
+typedef struct
+	{
+	LOGICAL	new;
+	COLOUR	colour;
+	LSTYLE	style;
+	float	xprev, yprev;
+	} PIPE_DISP;
+
+/* Flags and shared parameters for save module (with stack of saved lines) */
+#define PIPE_SAVE_STACK 5
+typedef struct
+	{
+	LINE	*lstack[PIPE_SAVE_STACK];
+	int		nstack[PIPE_SAVE_STACK];
+	int		istack;
+	LOGICAL	new;
+	LINE	line;
+	} PIPE_SAVE;
+
+/* Flags and shared parameters for meta module */
+typedef struct
+	{
+	CURVE		curve;
+	METAFILE	meta;
+	char		entity[41];
+	char		element[41];
+	char		level[41];
+	} PIPE_META;
+
+/* Structure to hold one complete pipe - the connections and the */
+/* state of each module (the connections must be kept together, */
+/* starting with Npipe and ending with Nmeta) */
+struct PIPE_CONTEXT_struct
+	{
+	pnode		Npipe, Nfilter, Nbuffer, Necho, Nspline,
+				Ndisp, Nclip, Nfill, Nsave, Nmeta;
+	PIPE_FILTER	filter;
+	PIPE_BUFFER	buffer;
+	PIPE_SPLINE	spline;
+	PIPE_CLIP	clip;
+	PIPE_FILL	fill;
+	PIPE_ECHO	echo;
+	PIPE_DISP	disp;
+	PIPE_SAVE	save;
+	PIPE_META	metaout;
+
+	/* Statistics */
+	LOGICAL		stats;		/* collect statistics? */
+	double		inner;		/* time spent in following operations */
+	};
+
+/* Declare internal functions in pipe.c */
+PIPE_CONTEXT	current_pipe(void);
 void	enable_module(pnode *p);
 void	disable_module(pnode *p);
-void	put_module(pnode *p, float x, float y);
-void	flush_module(pnode *p);
-void	put_next(pnode *p, float x, float y);
-void	flush_next(pnode *p);
+void	put_module(PIPE_CONTEXT ctx, pnode *p, float x, float y);
+void	flush_module(PIPE_CONTEXT ctx, pnode *p);
+void	put_next(PIPE_CONTEXT ctx, pnode *p, float x, float y);
+void	flush_next(PIPE_CONTEXT ctx, pnode *p);
+void	put_module_array(PIPE_CONTEXT ctx, pnode *p, POINT *pts, int npts);
+void	put_next_array(PIPE_CONTEXT ctx, pnode *p, POINT *pts, int npts);
+void	drain_next(PIPE_CONTEXT ctx, pnode *p);
 void	pipe_colour_fn(COLOUR colour, HILITE hilite);
 void	pipe_lstyle_fn(LSTYLE style, float width, float length);
 void	pipe_move_fn(float x, float y);
@@ -189,3 +298,33 @@ void	pipe_msize_fn(float msize);
 void	pipe_mangle_fn(float mangle);
 void	pipe_marker_fn(int type, float xoff, float yoff);
 void	pipe_flush_fn(void);
+
+/* Declare internal module functions (operating on a given pipe) */
+void	ctx_put_pipe(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_flush_pipe(PIPE_CONTEXT ctx);
+void	ctx_put_filter(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_flush_filter(PIPE_CONTEXT ctx);
+void	ctx_put_buffer(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_putn_buffer(PIPE_CONTEXT ctx, POINT *pts, int npts);
+void	ctx_flush_buffer(PIPE_CONTEXT ctx);
+void	ctx_clean_buffer(PIPE_CONTEXT ctx);
+void	ctx_put_spline(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_clean_spline(PIPE_CONTEXT ctx);
+void	ctx_flush_spline(PIPE_CONTEXT ctx);
+void	ctx_put_clip(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_putn_clip(PIPE_CONTEXT ctx, POINT *pts, int npts);
+void	ctx_flush_clip(PIPE_CONTEXT ctx);
+void	ctx_put_fill(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_flush_fill(PIPE_CONTEXT ctx);
+void	ctx_put_echo(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_flush_echo(PIPE_CONTEXT ctx);
+void	ctx_put_disp(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_flush_disp(PIPE_CONTEXT ctx);
+void	ctx_put_save(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_putn_save(PIPE_CONTEXT ctx, POINT *pts, int npts);
+void	ctx_flush_save(PIPE_CONTEXT ctx);
+void	ctx_clean_save(PIPE_CONTEXT ctx);
+void	ctx_put_meta(PIPE_CONTEXT ctx, float x, float y);
+void	ctx_putn_meta(PIPE_CONTEXT ctx, POINT *pts, int npts);
+void	ctx_flush_meta(PIPE_CONTEXT ctx);
+void	ctx_clean_meta(PIPE_CONTEXT ctx);
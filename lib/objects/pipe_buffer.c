@@ -49,29 +49,40 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for buffer module */
-static LINE	line = NULL;
+/* Flags and shared parameters for buffer module are in PIPE_BUFFER */
 
-/** Turn on polyline buffering */
 void	enable_buffer(void)
 	{
-	enable_module(Pbuffer);
-	if (!line) line = create_line();
-	empty_line(line);
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	enable_module(&ctx->Nbuffer);
+	if (!ctx->buffer.line) ctx->buffer.line = create_line();
+	empty_line(ctx->buffer.line);
 	}
 
-/** Turn off polyline buffering */
 void	disable_buffer(void)
 	{
-	disable_module(Pbuffer);
-	line = destroy_line(line);
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	disable_module(&ctx->Nbuffer);
+	ctx_clean_buffer(ctx);
 	}
 
-/** Add point to buffered polyline */
 void	put_buffer
  (
  float x,	/* x coord */
  float y	/* y coord */
+ )
+	{ ctx_put_buffer(current_pipe(),x,y); }
+
+void	flush_buffer(void)
+	{ ctx_flush_buffer(current_pipe()); }
+
+void	ctx_put_buffer
+ (
+ PIPE_CONTEXT	ctx,
+ float x,	/* x coord */
+ float y	/* y coord */
  )
 	{
 	POINT	p;
@@ -79,24 +90,28 @@ void	put_buffer
 	/* Add point to line */
 	p[X] = x;
 	p[Y] = y;
-	add_point_to_line(line,p);
+	add_point_to_line(ctx->buffer.line,p);
 	}
 
-/** Flush buffered polyline (pen-up) */
-void	flush_buffer(void)
+void	ctx_putn_buffer(PIPE_CONTEXT ctx, POINT *pts, int npts)
+	{
+	/* Add points to line */
+	add_points_to_line(ctx->buffer.line,pts,npts);
+	}
+
+void	ctx_flush_buffer(PIPE_CONTEXT ctx)
 	{
-	int	i;
-	float	x, y;
+	LINE	line = ctx->buffer.line;
 
 	/* Pass the buffered line to the rest of the pipe */
-	for (i=0; i<line->numpts; i++)
-		{
-		x = line->points[i][X];
-		y = line->points[i][Y];
-		put_next(Pbuffer,x,y);
-		}
+	put_next_array(ctx,&ctx->Nbuffer,line->points,line->numpts);
 
 	/* Empty the line and flush the rest of the pipe */
 	empty_line(line);
-	flush_next(Pbuffer);
+	flush_next(ctx,&ctx->Nbuffer);
+	}
+
+void	ctx_clean_buffer(PIPE_CONTEXT ctx)
+	{
+	ctx->buffer.line = destroy_line(ctx->buffer.line);
 	}
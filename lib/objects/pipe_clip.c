@@ -61,17 +61,8 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for clip module */
-static LOGICAL	new   = FALSE;	/* new line */
-static LOGICAL	out   = FALSE;	/* at least one point has been output */
-static LOGICAL	poly  = FALSE;	/* polygon mode (include corner points) */
-static LOGICAL	closd = FALSE;	/* close mode (close last to first points) */
-static float	xp, yp;
-static float	xq, yq;
-static float	xmin, ymin;
-static float	xmax, ymax;
-static float	infinity = 1e10;
-static LOGICAL	debug = FALSE;
+/* Flags and shared parameters for clip module are in PIPE_CLIP */
+static const float	infinity = 1e10;
 
 
 
@@ -97,17 +88,20 @@ void	enable_clip
 	)
 
 	{
-	enable_module(Pclip);
-	new   = TRUE;
-	out   = FALSE;
-	poly  = polygon;
-	closd = closed;
-	xmin  = MIN(left,right);
-	xmax  = MAX(left,right);
-	ymin  = MIN(bottom,top);
-	ymax  = MAX(bottom,top);
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_CLIP		*c  = &ctx->clip;
+
+	enable_module(&ctx->Nclip);
+	c->new   = TRUE;
+	c->out   = FALSE;
+	c->poly  = polygon;
+	c->closd = closed;
+	c->xmin  = MIN(left,right);
+	c->xmax  = MAX(left,right);
+	c->ymin  = MIN(bottom,top);
+	c->ymax  = MAX(bottom,top);
 #ifdef DEBUG
-	debug = (LOGICAL) (poly && !closed);
+	c->debug = (LOGICAL) (c->poly && !closed);
 #endif
 	}
 
@@ -116,92 +110,146 @@ void	enable_clip
 /** Turn off clipping */
 void disable_clip(void)
 	{
-	disable_module(Pclip);
-	new = FALSE;
-	out = FALSE;
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_CLIP		*c  = &ctx->clip;
+
+	disable_module(&ctx->Nclip);
+	c->new = FALSE;
+	c->out = FALSE;
 	}
 
 
 
-static	void output_point(float, float);
+static	void output_point(PIPE_CONTEXT, float, float);
 
-static	void output_point(float x, float y)
+static	void output_point(PIPE_CONTEXT ctx, float x, float y)
 	{
+	PIPE_CLIP	*c = &ctx->clip;
+
 	/* Save first output point to join at end */
-	if (!out)
+	if (!c->out)
 		{
-		out = TRUE;
-		if (poly && closd)
+		c->out = TRUE;
+		if (c->poly && c->closd)
 		{
-			xq  = x;
-			yq  = y;
+			c->xq  = x;
+			c->yq  = y;
 		}
 		}
 
 	/* Pass point along to next pipe operation */
-	put_next(Pclip,x,y);
+	put_next(ctx,&ctx->Nclip,x,y);
 	}
 
 
 
 /** Pass given point to clipper */
 void	put_clip(float x, float y)
+	{ ctx_put_clip(current_pipe(),x,y); }
+
+
+
+/** End the stream (Pen up) */
+void flush_clip(void)
+	{ ctx_flush_clip(current_pipe()); }
+
+
+
+/* Is the given point inside (or on the edge of) the window? */
+#define INSIDE(c,x,y) ( (x) >= (c)->xmin && (x) <= (c)->xmax \
+					 && (y) >= (c)->ymin && (y) <= (c)->ymax )
+
+/* Pass an array of points to clipper */
+void	ctx_putn_clip(PIPE_CONTEXT ctx, POINT *pts, int npts)
+	{
+	int			i;
+	float		x, y;
+	LOGICAL		pin, cin;
+	PIPE_CLIP	*c = &ctx->clip;
+
+	ctx->Nclip.batch = TRUE;
+	pin = (LOGICAL) (!c->new && INSIDE(c,c->xp,c->yp));
+	for (i=0; i<npts; i++)
+		{
+		x   = pts[i][X];
+		y   = pts[i][Y];
+		cin = (LOGICAL) INSIDE(c,x,y);
+
+		/* Segments with both ends inside the window need no clipping */
+		/* (this is what the full algorithm does with them) */
+		if (pin && cin && !c->debug)
+			{
+			output_point(ctx,x,y);
+			c->xp = x;
+			c->yp = y;
+			}
+		else ctx_put_clip(ctx,x,y);
+		pin = cin;
+		}
+	ctx->Nclip.batch = FALSE;
+	if (ctx->Nclip.nout > 0) drain_next(ctx,&ctx->Nclip);
+	}
+
+
+
+void	ctx_put_clip(PIPE_CONTEXT ctx, float x, float y)
 	{
 	float	xx, dx, xin, xout, axin, axout;
 	float	yy, dy, yin, yout, ayin, ayout;
 	float	ain1, ain2, aout1;
+	PIPE_CLIP	*c = &ctx->clip;
 
-	if (debug) (void) printf("\npoint: %f %f\n",x,y);
+	if (c->debug) (void) printf("\npoint: %f %f\n",x,y);
 
 	/* Process first point individually */
 	/* Remainder of algorithm depends on a previous point */
-	if (new)
+	if (c->new)
 		{
-		new = !new;
-		if (x < xmin) goto done;
-		if (x > xmax) goto done;
-		if (y < ymin) goto done;
-		if (y > ymax) goto done;
-		output_point(x,y);
+		c->new = !c->new;
+		if (x < c->xmin) goto done;
+		if (x > c->xmax) goto done;
+		if (y < c->ymin) goto done;
+		if (y > c->ymax) goto done;
+		output_point(ctx,x,y);
 		goto done;
 		}
 
 	/* Find the x entry point */
-	dx = x - xp;
+	dx = x - c->xp;
 	if (dx > 0)		/* line going right */
 		{
-		xin  = xmin;
-		axin = (xin-xp)/dx;
+		xin  = c->xmin;
+		axin = (xin-c->xp)/dx;
 		}
 	else if (dx < 0)	/* line going left */
 		{
-		xin  = xmax;
-		axin = (xin-xp)/dx;
+		xin  = c->xmax;
+		axin = (xin-c->xp)/dx;
 		}
 	else			/* vertical line */
 		{
-		xin  = xmax;
+		xin  = c->xmax;
 		axin = -infinity;
-		if (xp > xmax) xin = xmin;
+		if (c->xp > c->xmax) xin = c->xmin;
 		}
 
 	/* Find the y entry point */
-	dy = y - yp;
+	dy = y - c->yp;
 	if (dy > 0)		/* line going up */
 		{
-		yin  = ymin;
-		ayin = (yin-yp)/dy;
+		yin  = c->ymin;
+		ayin = (yin-c->yp)/dy;
 		}
 	else if (dy < 0)	/* line going down */
 		{
-		yin  = ymax;
-		ayin = (yin-yp)/dy;
+		yin  = c->ymax;
+		ayin = (yin-c->yp)/dy;
 		}
 	else			/* horizontal line */
 		{
-		yin  = ymax;
+		yin  = c->ymax;
 		ayin = -infinity;
-		if (yp > ymax) yin = ymin;
+		if (c->yp > c->ymax) yin = c->ymin;
 		}
 
 	/* Order the two entry points */
@@ -212,7 +260,7 @@ void	put_clip(float x, float y)
 	/* No contribution whatsoever */
 	if (1 < ain1)
 		{
-		if (debug) (void) printf("case-1\n");
+		if (c->debug) (void) printf("case-1\n");
 		goto done;
 		}
 
@@ -220,56 +268,56 @@ void	put_clip(float x, float y)
 	/* Add a turning vertex due to 1st point */
 	if (0 < ain1)
 		{
-		if (debug) (void) printf("case-5: %f %f\n",xin,yin);
-		if (poly)  output_point(xin,yin);
+		if (c->debug) (void) printf("case-5: %f %f\n",xin,yin);
+		if (c->poly)  output_point(ctx,xin,yin);
 		}
 
 	/* Case 2:  (0 >= ain1)  and  (1 < ain2) */
 	/* No contribution */
 	if (1 < ain2)
 		{
-		if (debug) (void) printf("case-2\n");
+		if (c->debug) (void) printf("case-2\n");
 		goto done;
 		}
 
 	/* Find the x exit point */
 	if (dx > 0)
 		{
-		xout  = xmax;
-		axout = (xout-xp)/dx;
+		xout  = c->xmax;
+		axout = (xout-c->xp)/dx;
 		}
 	else if (dx < 0)
 		{
-		xout  = xmin;
-		axout = (xout-xp)/dx;
+		xout  = c->xmin;
+		axout = (xout-c->xp)/dx;
 		}
 	else
 		{
-		xout  = xmin;
+		xout  = c->xmin;
 		axout = infinity;
-		if (xp < xmin) axout = -infinity;
-		if (xp > xmax) axout = -infinity;
-		if (xp > xmax) xout  = xmax;
+		if (c->xp < c->xmin) axout = -infinity;
+		if (c->xp > c->xmax) axout = -infinity;
+		if (c->xp > c->xmax) xout  = c->xmax;
 		}
 
 	/* Find the y exit point */
 	if (dy > 0)
 		{
-		yout  = ymax;
-		ayout = (yout-yp)/dy;
+		yout  = c->ymax;
+		ayout = (yout-c->yp)/dy;
 		}
 	else if (dy < 0)
 		{
-		yout  = ymin;
-		ayout = (yout-yp)/dy;
+		yout  = c->ymin;
+		ayout = (yout-c->yp)/dy;
 		}
 	else
 		{
-		yout  = ymin;
+		yout  = c->ymin;
 		ayout = infinity;
-		if (yp < ymin) ayout = -infinity;
-		if (yp > ymax) ayout = -infinity;
-		if (yp > ymax) yout  = ymax;
+		if (c->yp < c->ymin) ayout = -infinity;
+		if (c->yp > c->ymax) ayout = -infinity;
+		if (c->yp > c->ymax) yout  = c->ymax;
 		}
 
 	/* Order the two exit points */
@@ -279,12 +327,12 @@ void	put_clip(float x, float y)
 	/* No contribution */
 	if ((0 >= ain2) && (0 >= aout1))
 		{
-		if (debug) (void) printf("case-3\n");
+		if (c->debug) (void) printf("case-3\n");
 		if (0 == aout1)
 			{
 			/* Terminate line segment if line mode */
-			if (debug) (void) printf("going out: %f %f\n",xx,yy);
-			if (!poly) flush_next(Pclip);
+			if (c->debug) (void) printf("going out: %f %f\n",xx,yy);
+			if (!c->poly) flush_next(ctx,&ctx->Nclip);
 			}
 		goto done;
 		}
@@ -293,7 +341,7 @@ void	put_clip(float x, float y)
 	/* Visible segment - may be clipped on either end */
 	if (ain2 <= aout1)
 		{
-		if (debug) (void) printf("case-4\n");
+		if (c->debug) (void) printf("case-4\n");
 
 		/* 1st point invisible - coming in */
 		if (0 < ain2)
@@ -301,15 +349,15 @@ void	put_clip(float x, float y)
 			if (axin > ayin)	/* clip to vertical */
 			{
 			xx = xin;
-			yy = yp + axin*dy;
+			yy = c->yp + axin*dy;
 			}
 			else			/* clip to horizontal */
 			{
-			xx = xp + ayin*dx;
+			xx = c->xp + ayin*dx;
 			yy = yin;
 			}
-		if (debug) (void) printf("coming in: %f %f\n",xx,yy);
-			output_point(xx,yy);
+		if (c->debug) (void) printf("coming in: %f %f\n",xx,yy);
+			output_point(ctx,xx,yy);
 		}
 
 		/* 2nd point invisible - going out */
@@ -318,63 +366,64 @@ void	put_clip(float x, float y)
 		if (axout < ayout)	/* clip to vertical */
 			{
 			xx = xout;
-			yy = yp + axout*dy;
+			yy = c->yp + axout*dy;
 			}
 		else			/* clip to horizontal */
 			{
-			xx = xp + ayout*dx;
+			xx = c->xp + ayout*dx;
 			yy = yout;
 			}
-		if (debug) (void) printf("going out: %f %f\n",xx,yy);
-		output_point(xx,yy);
+		if (c->debug) (void) printf("going out: %f %f\n",xx,yy);
+		output_point(ctx,xx,yy);
 
 		/* Terminate line segment if line mode */
-		if (!poly) flush_next(Pclip);
+		if (!c->poly) flush_next(ctx,&ctx->Nclip);
 		}
 
 		/* 2nd point is visible - don't clip */
 		else
 		{
-		if (debug) (void) printf("end visible: %f %f\n",x,y);
-		output_point(x,y);
+		if (c->debug) (void) printf("end visible: %f %f\n",x,y);
+		output_point(ctx,x,y);
 		}
 		}
 
 	/* Case 6:  (0 < ain2 <= 1) and (aout1 < ain2) */
 	/* Add turning vertex due to 2nd point */
-	else if (poly)
+	else if (c->poly)
 		{
 		if (axin > ayin)
 		{
-		if (debug) (void) printf("case-6: %f %f\n",xin,yout);
-			output_point(xin,yout);
+		if (c->debug) (void) printf("case-6: %f %f\n",xin,yout);
+			output_point(ctx,xin,yout);
 		}
 		else
 		{
-		if (debug) (void) printf("case-6: %f %f\n",xout,yin);
-			output_point(xout,yin);
+		if (c->debug) (void) printf("case-6: %f %f\n",xout,yin);
+			output_point(ctx,xout,yin);
 		}
 		}
 
 	/* Save current point (un-clipped) */
 	done:
-	xp  = x;
-	yp  = y;
+	c->xp  = x;
+	c->yp  = y;
 	}
 
 
 
-/** End the stream (Pen up) */
-void flush_clip(void)
+void	ctx_flush_clip(PIPE_CONTEXT ctx)
 	{
+	PIPE_CLIP	*c = &ctx->clip;
+
 	/* Force polygon to join if needed */
-	if (poly && closd)
+	if (c->poly && c->closd)
 		{
-		if (out) put_next(Pclip,xq,yq);
+		if (c->out) put_next(ctx,&ctx->Nclip,c->xq,c->yq);
 		}
 
 	/* Reset new-line flag and flush buffer */
-	flush_next(Pclip);
-	new = TRUE;
-	out = FALSE;
+	flush_next(ctx,&ctx->Nclip);
+	c->new = TRUE;
+	c->out = FALSE;
 	}
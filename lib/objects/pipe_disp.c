@@ -47,12 +47,8 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for disp module */
-static LOGICAL	New    = FALSE;
-static COLOUR	Colour = 0;
-static LSTYLE	Style  = 0;
-static float	xprev;
-static float	yprev;
+/* Flags and shared parameters for disp module are in PIPE_DISP */
+
 /**********************************************************************/
 /** Turn on screen display
  *
@@ -67,41 +63,53 @@ void enable_disp
 	)
 
 	{
-	enable_module(Pdisp);
-	New    = TRUE;
-	Colour = colour;
-	Style  = style;
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	enable_module(&ctx->Ndisp);
+	ctx->disp.new    = TRUE;
+	ctx->disp.colour = colour;
+	ctx->disp.style  = style;
 	}
 
 /** Turn off screen display */
 void disable_disp(void)
 	{
-	disable_module(Pdisp);
-	New    = FALSE;
-	Colour = 0;
-	Style  = 0;
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	disable_module(&ctx->Ndisp);
+	ctx->disp.new    = FALSE;
+	ctx->disp.colour = 0;
+	ctx->disp.style  = 0;
 	}
 
 /** Add the given point to the display */
 void put_disp(float x, float y)
+	{ ctx_put_disp(current_pipe(),x,y); }
+
+/** Terminate the current curve (Pen up) */
+void flush_disp(void)
+	{ ctx_flush_disp(current_pipe()); }
+
+void ctx_put_disp(PIPE_CONTEXT ctx, float x, float y)
 	{
-	if (!New)
+	PIPE_DISP	*d = &ctx->disp;
+
+	if (!d->new)
 		{
-		pipe_colour_fn(Colour,0);
-		pipe_lstyle_fn(Style,0.0,0.0);
-		pipe_move_fn(xprev,yprev);
+		pipe_colour_fn(d->colour,0);
+		pipe_lstyle_fn(d->style,0.0,0.0);
+		pipe_move_fn(d->xprev,d->yprev);
 		pipe_draw_fn(x,y);
 		}
-	New   = !New;
-	xprev = x;
-	yprev = y;
-	put_next(Pdisp,x,y);
+	d->new   = !d->new;
+	d->xprev = x;
+	d->yprev = y;
+	put_next(ctx,&ctx->Ndisp,x,y);
 	}
 
-/** Terminate the current curve (Pen up) */
-void flush_disp(void)
+void ctx_flush_disp(PIPE_CONTEXT ctx)
 	{
-	flush_next(Pdisp);
+	flush_next(ctx,&ctx->Ndisp);
 	pipe_flush_fn();
-	New = TRUE;
+	ctx->disp.new = TRUE;
 	}
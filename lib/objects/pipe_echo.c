@@ -47,8 +47,7 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for echo module */
-static COLOUR	Colour = 0;
+/* Flags and shared parameters for echo module are in PIPE_ECHO */
 
 /**********************************************************************/
 /** Turn on screen echo
@@ -62,27 +61,35 @@ void enable_echo
 	)
 
 	{
-	enable_module(Pecho);
-	Colour = colour;
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	enable_module(&ctx->Necho);
+	ctx->echo.colour = colour;
 	}
 
 /** Turn off screen echo */
 void disable_echo(void)
 	{
-	disable_module(Pecho);
+	disable_module(&current_pipe()->Necho);
 	}
 
 /** echo the given point */
 void put_echo(float x, float y)
+	{ ctx_put_echo(current_pipe(),x,y); }
+
+/** Does nothing */
+void flush_echo(void)
+	{ ctx_flush_echo(current_pipe()); }
+
+void ctx_put_echo(PIPE_CONTEXT ctx, float x, float y)
 	{
-	pipe_colour_fn(Colour,0);
+	pipe_colour_fn(ctx->echo.colour,0);
 	pipe_msize_fn(0.0);
 	pipe_mangle_fn(0.0);
 	pipe_marker_fn(0,x,y);
 	pipe_flush_fn();
-	put_next(Pecho,x,y);
+	put_next(ctx,&ctx->Necho,x,y);
 	}
 
-/** Does nothing */
-void flush_echo(void)
-	{ flush_next(Pecho); }
+void ctx_flush_echo(PIPE_CONTEXT ctx)
+	{ flush_next(ctx,&ctx->Necho); }
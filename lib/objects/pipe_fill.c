@@ -51,68 +51,68 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for fill module */
-static LOGICAL	new = FALSE;	/* start new point stream */
-static float	res = 0;		/* fill resolution */
-static float	xo, yo;			/* anchor point */
+/* Flags and shared parameters for fill module are in PIPE_FILL */
 
-/**********************************************************************/
-/** Turn on polyline filling
- *
- * 	@param[in]	fres	Resolution
- **********************************************************************/
 void enable_fill(float fres)
 	{
-	enable_module(Pfill);
-	new = TRUE;
-	res = fres;
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	enable_module(&ctx->Nfill);
+	ctx->fill.new = TRUE;
+	ctx->fill.res = fres;
 	}
 
-/** Turn off polyline filling */
 void disable_fill(void)
 	{
-	disable_module(Pfill);
-	new = FALSE;
-	res = 0;
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	disable_module(&ctx->Nfill);
+	ctx->fill.new = FALSE;
+	ctx->fill.res = 0;
 	}
 
-/** Add point to filled polyline */
 void put_fill(float x, float y)
+	{ ctx_put_fill(current_pipe(),x,y); }
+
+void flush_fill(void)
+	{ ctx_flush_fill(current_pipe()); }
+
+void ctx_put_fill(PIPE_CONTEXT ctx, float x, float y)
 	{
-	float	s, ds ,dx, dy, r;
+	float		s, ds ,dx, dy, r;
+	PIPE_FILL	*f = &ctx->fill;
 
 	/* Re-initialize at start of new line */
-	if (new) new = !new;
+	if (f->new) f->new = !f->new;
 
 	/* Perform intermediate output on subsequent point */
 	else	{
 		/* Compute arc-length */
-		s  = hypot(x-xo,y-yo);
+		s  = hypot(x-f->xo,y-f->yo);
 
 		/* Output intermediate points, if any */
-		if (s > res)
+		if (s > f->res)
 			{
-			r  = res/s;
-			dx = (x-xo)*r;
-			dy = (y-yo)*r;
-			for (ds=res; ds<s; ds+=res)
+			r  = f->res/s;
+			dx = (x-f->xo)*r;
+			dy = (y-f->yo)*r;
+			for (ds=f->res; ds<s; ds+=f->res)
 				{
-				xo += dx;
-				yo += dy;
-				put_next(Pfill,xo,yo);
+				f->xo += dx;
+				f->yo += dy;
+				put_next(ctx,&ctx->Nfill,f->xo,f->yo);
 				}
 			}
 		}
 
 	/* Output current point and save it for the next time */
-	put_next(Pfill,x,y);
-	xo = x;
-	yo = y;
+	put_next(ctx,&ctx->Nfill,x,y);
+	f->xo = x;
+	f->yo = y;
 	}
 
-/** Flush filled polyline (pen up) */
-void flush_fill(void)
+void ctx_flush_fill(PIPE_CONTEXT ctx)
 	{
-	new = TRUE;
-	flush_next(Pfill);
+	ctx->fill.new = TRUE;
+	flush_next(ctx,&ctx->Nfill);
 	}
@@ -51,120 +51,117 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for filter module */
-static LOGICAL	new = FALSE;	/* start new point stream */
-static LOGICAL	out = FALSE;	/* has a point been output yet? */
-static float	res = 0;		/* filter resolution */
-static float	ang = 0;		/* filter angle */
-static float	s   = 0;		/* accumulated arc length from anchor point */
-static float	a   = 0;		/* accumulated angle from anchor point */
-static float	ao  = 0;		/* anchor angle */
-static float	xo, yo;			/* anchor point */
-static float	xp, yp;			/* previous point recalled */
+/* Flags and shared parameters for filter module are in PIPE_FILTER */
 
-/**********************************************************************/
-/** Turn on polyline filtering 
- *
- * 	@param[in]	fres	Distance resolution
- * 	@param[in]	fang	Angle resolution
- **********************************************************************/
 void enable_filter(float fres, float fang)
 	{
-	enable_module(Pfilter);
-	new = TRUE;
-	out = FALSE;
-	res = fres;
-	ang = fang;
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_FILTER		*f  = &ctx->filter;
+
+	enable_module(&ctx->Nfilter);
+	f->new = TRUE;
+	f->out = FALSE;
+	f->res = fres;
+	f->ang = fang;
 	}
 
-/** Turn off polyline filtering */
 void disable_filter(void)
 	{
-	disable_module(Pfilter);
-	new = FALSE;
-	out = FALSE;
-	res = 0;
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_FILTER		*f  = &ctx->filter;
+
+	disable_module(&ctx->Nfilter);
+	f->new = FALSE;
+	f->out = FALSE;
+	f->res = 0;
 	}
 
-/** Add point to filtered polyline */
 void put_filter(float x, float y)
+	{ ctx_put_filter(current_pipe(),x,y); }
+
+void flush_filter(void)
+	{ ctx_flush_filter(current_pipe()); }
+
+void ctx_put_filter(PIPE_CONTEXT ctx, float x, float y)
 	{
+	PIPE_FILTER	*f = &ctx->filter;
+
 	/* Re-initialize at start of new line */
-	if (new)
+	if (f->new)
 		{
-		new = FALSE;
-		out = FALSE;
+		f->new = FALSE;
+		f->out = FALSE;
 		}
 
 	/* Perform arc-length filter on subsequent points */
 	else
 		{
 		/* Compute accumulated arc-length */
-		if (x==xp && x==yp) return;
-		if (res>0) s += hypot(x-xp,y-yp);
-		if (out && ang>0)
+		if (x==f->xp && x==f->yp) return;
+		if (f->res>0) f->s += hypot(x-f->xp,y-f->yp);
+		if (f->out && f->ang>0)
 			{
-			a = -ao;
-			if (fabs(y-yo)-fabs(x-xo) > (fabs(x)+fabs(y))/100000.0)
-				a += atan2(y-yo,x-xo);
-			a = fmod(a, PI);
-			a = fabs(a);
+			f->a = -f->ao;
+			if (fabs(y-f->yo)-fabs(x-f->xo) > (fabs(x)+fabs(y))/100000.0)
+				f->a += atan2(y-f->yo,x-f->xo);
+			f->a = fmod(f->a, PI);
+			f->a = fabs(f->a);
 			}
 
 		/* If accumulated arc-length is less than resolution, */
 		/* and accumulated angle is less than resolution, */
 		/* retain anchor point and replace previous point */
-		if ((ang<=0 || a<=ang) && (res<=0 || s<=res))
+		if ((f->ang<=0 || f->a<=f->ang) && (f->res<=0 || f->s<=f->res))
 			{
-			xp = x;
-			yp = y;
+			f->xp = x;
+			f->yp = y;
 			return;
 			}
 
 		/* Otherwise, pass anchor point on to buffer */
 		else
 			{
-			out = TRUE;
-			put_next(Pfilter,xo,yo);
+			f->out = TRUE;
+			put_next(ctx,&ctx->Nfilter,f->xo,f->yo);
 			}
 		}
 
 	/* Reset current arc-length, reset anchor point and */
 	/* save current point */
-	s  = 0;
-	a  = 0;
-	ao = 0;
-	if (out && (fabs(y-yo)-fabs(x-xo) > (fabs(x)+fabs(y))/100000.0))
-		ao = atan2(y-yo,x-xo);
-	xo = x;
-	yo = y;
-	xp = x;
-	yp = y;
+	f->s  = 0;
+	f->a  = 0;
+	f->ao = 0;
+	if (f->out && (fabs(y-f->yo)-fabs(x-f->xo) > (fabs(x)+fabs(y))/100000.0))
+		f->ao = atan2(y-f->yo,x-f->xo);
+	f->xo = x;
+	f->yo = y;
+	f->xp = x;
+	f->yp = y;
 	}
 
-/** Flush filtered polyline (pen up) */
-void flush_filter(void)
+void ctx_flush_filter(PIPE_CONTEXT ctx)
 	{
-	float	ds;
+	float		ds;
+	PIPE_FILTER	*f = &ctx->filter;
 
 	/* Pass last point on to buffer and flush line */
-	if (!new)
+	if (!f->new)
 		{
-		if (!out)
+		if (!f->out)
 			{
-			ds  = 100 * hypot(xp-xo,yp-yo);
-			if (ds < res)
+			ds  = 100 * hypot(f->xp-f->xo,f->yp-f->yo);
+			if (ds < f->res)
 				{
-				new = TRUE;
-				out = FALSE;
-				flush_next(Pfilter);
+				f->new = TRUE;
+				f->out = FALSE;
+				flush_next(ctx,&ctx->Nfilter);
 				return;
 				}
-			put_next(Pfilter,xo,yo);
+			put_next(ctx,&ctx->Nfilter,f->xo,f->yo);
 			}
-		put_next(Pfilter,xp,yp);
+		put_next(ctx,&ctx->Nfilter,f->xp,f->yp);
 		}
-	new = TRUE;
-	out = FALSE;
-	flush_next(Pfilter);
+	f->new = TRUE;
+	f->out = FALSE;
+	flush_next(ctx,&ctx->Nfilter);
 	}
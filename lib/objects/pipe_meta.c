@@ -53,12 +53,8 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for meta module */
-static CURVE	Curve       = NULL;
-static METAFILE	Meta        = NULL;
-static char		Entity[41]  = "";
-static char		Element[41] = "";
-static char		Level[41]   = "";
+/* Flags and shared parameters for meta module are in PIPE_META */
+
 /**********************************************************************/
 /** Turn on output to metafile
  *
@@ -84,50 +80,79 @@ void		enable_meta
 	)
 
 	{
-	enable_module(Pmeta);
-	if (!Curve) Curve = create_curve(subelem,value,labst);
-	else        define_curve_value(Curve,subelem,value,labst);
-	empty_curve(Curve);
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_META		*m  = &ctx->metaout;
+
+	enable_module(&ctx->Nmeta);
+	if (!m->curve) m->curve = create_curve(subelem,value,labst);
+	else           define_curve_value(m->curve,subelem,value,labst);
+	empty_curve(m->curve);
 
 	/* Save line descriptors */
-	Meta = meta;
-	(void) strncpy(Entity,ent,40);
-	(void) strncpy(Element,elem,40);
-	(void) strncpy(Level,lev,40);
+	m->meta = meta;
+	(void) strncpy(m->entity,ent,40);
+	(void) strncpy(m->element,elem,40);
+	(void) strncpy(m->level,lev,40);
 	}
 
 /** Turn off output to metafile */
 void disable_meta(void)
 	{
-	disable_module(Pmeta);
-	Curve = destroy_curve(Curve);
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	disable_module(&ctx->Nmeta);
+	ctx_clean_meta(ctx);
 	}
 
 /** Add point to buffered polyline */
 void put_meta(float x, float y)
+	{ ctx_put_meta(current_pipe(),x,y); }
+
+/** Flush buffered polyline (pen up) */
+void flush_meta(void)
+	{ ctx_flush_meta(current_pipe()); }
+
+void ctx_put_meta(PIPE_CONTEXT ctx, float x, float y)
 	{
 	POINT	p;
 
 	/* Add point to curve */
 	p[X] = x;
 	p[Y] = y;
-	add_point_to_curve(Curve,p);
-	put_next(Pmeta,x,y);
+	add_point_to_curve(ctx->metaout.curve,p);
+	put_next(ctx,&ctx->Nmeta,x,y);
 	}
 
-/** Flush buffered polyline (pen up) */
-void flush_meta(void)
+void ctx_putn_meta(PIPE_CONTEXT ctx, POINT *pts, int npts)
+	{
+	CURVE	curve = ctx->metaout.curve;
+
+	/* Add points to curve */
+	if (!curve) return;
+	if (!curve->line) curve->line = create_line();
+	add_points_to_line(curve->line,pts,npts);
+	put_next_array(ctx,&ctx->Nmeta,pts,npts);
+	}
+
+void ctx_flush_meta(PIPE_CONTEXT ctx)
 	{
-	CURVE	c;
+	CURVE		c;
+	PIPE_META	*m = &ctx->metaout;
 
 	/* Place the new curve into the metafile */
-	if (Curve->line->numpts > 0)
+	if (m->curve->line->numpts > 0)
 		{
-		c = copy_curve(Curve);
-		add_item_to_metafile(Meta,"curve",Entity,Element,Level,(ITEM) c);
+		c = copy_curve(m->curve);
+		add_item_to_metafile(m->meta,"curve",m->entity,m->element,m->level,
+						(ITEM) c);
 		}
 
 	/* Empty the curve and flush the rest of the pipe */
-	empty_curve(Curve);
-	flush_next(Pmeta);
+	empty_curve(m->curve);
+	flush_next(ctx,&ctx->Nmeta);
+	}
+
+void ctx_clean_meta(PIPE_CONTEXT ctx)
+	{
+	ctx->metaout.curve = destroy_curve(ctx->metaout.curve);
 	}
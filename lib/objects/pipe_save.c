@@ -52,111 +52,132 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Shared parameters */
-static	LINE	*Lstack[] = { NULL, NULL, NULL, NULL, NULL };
-static	int		Nstack[]  = {    0,    0,    0,    0,    0 };
-static	int		Istack    = 0;
-static	int		Mstack    = 5;
-
-static	LINE	**Lbuf    = Lstack;
-static	int		*Nbuf     = Nstack;
-
-static	LOGICAL	New       = FALSE;
-static	LINE	Line      = NULL;
-
-static	void	clean_save(void);
+/* Shared parameters are in PIPE_SAVE - the saved lines are kept in */
+/* lstack[istack] and nstack[istack] */
 
 /** Turn on saving */
 void	enable_save(void)
 	{
-	enable_module(Psave);
-	clean_save();
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	enable_module(&ctx->Nsave);
+	ctx_clean_save(ctx);
 	}
 
 /** Turn off saving */
 void	disable_save(void)
 	{
-	disable_module(Psave);
-	clean_save();
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	disable_module(&ctx->Nsave);
+	ctx_clean_save(ctx);
 	}
 
 /** Add point to current curve */
 void	put_save(float x, float y)
-	{
-	POINT	p;
-	int		last;
-
-	/* If starting new line - add a fresh line to the array */
-	if (New)
-		{
-		last  = (*Nbuf)++;
-		*Lbuf = GETMEM(*Lbuf,LINE,*Nbuf);
-		(*Lbuf)[last] = create_line();
-		Line  = (*Lbuf)[last];
-		New   = FALSE;
-		}
-
-	/* Add given point to the current line */
-	p[X] = x;
-	p[Y] = y;
-	add_point_to_line(Line,p);
-	put_next(Psave,x,y);
-	}
+	{ ctx_put_save(current_pipe(),x,y); }
 
 /** End current curve (pen up) */
 void	flush_save(void)
-	{
-	New = TRUE;
-	flush_next(Psave);
-	}
+	{ ctx_flush_save(current_pipe()); }
 
 /** Retrieve the saved lines */
 int		recall_save(LINE **lbuf)
 	{
-	if (lbuf) *lbuf = *Lbuf;
-	return *Nbuf;
+	PIPE_SAVE	*sv = &current_pipe()->save;
+
+	if (lbuf) *lbuf = sv->lstack[sv->istack];
+	return sv->nstack[sv->istack];
 	}
 
 /** Push current saved lines onto stack */
 LOGICAL	push_save(void)
 	{
-	if (Istack >= Mstack-1)
+	PIPE_SAVE	*sv = &current_pipe()->save;
+
+	if (sv->istack >= PIPE_SAVE_STACK-1)
 		{
 		(void) printf("[push_save] Stack overflow\n");
 		return FALSE;
 		}
 
-	Istack++;
-	Lbuf = Lstack + Istack;
-	Nbuf = Nstack + Istack;
+	sv->istack++;
 	return TRUE;
 	}
 
 /** Pop current saved lines off stack */
 LOGICAL	pop_save(void)
 	{
-	if (Istack <= 0)
+	PIPE_CONTEXT	ctx = current_pipe();
+
+	if (ctx->save.istack <= 0)
 		{
 		(void) printf("[push_save] Stack underflow\n");
 		return FALSE;
 		}
 
-	clean_save();
+	ctx_clean_save(ctx);
 
-	Istack--;
-	Lbuf = Lstack + Istack;
-	Nbuf = Nstack + Istack;
+	ctx->save.istack--;
 	return TRUE;
 	}
 
-static	void	clean_save(void)
+void	ctx_put_save(PIPE_CONTEXT ctx, float x, float y)
+	{
+	POINT		p;
+	int			last;
+	PIPE_SAVE	*sv = &ctx->save;
+	LINE		**lbuf;
+
+	/* If starting new line - add a fresh line to the array */
+	if (sv->new)
+		{
+		lbuf     = &sv->lstack[sv->istack];
+		last     = sv->nstack[sv->istack]++;
+		*lbuf    = GETMEM(*lbuf,LINE,sv->nstack[sv->istack]);
+		(*lbuf)[last] = create_line();
+		sv->line = (*lbuf)[last];
+		sv->new  = FALSE;
+		}
+
+	/* Add given point to the current line */
+	p[X] = x;
+	p[Y] = y;
+	add_point_to_line(sv->line,p);
+	put_next(ctx,&ctx->Nsave,x,y);
+	}
+
+void	ctx_putn_save(PIPE_CONTEXT ctx, POINT *pts, int npts)
+	{
+	PIPE_SAVE	*sv = &ctx->save;
+
+	/* Add the first point as usual to start a new line if needed */
+	ctx_put_save(ctx,pts[0][X],pts[0][Y]);
+	if (npts <= 1) return;
+
+	/* Add the rest of the points to the current line */
+	add_points_to_line(sv->line,pts+1,npts-1);
+	put_next_array(ctx,&ctx->Nsave,pts+1,npts-1);
+	}
+
+void	ctx_flush_save(PIPE_CONTEXT ctx)
+	{
+	ctx->save.new = TRUE;
+	flush_next(ctx,&ctx->Nsave);
+	}
+
+/* Empty the current saved lines */
+void	ctx_clean_save(PIPE_CONTEXT ctx)
 	{
-	int	i;
-
-	for (i=0; i<*Nbuf; i++)
-		destroy_line((*Lbuf)[i]);
-	FREEMEM(*Lbuf);
-	*Nbuf = 0;
-	Line  = NULL;
-	New   = TRUE;
+	int			i;
+	PIPE_SAVE	*sv = &ctx->save;
+	LINE		**lbuf;
+
+	lbuf = &sv->lstack[sv->istack];
+	for (i=0; i<sv->nstack[sv->istack]; i++)
+		destroy_line((*lbuf)[i]);
+	FREEMEM(*lbuf);
+	sv->nstack[sv->istack] = 0;
+	sv->line = NULL;
+	sv->new  = TRUE;
 	}
@@ -64,6 +64,7 @@
 
 #include "pipeP.h"
 #include <fpa_math.h>
+#include <fpa_getmem.h>
 /***********************************************************************
 *                                                                      *
 *       e n a b l e _ s p l i n e   - turn on spline                   *
@@ -104,25 +105,15 @@
 *                                                                      *
 ***********************************************************************/
 
-/* Flags and shared parameters for spline module */
-static	float	ds, tau, per, amp, eps;
-static	LOGICAL	clsd, saved=FALSE;
-static	int		np = 0;
-static	float	s  = 0;
-static	float	xfirst, xsecond, xthird, xclose;
-static	float	yfirst, ysecond, ythird, yclose;
-static	float	xa,ya,sa, txa,tya,tsa;
-static	float	xb,yb,sb, txb,tyb,tsb;
-static	float	xc,yc,sc, txc,tyc,tsc;
-static	float	axl,bxl,cxl,dxl, ayl,byl,cyl,dyl;
-static	float	axr,bxr,cxr,dxr, ayr,byr,cyr,dyr;
-
-static	void	shift_segment(void);
-static	void	spline_segment(void);
+/* Flags and shared parameters for spline module are in PIPE_SPLINE */
+
+static	void	shift_segment(PIPE_SPLINE *);
+static	void	spline_segment(PIPE_CONTEXT);
 static	void	do_tension(float, float, float, float, float *, float *,
 						float *);
-static	void	define_scallop(float, float, float, float, float, float);
-static	void	do_scallop(float *, float *, float);
+static	void	define_scallop(PIPE_SPLINE *, float, float, float, float, float,
+						float);
+static	void	do_scallop(PIPE_SPLINE *, float *, float *, float);
 
 
 
@@ -145,19 +136,22 @@ void	enable_spline
 	)
 
 	{
+	PIPE_CONTEXT	ctx = current_pipe();
+	PIPE_SPLINE		*sp = &ctx->spline;
+
 	/* Enable the module */
-	enable_module(Pspline);
+	enable_module(&ctx->Nspline);
 
 	/* Set appropriate parameters */
-	ds    = resolution;
-	clsd  = closed;
-	tau   = tension;
-	per   = period;
-	amp   = amplitude;
-	eps   = ds/10;
-	np    = 0;
-	s     = 0;
-	saved = FALSE;
+	sp->ds    = resolution;
+	sp->clsd  = closed;
+	sp->tau   = tension;
+	sp->per   = period;
+	sp->amp   = amplitude;
+	sp->eps   = sp->ds/10;
+	sp->np    = 0;
+	sp->s     = 0;
+	sp->saved = FALSE;
 	}
 
 
@@ -165,173 +159,235 @@ void	enable_spline
 /** Turn off spline */
 void	disable_spline(void)
 	{
-	disable_module(Pspline);
+	disable_module(&current_pipe()->Nspline);
 	}
 
 
 
 /** Add given point to spline */
 void	put_spline(float x, float y)
+	{ ctx_put_spline(current_pipe(),x,y); }
+
+
+
+/** End the stream (close if spec) */
+void	flush_spline(void)
+	{ ctx_flush_spline(current_pipe()); }
+
+
+
+void	ctx_put_spline(PIPE_CONTEXT ctx, float x, float y)
 	{
+	PIPE_SPLINE	*sp = &ctx->spline;
+
 	/* Count points */
-	np++;
+	sp->np++;
 
 	/* Save first point and do tension transformation */
-	if (np == 1)
+	if (sp->np == 1)
 		{
-		xa = x;
-		ya = y;
-		sa = 0;
-		do_tension(tau,xa,ya,sa,&txa,&tya,&tsa);
+		sp->xa = x;
+		sp->ya = y;
+		sp->sa = 0;
+		do_tension(sp->tau,sp->xa,sp->ya,sp->sa,&sp->txa,&sp->tya,&sp->tsa);
 
 		/* Save first point on closed contours for closure condition */
-		if (clsd)
+		if (sp->clsd)
 			{
-			xfirst = x;
-			yfirst = y;
+			sp->xfirst = x;
+			sp->yfirst = y;
 			}
 		else
 			{
-			s = sa;
-			define_scallop(xa,ya,sa,ds,per,amp);
+			sp->s = sp->sa;
+			define_scallop(sp,sp->xa,sp->ya,sp->sa,sp->ds,sp->per,sp->amp);
 			}
 		return;
 		}
 
 	/* Save second point and do tension transformation */
-	else if (np == 2)
+	else if (sp->np == 2)
 		{
-		xb = x;
-		yb = y;
-		sb = sa + hypot((xb-xa),(yb-ya));
-		if ((sb-sa) < eps) { np--; return; }
-		do_tension(tau,xb,yb,sb,&txb,&tyb,&tsb);
+		sp->xb = x;
+		sp->yb = y;
+		sp->sb = sp->sa + hypot((sp->xb-sp->xa),(sp->yb-sp->ya));
+		if ((sp->sb-sp->sa) < sp->eps) { sp->np--; return; }
+		do_tension(sp->tau,sp->xb,sp->yb,sp->sb,&sp->txb,&sp->tyb,&sp->tsb);
 
 		/* Compute linear-parametric coefficients on left-hand segment */
 		/* dxl and dxr are needed for closed or open contours */
-		dxl = (txb-txa) / (tsb-tsa);	dyl = (tyb-tya) / (tsb-tsa);
-		axl = 0;				ayl = 0;
-		bxl = dxl;				byl = dyl;
-		cxl = txa - tsa*bxl;		cyl = tya - tsa*byl;
+		sp->dxl = (sp->txb-sp->txa) / (sp->tsb-sp->tsa);
+		sp->dyl = (sp->tyb-sp->tya) / (sp->tsb-sp->tsa);
+		sp->axl = 0;
+		sp->ayl = 0;
+		sp->bxl = sp->dxl;
+		sp->byl = sp->dyl;
+		sp->cxl = sp->txa - sp->tsa*sp->bxl;
+		sp->cyl = sp->tya - sp->tsa*sp->byl;
 
 		/* Save second point on closed contours for closure condition */
-		if (clsd)
+		if (sp->clsd)
 			{
-			s       = sb;
-			xsecond = x;
-			ysecond = y;
-			define_scallop(xb,yb,sb,ds,per,amp);
+			sp->s       = sp->sb;
+			sp->xsecond = x;
+			sp->ysecond = y;
+			define_scallop(sp,sp->xb,sp->yb,sp->sb,sp->ds,sp->per,sp->amp);
 			}
 		return;
 		}
 
 	/* Save third and subsequent points and do tension transformation */
-	xc = x;
-	yc = y;
-	sc = sb + hypot((xc-xb),(yc-yb));
-	if ((sc-sb) < eps) { np--; return; }
-	do_tension(tau,xc,yc,sc,&txc,&tyc,&tsc);
+	sp->xc = x;
+	sp->yc = y;
+	sp->sc = sp->sb + hypot((sp->xc-sp->xb),(sp->yc-sp->yb));
+	if ((sp->sc-sp->sb) < sp->eps) { sp->np--; return; }
+	do_tension(sp->tau,sp->xc,sp->yc,sp->sc,&sp->txc,&sp->tyc,&sp->tsc);
 
 	/* Compute quadratic-parametric coefficients on right-hand segment */
-	dxr = (txc-txb) / (tsc-tsb);		dyr = (tyc-tyb) / (tsc-tsb);
-	axr = (dxr-dxl) / (tsc-tsa);		ayr = (dyr-dyl) / (tsc-tsa);
-	bxr = dxl - axr*(tsb+tsa);		byr = dyl - ayr*(tsb+tsa);
-	cxr = txa - tsa*(bxr+tsa*axr);		cyr = tya - tsa*(byr+tsa*ayr);
+	sp->dxr = (sp->txc-sp->txb) / (sp->tsc-sp->tsb);
+	sp->dyr = (sp->tyc-sp->tyb) / (sp->tsc-sp->tsb);
+	sp->axr = (sp->dxr-sp->dxl) / (sp->tsc-sp->tsa);
+	sp->ayr = (sp->dyr-sp->dyl) / (sp->tsc-sp->tsa);
+	sp->bxr = sp->dxl - sp->axr*(sp->tsb+sp->tsa);
+	sp->byr = sp->dyl - sp->ayr*(sp->tsb+sp->tsa);
+	sp->cxr = sp->txa - sp->tsa*(sp->bxr+sp->tsa*sp->axr);
+	sp->cyr = sp->tya - sp->tsa*(sp->byr+sp->tsa*sp->ayr);
 
 	/* Save third point of closed contours for closure condition */
-	if ((np == 3) && clsd)
+	if ((sp->np == 3) && sp->clsd)
 		{
-		xthird = x;
-		ythird = y;
+		sp->xthird = x;
+		sp->ythird = y;
 		}
 
 	/* Generate points throughout the segment overlap */
-	else spline_segment();
+	else spline_segment(ctx);
 
 	/* Shift right-hand segment into left for next call */
-	shift_segment();
+	shift_segment(sp);
 	}
 
 
-static	void	spline_segment(void)
+static	void	spline_segment(PIPE_CONTEXT ctx)
 	{
-	float	xp, yp, wl, wr, twl, twr, ts;
+	int			i, n;
+	float		s, wl, wr, twl, twr, ts;
+	float		*sbuf;
+	POINT		*pbuf;
+	PIPE_SPLINE	*sp = &ctx->spline;
+
+	/* Find the arc-length of each point in the segment overlap */
+	/* (accumulated exactly as when done one point at a time) */
+	n = 0;
+	for (s=sp->s; s<sp->sb; s+=sp->ds) n++;
+	if (n <= 0) return;
+	if (n > sp->mbuf)
+		{
+		sp->mbuf = MAX(n, 2*sp->mbuf);
+		sp->sbuf = GETMEM(sp->sbuf, float, sp->mbuf);
+		sp->pbuf = GETMEM(sp->pbuf, POINT, sp->mbuf);
+		}
+	sbuf = sp->sbuf;
+	pbuf = sp->pbuf;
+	for (i=0; i<n; i++, sp->s+=sp->ds) sbuf[i] = sp->s;
 
 	/* Generate points throughout the segment overlap */
-	while (s < sb)
+	/* (each point is independent of the others) */
+	for (i=0; i<n; i++)
 		{
-		do_tension(tau,1.,1.,s,&twl,&twr,&ts);
-		wl = (sb-s)/(sb-sa)/twl;
-		wr = (s-sa)/(sb-sa)/twr;
-		xp = wl*( (axl*ts + bxl)*ts + cxl)
-		   + wr*( (axr*ts + bxr)*ts + cxr);
-		yp = wl*( (ayl*ts + byl)*ts + cyl)
-		   + wr*( (ayr*ts + byr)*ts + cyr);
-		do_scallop(&xp,&yp,s);
-		put_next(Pspline,xp,yp);
-		if (!saved)
-			{
-			xclose = xp;
-			yclose = yp;
-			saved  = TRUE;
-			}
-		s += ds;
+		s  = sbuf[i];
+		do_tension(sp->tau,1.,1.,s,&twl,&twr,&ts);
+		wl = (sp->sb-s)/(sp->sb-sp->sa)/twl;
+		wr = (s-sp->sa)/(sp->sb-sp->sa)/twr;
+		pbuf[i][X] = wl*( (sp->axl*ts + sp->bxl)*ts + sp->cxl)
+				   + wr*( (sp->axr*ts + sp->bxr)*ts + sp->cxr);
+		pbuf[i][Y] = wl*( (sp->ayl*ts + sp->byl)*ts + sp->cyl)
+				   + wr*( (sp->ayr*ts + sp->byr)*ts + sp->cyr);
 		}
+
+	/* Add the scallop (each point depends on the one before) */
+	if (sp->swave)
+		{
+		for (i=0; i<n; i++)
+			do_scallop(sp,&pbuf[i][X],&pbuf[i][Y],sbuf[i]);
+		}
+
+	/* Pass the points along */
+	if (!sp->saved)
+		{
+		sp->xclose = pbuf[0][X];
+		sp->yclose = pbuf[0][Y];
+		sp->saved  = TRUE;
+		}
+	put_next_array(ctx,&ctx->Nspline,pbuf,n);
 	}
 
 
-static	void	shift_segment(void)
+static	void	shift_segment(PIPE_SPLINE *sp)
 	{
 	/* Shift right-hand segment into left for next call */
-	xa  = xb;	xb  = xc;
-	ya  = yb;	yb  = yc;
-	sa  = sb;	sb  = sc;
-	txa = txb;	txb = txc;
-	tya = tyb;	tyb = tyc;
-	tsa = tsb;	tsb = tsc;
-
-	axl = axr;	ayl = ayr;
-	bxl = bxr;	byl = byr;
-	cxl = cxr;	cyl = cyr;
-	dxl = dxr;	dyl = dyr;
+	sp->xa  = sp->xb;	sp->xb  = sp->xc;
+	sp->ya  = sp->yb;	sp->yb  = sp->yc;
+	sp->sa  = sp->sb;	sp->sb  = sp->sc;
+	sp->txa = sp->txb;	sp->txb = sp->txc;
+	sp->tya = sp->tyb;	sp->tyb = sp->tyc;
+	sp->tsa = sp->tsb;	sp->tsb = sp->tsc;
+
+	sp->axl = sp->axr;	sp->ayl = sp->ayr;
+	sp->bxl = sp->bxr;	sp->byl = sp->byr;
+	sp->cxl = sp->cxr;	sp->cyl = sp->cyr;
+	sp->dxl = sp->dxr;	sp->dyl = sp->dyr;
 	}
 
 
 
-/** End the stream (close if spec) */
-void	flush_spline(void)
+void	ctx_clean_spline(PIPE_CONTEXT ctx)
 	{
+	FREEMEM(ctx->spline.sbuf);
+	FREEMEM(ctx->spline.pbuf);
+	ctx->spline.mbuf = 0;
+	}
+
+
+
+void	ctx_flush_spline(PIPE_CONTEXT ctx)
+	{
+	PIPE_SPLINE	*sp = &ctx->spline;
+
 	/* For closed contours simulate put_spline calls for the first  */
 	/* three points to accomplish the closure condition */
-	if (clsd)
+	if (sp->clsd)
 		{
-		if (np < 3) goto reset;
-		put_spline(xfirst,yfirst);
-		put_spline(xsecond,ysecond);
-		put_spline(xthird,ythird);
+		if (sp->np < 3) goto reset;
+		ctx_put_spline(ctx,sp->xfirst,sp->yfirst);
+		ctx_put_spline(ctx,sp->xsecond,sp->ysecond);
+		ctx_put_spline(ctx,sp->xthird,sp->ythird);
 		}
 
 	/* For open contours compute linear-parametric coefficients in */
 	/* remaining segment */
 	else
 		{
-		if (np < 2) goto reset;
-		axr = 0;				ayr = 0;
-		bxr = dxl;				byr = dyl;
-		cxr = txb - tsb*bxr;	cyr = tyb - tsb*byr;
-
-		spline_segment();
-		shift_segment();
+		if (sp->np < 2) goto reset;
+		sp->axr = 0;
+		sp->ayr = 0;
+		sp->bxr = sp->dxl;
+		sp->byr = sp->dyl;
+		sp->cxr = sp->txb - sp->tsb*sp->bxr;
+		sp->cyr = sp->tyb - sp->tsb*sp->byr;
+
+		spline_segment(ctx);
+		shift_segment(sp);
 		}
 
 	/* Now output last point and flush */
-	if (clsd && saved) put_next(Pspline,xclose,yclose);
-	else               put_next(Pspline,xa,ya);
+	if (sp->clsd && sp->saved) put_next(ctx,&ctx->Nspline,sp->xclose,sp->yclose);
+	else                       put_next(ctx,&ctx->Nspline,sp->xa,sp->ya);
 	reset:
-	flush_next(Pspline);
-	np    = 0;
-	s     = 0;
-	saved = FALSE;
+	flush_next(ctx,&ctx->Nspline);
+	sp->np    = 0;
+	sp->s     = 0;
+	sp->saved = FALSE;
 	}
 
 
@@ -404,14 +460,10 @@ static	void	do_tension
 *                                                                      *
 ***********************************************************************/
 
-/* Common parameters */
-static	LOGICAL	enabled = FALSE;
-static	LOGICAL	scallop = FALSE;
-static	float	xo, yo, so, freq, ampl;
-
 static	void	define_scallop
 
 	(
+	PIPE_SPLINE	*sp,
 	float	px,
 	float	py,
 	float	ps,
@@ -422,22 +474,23 @@ static	void	define_scallop
 
 	{
 	/* Exit if not enabled */
-	enabled = (period != 0) && (amplitude != 0);
-	if (!enabled) return;
+	sp->swave = (period != 0) && (amplitude != 0);
+	if (!sp->swave) return;
 
 	/* Save anchor point and parameters */
-	xo = px;
-	yo = py;
-	so = ps;
-	ampl  = amplitude / resolution;
-	freq  = PI / fabs(period);
-	scallop = period < 0;
+	sp->xo = px;
+	sp->yo = py;
+	sp->so = ps;
+	sp->ampl    = amplitude / resolution;
+	sp->freq    = PI / fabs(period);
+	sp->scallop = period < 0;
 	}
 
 
 static	void	do_scallop
 
 	(
+	PIPE_SPLINE	*sp,
 	float	*px,
 	float	*py,
 	float	ps
@@ -447,18 +500,18 @@ static	void	do_scallop
 	float	t, dx, dy;
 
 	/* Skip if disabled */
-	if (!enabled) return;
+	if (!sp->swave) return;
 
 	/* Compute the scallop as a sinusoid */
-	t = sin(freq*(ps-so));
-	if (scallop) t = fabs(t);
-	t *= ampl;
-	dx = t*(*py-yo);
-	dy = t*(*px-xo);
+	t = sin(sp->freq*(ps-sp->so));
+	if (sp->scallop) t = fabs(t);
+	t *= sp->ampl;
+	dx = t*(*py-sp->yo);
+	dy = t*(*px-sp->xo);
 
 	/* Modify the point and save unmodified point for next time */
-	xo   = *px;
-	yo   = *py;
+	sp->xo   = *px;
+	sp->yo   = *py;
 	*px -= dx;
 	*py += dy;
 	}
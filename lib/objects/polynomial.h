@@ -84,6 +84,8 @@ double	zeroin_unipoly(UNIPOLY *func, float cval, float xstart, float xend,
 void	init_bipoly(BIPOLY *func);
 void	copy_bipoly(BIPOLY *fnew, const BIPOLY *func);
 double	evaluate_bipoly(BIPOLY *func, POINT pos);
+void	evaluate_bipoly_many(BIPOLY *func, int npts, const float *u,
+						const float *v, double *vals);
 void	differentiate_bipoly(BIPOLY *func, BIPOLY *dfds, char coord);
 void	project_bipoly(BIPOLY *func, UNIPOLY *fnew, char coord, float value);
 double	zeroin_bipoly(BIPOLY *func, float cval, POINT centre, float radius,
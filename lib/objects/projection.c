@@ -118,6 +118,12 @@ static	LOGICAL	lc_xy_ll(const MAP_PROJ *, float, float, float *, float *);
 static	LOGICAL	lc_xy_llu(const MAP_PROJ *, float, float, float *, float *);
 static	LOGICAL	lc_distort(const MAP_PROJ *, float, float, float *, float *);
 
+static	LOGICAL	float_projection_math(void);
+static	void	ll_xy_array(const MAP_PROJ *, int, const float *, const float *,
+							float *, float *, LOGICAL *);
+static	void	xy_ll_array(const MAP_PROJ *, int, const float *, const float *,
+							float *, float *, LOGICAL *);
+
 /* Define useful internal constants */
 /* RE = radius of Earth (m) */
 #define	RE 6367650.0
@@ -138,6 +144,13 @@ static	LOGICAL	lc_distort(const MAP_PROJ *, float, float, float *, float *);
 #define ProjectRho1    parm[1]
 #define ProjectPsi     parm[2]
 
+/* Number of points transformed at a time by the array functions */
+#define PROJ_CHUNK 256
+
+/* Single point transforms (used by the array functions for projections */
+/* that do not have their own array kernel) */
+typedef	LOGICAL	(*PROJ_FUNC)(const MAP_PROJ *, float, float, float *, float *);
+
 /***********************************************************************
 *                                                                      *
 *      d e f i n e _ m a p _ d e f                                     *
@@ -2173,6 +2186,225 @@ LOGICAL	pos_to_pos
 		}
 	}
 
+/***********************************************************************
+*                                                                      *
+*     l l _ t o _ p o s _ a r r a y                                    *
+*                                                                      *
+*     p o s _ t o _ l l _ a r r a y                                    *
+*                                                                      *
+*     p o s _ t o _ p o s _ a r r a y                                  *
+*                                                                      *
+*     Array forms of ll_to_pos(), pos_to_ll() and pos_to_pos(). The    *
+*     projections are examined once for the whole array and the        *
+*     points are then transformed a chunk at a time by a loop for      *
+*     the given projection, rather than going through the projection  *
+*     switch (and for pos_to_pos() the same_projection() test) for     *
+*     every point.                                                     *
+*                                                                      *
+*     The results are the same as the single point functions, unless   *
+*     the "Projection.Math" advanced feature (or FPA_PROJECTION_MATH)  *
+*     is set to "float", in which case the polar stereographic and     *
+*     Lambert conformal kernels use single precision arithmetic.       *
+*                                                                      *
+***********************************************************************/
+
+/*********************************************************************/
+/** For given arrays of lat, lon returns x, y from origin of mproj
+ *
+ *	@param[in]  *mproj	given map projection
+ *	@param[in] 	npos	number of points
+ *	@param[in] 	*lat	given latitudes
+ *	@param[in] 	*lon	given longitudes
+ *	@param[out]	*pos	return map positions
+ *	@param[out]	*valid	return which points were transformed (may be NULL)
+ *  @return True if all points were transformed.
+ *********************************************************************/
+LOGICAL	ll_to_pos_array
+
+	(
+	const MAP_PROJ	*mproj,
+	int				npos,
+	const float		*lat,
+	const float		*lon,
+	POINT			*pos,
+	LOGICAL			*valid
+	)
+
+	{
+	int		ip, nc, ic;
+	LOGICAL	all = TRUE;
+	float	xs[PROJ_CHUNK], ys[PROJ_CHUNK];
+	LOGICAL	ok[PROJ_CHUNK];
+
+	/* Error return for missing parameters */
+	if (!mproj)             return FALSE;
+	if (npos <= 0)          return TRUE;
+	if (!lat || !lon)       return FALSE;
+	if (!pos)               return FALSE;
+
+	for (ip=0; ip<npos; ip+=nc)
+		{
+		nc = MIN(npos-ip, PROJ_CHUNK);
+		ll_xy_array(mproj, nc, lat+ip, lon+ip, xs, ys, ok);
+		for (ic=0; ic<nc; ic++)
+			{
+			if (fabs((double) lat[ip+ic]) > 90) ok[ic] = FALSE;
+			pos[ip+ic][X] = (ok[ic])? xs[ic]: 0;
+			pos[ip+ic][Y] = (ok[ic])? ys[ic]: 0;
+			if (!ok[ic]) all = FALSE;
+			if (valid) valid[ip+ic] = ok[ic];
+			}
+		}
+	return all;
+	}
+
+/*********************************************************************/
+/** For given array of x, y from origin of mproj returns lat and lon
+ *
+ *	@param[in]   *mproj	given map projection
+ *	@param[in] 	npos	number of points
+ *	@param[in] 	*pos	given map positions
+ *	@param[out]	*lat	return latitudes
+ *	@param[out]	*lon	return longitudes
+ *	@param[out]	*valid	return which points were transformed (may be NULL)
+ *  @return True if all points were transformed.
+ *********************************************************************/
+LOGICAL	pos_to_ll_array
+
+	(
+	const MAP_PROJ	*mproj,
+	int				npos,
+	POINT			*pos,
+	float			*lat,
+	float			*lon,
+	LOGICAL			*valid
+	)
+
+	{
+	int		ip, nc, ic;
+	LOGICAL	all = TRUE;
+	float	xs[PROJ_CHUNK], ys[PROJ_CHUNK];
+	float	lats[PROJ_CHUNK], lons[PROJ_CHUNK];
+	LOGICAL	ok[PROJ_CHUNK];
+
+	/* Error return for missing parameters */
+	if (!mproj)             return FALSE;
+	if (npos <= 0)          return TRUE;
+	if (!pos)               return FALSE;
+	if (!lat || !lon)       return FALSE;
+
+	for (ip=0; ip<npos; ip+=nc)
+		{
+		nc = MIN(npos-ip, PROJ_CHUNK);
+		for (ic=0; ic<nc; ic++)
+			{
+			xs[ic] = pos[ip+ic][X];
+			ys[ic] = pos[ip+ic][Y];
+			}
+		xy_ll_array(mproj, nc, xs, ys, lats, lons, ok);
+		for (ic=0; ic<nc; ic++)
+			{
+			lat[ip+ic] = (ok[ic])? lats[ic]: 0;
+			lon[ip+ic] = (ok[ic])? lons[ic]: 0;
+			if (!ok[ic]) all = FALSE;
+			if (valid) valid[ip+ic] = ok[ic];
+			}
+		}
+	return all;
+	}
+
+/*********************************************************************/
+/** For given array of x, y on mp1 returns x, y from origin on mp2
+ *
+ *	@param[in] 	*mp1	first given map projection
+ *	@param[in] 	npos	number of points
+ *	@param[in] 	*pos1	given points
+ *	@param[in] 	*mp2	second given map projection
+ *	@param[out]	*pos2	return points in new projection (may be pos1)
+ *	@param[out]	*valid	return which points were transformed (may be NULL)
+ *  @return True if all points were transformed.
+ *********************************************************************/
+LOGICAL	pos_to_pos_array
+
+	(
+	const MAP_PROJ	*mp1,
+	int				npos,
+	POINT			*pos1,
+	const MAP_PROJ	*mp2,
+	POINT			*pos2,
+	LOGICAL			*valid
+	)
+
+	{
+	int		ip, nc, ic;
+	float	fact, x, y;
+	LOGICAL	all = TRUE;
+	float	xs[PROJ_CHUNK], ys[PROJ_CHUNK];
+	float	lats[PROJ_CHUNK], lons[PROJ_CHUNK];
+	LOGICAL	ok1[PROJ_CHUNK], ok2[PROJ_CHUNK];
+
+	/* Error return for missing parameters */
+	if (!mp1)               return FALSE;
+	if (!mp2)               return FALSE;
+	if (npos <= 0)          return TRUE;
+	if (!pos1)              return FALSE;
+	if (!pos2)              return FALSE;
+
+	/* If the projections are the same, we may be able to do it the */
+	/* quick way. */
+	if (same_projection(&mp1->projection, &mp2->projection))
+		{
+		/* If the maps are identical, return the same points. */
+		if (same_map_def(&mp1->definition, &mp2->definition))
+			{
+			if (pos2 != pos1)
+				(void) memcpy((void *) pos2, (void *) pos1,
+								(size_t) npos * sizeof(POINT));
+			if (valid) for (ip=0; ip<npos; ip++) valid[ip] = TRUE;
+			return TRUE;
+			}
+
+		/* If the reference longitudes are the same, scale and translate */
+		else if (mp1->definition.lref == mp2->definition.lref)
+			{
+			fact = mp1->definition.units / mp2->definition.units;
+			for (ip=0; ip<npos; ip++)
+				{
+				x = (mp1->origin[X] + pos1[ip][X])*fact;
+				y = (mp1->origin[Y] + pos1[ip][Y])*fact;
+
+				pos2[ip][X] = x - mp2->origin[X];
+				pos2[ip][Y] = y - mp2->origin[Y];
+				}
+			if (valid) for (ip=0; ip<npos; ip++) valid[ip] = TRUE;
+			return TRUE;
+			}
+		}
+
+	/* We need to use brute force! */
+	/* Convert each chunk to lat-lon and then to the second projection */
+	for (ip=0; ip<npos; ip+=nc)
+		{
+		nc = MIN(npos-ip, PROJ_CHUNK);
+		for (ic=0; ic<nc; ic++)
+			{
+			xs[ic] = pos1[ip+ic][X];
+			ys[ic] = pos1[ip+ic][Y];
+			}
+		xy_ll_array(mp1, nc, xs, ys, lats, lons, ok1);
+		ll_xy_array(mp2, nc, lats, lons, xs, ys, ok2);
+		for (ic=0; ic<nc; ic++)
+			{
+			if (!ok1[ic]) ok2[ic] = FALSE;
+			pos2[ip+ic][X] = (ok2[ic])? xs[ic]: 0;
+			pos2[ip+ic][Y] = (ok2[ic])? ys[ic]: 0;
+			if (!ok2[ic]) all = FALSE;
+			if (valid) valid[ip+ic] = ok2[ic];
+			}
+		}
+	return all;
+	}
+
 /***********************************************************************
 *                                                                      *
 *     l l _ d i s t o r t                                              *
@@ -4011,6 +4243,417 @@ static	LOGICAL	lc_distort
 *                                                                      *
 ***********************************************************************/
 
+/***********************************************************************
+*                                                                      *
+*     f l o a t _ p r o j e c t i o n _ m a t h                        *
+*                                                                      *
+*     Should the array kernels use single precision arithmetic?        *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL	float_projection_math
+
+	(void)
+
+	{
+	STRING	val;
+
+	static	int	FloatMath = -1;
+
+	if (FloatMath < 0)
+		{
+		val = getenv("FPA_PROJECTION_MATH");
+		if (blank(val)) val = get_feature_mode("Projection.Math");
+		if (same_ic(val, "FLOAT"))                     FloatMath = TRUE;
+		else if (blank(val) || same_ic(val, "DOUBLE")) FloatMath = FALSE;
+		else
+			{
+			pr_warning("Projection",
+				"Supported Projection.Math Modes: DOUBLE FLOAT\n");
+			FloatMath = FALSE;
+			}
+		}
+	return (LOGICAL) FloatMath;
+	}
+
+/***********************************************************************
+*                                                                      *
+*     l l _ x y _ a r r a y                                            *
+*     x y _ l l _ a r r a y                                            *
+*                                                                      *
+*     transform and inverse for an array of points, for use by the     *
+*     array functions above                                            *
+*                                                                      *
+*     Lat-Lon, Polar Stereographic and Lambert Conformal projections   *
+*     have loops of their own, with everything that does not depend    *
+*     on the point taken out of the loop, which follow the single      *
+*     point functions step for step. Other projections call the        *
+*     single point function for each point.                            *
+*                                                                      *
+***********************************************************************/
+
+static	void	ll_xy_array
+
+	(
+	const MAP_PROJ	*mproj,	/* given map projection */
+	int				npos,
+	const float		*lat,
+	const float		*lon,
+	float			*x,
+	float			*y,
+	LOGICAL			*ok
+	)
+
+	{
+	int			ip;
+	float		plat, plon, clon, lref, ox, oy;
+	double		units, dlon, phi, d, xv, yv;
+	double		pdist, sinphi0, rho1, psi, t1, rho, theta;
+	LOGICAL		south;
+	PROJ_FUNC	func;
+
+	/* Note that the longitude difference is taken in single precision */
+	/* as in the single point functions */
+	clon  = mproj->clon;
+	lref  = mproj->definition.lref;
+	ox    = mproj->origin[X];
+	oy    = mproj->origin[Y];
+	units = mproj->definition.units;
+
+	switch (mproj->projection.type)
+		{
+		/* No projection (orthographic) */
+		case ProjectNone:
+			for (ip=0; ip<npos; ip++)
+				{
+				x[ip]  = lat[ip];
+				y[ip]  = lon[ip];
+				ok[ip] = TRUE;
+				}
+			return;
+
+		/* Lat-Lon */
+		case ProjectLatLon:
+			for (ip=0; ip<npos; ip++)
+				{
+				plat   = lat[ip];
+				plon   = lon[ip];
+				x[ip]  = 0;
+				y[ip]  = 0;
+				ok[ip] = (LOGICAL) (plat <= 90 && plat >= -90);
+				if (!ok[ip]) continue;
+				while (plon <= clon-180) plon += 360;
+				while (plon >  clon+180) plon -= 360;
+				x[ip] = plon/units - ox;
+				y[ip] = plat/units - oy;
+				}
+			return;
+
+		/* Polar stereographic */
+		case ProjectPolarSt:
+			south = (LOGICAL) (mproj->projection.ProjectPole < 0);
+			pdist = mproj->projection.ProjectPdist;
+			if (float_projection_math())
+				{
+				float	fd, fphi, fdlon, fx, fy;
+				float	fpdist = (float) pdist, funits = (float) units;
+				float	frad   = (float) RAD;
+
+				for (ip=0; ip<npos; ip++)
+					{
+					plat   = lat[ip];
+					x[ip]  = 0;
+					y[ip]  = 0;
+					ok[ip] = (LOGICAL) (plat <= 90 && plat >= -90);
+					if (!ok[ip]) continue;
+					fdlon = lon[ip] - lref;
+					fphi  = (south)? -plat: plat;
+					fd    = fpdist * tanf(frad*(45 - fphi/2));
+					fx    =  fd*sinf(frad*fdlon);
+					fy    = -fd*cosf(frad*fdlon);
+					if (south) fy = -fy;
+					x[ip] = fx/funits - ox;
+					y[ip] = fy/funits - oy;
+					}
+				return;
+				}
+			for (ip=0; ip<npos; ip++)
+				{
+				plat   = lat[ip];
+				x[ip]  = 0;
+				y[ip]  = 0;
+				ok[ip] = (LOGICAL) (plat <= 90 && plat >= -90);
+				if (!ok[ip]) continue;
+				dlon = lon[ip] - lref;
+				phi  = plat;
+				if (south) phi = -phi;
+				d    = pdist * tandeg(45 - phi/2.0);
+				xv   =  d*fpa_sindeg(dlon);
+				yv   = -d*fpa_cosdeg(dlon);
+				if (south) yv = -yv;
+				x[ip] = xv/units - ox;
+				y[ip] = yv/units - oy;
+				}
+			return;
+
+		/* Lambert conformal (secant or tangent) */
+		case ProjectLambertConf:
+			sinphi0 = mproj->projection.ProjectSinPhi0;
+			psi     = mproj->projection.ProjectPsi;
+			rho1    = mproj->projection.ProjectRho1;
+			if (float_projection_math())
+				{
+				float	ft, frho, ftheta;
+				float	fsinphi0 = (float) sinphi0, fpsi = (float) psi;
+				float	frho1    = (float) rho1,    frad = (float) RAD;
+				float	funits   = (float) units;
+
+				for (ip=0; ip<npos; ip++)
+					{
+					plat   = lat[ip];
+					plon   = lon[ip];
+					x[ip]  = 0;
+					y[ip]  = 0;
+					ok[ip] = (LOGICAL) (plat <= 90 && plat >= -90);
+					if (!ok[ip]) continue;
+					while (plon <= clon-180) plon += 360;
+					while (plon >  clon+180) plon -= 360;
+					ftheta = (plon - lref) * fsinphi0;
+					ft     = tanf(frad*(45 - plat/2));
+					frho   = fpsi * powf(ft, fsinphi0);
+					x[ip]  = (frho*sinf(frad*ftheta))/funits - ox;
+					y[ip]  = (frho1 - frho*cosf(frad*ftheta))/funits - oy;
+					}
+				return;
+				}
+			for (ip=0; ip<npos; ip++)
+				{
+				plat   = lat[ip];
+				plon   = lon[ip];
+				x[ip]  = 0;
+				y[ip]  = 0;
+				ok[ip] = (LOGICAL) (plat <= 90 && plat >= -90);
+				if (!ok[ip]) continue;
+				while (plon <= clon-180) plon += 360;
+				while (plon >  clon+180) plon -= 360;
+				dlon  = plon - lref;
+				phi   = plat;
+				theta = dlon * sinphi0;
+				t1    = tandeg(45 - phi/2.0);
+				rho   = psi * pow(t1, sinphi0);
+				xv    = rho * sindeg(theta);
+				yv    = rho1 - rho*cosdeg(theta);
+				x[ip] = xv/units - ox;
+				y[ip] = yv/units - oy;
+				}
+			return;
+
+		/* Others one point at a time */
+		case ProjectLatLonAng:		func = llr_ll_xy;	break;
+		case ProjectPlateCaree:		func = pc_ll_xy;	break;
+		case ProjectRectangular:	func = rec_ll_xy;	break;
+		case ProjectMercatorEq:		func = meq_ll_xy;	break;
+		case ProjectObliqueSt:		func = os_ll_xy;	break;
+
+		/* Unrecognized */
+		default:
+			for (ip=0; ip<npos; ip++)
+				{
+				x[ip]  = 0;
+				y[ip]  = 0;
+				ok[ip] = FALSE;
+				}
+			return;
+		}
+
+	for (ip=0; ip<npos; ip++)
+		ok[ip] = func(mproj, lat[ip], lon[ip], x+ip, y+ip);
+	}
+
+static	void	xy_ll_array
+
+	(
+	const MAP_PROJ	*mproj,	/* given map projection */
+	int				npos,
+	const float		*x,
+	const float		*y,
+	float			*lat,
+	float			*lon,
+	LOGICAL			*ok
+	)
+
+	{
+	int			ip;
+	float		ox, oy;
+	double		units, lref, xv, yv, d, pdist, dlat, dlon, num;
+	double		sinphi0, rho1, psi, theta;
+	LOGICAL		south;
+	PROJ_FUNC	func;
+
+	ox    = mproj->origin[X];
+	oy    = mproj->origin[Y];
+	units = mproj->definition.units;
+	lref  = mproj->definition.lref;
+
+	switch (mproj->projection.type)
+		{
+		/* No projection (orthographic) */
+		case ProjectNone:
+			for (ip=0; ip<npos; ip++)
+				{
+				lat[ip] = x[ip];
+				lon[ip] = y[ip];
+				ok[ip]  = TRUE;
+				}
+			return;
+
+		/* Lat-Lon */
+		case ProjectLatLon:
+			for (ip=0; ip<npos; ip++)
+				{
+				lon[ip] = (x[ip] + ox) * units;
+				lat[ip] = (y[ip] + oy) * units;
+				norm_lat_lon(lat+ip, lon+ip);
+				ok[ip]  = TRUE;
+				}
+			return;
+
+		/* Polar stereographic */
+		case ProjectPolarSt:
+			south = (LOGICAL) (mproj->projection.ProjectPole < 0);
+			pdist = mproj->projection.ProjectPdist;
+			if (float_projection_math())
+				{
+				float	fxv, fyv, fd;
+				float	fpdist = (float) pdist, funits = (float) units;
+				float	flref  = (float) lref,  frad   = (float) RAD;
+
+				for (ip=0; ip<npos; ip++)
+					{
+					fxv = (x[ip] + ox) * funits;
+					fyv = (y[ip] + oy) * funits;
+					if (south) fyv = -fyv;
+					fd  = hypotf(fxv, fyv);
+					lat[ip] = 90 - 2*atan2f(fd, fpdist)/frad;
+					if (south) lat[ip] = -lat[ip];
+					if (fxv == 0)
+						{
+						if (fyv < 0)       lon[ip] = flref;
+						else if (fyv == 0) lon[ip] = flref + 90;
+						else               lon[ip] = flref + 180;
+						}
+					else                   lon[ip] = flref + 90 + atan2f(fyv, fxv)/frad;
+					norm_lat_lon(lat+ip, lon+ip);
+					ok[ip] = TRUE;
+					}
+				return;
+				}
+			for (ip=0; ip<npos; ip++)
+				{
+				xv = (x[ip] + ox) * units;
+				yv = (y[ip] + oy) * units;
+				if (south) yv = -yv;
+				d  = hypot(xv, yv);
+				lat[ip] = 90 - 2*fpa_atan2deg(d, pdist);
+				if (south) lat[ip] = -lat[ip];
+				if (xv == 0)
+					{
+					if (yv < 0)       lon[ip] = lref;
+					else if (yv == 0) lon[ip] = lref + 90;
+					else              lon[ip] = lref + 180;
+					}
+				else                  lon[ip] = lref + 90 + atan2deg(yv, xv);
+				norm_lat_lon(lat+ip, lon+ip);
+				ok[ip] = TRUE;
+				}
+			return;
+
+		/* Lambert conformal (secant or tangent) */
+		case ProjectLambertConf:
+			sinphi0 = mproj->projection.ProjectSinPhi0;
+			rho1    = mproj->projection.ProjectRho1;
+			psi     = mproj->projection.ProjectPsi;
+			if (float_projection_math())
+				{
+				float	fxv, fyv, fnum, ftheta;
+				float	fsinphi0 = (float) sinphi0, fpsi  = (float) psi;
+				float	frho1    = (float) rho1,    flref = (float) lref;
+				float	funits   = (float) units,   frad  = (float) RAD;
+				float	fexp     = 1/fsinphi0;
+
+				for (ip=0; ip<npos; ip++)
+					{
+					fxv = (ox + x[ip]) * funits;
+					fyv = (oy + y[ip]) * funits;
+					if (fxv == 0)
+						{
+						lon[ip] = flref;
+						fnum    = (frho1 - fyv)/fpsi;
+						}
+					else
+						{
+						if (fyv == frho1 && fxv > 0) ftheta =  90;
+						else if (fyv == frho1)       ftheta = -90;
+						else                         ftheta = atanf(fxv/(frho1-fyv))/frad;
+						lon[ip] = flref + fexp*ftheta;
+						fnum    = fxv/(fpsi*sinf(frad*ftheta));
+						}
+					if (fnum < 0) fnum = 0;
+					lat[ip] = 90 - 2*atanf(powf(fnum, fexp))/frad;
+					norm_lat_lon(lat+ip, lon+ip);
+					ok[ip] = TRUE;
+					}
+				return;
+				}
+			for (ip=0; ip<npos; ip++)
+				{
+				xv = (ox + x[ip]) * units;
+				yv = (oy + y[ip]) * units;
+				if (xv == 0.0)
+					{
+					dlon = lref;
+					num  = (rho1 - yv)/psi;
+					}
+				else
+					{
+					if (yv == rho1 && xv > 0.0) theta =  90.0;
+					else if (yv == rho1)        theta = -90.0;
+					else                        theta = atandeg(xv/(rho1-yv));
+					dlon = lref + (1/sinphi0)*theta;
+					num  = xv/(psi*sindeg(theta));
+					}
+				if (num < 0.0) num = 0.0;
+				num  = pow(num, 1/sinphi0);
+				dlat = 90 - 2.0*atandeg(num);
+				lon[ip] = dlon;
+				lat[ip] = dlat;
+				norm_lat_lon(lat+ip, lon+ip);
+				ok[ip] = TRUE;
+				}
+			return;
+
+		/* Others one point at a time */
+		case ProjectLatLonAng:		func = llr_xy_ll;	break;
+		case ProjectPlateCaree:		func = pc_xy_ll;	break;
+		case ProjectRectangular:	func = rec_xy_ll;	break;
+		case ProjectMercatorEq:		func = meq_xy_ll;	break;
+		case ProjectObliqueSt:		func = os_xy_ll;	break;
+
+		/* Unrecognized */
+		default:
+			for (ip=0; ip<npos; ip++)
+				{
+				lat[ip] = 0;
+				lon[ip] = 0;
+				ok[ip]  = FALSE;
+				}
+			return;
+		}
+
+	for (ip=0; ip<npos; ip++)
+		ok[ip] = func(mproj, x[ip], y[ip], lat+ip, lon+ip);
+	}
+
 #ifdef STANDALONE
 
 /**********************************************************************
@@ -4275,6 +4918,59 @@ POINT		epos;			/* end position on map projection */
 			dist, 2.0*M_PI*RE);
 	}
 
+/**********************************************************************
+ *** routine to compare pos_to_pos_array with pos_to_pos            ***
+ **********************************************************************/
+
+#include <time.h>
+
+static	void	test_pos_to_pos_array(mp1, mp2)
+
+MAP_PROJ	*mp1;			/* source map projection */
+MAP_PROJ	*mp2;			/* target map projection */
+	{
+	int			ix, iy, ip, npos, nx = 1000, ny = 1000, nrep = 5, irep;
+	float		dx, dy, diff, maxdiff;
+	POINT		*pos1, *pos2, *pos3;
+	clock_t		start;
+	double		tscalar, tarray;
+
+	npos = nx*ny;
+	pos1 = INITMEM(POINT, npos);
+	pos2 = INITMEM(POINT, npos);
+	pos3 = INITMEM(POINT, npos);
+	dx   = mp1->definition.xlen / (nx-1);
+	dy   = mp1->definition.ylen / (ny-1);
+	for (iy=0, ip=0; iy<ny; iy++)
+		for (ix=0; ix<nx; ix++, ip++)
+			set_point(pos1[ip], ix*dx, iy*dy);
+
+	start = clock();
+	for (irep=0; irep<nrep; irep++)
+		for (ip=0; ip<npos; ip++)
+			(void) pos_to_pos(mp1, pos1[ip], mp2, pos2[ip]);
+	tscalar = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (irep=0; irep<nrep; irep++)
+		(void) pos_to_pos_array(mp1, npos, pos1, mp2, pos3, NullLogicalList);
+	tarray  = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	for (ip=0, maxdiff=0; ip<npos; ip++)
+		{
+		diff = point_dist(pos2[ip], pos3[ip]);
+		if (diff > maxdiff) maxdiff = diff;
+		}
+	fprintf(stdout, "  %d points x %d: pos_to_pos %.3f s  pos_to_pos_array %.3f s",
+			npos, nrep, tscalar, tarray);
+	fprintf(stdout, "  (%.1f times)  Max difference: %g\n",
+			(tarray > 0)? tscalar/tarray: 0.0, maxdiff);
+
+	FREEMEM(pos1);
+	FREEMEM(pos2);
+	FREEMEM(pos3);
+	}
+
 /**********************************************************************
  ***  m a i n   - Stand-alone test program                          ***
  **********************************************************************/
@@ -4284,7 +4980,7 @@ void	main()
 	PROJ_DEF	proj;
 	MAP_DEF		map;
 	GRID_DEF	grid;
-	MAP_PROJ	mproj;
+	MAP_PROJ	mproj, mp2, mp3;
 	POINT		pos, spos, epos;
 
 	fpalib_license(FpaAccessLib);
@@ -4868,5 +5564,46 @@ void	main()
 	spos[X] =   0.0;	spos[Y] =   0.0;
 	epos[X] =   0.0;	epos[Y] = 175.0;
 	test_great_circle_distance(&mproj, spos, epos);
+
+	/* Compare array and single point transforms */
+	fprintf(stdout, "\nArray transforms:\n");
+	(void) define_projection(&proj, ProjectPolarSt, 90., 60., 0., 0., 0.);
+	map.olat = 26.75;
+	map.olon = -90;
+	map.lref = -85;
+	map.xorg = 0;
+	map.yorg = 0;
+	map.xlen = 4000;
+	map.ylen = 5000;
+	map.units = 1000;
+	(void) define_map_projection(&mproj, &proj, &map, NullGridDef);
+	(void) define_projection(&proj, ProjectLambertConf, 30., 60., 0., 0., 0.);
+	map.olat = 30.0;
+	map.olon = -100;
+	map.lref = -95;
+	map.xorg = 0;
+	map.yorg = 0;
+	map.xlen = 5000;
+	map.ylen = 4000;
+	map.units = 1000;
+	(void) define_map_projection(&mp2, &proj, &map, NullGridDef);
+	(void) define_projection(&proj, ProjectLatLon, 0., 0., 0., 0., 0.);
+	map.olat = 20.0;
+	map.olon = -140.0;
+	map.lref = 0.0;
+	map.xorg = 0.0;
+	map.yorg = 0.0;
+	map.xlen = 100.0;
+	map.ylen = 60.0;
+	map.units = 1.0;
+	(void) define_map_projection(&mp3, &proj, &map, NullGridDef);
+	fprintf(stdout, " Polar Stereographic to Lambert Conformal:\n");
+	test_pos_to_pos_array(&mproj, &mp2);
+	fprintf(stdout, " Lambert Conformal to Polar Stereographic:\n");
+	test_pos_to_pos_array(&mp2, &mproj);
+	fprintf(stdout, " Lat/Long to Polar Stereographic:\n");
+	test_pos_to_pos_array(&mp3, &mproj);
+	fprintf(stdout, " Polar Stereographic to Lat/Long:\n");
+	test_pos_to_pos_array(&mproj, &mp3);
 	}
 #endif /* STANDALONE */
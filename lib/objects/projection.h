@@ -224,6 +224,13 @@ LOGICAL		ll_to_pos(const MAP_PROJ *mproj, float lat, float lon, POINT pos);
 LOGICAL		pos_to_ll(const MAP_PROJ *mproj, POINT pos, float *lat, float *lon);
 LOGICAL		pos_to_pos(const MAP_PROJ *mp1, POINT pos1,
 						const MAP_PROJ *mp2, POINT pos2);
+LOGICAL		ll_to_pos_array(const MAP_PROJ *mproj, int npos,
+						const float *lat, const float *lon,
+						POINT *pos, LOGICAL *valid);
+LOGICAL		pos_to_ll_array(const MAP_PROJ *mproj, int npos, POINT *pos,
+						float *lat, float *lon, LOGICAL *valid);
+LOGICAL		pos_to_pos_array(const MAP_PROJ *mp1, int npos, POINT *pos1,
+						const MAP_PROJ *mp2, POINT *pos2, LOGICAL *valid);
 LOGICAL		ll_distort(const MAP_PROJ *mproj, float lat, float lon,
 						float *scalex, float *scaley);
 LOGICAL		pos_distort(const MAP_PROJ *mproj, POINT pos,
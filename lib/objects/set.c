@@ -80,6 +80,7 @@ SET		create_set
 	set->ncspec = 0;
 	set->xspecs = (CATSPEC *) 0;
 	set->nxspec = 0;
+	set->sindex = NullPointer;
 
 	define_set_type(set, type);
 
@@ -132,6 +133,9 @@ SET		destroy_set
 	/* Free space used for category specs */
 	define_set_catspecs(set, 0, (CATSPEC *) 0);
 
+	/* Free space used for the spatial index */
+	free_set_index(set);
+
 	/* Free structure itself */
 	FREEMEM(set);
 	SetCount--;
@@ -365,6 +369,7 @@ void	empty_set
 
 	/* Zero the set itself */
 	set->num = 0;
+	free_set_index(set);
 	return;
 	}
 
@@ -56,6 +56,7 @@ typedef struct SET_struct
 	short	ncspec;		/**< number of category specs */
 	CATSPEC	*xspecs;	/**< secondary list of category specs */
 	short	nxspec;		/**< number of secondary category specs */
+	POINTER	sindex;		/**< spatial index for point queries (if built) */
 	} *SET;
 
 /* Convenient definitions */
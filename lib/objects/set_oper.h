@@ -68,6 +68,8 @@ LOGICAL	reorder_curves(SET set, PICK mode);
 /* Declare functions in area_set.c */
 LOGICAL	eval_areaset(SET set, POINT pos, PICK mode,
 						SUBAREA *sub, ATTRIB_LIST *attribs);
+int		eval_areaset_points(SET set, int npos, POINT *ppos, PICK mode,
+						LOGICAL *valid, SUBAREA *subs, ATTRIB_LIST *attribs);
 int		eval_areaset_list(SET set, POINT pos, PICK mode,
 						SUBAREA **slist, ATTRIB_LIST **attlist);
 AREA	closest_area(SET set, POINT ptest, float *dist, POINT point,
@@ -82,6 +84,7 @@ SUBAREA	enclosing_subarea(SET set, POINT ptest, PICK mode,
 int		enclosing_subarea_list(SET set, POINT ptest, PICK mode,
 						SUBAREA **slist);
 LOGICAL	reorder_areas(SET set, PICK mode);
+void	free_set_index(SET set);
 
 /* Declare functions in label_set.c */
 LABEL	closest_label(SET set, POINT ptest, STRING category,
@@ -1645,6 +1645,31 @@ LOGICAL	find_patch
 
 /**********************************************************************/
 
+/* Find the last knot at or below the given value (-1 if none) */
+/* The knots are in increasing order, so a binary search gives the */
+/* same answer as scanning down from the last knot */
+static	int		find_knot
+
+	(
+	float	*knots,	/* knot vector */
+	int		nk,		/* number of knots */
+	float	val		/* given value */
+	)
+
+	{
+	int		lo, hi, mid;
+
+	lo = -1;
+	hi = nk - 1;
+	while (lo < hi)
+		{
+		mid = (lo + hi + 1) / 2;
+		if (knots[mid] <= val) lo = mid;
+		else                   hi = mid - 1;
+		}
+	return lo;
+	}
+
 /**********************************************************************/
 /** Find the patch which contains the given point, and transform
  *  the point into the patch co-ordinate system.  The patch
@@ -1688,8 +1713,8 @@ LOGICAL	find_patch_unmapped
 	nu = sp->m + ORDER;
 	nv = sp->n + ORDER;
 
-	for (iuk=nu-1; ; iuk--) if (iuk < 0 || sp->uknots[iuk] <= ps[X]) break;
-	for (ivk=nv-1; ; ivk--) if (ivk < 0 || sp->vknots[ivk] <= ps[Y]) break;
+	iuk = find_knot(sp->uknots, nu, ps[X]);
+	ivk = find_knot(sp->vknots, nv, ps[Y]);
 
 	/* Translate to index of patch that contains the point */
 	*iup = iuk   - ORDER + 1;
@@ -2759,6 +2784,7 @@ void	add_patch_mask
 				line->points[ip][X] = (line->points[ip][X] - tx) / sx;
 				line->points[ip][Y] = (line->points[ip][Y] - ty) / sy;
 				}
+			touch_line(line);
 			}
 
 		/* Add area to mask */
@@ -3679,6 +3705,7 @@ static	void	tidy_patch_contours
 							break;
 				}
 			copy_point(curve->line->points[curve->line->numpts-1], pos);
+			touch_line(curve->line);
 			}
 		else
 			{
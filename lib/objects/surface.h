@@ -115,6 +115,12 @@ LOGICAL	eval_sfc_unmapped(SURFACE sfc, POINT pos, double *val);
 LOGICAL	eval_sfc_UV_unmapped(SURFACE sfc, POINT pos,
 						double *uval, double *vval);
 LOGICAL	eval_sfc_MD_unmapped(SURFACE sfc, POINT pos, double *mag, double *dir);
+LOGICAL	eval_sfc_many(SURFACE sfc, int npts, POINT *pts, double *vals,
+						LOGICAL *inside);
+LOGICAL	eval_sfc_UV_many(SURFACE sfc, int npts, POINT *pts,
+						double *uvals, double *vvals, LOGICAL *inside);
+LOGICAL	eval_sfc_MD_many(SURFACE sfc, int npts, POINT *pts,
+						double *mags, double *dirs, LOGICAL *inside);
 STRING	eval_sfc_feature(SURFACE sfc, POINT pos, STRING features,
 						POINT plab, char *which, ITEM *item, LOGICAL *valid);
 
@@ -140,6 +146,7 @@ SET		contour_areaset_from_curves(SET lcurves, SET ucurves, BOX *box);
 void	scalar_grid(GRID *gridd, float gridlen, int nx, int ny, SCALAR *scalr);
 void	spline_grid(GRID *gridd, float gridlen, int nx, int ny, SPLINE *spln);
 void	grid_buffer_control(STRING mode);
+void	grid_solver_cntl(STRING mode);
 void	grid_surface(SURFACE sfc, float gridlen, int nx, int ny, float **vals);
 void	grid_surface_2D(SURFACE sfc, float gridlen, int nx, int ny,
 						float **xvals, float **yvals);
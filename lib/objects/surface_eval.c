@@ -41,6 +41,9 @@
 #include <string.h>
 #include <stdio.h>
 
+static	int		eval_sfc_batch(SURFACE, int, POINT *, LOGICAL,
+						double *, double *, LOGICAL *);
+
 /***********************************************************************
 *                                                                      *
 *      e v a l _ s f c                                                 *
@@ -738,6 +741,120 @@ LOGICAL	eval_sfc_MD_unmapped
 	return inside;
 	}
 
+/***********************************************************************
+*                                                                      *
+*      e v a l _ s f c _ m a n y                                       *
+*      e v a l _ s f c _ U V _ m a n y                                 *
+*      e v a l _ s f c _ M D _ m a n y                                 *
+*                                                                      *
+*      These functions do the same thing as their single point         *
+*      equivalents above, for a whole list of points at once.          *
+*                                                                      *
+*      The points are located and then ordered by patch, so that each  *
+*      patch is prepared only once, and all the points in a patch are  *
+*      evaluated together with evaluate_bipoly_many().                 *
+*                                                                      *
+***********************************************************************/
+
+/*********************************************************************/
+/** Evaluates the surface spline at each of a list of points.
+ *
+ *	@param[in] 	sfc		surface to be evaluated
+ *	@param[in] 	npts	number of points
+ *	@param[in] 	*pts	where to evaluate
+ *	@param[out]	*vals	value at each point
+ *	@param[out]	*inside	is each point inside the surface? (may be NULL)
+ *  @return True if all points are inside the surface.
+ *********************************************************************/
+LOGICAL	eval_sfc_many
+
+	(
+	SURFACE	sfc,
+	int		npts,
+	POINT	*pts,
+	double	*vals,
+	LOGICAL	*inside
+	)
+
+	{
+	return (LOGICAL) (eval_sfc_batch(sfc, npts, pts, FALSE, vals, NULL,
+								inside) == npts);
+	}
+
+/**********************************************************************/
+
+/*********************************************************************/
+/** Evaluates U and V components from the given vector field
+ * (2D surface spline) at each of a list of points.
+ *
+ *	@param[in] 	sfc		surface to be evaluated
+ *	@param[in] 	npts	number of points
+ *	@param[in] 	*pts	where to evaluate
+ *	@param[out]	*uvals	U value at each point
+ *	@param[out]	*vvals	V value at each point
+ *	@param[out]	*inside	is each point inside the surface? (may be NULL)
+ *  @return True if all points are inside the surface.
+ *********************************************************************/
+LOGICAL	eval_sfc_UV_many
+
+	(
+	SURFACE	sfc,
+	int		npts,
+	POINT	*pts,
+	double	*uvals,
+	double	*vvals,
+	LOGICAL	*inside
+	)
+
+	{
+	return (LOGICAL) (eval_sfc_batch(sfc, npts, pts, TRUE, uvals, vvals,
+								inside) == npts);
+	}
+
+/**********************************************************************/
+
+/*********************************************************************/
+/** Evaluates magnitude and direction from the given vector
+ *  field at each of a list of points.
+ *
+ *	@param[in] 	sfc		surface to be evaluated
+ *	@param[in] 	npts	number of points
+ *	@param[in] 	*pts	where to evaluate
+ *	@param[out]	*mags	magnitude at each point
+ *	@param[out]	*dirs	direction at each point
+ *	@param[out]	*inside	is each point inside the surface? (may be NULL)
+ *  @return True if all points are inside the surface.
+ *********************************************************************/
+LOGICAL	eval_sfc_MD_many
+
+	(
+	SURFACE	sfc,
+	int		npts,
+	POINT	*pts,
+	double	*mags,
+	double	*dirs,
+	LOGICAL	*inside
+	)
+
+	{
+	int		ip, nin;
+	double	uval, vval;
+
+	/* Evaluate the components in place, then convert */
+	nin = eval_sfc_batch(sfc, npts, pts, TRUE, mags, dirs, inside);
+	if (mags && dirs)
+		{
+		for (ip=0; ip<npts; ip++)
+			{
+			uval     = mags[ip];
+			vval     = dirs[ip];
+			mags[ip] = hypot(vval, uval);
+			dirs[ip] = fpa_atan2deg(vval, uval);
+			}
+		}
+	return (LOGICAL) (nin == npts);
+	}
+
 /***********************************************************************
 *                                                                      *
 *      e v a l _ s f c _ f e a t u r e                                 *
@@ -913,3 +1030,140 @@ STRING	eval_sfc_feature
 	if (valid) *valid = ok;
 	return valbuf;
 	}
+
+/***********************************************************************
+*                                                                      *
+*    STATIC (LOCAL) ROUTINES:                                          *
+*                                                                      *
+***********************************************************************/
+
+/**********************************************************************/
+
+static	int		eval_sfc_batch
+
+	(
+	SURFACE	sfc,
+	int		npts,
+	POINT	*pts,
+	LOGICAL	vector,
+	double	*val1,
+	double	*val2,
+	LOGICAL	*inside
+	)
+
+	{
+	int		ip, jp, kp, np, iup, ivp, nvp, npatch, ipatch, nin;
+	int		*pidx, *pnum, *order;
+	POINT	pp, dp;
+	PATCH	patch;
+	LOGICAL	in, *pin;
+	float	*uu, *vv, *su, *sv;
+	double	*sval;
+
+	/* Do nothing if surface undefined */
+	if (val1) for (ip=0; ip<npts; ip++) val1[ip] = 0.0;
+	if (val2) for (ip=0; ip<npts; ip++) val2[ip] = 0.0;
+	if (inside) for (ip=0; ip<npts; ip++) inside[ip] = FALSE;
+	if (!sfc)      return 0;
+	if (!pts)      return 0;
+	if (npts <= 0) return 0;
+	if (sfc->nupatch <= 0 || sfc->nvpatch <= 0) return 0;
+
+	/* Find the patch which contains each point */
+	nvp    = sfc->nvpatch;
+	npatch = sfc->nupatch * nvp;
+	pidx   = INITMEM(int, npts);
+	pin    = INITMEM(LOGICAL, npts);
+	uu     = INITMEM(float, npts);
+	vv     = INITMEM(float, npts);
+	nin    = 0;
+	for (ip=0; ip<npts; ip++)
+		{
+		in = find_patch(&sfc->sp, pts[ip], &iup, &ivp, pp, dp);
+		if (in) nin++;
+		if (inside) inside[ip] = in;
+		pin[ip]  = in;
+		pidx[ip] = iup*nvp + ivp;
+		uu[ip]   = pp[X];
+		vv[ip]   = pp[Y];
+		}
+
+	if (val1 || val2)
+		{
+		/* Order the points by patch (a counting sort, which keeps */
+		/* the points within each patch in their original order) */
+		pnum  = INITMEM(int, npatch+1);
+		order = INITMEM(int, npts);
+		for (ipatch=0; ipatch<=npatch; ipatch++) pnum[ipatch] = 0;
+		for (ip=0; ip<npts; ip++) pnum[pidx[ip]+1]++;
+		for (ipatch=0; ipatch<npatch; ipatch++) pnum[ipatch+1] += pnum[ipatch];
+		for (ip=0; ip<npts; ip++) order[pnum[pidx[ip]]++] = ip;
+
+		/* Gather the patch co-ordinates in that order */
+		su   = INITMEM(float, npts);
+		sv   = INITMEM(float, npts);
+		sval = INITMEM(double, npts);
+		for (ip=0; ip<npts; ip++)
+			{
+			su[ip] = uu[order[ip]];
+			sv[ip] = vv[order[ip]];
+			}
+
+		/* Evaluate each run of points that fall in the same patch */
+		for (ip=0; ip<npts; ip+=np)
+			{
+			ipatch = pidx[order[ip]];
+			for (jp=ip+1; jp<npts; jp++)
+				if (pidx[order[jp]] != ipatch) break;
+			np  = jp - ip;
+			iup = ipatch / nvp;
+			ivp = ipatch % nvp;
+
+			patch = prepare_sfc_patch(sfc, iup, ivp);
+			if (!patch)
+				{
+				for (kp=ip; kp<jp; kp++)
+					{
+					if (pin[order[kp]]) nin--;
+					if (inside) inside[order[kp]] = FALSE;
+					}
+				continue;
+				}
+
+			if (!vector)
+				{
+				evaluate_bipoly_many(&patch->function, np, su+ip, sv+ip, sval);
+				for (kp=ip; kp<jp; kp++)
+					val1[order[kp]] = (float) sval[kp-ip];
+				}
+			else
+				{
+				if (val1)
+					{
+					evaluate_bipoly_many(&patch->xfunc, np, su+ip, sv+ip, sval);
+					for (kp=ip; kp<jp; kp++)
+						val1[order[kp]] = sval[kp-ip];
+					}
+				if (val2)
+					{
+					evaluate_bipoly_many(&patch->yfunc, np, su+ip, sv+ip, sval);
+					for (kp=ip; kp<jp; kp++)
+						val2[order[kp]] = sval[kp-ip];
+					}
+				}
+			patch = dispose_sfc_patch(sfc, iup, ivp);
+			}
+
+		FREEMEM(pnum);
+		FREEMEM(order);
+		FREEMEM(su);
+		FREEMEM(sv);
+		FREEMEM(sval);
+		}
+
+	FREEMEM(pidx);
+	FREEMEM(pin);
+	FREEMEM(uu);
+	FREEMEM(vv);
+	return nin;
+	}
@@ -154,12 +154,11 @@ void spline_grid
 	)
 
 	{
-	int iix, iiy;
-	LOGICAL valid;
+	int iix, iiy, ipt;
 	float *gvalblk;
-	double val;
+	double *vals;
 	SURFACE sfc;
-	POINT pos;
+	POINT *pos;
 
 
 	/* Return now if no SPLINE Object to convert ... */
@@ -187,18 +186,28 @@ void spline_grid
 	define_surface_spline(sfc, splne->m, splne->n, &splne->mp, splne->origin,
 						splne->orient, splne->gridlen, *splne->cvs, splne->n);
 
-	/* Set pointers and evaluate grid point data at each location */
-	for (iiy=0; iiy<ngy; iiy++)
+	/* Evaluate grid point data at all locations at once */
+	pos  = INITMEM(POINT, ngy*ngx);
+	vals = INITMEM(double, ngy*ngx);
+	for (iiy=0, ipt=0; iiy<ngy; iiy++)
 		{
-		gridd->gval[iiy] = gvalblk + iiy*ngx;
-		for (iix=0; iix<ngx; iix++)
+		for (iix=0; iix<ngx; iix++, ipt++)
 			{
-			pos[X] = (float) iix * glen;
-			pos[Y] = (float) iiy * glen;
-			valid  = eval_sfc(sfc, pos, &val);
-			gridd->gval[iiy][iix] = (float) val;
+			pos[ipt][X] = (float) iix * glen;
+			pos[ipt][Y] = (float) iiy * glen;
 			}
 		}
+	(void) eval_sfc_many(sfc, ngy*ngx, pos, vals, NULL);
+
+	/* Set pointers and grid point data */
+	for (iiy=0, ipt=0; iiy<ngy; iiy++)
+		{
+		gridd->gval[iiy] = gvalblk + iiy*ngx;
+		for (iix=0; iix<ngx; iix++, ipt++)
+			gridd->gval[iiy][iix] = (float) vals[ipt];
+		}
+	FREEMEM(pos);
+	FREEMEM(vals);
 
 	/* Free space used by SURFACE Object */
 	sfc = destroy_surface(sfc);
@@ -210,14 +219,20 @@ void spline_grid
 *                                                                      *
 ***********************************************************************/
 
+/* Buffers for matrix equation */
+typedef	struct
+	{
+	double	**Matrix;
+	double	*Vector;	/* 1D or magnitude RHS */
+	double	*VecU;		/* 2D U-component RHS */
+	double	*VecV;		/* 2D V-component RHS */
+	double	*Mblock;
+	int		Mbsize;
+	} GRID_BUFFER;
+
 /* Static buffers for matrix equation */
-static	double	**Matrix = NULL;
-static	double	*Vector  = NULL;	/* 1D or magnitude RHS */
-static	double	*VecU    = NULL;	/* 2D U-component RHS */
-static	double	*VecV    = NULL;	/* 2D V-component RHS */
-static	double	*Mblock  = NULL;
-static	int		Mbsize   = 0;
-static	int		Mretain  = TRUE;
+static	GRID_BUFFER	GridBuf = { NULL, NULL, NULL, NULL, NULL, 0 };
+static	int			Mretain = TRUE;
 
 /* Values of the four cubic basis functions at U=0 (start of patch) */
 static	VEC		Basis;
@@ -228,6 +243,12 @@ static	const	int		MinChunk = 4;
 static	const	int		MaxChunk = 7;
 static	const	int		Bridge   = 5;
 
+/* Solution method for grid fitting (chunked or banded) */
+static	LOGICAL	GridBanded  = FALSE;
+static	LOGICAL	GridModeSet = FALSE;
+
+static	void	free_grid_buffer(GRID_BUFFER *);
+
 /**********************************************************************/
 
 /*********************************************************************/
@@ -239,6 +260,9 @@ static	const	int		Bridge   = 5;
  * This in turn may prevent excessive memory growth due to poor
  * reclamation methods in the memory allocation package.
  *
+ * Only the buffers of the calling thread are retained.  Buffers for
+ * any additional worker threads are released after each fit.
+ *
  *	@param[in] 	mode	buffer mode. One of "retain", "release", "free"
  *********************************************************************/
 void	grid_buffer_cntl
@@ -250,15 +274,90 @@ void	grid_buffer_cntl
 	{
 	if (same(mode,"retain"))  Mretain = TRUE;
 	if (same(mode,"release")) Mretain = FALSE;
-	if (!Mretain || same(mode,"free"))
+	if (!Mretain || same(mode,"free")) free_grid_buffer(&GridBuf);
+	}
+
+/**********************************************************************/
+
+static	void	free_grid_buffer
+
+	(
+	GRID_BUFFER	*buf
+	)
+
+	{
+	FREEMEM(buf->Mblock);
+	FREEMEM(buf->Matrix);
+	FREEMEM(buf->VecU);
+	FREEMEM(buf->VecV);
+	FREEMEM(buf->Vector);
+	buf->Mbsize = 0;
+	}
+
+/***********************************************************************
+*                                                                      *
+*      g r i d _ s o l v e r _ c n t l                                 *
+*                                                                      *
+***********************************************************************/
+
+/*********************************************************************/
+/** Controls which method is used to solve for the control vertices
+ * in grid_surface() and grid_spline() and their 2D versions.
+ *
+ * The "chunked" method solves a dense matrix for each overlapping
+ * chunk of the grid and stitches the chunks together.  The "banded"
+ * method exploits the tensor-product structure of the system to
+ * solve the whole grid in one pass as a series of tridiagonal
+ * systems in each direction, using O(N) memory and leaving no seams
+ * between chunks.
+ *
+ * The default is taken from the environment variable FPA_GRID_SOLVER
+ * or the "Grid.Solver" advanced feature, and is "chunked" if neither
+ * is set.
+ *
+ *	@param[in] 	mode	solver mode. One of "chunked", "banded"
+ *********************************************************************/
+void	grid_solver_cntl
+
+	(
+	STRING	mode
+	)
+
+	{
+	if (same_ic(mode, "banded"))
 		{
-		FREEMEM(Mblock);
-		FREEMEM(Matrix);
-		FREEMEM(VecU);
-		FREEMEM(VecV);
-		FREEMEM(Vector);
-		Mbsize = 0;
+		GridBanded  = TRUE;
+		GridModeSet = TRUE;
 		}
+	else if (same_ic(mode, "chunked"))
+		{
+		GridBanded  = FALSE;
+		GridModeSet = TRUE;
+		}
+	else
+		{
+		pr_warning("Grid.Solver", "Unknown grid solver mode \'%s\'.\n", mode);
+		}
+	}
+
+/**********************************************************************/
+
+static	LOGICAL	grid_solver_banded(void)
+
+	{
+	STRING	mode;
+
+	if (!GridModeSet)
+		{
+		mode = getenv("FPA_GRID_SOLVER");
+		if (blank(mode)) mode = get_feature_mode("Grid.Solver");
+		if (blank(mode)) mode = "chunked";
+		grid_solver_cntl(mode);
+		GridModeSet = TRUE;
+		pr_diag("Grid.Solver", "Grid solver mode: %s\n",
+				(GridBanded)? "banded": "chunked");
+		}
+	return GridBanded;
 	}
 
 /***********************************************************************
@@ -266,6 +365,7 @@ void	grid_buffer_cntl
 *      g r i d _ s u r f a c e                                         *
 *      g r i d _ s p l i n e                                           *
 *      g r i d _ s p l i n e _ c h u n k                               *
+*      g r i d _ s p l i n e _ b a n d e d                             *
 *                                                                      *
 *      Define a surface spline to align with and interpolate a given   *
 *      set of grid point values.                                       *
@@ -289,10 +389,44 @@ void	grid_buffer_cntl
 *      The matrix is diagonally dominant, and therefore guarantees     *
 *      a solution.                                                     *
 *                                                                      *
+*      Since every equation is a product of a U term and a V term,     *
+*      the full matrix is the tensor product of two tridiagonal        *
+*      matrices, one for each direction.  The banded method solves     *
+*      the whole grid at once with a tridiagonal solve along each      *
+*      row and then along each column, rather than solving a dense     *
+*      matrix for each chunk.                                          *
+*                                                                      *
+*      In the chunked method, each strip of chunks across the grid     *
+*      loads only its own columns of control vertices, so the strips   *
+*      are fitted in parallel on the worker threads (see workers.c),   *
+*      giving the same result for any number of threads.               *
+*                                                                      *
 ***********************************************************************/
 
-static	void	grid_spline_chunk(SPLINE *, float, int, int, int, int,
-					int, int, float **);
+/* Data shared by each strip of chunks when fitting in parallel */
+typedef	struct
+	{
+	SPLINE		*spline;	/* spline to be fitted */
+	float		gridlen;	/* grid length */
+	int			ngx;		/* number of grid points in each direction */
+	int			ngy;		/* number of grid points in each direction */
+	float		**values;	/* array of grid values (or NULL) */
+	float		**xvals;	/* array of x-component grid values (or NULL) */
+	float		**yvals;	/* array of y-component grid values (or NULL) */
+	int			*sgx;		/* initial grid point of each strip */
+	int			*egx;		/* final grid point of each strip */
+	GRID_BUFFER	*bufs;		/* matrix buffers for each worker */
+	} GRID_JOB;
+
+static	void	grid_spline_chunks(SPLINE *, float, int, int, float **,
+					float **, float **);
+static	void	grid_spline_strip(int, int, POINTER);
+static	void	grid_spline_chunk(GRID_BUFFER *, SPLINE *, float, int, int,
+					int, int, int, int, float **);
+static	void	grid_spline_2D_chunk(GRID_BUFFER *, SPLINE *, float, int, int,
+					int, int, int, int, float **, float **);
+static	LOGICAL	grid_spline_banded(int, int, float **, float **, float **);
+static	void	grid_spline_bands(int, double *, double *, double *);
 
 /**********************************************************************/
 
@@ -378,8 +512,7 @@ void	grid_spline
 	)
 
 	{
-	int		ncu, sgx, egx, dgx, nxrem;
-	int		ncv, sgy, egy, dgy, nyrem;
+	int		ncu, ncv;
 	float	orient;
 	POINT	origin;
 
@@ -399,29 +532,135 @@ void	grid_spline
 	define_spline(spline, ncu, ncv, &spline->mp, origin, orient, gridlen,
 				NULL, 0);
 
+	/* Fit the whole grid at once if requested */
+	if (grid_solver_banded()
+			&& grid_spline_banded(ngx, ngy, values, NULL, spline->cvs)) return;
+
 	/* Split up the grid into managable chunks */
-	dgx = MaxChunk;
+	grid_spline_chunks(spline, gridlen, ngx, ngy, values, NULL, NULL);
+	}
+
+/**********************************************************************/
+
+static	void	grid_spline_chunks
+
+	(
+	SPLINE	*spline,	/* spline to be fitted */
+	float	gridlen,	/* grid length */
+	int		ngx,		/* number of grid points in each direction */
+	int		ngy,		/* number of grid points in each direction */
+	float	**values,	/* array of grid values (1D fit) */
+	float	**xvals,	/* array of x-component grid values (2D fit) */
+	float	**yvals		/* array of y-component grid values (2D fit) */
+	)
+
+	{
+	int			nstrip, nbuf, ibuf, sgx, dgx, nxrem;
+	LOGICAL		local;
+	GRID_JOB	job;
+
+	/* Values of the four cubic basis functions at U=0 (start of patch) */
+	if (!BasisDef)
+		{
+		evaluate_patch_basis(0.0,Basis);
+		BasisDef = TRUE;
+		}
+
+	/* Split up the grid into strips of chunks in the x direction */
+	/* Each strip only loads its own columns of control vertices, so */
+	/* the strips may be fitted in any order */
+	job.sgx = INITMEM(int, ngx);
+	job.egx = INITMEM(int, ngx);
+	nstrip  = 0;
+	dgx     = MaxChunk;
 	for (sgx=0; sgx<ngx; sgx+=dgx)
 		{
 		nxrem = ngx - sgx;
 		if (nxrem <= MaxChunk)               dgx = nxrem;
 		else if (nxrem <= MaxChunk+MinChunk) dgx = nxrem - MinChunk;
 		else                                 dgx = MaxChunk;
-		egx = sgx + dgx - 1;
+		job.sgx[nstrip] = sgx;
+		job.egx[nstrip] = sgx + dgx - 1;
+		nstrip++;
+		}
 
-		dgy = MaxChunk;
-		for (sgy=0; sgy<ngy; sgy+=dgy)
-			{
-			nyrem = ngy - sgy;
-			if (nyrem <= MaxChunk)               dgy = nyrem;
-			else if (nyrem <= MaxChunk+MinChunk) dgy = nyrem - MinChunk;
-			else                                 dgy = MaxChunk;
-			egy = sgy + dgy - 1;
-
-			/* Fit the current chunk */
-			grid_spline_chunk(spline, gridlen, ngx, ngy, sgx, sgy, egx, egy,
-						values);
-			}
+	/* Set up matrix buffers for each worker */
+	/* The calling thread uses the retained buffers, unless it is */
+	/* itself a worker thread */
+	local = in_worker_thread();
+	nbuf  = MIN(get_worker_threads(), nstrip);
+	nbuf  = MAX(nbuf, 1);
+	job.bufs = INITMEM(GRID_BUFFER, nbuf);
+	for (ibuf=0; ibuf<nbuf; ibuf++)
+		{
+		job.bufs[ibuf].Matrix = NULL;
+		job.bufs[ibuf].Vector = NULL;
+		job.bufs[ibuf].VecU   = NULL;
+		job.bufs[ibuf].VecV   = NULL;
+		job.bufs[ibuf].Mblock = NULL;
+		job.bufs[ibuf].Mbsize = 0;
+		}
+	if (!local) job.bufs[0] = GridBuf;
+
+	/* Fit the strips */
+	job.spline  = spline;
+	job.gridlen = gridlen;
+	job.ngx     = ngx;
+	job.ngy     = ngy;
+	job.values  = values;
+	job.xvals   = xvals;
+	job.yvals   = yvals;
+	(void) run_worker_jobs(nstrip, grid_spline_strip, (POINTER) &job);
+
+	/* De-allocate matrix and solution vectors */
+	if (!local) GridBuf = job.bufs[0];
+	for (ibuf=(local)? 0: 1; ibuf<nbuf; ibuf++)
+		free_grid_buffer(&job.bufs[ibuf]);
+	if (!local && !Mretain) grid_buffer_cntl("free");
+	FREEMEM(job.bufs);
+	FREEMEM(job.sgx);
+	FREEMEM(job.egx);
+	}
+
+/**********************************************************************/
+
+static	void	grid_spline_strip
+
+	(
+	int		istrip,		/* strip to be fitted */
+	int		worker,		/* worker fitting this strip */
+	POINTER	data		/* GRID_JOB shared by all strips */
+	)
+
+	{
+	int			sgx, egx;
+	int			sgy, egy, dgy, nyrem;
+	int			ngy;
+	GRID_JOB	*job;
+	GRID_BUFFER	*buf;
+
+	job = (GRID_JOB *) data;
+	buf = job->bufs + worker;
+	sgx = job->sgx[istrip];
+	egx = job->egx[istrip];
+	ngy = job->ngy;
+
+	dgy = MaxChunk;
+	for (sgy=0; sgy<ngy; sgy+=dgy)
+		{
+		nyrem = ngy - sgy;
+		if (nyrem <= MaxChunk)               dgy = nyrem;
+		else if (nyrem <= MaxChunk+MinChunk) dgy = nyrem - MinChunk;
+		else                                 dgy = MaxChunk;
+		egy = sgy + dgy - 1;
+
+		/* Fit the current chunk */
+		if (job->values)
+			grid_spline_chunk(buf, job->spline, job->gridlen, job->ngx, ngy,
+						sgx, sgy, egx, egy, job->values);
+		else
+			grid_spline_2D_chunk(buf, job->spline, job->gridlen, job->ngx, ngy,
+						sgx, sgy, egx, egy, job->xvals, job->yvals);
 		}
 	}
 
@@ -430,6 +669,7 @@ void	grid_spline
 static	void	grid_spline_chunk
 
 	(
+	GRID_BUFFER	*buf,	/* matrix buffers to use */
 	SPLINE	*spline,	/* spline to be fitted */
 	float	gridlen,	/* grid length */
 	int		ngx,		/* number of grid points in each direction */
@@ -449,6 +689,7 @@ static	void	grid_spline_chunk
 	int		nct, ncmax;
 	int		MaxBlock;
 	float	Bu, Bv;
+	double	**Matrix, *Vector, *Mblock;
 	double	*Vrow;
 	LOGICAL	begx, begy, endx, endy;
 
@@ -467,36 +708,32 @@ static	void	grid_spline_chunk
 	if (ngy <= 0)     return;
 	if (!values)      return;
 
-	/* Values of the four cubic basis functions at U=0 (start of patch) */
-	if (!BasisDef)
-		{
-		evaluate_patch_basis(0.0,Basis);
-		BasisDef = TRUE;
-		}
-
 	/* Allocate matrix and solution vector */
 	MaxBlock = MaxChunk + Bridge + Bridge;
 	ncmax = MaxBlock*MaxBlock;
-	if (ncmax > Mbsize)
+	if (ncmax > buf->Mbsize)
 		{
 #		ifdef DEBUG_SFC
 		(void) printf("[grid_spline] Allocating matrix %dX%d\n",ncmax,ncmax);
 		(void) printf("              Memory before: %d\n",sbrk(0));
 #		endif /* DEBUG_SFC */
-		Vector = GETMEM(Vector,double,ncmax);
-		Matrix = GETMEM(Matrix,double *,ncmax);
-		Mblock = GETMEM(Mblock,double,(ncmax*ncmax));
-		Mbsize = ncmax;
+		buf->Vector = GETMEM(buf->Vector,double,ncmax);
+		buf->Matrix = GETMEM(buf->Matrix,double *,ncmax);
+		buf->Mblock = GETMEM(buf->Mblock,double,(ncmax*ncmax));
+		buf->Mbsize = ncmax;
 #		ifdef DEBUG_SFC
 		(void) printf("              Memory after: %d\n",sbrk(0));
 #		endif /* DEBUG_SFC */
-		if (!Mblock || !Matrix || !Vector)
+		if (!buf->Mblock || !buf->Matrix || !buf->Vector)
 			{
 			(void) fprintf(stderr,"[grid_spline] Too big!\n");
-			grid_buffer_cntl("free");
+			free_grid_buffer(buf);
 			return;
 			}
 		}
+	Matrix = buf->Matrix;
+	Vector = buf->Vector;
+	Mblock = buf->Mblock;
 
 	/* Determine dimensions and range of control vertex array chunk */
 	begx = (LOGICAL) (sgx <= 0);		begy = (LOGICAL) (sgy <= 0);
@@ -646,9 +883,129 @@ static	void	grid_spline_chunk
 		for (icv=scv; icv<=ecv; icv++)
 			spline->cvs[icu][icv] = (float) Vrow[icv-svcv];
 		}
+	}
+
+/**********************************************************************/
+
+static	LOGICAL	grid_spline_banded
+
+	(
+	int		ngx,		/* number of grid points in each direction */
+	int		ngy,		/* number of grid points in each direction */
+	float	**xvals,	/* array of grid values (or x-components) */
+	float	**yvals,	/* array of y-components (magnitude fit) or NULL */
+	float	**cvs		/* control vertex array to be fitted */
+	)
+
+	{
+	int		nu, icu, igx;
+	int		nv, icv, igy;
+	double	*Ublock, *Vblock, *Wblock, **Wrows;
+	LOGICAL	ok;
+
+	/* Make sure we have enough information */
+	if (ngx <= 0)     return FALSE;
+	if (ngy <= 0)     return FALSE;
+	if (!xvals)       return FALSE;
+	if (!cvs)         return FALSE;
+
+	/* Values of the four cubic basis functions at U=0 (start of patch) */
+	if (!BasisDef)
+		{
+		evaluate_patch_basis(0.0,Basis);
+		BasisDef = TRUE;
+		}
 
-	/* De-allocate matrix and solution vector */
-	if (!Mretain) grid_buffer_cntl("free");
+	/* Allocate the bands for each direction and the solution block */
+	nu     = ngx + ORDER - 2;
+	nv     = ngy + ORDER - 2;
+	Ublock = INITMEM(double, 3*nu);
+	Vblock = INITMEM(double, 3*nv);
+	Wblock = INITMEM(double, nu*nv);
+	Wrows  = INITMEM(double *, nu);
+	if (!Ublock || !Vblock || !Wblock || !Wrows)
+		{
+		(void) fprintf(stderr,"[grid_spline] Too big!\n");
+		FREEMEM(Ublock);
+		FREEMEM(Vblock);
+		FREEMEM(Wblock);
+		FREEMEM(Wrows);
+		return FALSE;
+		}
+
+	/* Set up and factor the tridiagonal system for each direction */
+	grid_spline_bands(nu, Ublock, Ublock+nu, Ublock+2*nu);
+	grid_spline_bands(nv, Vblock, Vblock+nv, Vblock+2*nv);
+	ok = qfactor_tridiag(Ublock, Ublock+nu, Ublock+2*nu, nu)
+			&& qfactor_tridiag(Vblock, Vblock+nv, Vblock+2*nv, nv);
+
+	/* Load the grid values as the right-hand-side */
+	/* The outer ring is zero for the free boundary condition */
+	for (icu=0; icu<nu; icu++)
+		{
+		Wrows[icu] = Wblock + icu*nv;
+		if (icu == 0 || icu == nu-1) continue;
+		igx = icu - 1;
+		for (icv=1; icv<nv-1; icv++)
+			{
+			igy = icv - 1;
+			Wrows[icu][icv] = (yvals)? hypot(xvals[igy][igx], yvals[igy][igx]):
+										xvals[igy][igx];
+			}
+		}
+
+	/* Solve along each row (V direction) and then along each column */
+	/* (U direction) */
+	if (ok)
+		{
+		for (icu=1; icu<nu-1; icu++)
+			(void) qsolve_tridiag(Vblock, Vblock+nv, Vblock+2*nv,
+						Wrows[icu], nv);
+		ok = qsolve_tridiag_rows(Ublock, Ublock+nu, Ublock+2*nu,
+						Wrows, nu, nv);
+		}
+
+	/* Now load the control vertex array into the surface spline */
+	if (ok)
+		{
+		for (icu=0; icu<nu; icu++)
+			for (icv=0; icv<nv; icv++)
+				cvs[icu][icv] = (float) Wrows[icu][icv];
+		}
+
+	FREEMEM(Ublock);
+	FREEMEM(Vblock);
+	FREEMEM(Wblock);
+	FREEMEM(Wrows);
+	return ok;
+	}
+
+/**********************************************************************/
+
+static	void	grid_spline_bands
+
+	(
+	int		nc,			/* number of control vertices in this direction */
+	double	*Sub,		/* sub-diagonal */
+	double	*Diag,		/* diagonal */
+	double	*Sup		/* super-diagonal */
+	)
+
+	{
+	int		ic;
+
+	/* Interior control vertices interpolate the grid values */
+	for (ic=1; ic<nc-1; ic++)
+		{
+		Sub[ic]  = Basis[0];
+		Diag[ic] = Basis[1];
+		Sup[ic]  = Basis[2];
+		}
+
+	/* Outer control vertices take the same value as their inner */
+	/* neighbours, to force the second derivative to zero */
+	Sub[0]     = 0;		Diag[0]    = 1;		Sup[0]    = -1;
+	Sub[nc-1]  = -1;	Diag[nc-1] = 1;		Sup[nc-1] = 0;
 	}
 
 /***********************************************************************
@@ -662,9 +1019,6 @@ static	void	grid_spline_chunk
 *                                                                      *
 ***********************************************************************/
 
-static	void	grid_spline_2D_chunk(SPLINE *, float, int, int, int, int,
-					int, int, float **, float **);
-
 /**********************************************************************/
 
 /*********************************************************************/
@@ -755,8 +1109,7 @@ void	grid_spline_2D
 	)
 
 	{
-	int		ncu, sgx, egx, dgx, nxrem;
-	int		ncv, sgy, egy, dgy, nyrem;
+	int		ncu, ncv;
 	float	orient;
 	POINT	origin;
 
@@ -777,30 +1130,14 @@ void	grid_spline_2D
 	define_spline_2D(spline, ncu, ncv, &spline->mp, origin, orient, gridlen,
 				NULL, NULL, 0);
 
-	/* Split up the grid into managable chunks */
-	dgx = MaxChunk;
-	for (sgx=0; sgx<ngx; sgx+=dgx)
-		{
-		nxrem = ngx - sgx;
-		if (nxrem <= MaxChunk)               dgx = nxrem;
-		else if (nxrem <= MaxChunk+MinChunk) dgx = nxrem - MinChunk;
-		else                                 dgx = MaxChunk;
-		egx = sgx + dgx - 1;
+	/* Fit the whole grid at once if requested */
+	if (grid_solver_banded()
+			&& grid_spline_banded(ngx, ngy, xvals, NULL,  spline->cvx)
+			&& grid_spline_banded(ngx, ngy, yvals, NULL,  spline->cvy)
+			&& grid_spline_banded(ngx, ngy, xvals, yvals, spline->cvs)) return;
 
-		dgy = MaxChunk;
-		for (sgy=0; sgy<ngy; sgy+=dgy)
-			{
-			nyrem = ngy - sgy;
-			if (nyrem <= MaxChunk)               dgy = nyrem;
-			else if (nyrem <= MaxChunk+MinChunk) dgy = nyrem - MinChunk;
-			else                                 dgy = MaxChunk;
-			egy = sgy + dgy - 1;
-
-			/* Fit the current chunk */
-			grid_spline_2D_chunk(spline, gridlen, ngx, ngy, sgx, sgy, egx, egy,
-					xvals, yvals);
-			}
-		}
+	/* Split up the grid into managable chunks */
+	grid_spline_chunks(spline, gridlen, ngx, ngy, NULL, xvals, yvals);
 	}
 
 /**********************************************************************/
@@ -808,6 +1145,7 @@ void	grid_spline_2D
 static	void	grid_spline_2D_chunk
 
 	(
+	GRID_BUFFER	*buf,	/* matrix buffers to use */
 	SPLINE	*spline,	/* spline to be fitted */
 	float	gridlen,	/* grid length */
 	int		ngx,		/* number of grid points in each direction */
@@ -829,6 +1167,7 @@ static	void	grid_spline_2D_chunk
 	int		MaxBlock;
 	float	Bu, Bv;
 	double	xv, yv;
+	double	**Matrix, *Vector, *VecU, *VecV, *Mblock;
 	double	*Urow, *Vrow, *Srow;
 	LOGICAL	begx, begy, endx, endy;
 
@@ -848,40 +1187,39 @@ static	void	grid_spline_2D_chunk
 	if (!xvals)       return;
 	if (!yvals)       return;
 
-	/* Values of the four cubic basis functions at U=0 (start of patch) */
-	if (!BasisDef)
-		{
-		evaluate_patch_basis(0.0,Basis);
-		BasisDef = TRUE;
-		}
-
 	/* Allocate matrix and solution vector */
 	MaxBlock = MaxChunk + Bridge + Bridge;
 	ncmax = MaxBlock*MaxBlock;
-	if (ncmax > Mbsize)
+	if (ncmax > buf->Mbsize)
 		{
 #		ifdef DEBUG_SFC
 		(void) printf("[grid_spline] Allocating matrix %dX%d\n",ncmax,ncmax);
 		(void) printf("              Memory before: %d\n",sbrk(0));
 #		endif /* DEBUG_SFC */
-		VecU   = GETMEM(VecU,double,ncmax);
-		VecV   = GETMEM(VecV,double,ncmax);
-		Vector = GETMEM(Vector,double,ncmax);
-		Matrix = GETMEM(Matrix,double *,ncmax);
-		Mblock = GETMEM(Mblock,double,(ncmax*ncmax));
-		Mbsize = ncmax;
+		buf->VecU   = GETMEM(buf->VecU,double,ncmax);
+		buf->VecV   = GETMEM(buf->VecV,double,ncmax);
+		buf->Vector = GETMEM(buf->Vector,double,ncmax);
+		buf->Matrix = GETMEM(buf->Matrix,double *,ncmax);
+		buf->Mblock = GETMEM(buf->Mblock,double,(ncmax*ncmax));
+		buf->Mbsize = ncmax;
 #		ifdef DEBUG_SFC
 		(void) printf("              Memory after: %d\n",sbrk(0));
 #		endif /* DEBUG_SFC */
-		if (!Mblock || !Matrix || !Vector || !VecU || !VecV)
+		if (!buf->Mblock || !buf->Matrix || !buf->Vector
+				|| !buf->VecU || !buf->VecV)
 			{
 			(void) fprintf(stderr,"[grid_spline] Too big!\n");
-			grid_buffer_cntl("free");
+			free_grid_buffer(buf);
 			return;
 			}
 		}
-	if (!VecU) VecU = INITMEM(double,ncmax);
-	if (!VecV) VecV = INITMEM(double,ncmax);
+	if (!buf->VecU) buf->VecU = INITMEM(double,buf->Mbsize);
+	if (!buf->VecV) buf->VecV = INITMEM(double,buf->Mbsize);
+	Matrix = buf->Matrix;
+	Vector = buf->Vector;
+	VecU   = buf->VecU;
+	VecV   = buf->VecV;
+	Mblock = buf->Mblock;
 
 	/* Determine dimensions and range of control vertex array chunk */
 	begx = (LOGICAL) (sgx <= 0);		begy = (LOGICAL) (sgy <= 0);
@@ -1055,9 +1393,6 @@ static	void	grid_spline_2D_chunk
 			spline->cvs[icu][icv] = (float) Srow[icv-svcv];
 			}
 		}
-
-	/* De-allocate matrix and solution vector */
-	if (!Mretain) grid_buffer_cntl("free");
 	}
 
 /**********************************************************************/
@@ -1073,11 +1408,6 @@ void	grid_spline_mag
 	)
 
 	{
-	int		ncu, sgx, egx, dgx, nxrem;
-	int		ncv, sgy, egy, dgy, nyrem;
-	float	orient;
-	POINT	origin;
-
 	/* Make sure we have enough information */
 	if (!spline)      return;
 	if (spline->dim != DimVector2D) return;
@@ -1089,30 +1419,12 @@ void	grid_spline_mag
 	/* Define spline dimensions so as to align patch vertices */
 	/* with the given grid */
 
-	/* Split up the grid into managable chunks */
-	dgx = MaxChunk;
-	for (sgx=0; sgx<ngx; sgx+=dgx)
-		{
-		nxrem = ngx - sgx;
-		if (nxrem <= MaxChunk)               dgx = nxrem;
-		else if (nxrem <= MaxChunk+MinChunk) dgx = nxrem - MinChunk;
-		else                                 dgx = MaxChunk;
-		egx = sgx + dgx - 1;
+	/* Fit the whole grid at once if requested */
+	if (grid_solver_banded()
+			&& grid_spline_banded(ngx, ngy, values, NULL, spline->cvs)) return;
 
-		dgy = MaxChunk;
-		for (sgy=0; sgy<ngy; sgy+=dgy)
-			{
-			nyrem = ngy - sgy;
-			if (nyrem <= MaxChunk)               dgy = nyrem;
-			else if (nyrem <= MaxChunk+MinChunk) dgy = nyrem - MinChunk;
-			else                                 dgy = MaxChunk;
-			egy = sgy + dgy - 1;
-
-			/* Fit the current chunk */
-			grid_spline_chunk(spline, gridlen, ngx, ngy, sgx, sgy, egx, egy,
-						values);
-			}
-		}
+	/* Split up the grid into managable chunks */
+	grid_spline_chunks(spline, gridlen, ngx, ngy, values, NULL, NULL);
 	}
 
 /***********************************************************************
@@ -1372,8 +1684,46 @@ void edit_surface_2D_real
 *      the evaluated value at each grid intersection, according to     *
 *      its distance from neighbouring fit points.                      *
 *                                                                      *
+*      The fit points are binned by patch, so that each grid point     *
+*      only visits the points within its radius of influence, and      *
+*      the rows of grid points are adjusted in parallel on the worker  *
+*      threads (see workers.c).  The points near each grid point are   *
+*      still accumulated in their original order, so the result is     *
+*      the same for any number of threads.                             *
+*                                                                      *
 ***********************************************************************/
 
+/* Fit points binned by patch, shared by each row of grid points when */
+/* adjusting the grid values in parallel */
+typedef	struct
+	{
+	int			ngx;		/* number of grid points in each direction */
+	int			ngy;		/* number of grid points in each direction */
+	int			fnum;		/* number of fit points */
+	int			*fpu;		/* patch containing each fit point */
+	int			*fpv;		/* patch containing each fit point */
+	POINT		*floc;		/* location of each fit point within its patch */
+	float		*fval;		/* adjustment at each fit point (1D fit) */
+	float		*fxval;		/* x-component adjustment (2D fit) */
+	float		*fyval;		/* y-component adjustment (2D fit) */
+	float		**grid;		/* array of grid values (1D fit) */
+	float		**gridx;	/* array of x-component grid values (2D fit) */
+	float		**gridy;	/* array of y-component grid values (2D fit) */
+	double		dp;			/* radius of influence (in grid units) */
+	double		dh;			/* radius of full influence (in grid units) */
+	double		weighting;	/* weighting factor for adjustments */
+	int			reach;		/* patches to search on each side of a node */
+	int			*bstart;	/* first entry in blist for each patch */
+	int			*blist;		/* fit points ordered by patch */
+	int			**cands;	/* candidate fit point buffer for each worker */
+	} FIT_JOB;
+
+static	void	sfit_grid_values(SURFACE, int, int, float **, float **,
+					float **);
+static	void	sfit_grid_adjust(FIT_JOB *);
+static	void	sfit_grid_row(int, int, POINTER);
+static	int		sfit_grid_order(const void *, const void *);
+
 /*********************************************************************/
 /** Alter the surface spline to interpolate the given set of values
  *  at the specified points.
@@ -1432,12 +1782,11 @@ int		sfit_surface
 	)
 
 	{
-	int		ix, iy, iu, iv, ip, jp;
-	double	dx, dy, wx, wy, wt, vsum, wsum;
-	double	dp, dh;
+	int		iy, iu, iv, ip, jp;
 	POINT	ppos, plen;
 	int		success = FALSE;
 	PATCH	patch;
+	FIT_JOB	job;
 
 	/* Pointers for working buffers */
 	int		FNum, FMax, Ngx, Ngy;
@@ -1503,78 +1852,26 @@ int		sfit_surface
 	if (FNum <= 0) goto Tidy;
 	success = TRUE;
 
-	/* Set up new grid values */
-	dp = (double) influence;
-	dh = dp / 4;
-	for (ix=0; ix<Ngx; ix++)
-		{
-		/* Relate x value to patch */
-		if (ix < Ngx-1)	{ iu = ix;		ppos[X] = 0; }
-		else            { iu = ix-1;	ppos[X] = 1; }
-
-		for (iy=0; iy<Ngy; iy++)
-			{
-			/* Relate y value to patch */
-			if (iy < Ngy-1)	{ iv = iy;		ppos[Y] = 0; }
-			else            { iv = iy-1;	ppos[Y] = 1; }
-
-			/* Evaluate original grid values */
-			patch = prepare_sfc_patch(sfc, iu, iv);
-			Grid[iy][ix] = (float) evaluate_bipoly(&patch->function,ppos);
-			patch = dispose_sfc_patch(sfc, iu, iv);
-
-			/* Account for any fit points that are within range */
-			vsum = 0;
-			wsum = 0;
-			for (ip=0; ip<FNum; ip++)
-				{
-
-				/* Determine x and y distance in patch lengths */
-				dx = fabs((double) (FPu[ip] + FLoc[ip][X] - ix));
-				dy = fabs((double) (FPv[ip] + FLoc[ip][Y] - iy));
-
-				/* Is this one within range? */
-				if (dx >= dp) continue;
-				if (dy >= dp) continue;
-
-				/* Compute corresponding weights */
-				wx = 1;	if (dx > dh) wx -= (dx-dh)/(dp-dh);
-				wy = 1;	if (dy > dh) wy -= (dy-dh)/(dp-dh);
-				wt = wx * wy;
-
-				/* Accumulate weighted sum */
-				vsum += FVal[ip] * wt * wt;
-				wsum += wt * wt;
-
-#				ifdef DEBUG_FIT
-				pr_diag("sfit_surface",
-					"   Point [%d] at (%.3f,%.3f)  Adj: %f  Wgt: %f\n",
-						ip, dx, dy, FVal[ip], wt);
-#				endif /* DEBUG_FIT */
-				}
-
-			/* Continue if no points nearby */
-			if (wsum <= MinimumWgt) continue;
-
-#			ifdef DEBUG_FIT
-			pr_diag("sfit_surface",
-				" Grid [%d][%d]  Initial Val: %f\n",
-					ix, iy, Grid[iy][ix]);
-#			endif /* DEBUG_FIT */
-
-			/* Add weighted mean to grid value */
-			/* Note that the sum of the weights may be increased */
-			/*  ... which will underestimate the adjustment      */
-			/*       but avoid errors with very small weights!   */
-			Grid[iy][ix] += vsum/(wsum*weighting);
-
-#			ifdef DEBUG_FIT
-			pr_diag("sfit_surface",
-				"  Adjs: %f  Wgts: %f  Final Val: %f\n\n",
-					vsum, wsum, Grid[iy][ix]);
-#			endif /* DEBUG_FIT */
-			}
-		}
+	/* Evaluate original grid values */
+	sfit_grid_values(sfc, Ngx, Ngy, Grid, NULL, NULL);
+
+	/* Add the weighted mean of the nearby fit points to each grid value */
+	job.ngx       = Ngx;
+	job.ngy       = Ngy;
+	job.fnum      = FNum;
+	job.fpu       = FPu;
+	job.fpv       = FPv;
+	job.floc      = FLoc;
+	job.fval      = FVal;
+	job.fxval     = NULL;
+	job.fyval     = NULL;
+	job.grid      = Grid;
+	job.gridx     = NULL;
+	job.gridy     = NULL;
+	job.dp        = (double) influence;
+	job.dh        = job.dp / 4;
+	job.weighting = (double) weighting;
+	sfit_grid_adjust(&job);
 
 	/* Now fit a new surface to the new grid values */
 	grid_surface(sfc,sfc->sp.gridlen,Ngx,Ngy,Grid);
@@ -1662,12 +1959,11 @@ int		sfit_surface_2D
 	)
 
 	{
-	int		ix, iy, iu, iv, ip, jp;
-	double	dx, dy, wx, wy, wt, usum, vsum, wsum;
-	double	dp, dh;
+	int		iy, iu, iv, ip, jp;
 	POINT	ppos, plen;
 	int		success = FALSE;
 	PATCH	patch;
+	FIT_JOB	job;
 
 	/* Pointers for working buffers */
 	int		FNum, FMax, Ngx, Ngy;
@@ -1742,70 +2038,26 @@ int		sfit_surface_2D
 	if (FNum <= 0) goto Tidy;
 	success = TRUE;
 
-	/* Set up new grid values */
-	dp = (double) influence;
-	dh = dp / 4;
-	for (ix=0; ix<Ngx; ix++)
-		{
-		/* Relate x value to patch */
-		if (ix < Ngx-1)	{ iu = ix;		ppos[X] = 0; }
-		else            { iu = ix-1;	ppos[X] = 1; }
-
-		for (iy=0; iy<Ngy; iy++)
-			{
-			/* Relate y value to patch */
-			if (iy < Ngy-1)	{ iv = iy;		ppos[Y] = 0; }
-			else            { iv = iy-1;	ppos[Y] = 1; }
-
-			/* Evaluate original grid values */
-			patch = prepare_sfc_patch(sfc, iu, iv);
-			Gridx[iy][ix] = (float) evaluate_bipoly(&patch->xfunc,ppos);
-			Gridy[iy][ix] = (float) evaluate_bipoly(&patch->yfunc,ppos);
-			patch = dispose_sfc_patch(sfc, iu, iv);
-
-			/* Account for any fit points that are within range */
-			usum = 0;
-			vsum = 0;
-			wsum = 0;
-			for (ip=0; ip<FNum; ip++)
-				{
-
-				/* Determine x and y distance in patch lengths */
-				dx = fabs((double) (FPu[ip] + FLoc[ip][X] - ix));
-				dy = fabs((double) (FPv[ip] + FLoc[ip][Y] - iy));
-
-				/* Is this one within range? */
-				if (dx >= dp) continue;
-				if (dy >= dp) continue;
-
-				/* Compute corresponding weights */
-				wx = 1;	if (dx > dh) wx -= (dx-dh)/(dp-dh);
-				wy = 1;	if (dy > dh) wy -= (dy-dh)/(dp-dh);
-				wt = wx * wy;
-
-				/* Accumulate weighted sum */
-				usum += FxVal[ip] * wt * wt;
-				vsum += FyVal[ip] * wt * wt;
-				wsum += wt * wt;
-
-				/*
-				(void) printf("      Grid [%d][%d] Fit Point [%d] at (%f,%f)\n",
-					ix,iy,ip,dx,dy);
-				fflush(stdout);
-				*/
-				}
-
-			/* Continue if no points nearby */
-			if (wsum <= MinimumWgt) continue;
-
-			/* Add weighted mean to grid value */
-			/* Note that the sum of the weights may be increased */
-			/*  ... which will underestimate the adjustment      */
-			/*       but avoid errors with very small weights!   */
-			Gridx[iy][ix] += usum/(wsum*weighting);
-			Gridy[iy][ix] += vsum/(wsum*weighting);
-			}
-		}
+	/* Evaluate original grid values */
+	sfit_grid_values(sfc, Ngx, Ngy, NULL, Gridx, Gridy);
+
+	/* Add the weighted mean of the nearby fit points to each grid value */
+	job.ngx       = Ngx;
+	job.ngy       = Ngy;
+	job.fnum      = FNum;
+	job.fpu       = FPu;
+	job.fpv       = FPv;
+	job.floc      = FLoc;
+	job.fval      = NULL;
+	job.fxval     = FxVal;
+	job.fyval     = FyVal;
+	job.grid      = NULL;
+	job.gridx     = Gridx;
+	job.gridy     = Gridy;
+	job.dp        = (double) influence;
+	job.dh        = job.dp / 4;
+	job.weighting = (double) weighting;
+	sfit_grid_adjust(&job);
 
 	/* Now fit a new surface to the new grid values */
 	grid_surface_2D(sfc,sfc->sp.gridlen,Ngx,Ngy,Gridx,Gridy);
@@ -1824,6 +2076,259 @@ Tidy:
 	return success;
 	}
 
+/**********************************************************************/
+
+static	void	sfit_grid_values
+
+	(
+	SURFACE	sfc,		/* surface to be evaluated */
+	int		ngx,		/* number of grid points in each direction */
+	int		ngy,		/* number of grid points in each direction */
+	float	**grid,		/* array of grid values (1D fit) */
+	float	**gridx,	/* array of x-component grid values (2D fit) */
+	float	**gridy		/* array of y-component grid values (2D fit) */
+	)
+
+	{
+	int		iu, iv, nu, nv, ip, np;
+	int		gx[4], gy[4];
+	float	pu[4], pv[4];
+	double	vals[4];
+	PATCH	patch;
+
+	/* Evaluate the grid points at the corners of each patch in turn */
+	/* The last row and column of grid points are at the far edges */
+	/* of the last row and column of patches */
+	nu = ngx - 1;
+	nv = ngy - 1;
+	for (iu=0; iu<nu; iu++)
+		{
+		for (iv=0; iv<nv; iv++)
+			{
+			np = 0;
+			gx[np] = iu;	gy[np] = iv;	pu[np] = 0;	pv[np] = 0;	np++;
+			if (iu == nu-1)
+				{
+				gx[np] = iu+1;	gy[np] = iv;	pu[np] = 1;	pv[np] = 0;	np++;
+				}
+			if (iv == nv-1)
+				{
+				gx[np] = iu;	gy[np] = iv+1;	pu[np] = 0;	pv[np] = 1;	np++;
+				}
+			if (iu == nu-1 && iv == nv-1)
+				{
+				gx[np] = iu+1;	gy[np] = iv+1;	pu[np] = 1;	pv[np] = 1;	np++;
+				}
+
+			/* Prepare each patch only once */
+			patch = prepare_sfc_patch(sfc, iu, iv);
+			if (grid)
+				{
+				evaluate_bipoly_many(&patch->function, np, pu, pv, vals);
+				for (ip=0; ip<np; ip++)
+					grid[gy[ip]][gx[ip]] = (float) vals[ip];
+				}
+			if (gridx)
+				{
+				evaluate_bipoly_many(&patch->xfunc, np, pu, pv, vals);
+				for (ip=0; ip<np; ip++)
+					gridx[gy[ip]][gx[ip]] = (float) vals[ip];
+				}
+			if (gridy)
+				{
+				evaluate_bipoly_many(&patch->yfunc, np, pu, pv, vals);
+				for (ip=0; ip<np; ip++)
+					gridy[gy[ip]][gx[ip]] = (float) vals[ip];
+				}
+			patch = dispose_sfc_patch(sfc, iu, iv);
+			}
+		}
+	}
+
+/**********************************************************************/
+
+static	void	sfit_grid_adjust
+
+	(
+	FIT_JOB	*job		/* fit points and grid values to adjust */
+	)
+
+	{
+	int		nu, nv, npatch, ipatch, ip, nbuf, ibuf;
+
+	/* Bin the fit points by patch (a counting sort, which keeps the */
+	/* points within each patch in their original order) */
+	nu     = job->ngx - 1;
+	nv     = job->ngy - 1;
+	npatch = nu * nv;
+	job->bstart = INITMEM(int, npatch+1);
+	job->blist  = INITMEM(int, job->fnum);
+	for (ipatch=0; ipatch<=npatch; ipatch++) job->bstart[ipatch] = 0;
+	for (ip=0; ip<job->fnum; ip++)
+		job->bstart[job->fpu[ip]*nv + job->fpv[ip] + 1]++;
+	for (ipatch=0; ipatch<npatch; ipatch++)
+		job->bstart[ipatch+1] += job->bstart[ipatch];
+	for (ip=0; ip<job->fnum; ip++)
+		job->blist[job->bstart[job->fpu[ip]*nv + job->fpv[ip]]++] = ip;
+	for (ipatch=npatch; ipatch>0; ipatch--)
+		job->bstart[ipatch] = job->bstart[ipatch-1];
+	job->bstart[0] = 0;
+
+	/* Number of patches on each side of a grid point that may hold */
+	/* fit points within the radius of influence */
+	if (job->dp <= 0)           job->reach = 0;
+	else if (job->dp >= nu+nv)  job->reach = nu + nv;
+	else                        job->reach = (int) ceil(job->dp);
+
+	/* Set up candidate buffers for each worker */
+	nbuf = MIN(get_worker_threads(), job->ngy);
+	nbuf = MAX(nbuf, 1);
+	job->cands = INITMEM(int *, nbuf);
+	for (ibuf=0; ibuf<nbuf; ibuf++)
+		job->cands[ibuf] = INITMEM(int, job->fnum);
+
+	/* Adjust the rows of grid points */
+	(void) run_worker_jobs(job->ngy, sfit_grid_row, (POINTER) job);
+
+	for (ibuf=0; ibuf<nbuf; ibuf++)
+		FREEMEM(job->cands[ibuf]);
+	FREEMEM(job->cands);
+	FREEMEM(job->bstart);
+	FREEMEM(job->blist);
+	}
+
+/**********************************************************************/
+
+static	void	sfit_grid_row
+
+	(
+	int		iy,			/* row of grid points to be adjusted */
+	int		worker,		/* worker adjusting this row */
+	POINTER	data		/* FIT_JOB shared by all rows */
+	)
+
+	{
+	int		ix, iu, iv, ip, ic, nc, nu, nv;
+	int		iulo, iuhi, ivlo, ivhi, jlo, jhi;
+	int		*cands;
+	double	dx, dy, wx, wy, wt, usum, vsum, wsum;
+	double	dp, dh;
+	FIT_JOB	*job;
+
+	job   = (FIT_JOB *) data;
+	cands = job->cands[worker];
+	nu    = job->ngx - 1;
+	nv    = job->ngy - 1;
+	dp    = job->dp;
+	dh    = job->dh;
+
+	/* Patches in range of this row */
+	ivlo = MAX(iy - job->reach - 1, 0);
+	ivhi = MIN(iy + job->reach, nv-1);
+
+	for (ix=0; ix<job->ngx; ix++)
+		{
+		/* Gather the fit points in patches in range of this grid point */
+		/* and restore their original order */
+		iulo = MAX(ix - job->reach - 1, 0);
+		iuhi = MIN(ix + job->reach, nu-1);
+		nc   = 0;
+		for (iu=iulo; iu<=iuhi && ivlo<=ivhi; iu++)
+			{
+			jlo = job->bstart[iu*nv + ivlo];
+			jhi = job->bstart[iu*nv + ivhi + 1];
+			for ( ; jlo<jhi; jlo++) cands[nc++] = job->blist[jlo];
+			}
+		if (nc > 1)
+			(void) qsort((POINTER) cands, (size_t) nc, sizeof(int),
+					sfit_grid_order);
+
+		/* Account for any fit points that are within range */
+		usum = 0;
+		vsum = 0;
+		wsum = 0;
+		for (ic=0; ic<nc; ic++)
+			{
+			ip = cands[ic];
+			iu = job->fpu[ip];
+			iv = job->fpv[ip];
+
+			/* Determine x and y distance in patch lengths */
+			dx = fabs((double) (iu + job->floc[ip][X] - ix));
+			dy = fabs((double) (iv + job->floc[ip][Y] - iy));
+
+			/* Is this one within range? */
+			if (dx >= dp) continue;
+			if (dy >= dp) continue;
+
+			/* Compute corresponding weights */
+			wx = 1;	if (dx > dh) wx -= (dx-dh)/(dp-dh);
+			wy = 1;	if (dy > dh) wy -= (dy-dh)/(dp-dh);
+			wt = wx * wy;
+
+			/* Accumulate weighted sum */
+			if (job->fval)
+				{
+				vsum += job->fval[ip] * wt * wt;
+				}
+			else
+				{
+				usum += job->fxval[ip] * wt * wt;
+				vsum += job->fyval[ip] * wt * wt;
+				}
+			wsum += wt * wt;
+
+#			ifdef DEBUG_FIT
+			pr_diag("sfit_surface",
+				"   Point [%d] at (%.3f,%.3f)  Wgt: %f\n",
+					ip, dx, dy, wt);
+#			endif /* DEBUG_FIT */
+			}
+
+		/* Continue if no points nearby */
+		if (wsum <= MinimumWgt) continue;
+
+		/* Add weighted mean to grid value */
+		/* Note that the sum of the weights may be increased */
+		/*  ... which will underestimate the adjustment      */
+		/*       but avoid errors with very small weights!   */
+		if (job->grid)
+			{
+			job->grid[iy][ix] += vsum/(wsum*job->weighting);
+			}
+		else
+			{
+			job->gridx[iy][ix] += usum/(wsum*job->weighting);
+			job->gridy[iy][ix] += vsum/(wsum*job->weighting);
+			}
+
+#		ifdef DEBUG_FIT
+		pr_diag("sfit_surface",
+			" Grid [%d][%d]  Adjs: %f  Wgts: %f\n",
+				ix, iy, vsum, wsum);
+#		endif /* DEBUG_FIT */
+		}
+	}
+
+/**********************************************************************/
+
+static	int		sfit_grid_order
+
+	(
+	const void	*c1,
+	const void	*c2
+	)
+
+	{
+	int		ip1, ip2;
+
+	ip1 = *(const int *) c1;
+	ip2 = *(const int *) c2;
+	if (ip1 < ip2) return -1;
+	if (ip1 > ip2) return  1;
+	return 0;
+	}
+
 /***********************************************************************
 *                                                                      *
 *      r e m a p _ g r i d                                             *
@@ -2114,12 +2619,17 @@ static LOGICAL		grid_remapping
 			/* Set up row pointers in doubly dimensioned array */
 			Spos[iiy]  = Ppos + iiy*numx;
 
+			/* Convert the row of locations to the source map */
+			/*  (held in the row until replaced by grid indices) */
+			(void) ll_to_pos_array(smproj, numx, tlat[iiy], tlon[iiy],
+									Spos[iiy], NullLogicalList);
+
 			/* Compute positions for each row */
 			for (iix=0; iix<numx; iix++)
 				{
 
 				/* Convert location to grid indices on the source grid */
-				(void) ll_to_pos(smproj, tlat[iiy][iix], tlon[iiy][iix], pos);
+				copy_point(pos, Spos[iiy][iix]);
 				(void) pos_to_grid(smproj, pos, gpos);
 
 				/* Set locations within the source grid */
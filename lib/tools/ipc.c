@@ -3,7 +3,8 @@
 *    i p c . c                                                         *
 *                                                                      *
 *        Routines to handle Inter-Process Communication via System-V   *
-*        Message System calls                                          *
+*        Message System calls, or via Unix domain sockets (for servers  *
+*        and clients that both support them)                           *
 *                                                                      *
 *     Version 5 (c) Copyright 1998 Environment Canada (AES)            *
 *     Version 7 (c) Copyright 2006 Environment Canada                  *
@@ -39,21 +40,38 @@
 #include <sys/stat.h>
 #include <sys/ipc.h>
 #include <sys/msg.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 extern	int	errno;
 
+/* Maximum number of socket clients connected to one server */
+#define MAXCLIENT 10
+
+/* Interval (milliseconds) for a socket server to check the query queue */
+#define MSGQ_POLL 20L
+
 /* Structure to keep track of communications channel between a client */
 /* and a server */
 typedef	struct
 	{
-	key_t	key;	/* channel name key */
-	int		query;	/* query queue-id */
-	int		reply;	/* reply queue-id */
+	key_t	key;		/* channel name key */
+	char	name[4];	/* channel name */
+	int		query;		/* query queue-id */
+	int		reply;		/* reply queue-id */
+	int		sock;		/* socket to server (client) or to current */
+						/*  client (server) - or -1 to use queues  */
+	int		lsock;		/* listening socket (server) */
+	int		nclient;	/* number of connected socket clients (server) */
+	int		clients[MAXCLIENT];	/* connected socket clients (server) */
 	}	CHANNEL;
 
 /* Internal functions */
@@ -63,6 +81,19 @@ static	int		ipc_destroy(CHANNEL *);
 static	int		ipc_pending(int);
 static	int		ipc_send(int, int, STRING);
 static	int		ipc_receive(int, int, int *, STRING *);
+static	STRING	sock_path(STRING);
+static	int		sock_create(STRING);
+static	int		sock_connect(STRING);
+static	void	sock_set_listener(STRING, int);
+static	int		sock_listener(STRING);
+static	int		sock_poll(CHANNEL *, long);
+static	void	sock_drop(CHANNEL *, int);
+static	void	sock_close(CHANNEL *);
+static	int		sock_write(int, char *, size_t);
+static	int		sock_read(int, char *, size_t);
+static	int		sock_send(int, int, STRING);
+static	int		sock_receive(int, int, int *, STRING *);
+static	int		channel_send(CHANNEL *, int, STRING);
 
 /***********************************************************************
 *                                                                      *
@@ -160,7 +191,11 @@ int		server_control
 /**********************************************************************/
 /** Become a server process, with an active communications channel.
  *
- *    The server communications (listen) channel is created.
+ *    The server communications (listen) channel is created, along
+ *    with the socket the server will listen on.  Since both exist
+ *    before this returns to the process that started the server,
+ *    clients may connect as soon as the server has been started,
+ *    without waiting for it to finish initializing.
  *    Then the current process is "fork"ed, thereby producing a
  *    detached child.  The child then disconnects its terminal
  *    affiliation and becomes the server.  The Parent hangs around
@@ -191,7 +226,7 @@ int		server
 	)
 
 	{
-	int		status;
+	int		status, lsock;
 	CHANNEL	channel;
 
 	/* Make sure desired communications channel is not in use */
@@ -215,6 +250,10 @@ int		server
 		return -2;
 		}
 
+	/* Create the listening socket (if possible) */
+	/* Clients will use the message queues if there is no socket */
+	lsock = sock_create(chname);
+
 	/* Spawn a child to become the server */
 	status = spawn(detach);
 	if (status < 0)
@@ -222,9 +261,17 @@ int		server
 #		ifdef PRINT_STATUS
 		perror("[server] failed to spawn server process");
 #		endif
+		if (lsock >= 0)
+			{
+			(void) close(lsock);
+			(void) unlink(sock_path(chname));
+			}
 		return -3;
 		}
 
+	/* Pass the listening socket on to connect_client() */
+	if (lsock >= 0) sock_set_listener(chname,lsock);
+
 	/* Success - Return 0 */
 #	ifdef PRINT_STATUS
 	(void) printf("[server] server ready\n");
@@ -277,6 +324,11 @@ int		find_channel(void)
 ***********************************************************************/
 /**********************************************************************/
 /** Obtain the communications channel for the given server.
+ *
+ *    Queries are sent through the server socket if the server is
+ *    listening on one, unless the environment variable
+ *    FPA_IPC_TRANSPORT is set to "msgq".  Otherwise queries are sent
+ *    through the message queues.
  *
  *	@param[in]	chname  3-letter channel identifier
  *	@return	>= 0 :- success: channel-id
@@ -291,16 +343,22 @@ int		connect_server
 
 	{
 	int		status, chid;
+	STRING	transport;
 	CHANNEL	*channel;
 
 	/* Find next available channel */
 	chid    = find_channel();
+	if (chid < 0) return -1;
 	channel = &channels[chid];
 
 	/* Obtain access to server communications channel */
 	status = ipc_get(chname,channel);
 	if (status < 0) return -1;
 
+	/* Connect to the server socket (if present) */
+	transport = getenv("FPA_IPC_TRANSPORT");
+	if (!same_ic(transport,"msgq")) channel->sock = sock_connect(chname);
+
 	/* Success */
 	return chid;
 	}
@@ -333,6 +391,7 @@ int		disconnect_server
 	channel = &channels[chid];
 
 	/* Free up current channel */
+	if (channel->key > 0) sock_close(channel);
 	channel->key   = 0;
 	channel->query = 0;
 	channel->reply = 0;
@@ -398,6 +457,8 @@ int		shutdown_server
 /***********************************************************************
 *                                                                      *
 *    q u e r y _ s e r v e r                                           *
+*    s e n d _ s e r v e r                                             *
+*    r e c e i v e _ s e r v e r                                       *
 *                                                                      *
 ***********************************************************************/
 /**********************************************************************/
@@ -429,6 +490,89 @@ int		query_server
 	int		timeout
 	)
 
+	{
+	int		status;
+
+	/* Make sure return parameters are available */
+	if (!rtype) return -1;
+	if (!rtext) return -1;
+
+	/* Send query message */
+	status = send_server(chid,qtype,qtext);
+	if (status < 0) return status;
+
+	/* Receive reply message */
+	return receive_server(chid,rtype,rtext,timeout);
+	}
+
+/**********************************************************************/
+/** Submit a query request to the server associated with the
+ *    given communications channel-id without waiting for the reply.
+ *
+ *    Several queries may be sent before their replies are received
+ *    (with receive_server()), since the server answers the queries
+ *    in the order they are sent.
+ *
+ *  @param[in]	chid 		 channel-id of server communications channel
+ *	@param[in]	qtype 		 query message type
+ *	@param[in]	qtext 		 query message
+ *  @return 0 :- success
+ *         -1 :- failure: invalid channel-id
+ *         -2 :- failure: communications channel lost
+ *
+ **********************************************************************/
+
+int		send_server
+
+(
+	int		chid,
+	int		qtype,
+	STRING	qtext
+	)
+
+	{
+	int		status;
+	CHANNEL	*channel;
+
+	/* Make sure channel-id is valid and in use */
+	if (chid < 0)          return -1;
+	if (chid >= MAXCHAN)   return -1;
+	channel = &channels[chid];
+	if (channel->key <= 0) return -1;
+
+	/* Send query message through socket or on query queue */
+	if (channel->sock >= 0) status = sock_send(channel->sock,qtype,qtext);
+	else                    status = ipc_send(channel->query,qtype,qtext);
+	if (status != 0) return -2;
+
+	return 0;
+	}
+
+/**********************************************************************/
+/** Await the reply to the next query request sent to the server
+ *    associated with the given communications channel-id.
+ *
+ *  @param[in]	chid 		 channel-id of server communications channel
+ *	@param[out]	*rtype  	 reply message type
+ *	@param[out]	*rtext  	 reply message
+ *	@param[in]	timeout 	 timeout in seconds
+ *  @return 0 :- success
+ *         -1 :- failure: invalid channel-id
+ *         -2 :- failure: communications channel lost
+ *         -3 :- failure: timeout
+ *         -4 :- failure: server aborted (with notification)
+ *
+ **********************************************************************/
+
+int		receive_server
+
+(
+	int		chid,
+	int		*rtype,
+	STRING	*rtext,
+	int		timeout
+	)
+
 	{
 	int		status;
 	CHANNEL	*channel;
@@ -443,12 +587,11 @@ int		query_server
 	if (!rtype) return -1;
 	if (!rtext) return -1;
 
-	/* Send query message on query queue */
-	status = ipc_send(channel->query,qtype,qtext);
-	if (status < 0) return -2;
-
-	/* Receive reply message on reply queue */
-	status = ipc_receive(channel->reply,timeout,rtype,rtext);
+	/* Receive reply message through socket or on reply queue */
+	if (channel->sock >= 0)
+		status = sock_receive(channel->sock,timeout,rtype,rtext);
+	else
+		status = ipc_receive(channel->reply,timeout,rtype,rtext);
 	if (status == -2) return -3;
 	if (status < 0)   return -2;
 
@@ -490,7 +633,23 @@ int		connect_client
 	)
 
 	{
-	return connect_server(chname);
+	int		status, chid;
+	CHANNEL	*channel;
+
+	/* Find next available channel */
+	chid    = find_channel();
+	if (chid < 0) return -1;
+	channel = &channels[chid];
+
+	/* Obtain access to server communications channel */
+	status = ipc_get(chname,channel);
+	if (status < 0) return -1;
+
+	/* Listen on the socket created in server() (if any) */
+	channel->lsock = sock_listener(chname);
+
+	/* Success */
+	return chid;
 	}
 
 /***********************************************************************
@@ -586,7 +745,11 @@ int		pending_client
 	channel = &channels[chid];
 	if (channel->key <= 0) return -1;
 
-	/* Now test the channel */
+	/* Test the sockets first, then the query queue */
+	if (channel->lsock >= 0 || channel->nclient > 0)
+		{
+		if (sock_poll(channel,0L) >= 0) return 1;
+		}
 	return ipc_pending(channel->query);
 	}
 
@@ -617,7 +780,7 @@ int		receive_client
 
 	{
 	CHANNEL	*channel;
-	int		status;
+	int		status, sock;
 	char	reply[21];
 
 	/* Make sure channel-id is valid and in use */
@@ -630,15 +793,52 @@ int		receive_client
 	if (!type) return -1;
 	if (!text) return -1;
 
-more:	status = ipc_receive(channel->query,0,type,text);
-	if (status < 0) return status;
+more:
+	/* Wait on the query queue if there are no sockets */
+	if (channel->lsock < 0 && channel->nclient <= 0)
+		{
+		channel->sock = -1;
+		status = ipc_receive(channel->query,0,type,text);
+		if (status < 0) return status;
+		}
+
+	/* Otherwise wait on the sockets ... but check the query */
+	/*  queue regularly for clients that do not use sockets  */
+	else
+		{
+		while (TRUE)
+			{
+			sock = sock_poll(channel,MSGQ_POLL);
+			if (sock >= 0)
+				{
+				status = sock_receive(sock,0,type,text);
+				if (status < 0)
+					{
+					sock_drop(channel,sock);
+					continue;
+					}
+				channel->sock = sock;
+				break;
+				}
+
+			status = ipc_pending(channel->query);
+			if (status < 0) return -1;
+			if (status > 0)
+				{
+				channel->sock = -1;
+				status = ipc_receive(channel->query,0,type,text);
+				if (status < 0) return status;
+				break;
+				}
+			}
+		}
 
 	/* Handle priority messages */
 	if (*type == 99)
 		{
 		if (same(*text,"shutdown"))
 			{
-			status = ipc_send(channel->reply,99,"OK");
+			status = channel_send(channel,99,"OK");
 			(void) sleep(1);
 			status = ipc_destroy(channel);
 			return 1;
@@ -646,7 +846,7 @@ more:	status = ipc_receive(channel->query,0,type,text);
 		if (same(*text,"identify"))
 			{
 			(void) sprintf(reply,"%d",getpid());
-			status = ipc_send(channel->reply,99,reply);
+			status = channel_send(channel,99,reply);
 			goto more;
 			}
 		}
@@ -686,7 +886,7 @@ int		respond_client
 	channel = &channels[chid];
 	if (channel->key <= 0) return -1;
 
-	return ipc_send(channel->reply,type,text);
+	return channel_send(channel,type,text);
 	}
 
 /***********************************************************************
@@ -722,6 +922,7 @@ int		notify_client
 *    i p c _ d e s t r o y   - Destroy communications channel          *
 *    i p c _ s e n d         - Send a message                          *
 *    i p c _ r e c e i v e   - Receive a message                       *
+*    s o c k _ ...           - Same, through Unix domain sockets       *
 *                                                                      *
 *        Low level routines to set up inter-process communications.    *
 *                                                                      *
@@ -801,9 +1002,13 @@ static	int		ipc_create
 	(void) printf("[ipc_create] reply queue created: %sR/%d\n",chname,rid);
 #	endif
 
-	channel->key   = key;
-	channel->query = qid;
-	channel->reply = rid;
+	(void) strcpy(channel->name,chname);
+	channel->key     = key;
+	channel->query   = qid;
+	channel->reply   = rid;
+	channel->sock    = -1;
+	channel->lsock   = -1;
+	channel->nclient = 0;
 	return 0;
 	}
 
@@ -859,9 +1064,13 @@ static	int		ipc_get
 	(void) printf("[ipc_get] reply queue opened: %sR/%d\n",chname,rid);
 #	endif
 
-	channel->key   = key;
-	channel->query = qid;
-	channel->reply = rid;
+	(void) strcpy(channel->name,chname);
+	channel->key     = key;
+	channel->query   = qid;
+	channel->reply   = rid;
+	channel->sock    = -1;
+	channel->lsock   = -1;
+	channel->nclient = 0;
 	return 0;
 	}
 
@@ -878,6 +1087,10 @@ static	int		ipc_destroy
 	if (!channel) return 0;
 	if (channel->key <= 0) return 0;
 
+	/* Close and remove the sockets */
+	sock_close(channel);
+	(void) unlink(sock_path(channel->name));
+
 	/* Remove the query queue */
 	(void) msgctl(channel->query,IPC_RMID,(struct msqid_ds *)0);
 #	ifdef PRINT_STATUS
@@ -1059,6 +1272,444 @@ static	int		ipc_receive
 	return 0;
 	}
 
+/***********************************************************************
+*                                                                      *
+*    Socket transport:                                                 *
+*                                                                      *
+*        A server listens on a Unix domain socket named for the        *
+*        channel, as well as on the query queue.  Each message is      *
+*        sent as an 8-byte header (message type and text length as     *
+*        32-bit integers in network order) followed by the text, so    *
+*        that a message of any size is sent in one piece, and several  *
+*        queries may be sent before their replies are read.            *
+*                                                                      *
+***********************************************************************/
+
+#define SOCK_DIR  "/tmp"
+#define SOCK_ENV  "FPA_IPC_LISTEN"
+#define SOCK_HEAD 8
+#define SOCK_MAX  (64*1024*1024)
+
+/* Listening socket created by server() for connect_client() */
+static	char	ListenName[4] = "";
+static	int		ListenSock    = -1;
+
+static	STRING	sock_path
+
+	(
+	STRING	chname
+	)
+
+	{
+	static	char	path[64];
+
+	(void) sprintf(path,"%s/fpa_ipc_%s",SOCK_DIR,chname);
+	return path;
+	}
+
+
+
+static	int		sock_create
+
+	(
+	STRING	chname
+	)
+
+	{
+	int		sock;
+	STRING	path;
+	struct	sockaddr_un	addr;
+
+	/* Remove any socket left behind by a server that has gone away */
+	path = sock_path(chname);
+	(void) unlink(path);
+
+	sock = socket(AF_UNIX,SOCK_STREAM,0);
+	if (sock < 0) return -1;
+
+	(void) memset(&addr,0,sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strncpy(addr.sun_path,path,sizeof(addr.sun_path)-1);
+	if (bind(sock,(struct sockaddr *) &addr,sizeof(addr)) < 0)
+		{
+#		ifdef PRINT_ERRORS
+		perror("[sock_create] socket not bound");
+#		endif
+		(void) close(sock);
+		return -1;
+		}
+	(void) chmod(path,0666);
+
+	if (listen(sock,SOMAXCONN) < 0)
+		{
+#		ifdef PRINT_ERRORS
+		perror("[sock_create] socket not listening");
+#		endif
+		(void) close(sock);
+		(void) unlink(path);
+		return -1;
+		}
+
+#	ifdef PRINT_STATUS
+	(void) printf("[sock_create] socket created: %s/%d\n",path,sock);
+#	endif
+	return sock;
+	}
+
+
+
+static	int		sock_connect
+
+	(
+	STRING	chname
+	)
+
+	{
+	int		sock;
+	STRING	path;
+	struct	stat		sbuf;
+	struct	sockaddr_un	addr;
+
+	/* Servers that do not listen on a socket have none */
+	path = sock_path(chname);
+	if (stat(path,&sbuf) != 0)  return -1;
+	if (!S_ISSOCK(sbuf.st_mode)) return -1;
+
+	sock = socket(AF_UNIX,SOCK_STREAM,0);
+	if (sock < 0) return -1;
+
+	(void) memset(&addr,0,sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strncpy(addr.sun_path,path,sizeof(addr.sun_path)-1);
+	if (connect(sock,(struct sockaddr *) &addr,sizeof(addr)) < 0)
+		{
+#		ifdef PRINT_ERRORS
+		perror("[sock_connect] socket not connected");
+#		endif
+		(void) close(sock);
+		return -1;
+		}
+
+#	ifdef PRINT_STATUS
+	(void) printf("[sock_connect] socket connected: %s/%d\n",path,sock);
+#	endif
+	return sock;
+	}
+
+
+
+static	void	sock_set_listener
+
+	(
+	STRING	chname,
+	int		lsock
+	)
+
+	{
+	static	char	env[40];
+
+	/* Remember the listening socket for connect_client() ... */
+	(void) strcpy(ListenName,chname);
+	ListenSock = lsock;
+
+	/* ... and pass it on to server programs started by exec() */
+	(void) sprintf(env,"%s=%s:%d",SOCK_ENV,chname,lsock);
+	(void) putenv(env);
+	}
+
+
+
+static	int		sock_listener
+
+	(
+	STRING	chname
+	)
+
+	{
+	int		lsock;
+	STRING	env, colon;
+	struct	stat	sbuf;
+
+	if (ListenSock >= 0 && same(ListenName,chname)) return ListenSock;
+
+	/* Check for a listening socket inherited from server() */
+	env = getenv(SOCK_ENV);
+	if (blank(env)) return -1;
+	colon = strchr(env,':');
+	if (!colon) return -1;
+	if (colon-env != strlen(chname))         return -1;
+	if (strncmp(env,chname,colon-env) != 0) return -1;
+	lsock = atoi(colon+1);
+	if (lsock < 0) return -1;
+	if (fstat(lsock,&sbuf) != 0)  return -1;
+	if (!S_ISSOCK(sbuf.st_mode)) return -1;
+
+	(void) strcpy(ListenName,chname);
+	ListenSock = lsock;
+	return lsock;
+	}
+
+
+
+static	int		sock_poll
+
+	(
+	CHANNEL	*channel,
+	long	msec
+	)
+
+	{
+	int		ic, sock, maxfd, nfd;
+	fd_set	rfds;
+	struct	timeval	tv;
+
+	/* Wait (at most msec milliseconds, or forever if negative) for */
+	/*  a client socket with a query waiting                        */
+	while (TRUE)
+		{
+		FD_ZERO(&rfds);
+		maxfd = -1;
+		if (channel->lsock >= 0)
+			{
+			FD_SET(channel->lsock,&rfds);
+			maxfd = channel->lsock;
+			}
+		for (ic=0; ic<channel->nclient; ic++)
+			{
+			FD_SET(channel->clients[ic],&rfds);
+			if (channel->clients[ic] > maxfd) maxfd = channel->clients[ic];
+			}
+		if (maxfd < 0) return -1;
+
+		tv.tv_sec  = msec / 1000;
+		tv.tv_usec = (msec % 1000) * 1000;
+		nfd = select(maxfd+1,&rfds,(fd_set *)0,(fd_set *)0,
+						(msec < 0)? (struct timeval *)0: &tv);
+		if (nfd < 0 && errno == EINTR) continue;
+		if (nfd <= 0) return -1;
+
+		/* Return the first client with a query waiting */
+		for (ic=0; ic<channel->nclient; ic++)
+			{
+			sock = channel->clients[ic];
+			if (FD_ISSET(sock,&rfds)) return sock;
+			}
+
+		/* Otherwise accept the new client and keep waiting */
+		if (channel->lsock >= 0 && FD_ISSET(channel->lsock,&rfds))
+			{
+			sock = accept(channel->lsock,(struct sockaddr *)0,(socklen_t *)0);
+			if (sock >= 0)
+				{
+				if (channel->nclient < MAXCLIENT)
+					channel->clients[channel->nclient++] = sock;
+				else
+					(void) close(sock);
+				}
+			}
+		}
+	}
+
+
+
+static	void	sock_drop
+
+	(
+	CHANNEL	*channel,
+	int		sock
+	)
+
+	{
+	int		ic;
+
+	/* Client has disconnected */
+	(void) close(sock);
+	for (ic=0; ic<channel->nclient; ic++)
+		{
+		if (channel->clients[ic] != sock) continue;
+		channel->clients[ic] = channel->clients[--channel->nclient];
+		break;
+		}
+	if (channel->sock == sock) channel->sock = -1;
+	}
+
+
+
+static	void	sock_close
+
+	(
+	CHANNEL	*channel
+	)
+
+	{
+	int		ic;
+
+	/* The current client of a server is one of its clients */
+	if (channel->nclient > 0)
+		{
+		for (ic=0; ic<channel->nclient; ic++) (void) close(channel->clients[ic]);
+		}
+	else if (channel->sock >= 0) (void) close(channel->sock);
+	if (channel->lsock >= 0)     (void) close(channel->lsock);
+
+	if (channel->lsock == ListenSock) ListenSock = -1;
+	channel->sock    = -1;
+	channel->lsock   = -1;
+	channel->nclient = 0;
+	}
+
+
+
+static	int		sock_write
+
+	(
+	int		sock,
+	char	*buf,
+	size_t	nbyte
+	)
+
+	{
+	ssize_t	nw;
+	int		flags = 0;
+
+	/* Do not let a client that has gone away kill the server */
+#	ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#	endif
+
+	while (nbyte > 0)
+		{
+		nw = send(sock,buf,nbyte,flags);
+		if (nw < 0 && errno == EINTR) continue;
+		if (nw <= 0) return -1;
+		buf   += nw;
+		nbyte -= nw;
+		}
+	return 0;
+	}
+
+
+
+static	int		sock_read
+
+	(
+	int		sock,
+	char	*buf,
+	size_t	nbyte
+	)
+
+	{
+	ssize_t	nr;
+
+	while (nbyte > 0)
+		{
+		nr = read(sock,buf,nbyte);
+		if (nr < 0 && errno == EINTR) continue;
+		if (nr <= 0) return -1;
+		buf   += nr;
+		nbyte -= nr;
+		}
+	return 0;
+	}
+
+
+
+static	int		sock_send
+
+	(
+	int		sock,
+	int		type,
+	STRING	text
+	)
+
+	{
+	unsigned int	head[2];
+	size_t			tlen;
+
+	if (sock < 0) return -1;
+
+	tlen    = (text)? strlen(text): 0;
+	head[0] = htonl((unsigned int) type);
+	head[1] = htonl((unsigned int) tlen);
+	if (sock_write(sock,(char *) head,SOCK_HEAD) != 0) return 1;
+	if (tlen > 0 && sock_write(sock,text,tlen) != 0)   return 1;
+	return 0;
+	}
+
+
+
+static	int		sock_receive
+
+	(
+	int		sock,
+	int		timeout,
+	int		*type,
+	STRING	*text
+	)
+
+	{
+	unsigned int	head[2];
+	size_t			tlen;
+	int				nfd;
+	fd_set			rfds;
+	struct	timeval	tv;
+
+	/* Clean up text buffer (shared with ipc_receive) */
+	FREEMEM(tbuf);
+	tsize = 0;
+
+	if (sock < 0) return -1;
+	if (!type) return -1;
+	if (!text) return -1;
+
+	/* Wait for the message to arrive */
+	if (timeout > 0)
+		{
+		do	{
+			FD_ZERO(&rfds);
+			FD_SET(sock,&rfds);
+			tv.tv_sec  = timeout;
+			tv.tv_usec = 0;
+			nfd = select(sock+1,&rfds,(fd_set *)0,(fd_set *)0,&tv);
+			} while (nfd < 0 && errno == EINTR);
+		if (nfd == 0)
+			{
+			(void) fprintf(stderr,"IPC Receive Timeout\n");
+			return -2;
+			}
+		if (nfd < 0) return -1;
+		}
+
+	/* Read the header then the text */
+	if (sock_read(sock,(char *) head,SOCK_HEAD) != 0) return -1;
+	tlen = (size_t) ntohl(head[1]);
+	if (tlen > SOCK_MAX) return -1;
+	tbuf = INITMEM(char,tlen+1);
+	if (tlen > 0 && sock_read(sock,tbuf,tlen) != 0) return -1;
+	tbuf[tlen] = '\0';
+	tsize      = (int) tlen;
+
+	*text = tbuf;
+	*type = (int) ntohl(head[0]);
+	return 0;
+	}
+
+
+
+static	int		channel_send
+
+	(
+	CHANNEL	*channel,
+	int		type,
+	STRING	text
+	)
+
+	{
+	/* Reply to the current client through its socket or the reply queue */
+	if (channel->sock >= 0) return sock_send(channel->sock,type,text);
+	return ipc_send(channel->reply,type,text);
+	}
+
 #ifdef LATER
 /***********************************************************************
 *                                                                      *
@@ -36,6 +36,8 @@ int		connect_server(STRING);
 int		disconnect_server(int);
 int		shutdown_server(int);
 int		query_server(int, int, STRING, int *, STRING *, int);
+int		send_server(int, int, STRING);
+int		receive_server(int, int *, STRING *, int);
 
 /* Server functions */
 int		connect_client(STRING);
@@ -221,6 +221,181 @@ LOGICAL	qsolve_matrix_2D
 	return TRUE;
 	}
 
+/***********************************************************************
+*                                                                      *
+*    q f a c t o r _ t r i d i a g                                     *
+*    q s o l v e _ t r i d i a g                                       *
+*    q s o l v e _ t r i d i a g _ r o w s                             *
+*                                                                      *
+***********************************************************************/
+/*********************************************************************/
+/** Factor a tridiagonal system of equations in place.
+ *
+ * The system is given by its three bands, where row i reads:
+ *
+ * @f[ Sub_i*S_{i-1} + Diag_i*S_i + Sup_i*S_{i+1} = V_i @f]
+ *
+ * (Sub[0] and Sup[nrow-1] are ignored).
+ *
+ * This is the Thomas algorithm without pivoting, intended only for
+ * diagonally dominant systems, which guarantee a solution.  On
+ * return, Diag holds the reduced pivots and Sup holds the scaled
+ * super-diagonal, ready for qsolve_tridiag() or qsolve_tridiag_rows().
+ * Sub is untouched.
+ *
+ *	@param[in]	*Sub		sub-diagonal
+ *	@param[in]	*Diag		diagonal in, reduced pivots out
+ *	@param[in]	*Sup		super-diagonal in, scaled super-diagonal out
+ *	@param[in]	nrow		number of rows and columns
+ * 	@return TRUE if successful.
+ *********************************************************************/
+
+LOGICAL	qfactor_tridiag
+
+	(
+	double	*Sub,
+	double	*Diag,
+	double	*Sup,
+	int		nrow
+	)
+
+	{
+	int		row;
+	double	A;
+
+	/* Error return for missing parameters */
+	if (!Sub)  return FALSE;
+	if (!Diag) return FALSE;
+	if (!Sup)  return FALSE;
+	if (nrow <= 0) return FALSE;
+
+	/* Forward elimination of the sub-diagonal */
+	for (row=0; row<nrow; row++)
+		{
+		A = Diag[row];
+		if (row > 0) A -= Sub[row] * Sup[row-1];
+		if (A == 0) return FALSE;
+		Diag[row] = A;
+		Sup[row]  = (row < nrow-1)? Sup[row] / A: 0;
+		}
+
+	return TRUE;
+	}
+
+/*********************************************************************/
+/** Solve a tridiagonal system of equations, previously factored by
+ * qfactor_tridiag().
+ *
+ * The solution is returned in the original right-hand-side vector
+ * [V], and the factored bands are untouched, so they may be re-used
+ * for any number of right-hand-sides.
+ *
+ *	@param[in]	*Sub		sub-diagonal
+ *	@param[in]	*Diag		reduced pivots from qfactor_tridiag()
+ *	@param[in]	*Sup		scaled super-diagonal from qfactor_tridiag()
+ *	@param[in]	*Vector		RHS vector in, solution vector out
+ *	@param[in]	nrow		number of rows and columns
+ * 	@return TRUE if successful.
+ *********************************************************************/
+
+LOGICAL	qsolve_tridiag
+
+	(
+	const double	*Sub,
+	const double	*Diag,
+	const double	*Sup,
+	double			*Vector,
+	int				nrow
+	)
+
+	{
+	int		row;
+
+	/* Error return for missing parameters */
+	if (!Sub)    return FALSE;
+	if (!Diag)   return FALSE;
+	if (!Sup)    return FALSE;
+	if (!Vector) return FALSE;
+
+	/* Forward elimination */
+	Vector[0] /= Diag[0];
+	for (row=1; row<nrow; row++)
+		Vector[row] = (Vector[row] - Sub[row]*Vector[row-1]) / Diag[row];
+
+	/* Back substitution */
+	for (row=nrow-2; row>=0; row--)
+		Vector[row] -= Sup[row] * Vector[row+1];
+
+	return TRUE;
+	}
+
+/*********************************************************************/
+/** Solve a tridiagonal system of equations, previously factored by
+ * qfactor_tridiag(), for a whole block of right-hand-sides at once.
+ *
+ * Each of the nrow rows of the block holds ncol independent
+ * right-hand-side values, so that column j of the block is one
+ * complete right-hand-side vector.  Processing whole rows at a time
+ * keeps the inner loops contiguous in memory.
+ *
+ *	@param[in]	*Sub		sub-diagonal
+ *	@param[in]	*Diag		reduced pivots from qfactor_tridiag()
+ *	@param[in]	*Sup		scaled super-diagonal from qfactor_tridiag()
+ *	@param[in]	**Rows		RHS block in, solution block out
+ *	@param[in]	nrow		number of rows and columns in the system
+ *	@param[in]	ncol		number of right-hand-sides in each row
+ * 	@return TRUE if successful.
+ *********************************************************************/
+
+LOGICAL	qsolve_tridiag_rows
+
+	(
+	const double	*Sub,
+	const double	*Diag,
+	const double	*Sup,
+	double			**Rows,
+	int				nrow,
+	int				ncol
+	)
+
+	{
+	int		row, col;
+	double	A, B, *R, *P;
+
+	/* Error return for missing parameters */
+	if (!Sub)  return FALSE;
+	if (!Diag) return FALSE;
+	if (!Sup)  return FALSE;
+	if (!Rows) return FALSE;
+
+	/* Forward elimination */
+	R = Rows[0];
+	A = 1 / Diag[0];
+	for (col=0; col<ncol; col++) R[col] *= A;
+	for (row=1; row<nrow; row++)
+		{
+		P = Rows[row-1];
+		R = Rows[row];
+		A = Sub[row];
+		B = 1 / Diag[row];
+		for (col=0; col<ncol; col++)
+			R[col] = (R[col] - A*P[col]) * B;
+		}
+
+	/* Back substitution */
+	for (row=nrow-2; row>=0; row--)
+		{
+		P = Rows[row+1];
+		R = Rows[row];
+		A = Sup[row];
+		if (A == 0) continue;
+		for (col=0; col<ncol; col++)
+			R[col] -= A * P[col];
+		}
+
+	return TRUE;
+	}
+
 /***********************************************************************
 *                                                                      *
 *    s o l v e _ m a t r i x                                           *
@@ -37,6 +37,11 @@
 LOGICAL	qsolve_matrix(double **Matrix, double *Vector, int nrow);
 LOGICAL	qsolve_matrix_2D(double **Matrix, double *VecU, double *VecV,
 				double *VecS, int nrow);
+LOGICAL	qfactor_tridiag(double *Sub, double *Diag, double *Sup, int nrow);
+LOGICAL	qsolve_tridiag(const double *Sub, const double *Diag,
+				const double *Sup, double *Vector, int nrow);
+LOGICAL	qsolve_tridiag_rows(const double *Sub, const double *Diag,
+				const double *Sup, double **Rows, int nrow, int ncol);
 LOGICAL	solve_matrix(double **Matrix, double *Vector, int nrow,
 				int swap, int zero);
 LOGICAL	lsq_matrix(double **Matrix, double *Vector, int nrow, int ncol);
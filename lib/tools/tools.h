@@ -23,3 +23,4 @@
 #include "twixt.h"
 #include "under.h"
 #include "unix.h"
+#include "workers.h"
@@ -0,0 +1,356 @@
+/*********************************************************************/
+/** @file workers.c
+ *
+ * Routines to run a batch of independent jobs on a pool of worker
+ * threads.
+ *
+ * Version 8 &copy; Copyright 2011 Environment Canada
+ *
+ *********************************************************************/
+/***********************************************************************
+*                                                                      *
+*    w o r k e r s . c                                                 *
+*                                                                      *
+*    Routines to run a batch of independent jobs on a pool of worker   *
+*    threads.                                                          *
+*                                                                      *
+*    The pool is started the first time it is needed, and the threads  *
+*    then wait for further batches.  The calling thread takes part in  *
+*    each batch as worker 0, so a single worker thread is the same as  *
+*    running the jobs in order in the calling thread.                  *
+*                                                                      *
+*    Only one batch runs at a time.  A batch requested from within a   *
+*    job, or while another thread is running a batch, is run in order  *
+*    in the requesting thread.                                         *
+*                                                                      *
+*    A forked child does not inherit the threads of the pool, so it    *
+*    forgets the pool and starts its own when first needed.            *
+*                                                                      *
+*     Version 8 (c) Copyright 2011 Environment Canada                  *
+*                                                                      *
+*   This file is part of the Forecast Production Assistant (FPA).      *
+*   The FPA is free software: you can redistribute it and/or modify it *
+*   under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation, either version 3 of the License, or  *
+*   any later version.                                                 *
+*                                                                      *
+*   The FPA is distributed in the hope that it will be useful, but     *
+*   WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.               *
+*   See the GNU General Public License for more details.               *
+*                                                                      *
+*   You should have received a copy of the GNU General Public License  *
+*   along with the FPA.  If not, see <http://www.gnu.org/licenses/>.   *
+*                                                                      *
+***********************************************************************/
+
+#include "workers.h"
+#include "parse.h"
+#include "message.h"
+
+#include <fpa_types.h>
+#include <fpa_math.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Upper limit on the size of the pool */
+#define MaxWorkers 64
+
+/* Configured number of worker threads (including the calling thread) */
+static	int		WorkerThreads = 1;
+static	LOGICAL	WorkerSet     = FALSE;
+
+/* Pool of worker threads */
+static	pthread_mutex_t	PoolMutex  = PTHREAD_MUTEX_INITIALIZER;
+static	pthread_cond_t	PoolWake   = PTHREAD_COND_INITIALIZER;
+static	pthread_cond_t	PoolDone   = PTHREAD_COND_INITIALIZER;
+static	pthread_mutex_t	BatchMutex = PTHREAD_MUTEX_INITIALIZER;
+static	pthread_once_t	KeyOnce    = PTHREAD_ONCE_INIT;
+static	pthread_once_t	ForkOnce   = PTHREAD_ONCE_INIT;
+static	pthread_key_t	WorkerKey;
+static	int				PoolSize   = 0;
+static	long			PoolStart[MaxWorkers];
+
+/* Current batch of jobs */
+static	WORKER_FUNC	BatchFunc  = NULL;
+static	POINTER		BatchData  = NULL;
+static	int			BatchJobs  = 0;
+static	int			BatchNext  = 0;
+static	int			BatchLimit = 0;
+static	int			BatchBusy  = 0;
+static	long		BatchGen   = 0;
+
+static	void	worker_key_init(void);
+static	void	worker_fork_init(void);
+static	void	worker_fork_child(void);
+static	void	*worker_main(POINTER);
+
+/***********************************************************************
+*                                                                      *
+*    s e t _ w o r k e r _ t h r e a d s                               *
+*    g e t _ w o r k e r _ t h r e a d s                               *
+*    i n _ w o r k e r _ t h r e a d                                   *
+*                                                                      *
+***********************************************************************/
+
+/*********************************************************************/
+/** Set the number of worker threads to use for each batch of jobs,
+ * including the calling thread.
+ *
+ * This overrides the environment variable FPA_WORKER_THREADS and the
+ * "Worker.Threads" advanced feature.
+ *
+ *	@param[in]	nthreads	number of threads (1 to run jobs in order)
+ *********************************************************************/
+void	set_worker_threads
+
+	(
+	int		nthreads
+	)
+
+	{
+	WorkerThreads = MAX(nthreads, 1);
+	WorkerThreads = MIN(WorkerThreads, MaxWorkers);
+	WorkerSet     = TRUE;
+	}
+
+/*********************************************************************/
+/** Get the number of worker threads to use for each batch of jobs.
+ *
+ * Unless set_worker_threads() has been called, this is taken from the
+ * environment variable FPA_WORKER_THREADS or the "Worker.Threads"
+ * advanced feature.  Either may be a number or "auto" to use one
+ * thread for each available processor.  The default is 1.
+ *
+ * 	@return the number of worker threads, including the calling thread.
+ *********************************************************************/
+int		get_worker_threads(void)
+
+	{
+	int		nthreads;
+	STRING	mode;
+
+	if (!WorkerSet)
+		{
+		mode = getenv("FPA_WORKER_THREADS");
+		if (blank(mode)) mode = get_feature_mode("Worker.Threads");
+
+		nthreads = 1;
+		if (same_ic(mode, "auto"))
+			nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+		else if (!blank(mode) && sscanf(mode, "%d", &nthreads) != 1)
+			{
+			pr_warning("Workers", "Unknown worker thread count \'%s\'.\n",
+					mode);
+			nthreads = 1;
+			}
+
+		set_worker_threads(nthreads);
+		pr_diag("Workers", "Worker threads: %d\n", WorkerThreads);
+		}
+
+	return WorkerThreads;
+	}
+
+/*********************************************************************/
+/** Is the current thread running a job from run_worker_jobs()?
+ *
+ * Library routines that keep static buffers between calls can use
+ * this to decide whether they must use private buffers instead.
+ *
+ * 	@return TRUE if called from within a job.
+ *********************************************************************/
+LOGICAL	in_worker_thread(void)
+
+	{
+	(void) pthread_once(&KeyOnce, worker_key_init);
+	return (LOGICAL) (pthread_getspecific(WorkerKey) != NULL);
+	}
+
+/***********************************************************************
+*                                                                      *
+*    r u n _ w o r k e r _ j o b s                                     *
+*                                                                      *
+***********************************************************************/
+
+/*********************************************************************/
+/** Run a batch of independent jobs on the pool of worker threads,
+ * and wait for all of them to finish.
+ *
+ * Each job is identified by its index (0 to njobs-1).  Jobs are handed
+ * out in order, but may finish in any order, so each job must only
+ * write to its own part of the output.  The worker index passed to
+ * each job (0 to get_worker_threads()-1) may be used to select
+ * per-worker buffers for the duration of this call.
+ *
+ *	@param[in]	njobs	number of jobs
+ *	@param[in]	func	function to run each job
+ *	@param[in]	data	data passed to each job
+ * 	@return TRUE if successful.
+ *********************************************************************/
+LOGICAL	run_worker_jobs
+
+	(
+	int			njobs,
+	WORKER_FUNC	func,
+	POINTER		data
+	)
+
+	{
+	int			nthreads, worker, job;
+	pthread_t	thread;
+
+	if (!func)      return FALSE;
+	if (njobs <= 0) return TRUE;
+
+	/* Run the jobs in order if there is nothing to share, if this is */
+	/* a job within a batch, or if another batch is already running */
+	nthreads = MIN(get_worker_threads(), njobs);
+	if (nthreads <= 1 || in_worker_thread()
+			|| pthread_mutex_trylock(&BatchMutex) != 0)
+		{
+		for (job=0; job<njobs; job++)
+			(*func)(job, 0, data);
+		return TRUE;
+		}
+
+	/* Start any additional threads that are needed */
+	/* ... a forked process starts its own pool */
+	(void) pthread_once(&ForkOnce, worker_fork_init);
+	(void) pthread_mutex_lock(&PoolMutex);
+	while (PoolSize < nthreads-1)
+		{
+		worker = PoolSize + 1;
+		PoolStart[worker] = BatchGen;
+		if (pthread_create(&thread, NULL, worker_main,
+				(POINTER) (long) worker) != 0)
+			{
+			pr_warning("Workers", "Cannot start worker thread %d.\n", worker);
+			break;
+			}
+		(void) pthread_detach(thread);
+		PoolSize++;
+		}
+	nthreads = MIN(nthreads, PoolSize+1);
+
+	/* Hand out the new batch */
+	BatchFunc  = func;
+	BatchData  = data;
+	BatchJobs  = njobs;
+	BatchNext  = 0;
+	BatchLimit = nthreads;
+	BatchBusy  = PoolSize;
+	BatchGen++;
+	(void) pthread_cond_broadcast(&PoolWake);
+
+	/* The calling thread is worker 0 */
+	(void) pthread_setspecific(WorkerKey, (POINTER) &BatchLimit);
+	while (BatchNext < BatchJobs)
+		{
+		job = BatchNext++;
+		(void) pthread_mutex_unlock(&PoolMutex);
+		(*func)(job, 0, data);
+		(void) pthread_mutex_lock(&PoolMutex);
+		}
+	(void) pthread_setspecific(WorkerKey, NULL);
+
+	/* Wait for the rest of the pool to finish */
+	while (BatchBusy > 0)
+		(void) pthread_cond_wait(&PoolDone, &PoolMutex);
+	BatchFunc = NULL;
+	BatchData = NULL;
+	(void) pthread_mutex_unlock(&PoolMutex);
+	(void) pthread_mutex_unlock(&BatchMutex);
+	return TRUE;
+	}
+
+/***********************************************************************
+*                                                                      *
+*    STATIC (LOCAL) ROUTINES:                                          *
+*                                                                      *
+***********************************************************************/
+
+static	void	worker_key_init(void)
+
+	{
+	(void) pthread_key_create(&WorkerKey, NULL);
+	}
+
+/**********************************************************************/
+
+static	void	worker_fork_init(void)
+
+	{
+	(void) pthread_atfork(NULL, NULL, worker_fork_child);
+	}
+
+/**********************************************************************/
+
+static	void	worker_fork_child(void)
+
+	{
+	/* Only the forking thread exists in the child, so forget the */
+	/* pool and start again with the next batch */
+	PoolSize   = 0;
+	BatchFunc  = NULL;
+	BatchData  = NULL;
+	BatchJobs  = 0;
+	BatchNext  = 0;
+	BatchLimit = 0;
+	BatchBusy  = 0;
+	(void) pthread_mutex_init(&PoolMutex,  NULL);
+	(void) pthread_mutex_init(&BatchMutex, NULL);
+	(void) pthread_cond_init(&PoolWake, NULL);
+	(void) pthread_cond_init(&PoolDone, NULL);
+	}
+
+/**********************************************************************/
+
+static	void	*worker_main
+
+	(
+	POINTER	arg
+	)
+
+	{
+	int			worker, job;
+	long		gen;
+	WORKER_FUNC	func;
+	POINTER		data;
+
+	worker = (int) (long) arg;
+	(void) pthread_setspecific(WorkerKey, arg);
+
+	(void) pthread_mutex_lock(&PoolMutex);
+	gen = PoolStart[worker];
+	for (;;)
+		{
+		/* Wait for the next batch */
+		while (BatchGen == gen)
+			(void) pthread_cond_wait(&PoolWake, &PoolMutex);
+		gen = BatchGen;
+
+		/* Take jobs until there are none left */
+		func = BatchFunc;
+		data = BatchData;
+		if (worker < BatchLimit)
+			{
+			while (BatchNext < BatchJobs)
+				{
+				job = BatchNext++;
+				(void) pthread_mutex_unlock(&PoolMutex);
+				(*func)(job, worker, data);
+				(void) pthread_mutex_lock(&PoolMutex);
+				}
+			}
+
+		/* Report back when this worker is done with the batch */
+		if (--BatchBusy <= 0) (void) pthread_cond_signal(&PoolDone);
+		}
+
+	/* Never reached */
+	return NULL;
+	}
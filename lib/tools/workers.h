@@ -0,0 +1,50 @@
+/**********************************************************************/
+/** @file workers.h
+ *
+ *  Pool of worker threads for independent jobs (include file)
+ *
+ *  Version 8 &copy; Copyright 2011 Environment Canada
+ *
+ **********************************************************************/
+/***********************************************************************
+*                                                                      *
+*    w o r k e r s . h                                                 *
+*                                                                      *
+*    Pool of worker threads for independent jobs (include file)        *
+*                                                                      *
+*     Version 8 (c) Copyright 2011 Environment Canada                  *
+*                                                                      *
+*   This file is part of the Forecast Production Assistant (FPA).      *
+*   The FPA is free software: you can redistribute it and/or modify it *
+*   under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation, either version 3 of the License, or  *
+*   any later version.                                                 *
+*                                                                      *
+*   The FPA is distributed in the hope that it will be useful, but     *
+*   WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.               *
+*   See the GNU General Public License for more details.               *
+*                                                                      *
+*   You should have received a copy of the GNU General Public License  *
+*   along with the FPA.  If not, see <http://www.gnu.org/licenses/>.   *
+*                                                                      *
+***********************************************************************/
+
+/* See if already included */
+#ifndef WORKERS_DEFS
+#define WORKERS_DEFS
+
+#include <fpa_types.h>
+
+/* Job function: called once for each job, with the index of the job */
+/* and the index of the worker (0 to nthreads-1) that is running it */
+typedef	void	(*WORKER_FUNC)(int job, int worker, POINTER data);
+
+/* Declare all functions in workers.c */
+void	set_worker_threads(int nthreads);
+int		get_worker_threads(void);
+LOGICAL	in_worker_thread(void);
+LOGICAL	run_worker_jobs(int njobs, WORKER_FUNC func, POINTER data);
+
+/* Now it has been included */
+#endif
@@ -36,8 +36,11 @@
 /* We need C standard library definitions */
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
+#include <unistd.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 
 /* Define FpaGPgen program types */
 static const PROGRAM_INFO GPGprogramTypes[] =
@@ -69,6 +72,19 @@ static const int NumGPGprogramTypes =
 /* Trap for error situations */
 static	void	error_trap(int);
 
+/* Product generation (single, batch or spooled) */
+static	LOGICAL	run_product(STRING, STRING, STRING);
+static	int		run_batch(STRING, int, STRING *, STRING *);
+static	int		run_batch_list(STRING, STRING, STRING);
+static	int		run_spool(STRING, STRING, STRING);
+static	int		read_batch_jobs(FILE *, STRING, int *, STRING **, STRING **);
+static	int		batch_workers(void);
+static	void	write_product_fields(FILE *);
+static	void	preload_product_fields(FILE *);
+
+/* Seconds to wait between checks of an empty spool directory */
+#define	SpoolWait	10
+
 /* Default message string */
 static	char	MyLabel[GPGLong];
 
@@ -91,9 +107,6 @@ int				main
 	int				cyear, cjday, cmonth, cmday, chour, cmin, csec;
 	STRING			rname, pname, sfile, *slist, vtime;
 	MAP_PROJ		*mproj;
-	STRING			pdf_file;
-
-	static	char	PdfFile[GPGLong] = FpaCblank;
 
 	/* Ignore hangup, interrupt and quit signals so we can survive after */
 	/* logging off */
@@ -143,6 +156,15 @@ int				main
 		(void) fprintf(stderr, " <pdf_filename> <run_time>\n");
 		(void) fprintf(stderr, "\n     <pdf_filename> does not need the");
 		(void) fprintf(stderr, "  .fpdf  extension\n");
+		(void) fprintf(stderr, "\n     @<list_file> runs each fpdf file named");
+		(void) fprintf(stderr, " in the list (\"@-\" for standard input)\n");
+		(void) fprintf(stderr, "     +<spool_dir> runs the fpdf files named");
+		(void) fprintf(stderr, " in job files placed in the directory\n");
+		(void) fprintf(stderr, "        (<list_file> and <spool_dir> are");
+		(void) fprintf(stderr, " relative to the setup home directory)\n");
+		(void) fprintf(stderr, "        (one \"<pdf_filename> [<run_time>]\"");
+		(void) fprintf(stderr, " per line, job files starting with \".\"");
+		(void) fprintf(stderr, " are ignored)\n");
 		(void) fprintf(stderr, "\n     <run_time> has the format YYYY:DDD:HH\n");
 		(void) fprintf(stderr, "        where YYYY is the year\n");
 		(void) fprintf(stderr, "              DDD  is the julian day\n");
@@ -354,15 +376,68 @@ int				main
 	(void) set_fld_descript(&Fdesc, FpaF_MAP_PROJECTION, mproj,
 									FpaF_END_OF_LIST);
 
+	/* Run a list of fpdf files, or fpdf files from a spool directory */
+	/*  ... keeping setup, config and fields resident between products */
+	if ( argv[3][0] == '@' )
+		{
+		status = run_batch_list(argv[2], argv[3]+1, argv[4]);
+		}
+	else if ( argv[3][0] == '+' )
+		{
+		status = run_spool(argv[2], argv[3]+1, argv[4]);
+		}
+
+	/* Otherwise run a single fpdf file */
+	else if ( !run_product(argv[2], argv[3], argv[4]) )
+		{
+		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
+		return (-1);
+		}
+	else
+		{
+		status = 0;
+		}
+
+	/* Shutdown message */
+	(void) systime(&cyear, &cjday, &chour, &cmin, &csec);
+	(void) mdate(&cyear, &cjday, &cmonth, &cmday);
+	(void) fprintf(stdout, "\n%s Finished: %d/%.2d/%.2d %.2d:%.2d:%.2d GMT\n",
+			MyLabel, cyear, cmonth, cmday, chour, cmin, csec);
+	FREEMEM(pname);
+	FREEMEM(sfile);
+
+	return ( status == 0 )? 0: (-1);
+	}
+
+/***********************************************************************
+*                                                                      *
+*     r u n _ p r o d u c t                                            *
+*                                                                      *
+*     Generate the graphics product for one fpdf file.                 *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL	run_product
+
+	(
+	STRING		gra_dir,
+	STRING		pdf_name,
+	STRING		rtime
+	)
+
+	{
+	STRING			vtime, pdf_file;
+
+	static	char	PdfFile[GPGLong] = FpaCblank;
+
 	/* Initialize run/valid time stamps */
-	vtime = interpret_timestring(argv[4], NullString, 0.0);
+	vtime = interpret_timestring(rtime, NullString, 0.0);
 	if ( IsNull(vtime) )
 		{
 		(void) fprintf(stderr,
 				"%s Invalid T0 timestring \"%s\"\n",
-				MyLabel, argv[4]);
-		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
-		return (-1);
+				MyLabel, rtime);
+		return FALSE;
 		}
 	(void) safe_strcpy(T0stamp, vtime);
 	(void) safe_strcpy(TVstamp, vtime);
@@ -374,21 +449,20 @@ int				main
 	(void) initialize_graphics_display();
 
 	/* Initialize the input and output directories */
-	if ( !initialize_graphics_directories(argv[2], argv[3]) )
+	if ( !initialize_graphics_directories(gra_dir, pdf_name) )
 		{
-		(void) fprintf(stderr, "%s Error in %s directories\n", MyLabel, pname);
-		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
-		return (-1);
+		(void) fprintf(stderr, "%s Error in %s directories\n",
+				MyLabel, Program.program);
+		return FALSE;
 		}
 
 	/* Identify the base fpdf file */
-	pdf_file = find_pdf_file(argv[3]);
+	pdf_file = find_pdf_file(pdf_name);
 	if ( blank(pdf_file) )
 		{
 		(void) fprintf(stderr, "%s Cannot find fpdf filename \"%s\"\n",
-				MyLabel, argv[3]);
-		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
-		return (-1);
+				MyLabel, pdf_name);
+		return FALSE;
 		}
 	(void) strcpy(PdfFile, pdf_file);
 
@@ -397,24 +471,428 @@ int				main
 		{
 		(void) fprintf(stderr, "%s Error processing fpdf file \"%s\"\n",
 				MyLabel, PdfFile);
-		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
-		return (-1);
+		return FALSE;
 		}
 
 	/* Close the ouput file */
 	(void) close_graphics_file();
+	return TRUE;
+	}
 
-	/* Shutdown message */
-	(void) systime(&cyear, &cjday, &chour, &cmin, &csec);
-	(void) mdate(&cyear, &cjday, &cmonth, &cmday);
-	(void) fprintf(stdout, "\n%s Finished: %d/%.2d/%.2d %.2d:%.2d:%.2d GMT\n",
-			MyLabel, cyear, cmonth, cmday, chour, cmin, csec);
-	FREEMEM(pname);
-	FREEMEM(sfile);
+/***********************************************************************
+*                                                                      *
+*     r u n _ b a t c h                                                *
+*                                                                      *
+*     Generate the graphics products for a list of fpdf files.         *
+*                                                                      *
+*     Each product is generated in a child process, so that nothing    *
+*     one product sets can affect the next, while the setup, config    *
+*     and fields already read by this process are shared (read-only)   *
+*     by every child.  The first product is generated on its own, and  *
+*     the fields each product reads are then read here as well, so     *
+*     that later products find them already loaded.  Up to the number  *
+*     of workers given by the FPA_GPGEN_WORKERS environment variable   *
+*     or the "GPGen.Workers" advanced feature are run at once.         *
+*                                                                      *
+*     Returns the number of products that failed.                      *
+*                                                                      *
+***********************************************************************/
+
+static	int		run_batch
+
+	(
+	STRING		gra_dir,
+	int			njobs,
+	STRING		*pdfs,
+	STRING		*rtimes
+	)
+
+	{
+	int			nwork, nrun, ndone, nfail, next, iw, wstat;
+	pid_t		pid, *pids;
+	int			*jobs;
+	FILE		*fp, **flds;
+
+	if ( njobs <= 0 ) return 0;
+	nwork = batch_workers();
+	pids  = INITMEM(pid_t,  nwork);
+	jobs  = INITMEM(int,    nwork);
+	flds  = INITMEM(FILE *, nwork);
+	for ( iw=0; iw<nwork; iw++ ) pids[iw] = 0;
+
+	nrun  = 0;
+	ndone = 0;
+	nfail = 0;
+	next  = 0;
+	while ( next < njobs || nrun > 0 )
+		{
+
+		/* Start products while there are free workers */
+		/*  ... but wait for the first product to finish */
+		while ( next < njobs && nrun < nwork && ( next == 0 || ndone > 0 ) )
+			{
+			for ( iw=0; iw<nwork; iw++ ) if ( pids[iw] == 0 ) break;
+
+			/* The child lists the fields it read in a scratch file */
+			fp = tmpfile();
+			(void) fflush(stdout);
+			(void) fflush(stderr);
+			pid = fork();
+			if ( pid == 0 )
+				{
+				/* The child leaves with _exit() so that stdio buffers */
+				/*  inherited from the parent are not written again    */
+				(void) sprintf(MyLabel, "[%d] %s:", getpid(), Program.label);
+				if ( !run_product(gra_dir, pdfs[next], rtimes[next]) )
+					{
+					(void) fprintf(stdout, "%s Aborted\n", MyLabel);
+					(void) fflush(stdout);
+					(void) fflush(stderr);
+					_exit(1);
+					}
+				if ( NotNull(fp) )
+					{
+					(void) write_product_fields(fp);
+					(void) fflush(fp);
+					}
+				(void) fflush(stdout);
+				(void) fflush(stderr);
+				_exit(0);
+				}
+			if ( pid < 0 )
+				{
+				(void) fprintf(stderr, "%s Cannot start fpdf file \"%s\"\n",
+						MyLabel, pdfs[next]);
+				if ( NotNull(fp) ) (void) fclose(fp);
+				nfail++;
+				ndone++;
+				next++;
+				continue;
+				}
+
+			(void) fprintf(stdout, "%s Started fpdf file \"%s\" (%s) [%d]\n",
+					MyLabel, pdfs[next], rtimes[next], (int) pid);
+			pids[iw] = pid;
+			jobs[iw] = next;
+			flds[iw] = fp;
+			nrun++;
+			next++;
+			}
+		if ( nrun <= 0 ) continue;
+
+		/* Wait for a product to finish */
+		pid = waitpid((pid_t) -1, &wstat, 0);
+		if ( pid < 0 ) break;
+		for ( iw=0; iw<nwork; iw++ ) if ( pids[iw] == pid ) break;
+		if ( iw >= nwork ) continue;
+		pids[iw] = 0;
+		nrun--;
+		ndone++;
+
+		if ( WIFEXITED(wstat) && WEXITSTATUS(wstat) == 0 )
+			{
+			(void) fprintf(stdout, "%s Finished fpdf file \"%s\"\n",
+					MyLabel, pdfs[jobs[iw]]);
+			}
+		else
+			{
+			(void) fprintf(stdout, "%s Failed fpdf file \"%s\"\n",
+					MyLabel, pdfs[jobs[iw]]);
+			nfail++;
+			}
+
+		/* Load the fields read for this product for later products */
+		if ( NotNull(flds[iw]) )
+			{
+			rewind(flds[iw]);
+			(void) preload_product_fields(flds[iw]);
+			(void) fclose(flds[iw]);
+			flds[iw] = NullPtr(FILE *);
+			}
+		}
+
+	FREEMEM(pids);
+	FREEMEM(jobs);
+	FREEMEM(flds);
+	return nfail;
+	}
+
+/**********************************************************************/
+
+static	int		batch_workers
+
+	(
+	)
+
+	{
+	STRING	mode;
+	int		nwork;
+
+	mode = getenv("FPA_GPGEN_WORKERS");
+	if ( blank(mode) ) mode = get_feature_mode("GPGen.Workers");
+
+	nwork = 1;
+	if ( !blank(mode) && sscanf(mode, "%d", &nwork) != 1 )
+		{
+		(void) fprintf(stderr, "%s Unknown GPGen.Workers \"%s\"\n",
+				MyLabel, mode);
+		nwork = 1;
+		}
+	return MAX(nwork, 1);
+	}
+
+/***********************************************************************
+*                                                                      *
+*     r u n _ b a t c h _ l i s t                                      *
+*     r u n _ s p o o l                                                *
+*     r e a d _ b a t c h _ j o b s                                    *
+*                                                                      *
+*     Generate the graphics products for the fpdf files named in a     *
+*     list file, or in job files placed in a spool directory.  Each    *
+*     line gives an fpdf file name and (optionally) a run time.        *
+*     Spooled job files are removed once read, and the fields held     *
+*     are discarded before each set of jobs, since the data may have   *
+*     changed while waiting.                                           *
+*                                                                      *
+***********************************************************************/
+
+static	int		run_batch_list
+
+	(
+	STRING		gra_dir,
+	STRING		list_file,
+	STRING		rtime
+	)
+
+	{
+	int			njobs, nfail;
+	STRING		*pdfs, *rtimes;
+	FILE		*fp;
+
+	/* Read the list of fpdf files (relative to the home directory) */
+	if ( !same(list_file, "-") )
+		list_file = pathname(home_directory(), list_file);
+	fp = ( same(list_file, "-") )? stdin: fopen(list_file, "r");
+	if ( IsNull(fp) )
+		{
+		(void) fprintf(stderr, "%s Cannot read fpdf list \"%s\"\n",
+				MyLabel, list_file);
+		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
+		return (-1);
+		}
+	njobs  = 0;
+	pdfs   = NullStringList;
+	rtimes = NullStringList;
+	(void) read_batch_jobs(fp, rtime, &njobs, &pdfs, &rtimes);
+	if ( fp != stdin ) (void) fclose(fp);
+
+	/* Generate the products */
+	(void) fprintf(stdout, "%s Running %d fpdf files from \"%s\"\n",
+			MyLabel, njobs, list_file);
+	nfail = run_batch(gra_dir, njobs, pdfs, rtimes);
+	if ( nfail > 0 )
+		(void) fprintf(stdout, "%s %d of %d fpdf files failed\n",
+				MyLabel, nfail, njobs);
+
+	pdfs   = freelist(njobs, pdfs);
+	rtimes = freelist(njobs, rtimes);
+	return nfail;
+	}
+
+/**********************************************************************/
+
+static	int		run_spool
+
+	(
+	STRING		gra_dir,
+	STRING		spool_dir,
+	STRING		rtime
+	)
+
+	{
+	int			nfiles, ifile, njobs, nfail;
+	STRING		*files, *pdfs, *rtimes, path;
+	FILE		*fp;
+
+	/* The spool directory is relative to the home directory */
+	spool_dir = safe_strdup(pathname(home_directory(), spool_dir));
+	if ( !find_directory(spool_dir) )
+		{
+		(void) fprintf(stderr, "%s Cannot find spool directory \"%s\"\n",
+				MyLabel, spool_dir);
+		(void) fprintf(stdout, "%s Aborted\n", MyLabel);
+		FREEMEM(spool_dir);
+		return (-1);
+		}
+	(void) fprintf(stdout, "%s Waiting for fpdf jobs in \"%s\"\n",
+			MyLabel, spool_dir);
+
+	while ( TRUE )
+		{
+
+		/* Read and remove each job file in the spool directory */
+		njobs  = 0;
+		pdfs   = NullStringList;
+		rtimes = NullStringList;
+		nfiles = dirlist(spool_dir, "^[^.]", &files);
+		for ( ifile=0; ifile<nfiles; ifile++ )
+			{
+			path = pathname(spool_dir, files[ifile]);
+			if ( IsNull( fp = fopen(path, "r") ) ) continue;
+			(void) read_batch_jobs(fp, rtime, &njobs, &pdfs, &rtimes);
+			(void) fclose(fp);
+			(void) unlink(path);
+			}
 
+		if ( njobs <= 0 )
+			{
+			(void) sleep(SpoolWait);
+			continue;
+			}
+
+		/* Generate the products from freshly read fields */
+		(void) clear_equation_database();
+		(void) fprintf(stdout, "%s Running %d spooled fpdf files\n",
+				MyLabel, njobs);
+		nfail = run_batch(gra_dir, njobs, pdfs, rtimes);
+		if ( nfail > 0 )
+			(void) fprintf(stdout, "%s %d of %d fpdf files failed\n",
+					MyLabel, nfail, njobs);
+
+		pdfs   = freelist(njobs, pdfs);
+		rtimes = freelist(njobs, rtimes);
+		}
+
+	/* Never reached */
 	return 0;
 	}
 
+/**********************************************************************/
+
+static	int		read_batch_jobs
+
+	(
+	FILE		*fp,
+	STRING		rtime,
+	int			*njobs,
+	STRING		**pdfs,
+	STRING		**rtimes
+	)
+
+	{
+	int			nadd;
+	LOGICAL		status;
+	char		line[GPGLong], pdf[GPGLong], tstamp[GPGLong];
+
+	nadd = 0;
+	while ( NotNull(getvalidline(fp, line, (size_t) GPGLong, "#")) )
+		{
+		(void) strcpy_arg(pdf, line, &status);
+		if ( !status || blank(pdf) ) continue;
+		(void) strcpy_arg(tstamp, line, &status);
+		if ( !status || blank(tstamp) ) (void) strcpy(tstamp, rtime);
+
+		(*njobs)++;
+		*pdfs   = GETMEM(*pdfs,   STRING, *njobs);
+		*rtimes = GETMEM(*rtimes, STRING, *njobs);
+		(*pdfs)[*njobs-1]   = strdup(pdf);
+		(*rtimes)[*njobs-1] = strdup(tstamp);
+		nadd++;
+		}
+	return nadd;
+	}
+
+/***********************************************************************
+*                                                                      *
+*     w r i t e _ p r o d u c t _ f i e l d s                          *
+*     p r e l o a d _ p r o d u c t _ f i e l d s                      *
+*                                                                      *
+*     Pass the fields read for a product (one field per line, given    *
+*     by directory path, source, subsource, run time, valid time,      *
+*     element, level and field type) back to the parent process, and   *
+*     read the same fields there.                                      *
+*                                                                      *
+***********************************************************************/
+
+#define	FieldArg(arg)	( (blank(arg))? "-": (arg) )
+#define	FieldVal(arg)	( (same(arg, "-"))? FpaCblank: (arg) )
+
+static	void	write_product_fields
+
+	(
+	FILE		*fp
+	)
+
+	{
+	int				nfds, ifd;
+	FLD_DESCRIPT	*fdescs, *fd;
+
+	nfds = equation_database_descriptors(&fdescs);
+	for ( ifd=0; ifd<nfds; ifd++ )
+		{
+		fd = fdescs + ifd;
+		if ( IsNull(fd->sdef) || IsNull(fd->subdef)
+				|| IsNull(fd->edef) || IsNull(fd->ldef) ) continue;
+		(void) fprintf(fp, "%s %s %s %s %s %s %s %d\n",
+				FieldArg(fd->path),
+				FieldArg(fd->sdef->name), FieldArg(fd->subdef->name),
+				FieldArg(fd->rtime), FieldArg(fd->vtime),
+				FieldArg(fd->edef->name), FieldArg(fd->ldef->name),
+				fd->fmacro);
+		}
+	FREEMEM(fdescs);
+	(void) fflush(fp);
+	}
+
+/**********************************************************************/
+
+static	void	preload_product_fields
+
+	(
+	FILE		*fp
+	)
+
+	{
+	int				fmacro;
+	LOGICAL			status;
+	FLD_DESCRIPT	descript;
+	FIELD			fld;
+	char			line[MAX_BCHRS+GPGLong], path[MAX_BCHRS];
+	char			source[GPGMedium], subsrc[GPGMedium];
+	char			rtime[GPGMedium], vtime[GPGMedium];
+	char			elem[GPGMedium], level[GPGMedium];
+
+	while ( NotNull(getvalidline(fp, line, sizeof(line), "#")) )
+		{
+		(void) strcpy_arg(path,   line, NullLogicalPtr);
+		(void) strcpy_arg(source, line, NullLogicalPtr);
+		(void) strcpy_arg(subsrc, line, NullLogicalPtr);
+		(void) strcpy_arg(rtime,  line, NullLogicalPtr);
+		(void) strcpy_arg(vtime,  line, NullLogicalPtr);
+		(void) strcpy_arg(elem,   line, NullLogicalPtr);
+		(void) strcpy_arg(level,  line, NullLogicalPtr);
+
+		/* A complete line ends with the field type */
+		fmacro = int_arg(line, &status);
+		if ( !status ) continue;
+
+		/* Reading the field enters it in the Equation Database */
+		(void) copy_fld_descript(&descript, &Fdesc);
+		if ( !set_fld_descript(&descript,
+								FpaF_SOURCE_NAME,    FieldVal(source),
+								FpaF_SUBSOURCE_NAME, FieldVal(subsrc),
+								FpaF_DIRECTORY_PATH, FieldVal(path),
+								FpaF_RUN_TIME,       FieldVal(rtime),
+								FpaF_VALID_TIME,     FieldVal(vtime),
+								FpaF_ELEMENT_NAME,   FieldVal(elem),
+								FpaF_LEVEL_NAME,     FieldVal(level),
+								FpaF_FIELD_MACRO,    fmacro,
+								FpaF_END_OF_LIST) ) continue;
+		fld = field_from_equation_database(&descript);
+		(void) destroy_field(fld);
+		}
+	}
+
 /***********************************************************************
 *                                                                      *
 *     e r r o r _ t r a p                                              *
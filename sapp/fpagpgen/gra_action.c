@@ -44,6 +44,12 @@ static	LOGICAL	DebugMode = FALSE;
 static  STRING		parse_ctable_name(STRING);
 static  void		reverse_image_list(Image *, int);
 static	STRING		check_sample_cases(POINT, STRING, STRING, SPCASE *, int);
+static	int			retrieve_xsection_values(FLD_DESCRIPT *, int, STRING, int,
+											POINT *, STRING *, float *, float *,
+											LOGICAL *);
+static	LOGICAL		retrieve_xsection_group(FLD_DESCRIPT *, int, STRING, int,
+											POINT *, int *, float *, float *,
+											LOGICAL *);
 static	float		set_vertical_position(FLD_DESCRIPT *, XSECT_VER_AXIS *,
 											POINT, STRING, STRING, STRING,
 											STRING, STRING, STRING,
@@ -5183,9 +5189,8 @@ LOGICAL			GRA_display_xsection_contours
 	char			err_buf[GPGLong];
 
 	LOGICAL			status = FALSE;
+	int				nvalid;
 	float			flat, flon;
-	POINT			pos[1] = { ZERO_POINT };
-	VLIST			*vlist;
 	SURFACE			sfc;
 	float			fval, fminv, fmaxv, fbase, fint, vmin, vmax, diff;
 	double			dval;
@@ -5199,6 +5204,12 @@ LOGICAL			GRA_display_xsection_contours
 	static float		*FldVals   = NullPtr(float *);
 	static float		**GridVals = NullPtr(float **);
 
+	/* Storage for cross section locations and values for one field */
+	static int			NumXpos = 0;
+	static POINT		*Xpos   = NullPointList;
+	static float		*Xvals  = NullFloat;
+	static LOGICAL		*Xvalid = NullLogicalPtr;
+
 	/* Storage for cross section contour field units specification */
 	static USPEC		uspec = {NullString, 1.0, 0.0};
 
@@ -5268,6 +5279,34 @@ LOGICAL			GRA_display_xsection_contours
 	FldVals  = INITMEM(float,   haxis->num * vaxis->num);
 	GridVals = INITMEM(float *, vaxis->num);
 
+	/* Initialize space for cross section locations */
+	if ( haxis->num > NumXpos )
+		{
+		NumXpos  = haxis->num;
+		Xpos     = GETMEM(Xpos,   POINT,   NumXpos);
+		Xvals    = GETMEM(Xvals,  float,   NumXpos);
+		Xvalid   = GETMEM(Xvalid, LOGICAL, NumXpos);
+		}
+
+	/* Set map positions for field data */
+	for ( nx=0; nx<haxis->num; nx++ )
+		{
+		flat = haxis->flats[nx];
+		flon = haxis->flons[nx];
+		(void) ll_to_pos(&BaseMap, flat, flon, Xpos[nx]);
+		if ( Xpos[nx][X] < 0.0 || Xpos[nx][Y] < 0.0
+				|| Xpos[nx][X] > BaseMap.definition.xlen
+				|| Xpos[nx][Y] > BaseMap.definition.ylen )
+			{
+			if ( Verbose )
+				{
+				(void) fprintf(stdout,
+					"  Cross section lat/lon outside map at ... %.1f %.1f\n",
+					flat, flon);
+				}
+			}
+		}
+
 	/* Now extract the data for cross section contouring field by field */
 	/* Note that field data is ordered wrt vertical axis parameters     */
 	for ( ny=0; ny<vaxis->num; ny++ )
@@ -5280,181 +5319,124 @@ LOGICAL			GRA_display_xsection_contours
 		/* Set the row count location */
 		GridVals[ny] = FldVals + ny * haxis->num;
 
-		/* Extract the data for cross section contouring point by point       */
-		/* Note that the field data is ordered wrt horizontal axis parameters */
-		for ( nx=0; nx<haxis->num; nx++ )
-			{
-
-			/* Set latitude/longitude for field data */
-			flat = haxis->flats[nx];
-			flon = haxis->flons[nx];
+		/* Make a copy of the global field descriptor */
+		(void) copy_fld_descript(&descript, &Fdesc);
 
-			/* Set map position for field data */
-			(void) ll_to_pos(&BaseMap, flat, flon, pos[0]);
-			if ( pos[0][X] < 0.0 || pos[0][Y] < 0.0
-					|| pos[0][X] > BaseMap.definition.xlen
-					|| pos[0][Y] > BaseMap.definition.ylen )
-				{
-				if ( Verbose )
-					{
-					(void) fprintf(stdout,
-						"  Cross section lat/lon outside map at ... %.1f %.1f\n",
-						flat, flon);
-					}
-				}
+		/* Re-initialize field descriptor for element, level, valid time */
+		if ( !set_fld_descript(&descript, FpaF_DIRECTORY_PATH, FpaCblank,
+							FpaF_SOURCE_NAME,   CurSource,
+							FpaF_RUN_TIME,      FpaCblank,
+							FpaF_ELEMENT_NAME,  xsect_flds[nfld].element,
+							FpaF_LEVEL_NAME,    xsect_flds[nfld].level,
+							FpaF_VALID_TIME,    haxis->vtimes[0],
+							FpaF_END_OF_LIST) )
+			{
+			(void) sprintf(err_buf,
+					" Error setting field descriptor for ... %s %s from %s at %s\n",
+					xsect_flds[nfld].element, xsect_flds[nfld].level,
+					CurSource, haxis->vtimes[0]);
+			(void) error_report(err_buf);
+			}
 
-			/* Make a copy of the global field descriptor */
-			(void) copy_fld_descript(&descript, &Fdesc);
+		/* Set the field type for sampling by equation */
+		if ( !blank(xsect_flds[nfld].equation) )
+			{
+			fkind = FpaC_CONTINUOUS;
+			}
 
-			/* Re-initialize field descriptor for element, level, valid time */
-			if ( !set_fld_descript(&descript, FpaF_DIRECTORY_PATH, FpaCblank,
-								FpaF_SOURCE_NAME,   CurSource,
-								FpaF_RUN_TIME,      FpaCblank,
-								FpaF_ELEMENT_NAME,  xsect_flds[nfld].element,
-								FpaF_LEVEL_NAME,    xsect_flds[nfld].level,
-								FpaF_VALID_TIME,    haxis->vtimes[nx],
-								FpaF_END_OF_LIST) )
+		/* Set the field type from the element and level */
+		else
+			{
+			fdef = get_field_info(descript.edef->name, descript.ldef->name);
+			if ( IsNull(fdef) )
 				{
 				(void) sprintf(err_buf,
-						" Error setting field descriptor for ... %s %s from %s at %s\n",
-						xsect_flds[nfld].element, xsect_flds[nfld].level,
-						CurSource, haxis->vtimes[nx]);
+						"Unrecognized element ... %s  or level ... %s",
+						xsect_flds[nfld].element, xsect_flds[nfld].level);
 				(void) error_report(err_buf);
 				}
+			fkind = fdef->element->fld_type;
 
-			/* Set the field type for sampling by equation */
-			if ( !blank(xsect_flds[nfld].equation) )
-				{
-				fkind = FpaC_CONTINUOUS;
-				}
-
-			/* Set the field type from the element and level */
-			else
-				{
-				fdef = get_field_info(descript.edef->name, descript.ldef->name);
-				if ( IsNull(fdef) )
-					{
-					(void) sprintf(err_buf,
-							"Unrecognized element ... %s  or level ... %s",
-							xsect_flds[nfld].element, xsect_flds[nfld].level);
-					(void) error_report(err_buf);
-					}
-				fkind = fdef->element->fld_type;
-
-				/* Check that units match with field information */
-				switch ( fkind )
-					{
-
-					/* Must match field units for continuous/vector fields */
-					case FpaC_CONTINUOUS:
-					case FpaC_VECTOR:
-						udef = fdef->element->elem_io->units;
-						if ( NotNull(udef)
-								&& !convert_value(udef->name, 0.0,
-															units, NullDouble) )
-							{
-							(void) sprintf(err_buf,
-									"Incorrect units: %s  for field: %s %s with units %s",
-									units, xsect_flds[nfld].element,
-									xsect_flds[nfld].level, udef->name);
-							(void) error_report(err_buf);
-							}
-						break;
-					}
-				}
-
-			/* Extract field value depending on field type */
+			/* Check that units match with field information */
 			switch ( fkind )
 				{
 
-				/* Extract field value for continuous type fields */
+				/* Must match field units for continuous/vector fields */
 				case FpaC_CONTINUOUS:
-
-					/* Extract field value by equation */
-					if ( !blank(xsect_flds[nfld].equation) )
-						{
-						vlist = retrieve_vlist_by_equation(&descript, 1, pos,
-								FpaCmksUnits, xsect_flds[nfld].equation);
-						if ( IsNull(vlist) )
-							{
-							if ( Verbose )
-								{
-								(void) fprintf(stdout,
-									"Cannot calculate equation ... %s",
-									xsect_flds[nfld].equation);
-								(void) fprintf(stdout,
-									"  from %s at %s\n",
-									CurSource, haxis->vtimes[nx]);
-								}
-							return TRUE;
-							}
-						}
-
-					/* Extract field value directly */
-					else
+				case FpaC_VECTOR:
+					udef = fdef->element->elem_io->units;
+					if ( NotNull(udef)
+							&& !convert_value(udef->name, 0.0,
+														units, NullDouble) )
 						{
-						vlist = retrieve_vlist(&descript, 1, pos);
-						if ( IsNull(vlist) )
-							{
-							if ( Verbose )
-								{
-								(void) fprintf(stdout,
-									"Cannot extract field ... %s %s",
-									xsect_flds[nfld].element,
-									xsect_flds[nfld].level);
-								(void) fprintf(stdout,
-									"  from %s at %s\n",
-									CurSource, haxis->vtimes[nx]);
-								}
-							return TRUE;
-							}
+						(void) sprintf(err_buf,
+								"Incorrect units: %s  for field: %s %s with units %s",
+								units, xsect_flds[nfld].element,
+								xsect_flds[nfld].level, udef->name);
+						(void) error_report(err_buf);
 						}
 					break;
+				}
+			}
 
-				/* Extract field values for vector type fields */
-				case FpaC_VECTOR:
-					vlist = retrieve_vlist_component(&descript, M_Comp, 1, pos);
-					if ( IsNull(vlist) )
+		/* Extract field values depending on field type */
+		switch ( fkind )
+			{
+
+			/* Extract field values for continuous or vector type fields */
+			/*  ... for all locations at each valid time at once         */
+			case FpaC_CONTINUOUS:
+			case FpaC_VECTOR:
+				nvalid = retrieve_xsection_values(&descript, fkind,
+							xsect_flds[nfld].equation, haxis->num, Xpos,
+							haxis->vtimes, Xvals, NullFloat, Xvalid);
+				if ( nvalid < haxis->num )
+					{
+					if ( Verbose )
 						{
-						if ( Verbose )
-							{
+						for ( nx=0; nx<haxis->num; nx++ )
+							if ( !Xvalid[nx] ) break;
+						if ( !blank(xsect_flds[nfld].equation) )
+							(void) fprintf(stdout,
+								"Cannot calculate equation ... %s",
+								xsect_flds[nfld].equation);
+						else
 							(void) fprintf(stdout,
 								"Cannot extract field ... %s %s",
 								xsect_flds[nfld].element,
 								xsect_flds[nfld].level);
-							(void) fprintf(stdout,
-								"  from %s at %s\n",
-								CurSource, haxis->vtimes[nx]);
-							}
-						return TRUE;
-						}
-					break;
-
-				/* Default for all other types of fields */
-				case FpaC_DISCRETE:
-				case FpaC_LINE:
-				case FpaC_SCATTERED:
-				case FpaC_LCHAIN:
-				default:
-					if ( Verbose )
-						{
-						(void) fprintf(stdout,
-							"Cannot extract values from field ... %s %s",
-							xsect_flds[nfld].element, xsect_flds[nfld].level);
 						(void) fprintf(stdout,
 							"  from %s at %s\n",
 							CurSource, haxis->vtimes[nx]);
 						}
 					return TRUE;
-				}
+					}
+				break;
 
-			/* Convert field value to required units */
-			(void) convert_value(FpaCmksUnits, (double) vlist->val[0],
-					units, &dval);
-			(void) free_vlist(vlist);
-			FREEMEM(vlist);
+			/* Default for all other types of fields */
+			case FpaC_DISCRETE:
+			case FpaC_LINE:
+			case FpaC_SCATTERED:
+			case FpaC_LCHAIN:
+			default:
+				if ( Verbose )
+					{
+					(void) fprintf(stdout,
+						"Cannot extract values from field ... %s %s",
+						xsect_flds[nfld].element, xsect_flds[nfld].level);
+					(void) fprintf(stdout,
+						"  from %s at %s\n",
+						CurSource, haxis->vtimes[0]);
+					}
+				return TRUE;
+			}
 
-			/* Set cross section data for this location */
+		/* Convert field values to required units */
+		/*  and set cross section data for each location */
+		for ( nx=0; nx<haxis->num; nx++ )
+			{
+			(void) convert_value(FpaCmksUnits, (double) Xvals[nx],
+					units, &dval);
 			GridVals[ny][nx] = (float) dval;
 			}
 		}
@@ -9993,6 +9975,14 @@ LOGICAL			GRA_sample_field
 	static	char		lastlevel[GPGLong]   = "";
 	static	int			lastfkind            = FpaCnoMacro;
 
+	/* Arrays for cross section sampling */
+	static	int		NumXpos = 0;
+	static	POINT	*Xpos   = NullPointList;
+	static	STRING	*Xvts   = NullStringList;
+	static	float	*Xvals  = NullFloat;
+	static	float	*Xdirs  = NullFloat;
+	static	LOGICAL	*Xvalid = NullLogicalPtr;
+
 	/* Arrays for table or grid sampling */
 	static	int		Nump   = 0;
 	static	POINT	*Ppos  = NullPointList;
@@ -15969,6 +15959,31 @@ LOGICAL			GRA_sample_field
 			(void) error_report(err_buf);
 			}
 
+		/* Extract continuous or vector field values for all cross section */
+		/*  locations at once ... for each valid time                      */
+		if ( blank(data_file) && blank(geo_file)
+				&& ( fkind == FpaC_CONTINUOUS || fkind == FpaC_VECTOR ) )
+			{
+			if ( haxis->num > NumXpos )
+				{
+				NumXpos = haxis->num;
+				Xpos    = GETMEM(Xpos,   POINT,   NumXpos);
+				Xvts    = GETMEM(Xvts,   STRING,  NumXpos);
+				Xvals   = GETMEM(Xvals,  float,   NumXpos);
+				Xdirs   = GETMEM(Xdirs,  float,   NumXpos);
+				Xvalid  = GETMEM(Xvalid, LOGICAL, NumXpos);
+				}
+			for ( iloc=0; iloc<haxis->num; iloc++ )
+				{
+				if ( !blank(haxis->vtimes[iloc]) ) Xvts[iloc] = haxis->vtimes[iloc];
+				else                               Xvts[iloc] = vtime;
+				(void) ll_to_pos(&BaseMap, haxis->flats[iloc],
+						haxis->flons[iloc], Xpos[iloc]);
+				}
+			(void) retrieve_xsection_values(&descript, fkind, equation,
+						haxis->num, Xpos, Xvts, Xvals, Xdirs, Xvalid);
+			}
+
 		/* Sample fields for all cross section locations */
 		for ( iloc=0; iloc<haxis->num; iloc++ )
 			{
@@ -16240,14 +16255,15 @@ LOGICAL			GRA_sample_field
 					/* Sample continuous type fields */
 					case FpaC_CONTINUOUS:
 
-						/* Extract field value by equation */
-						if ( !blank(equation) )
-							vlist = retrieve_vlist_by_equation(&descript,
-												1, pos, FpaCmksUnits, equation);
-
-						/* Extract field value directly */
-						else
-							vlist = retrieve_vlist(&descript, 1, pos);
+						/* Set field value extracted for all locations */
+						vlist = NullPtr(VLIST *);
+						if ( Xvalid[iloc] )
+							{
+							vlist = INITMEM(VLIST, 1);
+							(void) init_vlist(vlist);
+							(void) add_point_to_vlist(vlist, pos[0],
+															Xvals[iloc]);
+							}
 
 						/* Skip to next location if field cannot be evaluated */
 						if ( IsNull(vlist) )
@@ -16270,14 +16286,8 @@ LOGICAL			GRA_sample_field
 					/* Sample vector type fields */
 					case FpaC_VECTOR:
 
-						/* Extract magnitude and direction of vector field */
-						mlist = retrieve_vlist_component(&descript, M_Comp,
-																		1, pos);
-						dlist = retrieve_vlist_component(&descript, D_Comp,
-																		1, pos);
-
 						/* Skip to next location if field cannot be evaluated */
-						if ( IsNull(mlist) || IsNull(dlist) )
+						if ( !Xvalid[iloc] )
 							{
 							if ( Verbose )
 								{
@@ -16287,6 +16297,15 @@ LOGICAL			GRA_sample_field
 								}
 							continue;
 							}
+
+						/* Set magnitude and direction extracted for all */
+						/*  locations                                    */
+						mlist = INITMEM(VLIST, 1);
+						(void) init_vlist(mlist);
+						(void) add_point_to_vlist(mlist, pos[0], Xvals[iloc]);
+						dlist = INITMEM(VLIST, 1);
+						(void) init_vlist(dlist);
+						(void) add_point_to_vlist(dlist, pos[0], Xdirs[iloc]);
 						break;
 
 					/* Sample discrete type fields */
@@ -18661,6 +18680,164 @@ static	STRING		check_sample_cases
 	return look_up;
 	}
 
+/***********************************************************************
+*                                                                      *
+*    r e t r i e v e _ x s e c t i o n _ v a l u e s                   *
+*    r e t r i e v e _ x s e c t i o n _ g r o u p                     *
+*                                                                      *
+*    Extract continuous or vector field values at a set of locations,  *
+*    each with its own valid time.  The locations are gathered by      *
+*    valid time, so that each field is retrieved (or each equation     *
+*    evaluated) once for all locations that share it, and the values   *
+*    are then scattered back to the original order.  Locations where   *
+*    a value cannot be extracted are flagged as not valid.             *
+*                                                                      *
+***********************************************************************/
+
+static	int			retrieve_xsection_values
+
+	(
+	FLD_DESCRIPT	*fdesc,		/* Field descriptor */
+	int				fkind,		/* Field type */
+	STRING			equation,	/* Equation to calculate (if any) */
+	int				num,		/* Number of locations */
+	POINT			*ppos,		/* Map positions of locations */
+	STRING			*vtimes,	/* Valid times for each location */
+	float			*vals,		/* Values (or magnitudes) at each location */
+	float			*dirs,		/* Directions at each location (or NULL) */
+	LOGICAL			*valid		/* Value extracted at each location? */
+	)
+
+	{
+	int				nn, ii, nsub, nvalid;
+	FLD_DESCRIPT	descript;
+
+	/* Storage for locations gathered by valid time */
+	static	int		Nsub   = 0;
+	static	POINT	*Spos  = NullPointList;
+	static	int		*Sidx  = NullInt;
+	static	LOGICAL	*Sdone = NullLogicalPtr;
+
+	if ( num <= 0 ) return 0;
+	if ( num > Nsub )
+		{
+		Nsub  = num;
+		Spos  = GETMEM(Spos,  POINT,   Nsub);
+		Sidx  = GETMEM(Sidx,  int,     Nsub);
+		Sdone = GETMEM(Sdone, LOGICAL, Nsub);
+		}
+	for ( nn=0; nn<num; nn++ )
+		{
+		valid[nn] = FALSE;
+		Sdone[nn] = FALSE;
+		}
+
+	/* Make a copy of the field descriptor to reset valid times */
+	(void) copy_fld_descript(&descript, fdesc);
+
+	for ( nn=0; nn<num; nn++ )
+		{
+		if ( Sdone[nn] ) continue;
+
+		/* Gather all locations with the same valid time */
+		nsub = 0;
+		for ( ii=nn; ii<num; ii++ )
+			{
+			if ( Sdone[ii] || !same(vtimes[ii], vtimes[nn]) ) continue;
+			Sdone[ii]  = TRUE;
+			Sidx[nsub] = ii;
+			(void) copy_point(Spos[nsub], ppos[ii]);
+			nsub++;
+			}
+
+		/* Reset field descriptor for this valid time */
+		if ( !set_fld_descript(&descript, FpaF_VALID_TIME, vtimes[nn],
+										FpaF_END_OF_LIST) ) continue;
+
+		/* Extract values at all gathered locations at once ... */
+		/*  or one location at a time if any location fails     */
+		if ( retrieve_xsection_group(&descript, fkind, equation,
+						nsub, Spos, Sidx, vals, dirs, valid) ) continue;
+		if ( nsub <= 1 ) continue;
+		for ( ii=0; ii<nsub; ii++ )
+			(void) retrieve_xsection_group(&descript, fkind, equation,
+						1, Spos + ii, Sidx + ii, vals, dirs, valid);
+		}
+
+	/* Return the number of locations with values */
+	for ( nvalid=0, nn=0; nn<num; nn++ ) if ( valid[nn] ) nvalid++;
+	return nvalid;
+	}
+
+/**********************************************************************/
+
+static	LOGICAL		retrieve_xsection_group
+
+	(
+	FLD_DESCRIPT	*fdesc,		/* Field descriptor */
+	int				fkind,		/* Field type */
+	STRING			equation,	/* Equation to calculate (if any) */
+	int				nsub,		/* Number of gathered locations */
+	POINT			*spos,		/* Map positions of gathered locations */
+	int				*sidx,		/* Index of each gathered location */
+	float			*vals,		/* Values (or magnitudes) at all locations */
+	float			*dirs,		/* Directions at all locations (or NULL) */
+	LOGICAL			*valid		/* Value extracted at all locations? */
+	)
+
+	{
+	int				ii;
+	VLIST			*vlist, *dlist;
+
+	/* Extract values depending on field type */
+	vlist = NullPtr(VLIST *);
+	dlist = NullPtr(VLIST *);
+	switch ( fkind )
+		{
+		case FpaC_CONTINUOUS:
+			if ( !blank(equation) )
+				vlist = retrieve_vlist_by_equation(fdesc, nsub, spos,
+													FpaCmksUnits, equation);
+			else
+				vlist = retrieve_vlist(fdesc, nsub, spos);
+			break;
+
+		case FpaC_VECTOR:
+			vlist = retrieve_vlist_component(fdesc, M_Comp, nsub, spos);
+			if ( NotNull(dirs) )
+				dlist = retrieve_vlist_component(fdesc, D_Comp, nsub, spos);
+			break;
+		}
+
+	/* Scatter the values back to their locations */
+	if ( NotNull(vlist) && vlist->numpts == nsub
+			&& ( IsNull(dirs) || ( NotNull(dlist) && dlist->numpts == nsub ) ) )
+		{
+		for ( ii=0; ii<nsub; ii++ )
+			{
+			vals[sidx[ii]] = vlist->val[ii];
+			if ( NotNull(dirs) ) dirs[sidx[ii]] = dlist->val[ii];
+			valid[sidx[ii]] = TRUE;
+			}
+		}
+	else
+		{
+		nsub = 0;
+		}
+
+	if ( NotNull(vlist) )
+		{
+		(void) free_vlist(vlist);
+		FREEMEM(vlist);
+		}
+	if ( NotNull(dlist) )
+		{
+		(void) free_vlist(dlist);
+		FREEMEM(dlist);
+		}
+	return ( nsub > 0 )? TRUE: FALSE;
+	}
+
 /***********************************************************************
 *                                                                      *
 *    s e t _ v e r t i c a l _ p o s i t i o n                         *
@@ -35,8 +35,18 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <time.h>
 extern	FILE	*popen(const char *, const char *);
 
+/* Use inotify to wake up when monitored files are written (Linux only) */
+#ifdef MACHINE_PCLINUX
+#define WATCH_FILES
+#include <sys/inotify.h>
+#include <sys/select.h>
+#include <stddef.h>
+#include <regex.h>
+#endif
+
 #undef DEBUG
 
 #define MAXBUF 10000
@@ -99,6 +109,22 @@ static	int		StartLog	= TRUE;
 
 static FpaMonitorTypeStruct	*MonitorList = NullPtr(FpaMonitorTypeStruct *);
 static int					NumMonitorList = 0;
+
+/* Hash table for looking up files in the status list */
+static	int		*StatHash    = NullPtr(int *);
+static	int		*StatNext    = NullPtr(int *);
+static	int		StatBuckets  = 0;
+
+/* File watcher - watch descriptor for each pattern and files written */
+/* since the last check (WatchFd is -1 when polling only) */
+static	int		WatchFd     = -1;
+static	int		*WatchDescs = NullPtr(int *);
+static	STRING	*Written    = NullStringList;
+static	int		NumWritten  = 0;
+#ifdef WATCH_FILES
+static	regex_t	*WatchRegs  = NullPtr(regex_t *);
+#endif
+
 /* Internal static functions */
 static	void	place_lock(void);
 static	void	update_lock(void);
@@ -108,6 +134,13 @@ static	void	term_trap(int);
 static	void	mvlog_trap(int);
 static	void	move_log(void);
 static	int		check_files(void);
+static	STRING	monitor_file(int, STRING);
+static	void	hash_status(int, STRING *, STRING *);
+static	int		find_status(STRING, STRING, STRING *, STRING *);
+static	void	start_watch(void);
+static	void	wait_for_files(UNSIGN);
+static	LOGICAL	file_written(STRING);
+static	void	clear_written(void);
 static	SMODE	get_smode(STRING);
 
 FpaMonitorTypeStruct *find_type ( const STRING );
@@ -468,6 +501,9 @@ int		main
 	/* Start output to the log file */
 	if (StartLog) move_log();
 
+	/* Watch the monitored directories for new files if possible */
+	start_watch();
+
 	/* Check for new data at pre-defined intervals */
 	while (TRUE)
 		{
@@ -476,8 +512,9 @@ int		main
 		wtime = (ready)? WaitTime: RecheckTime;
 
 		/* Sleep for appropriate time or until awakened */
+		/* (or until a monitored file has been written) */
 		(void) signal(SIGINT, wake_trap);
-		(void) sleep(wtime);
+		wait_for_files(wtime);
 		(void) signal(SIGINT, SIG_IGN);
 
 		/* Future enhancement: Check here if setup file has been modified */
@@ -804,6 +841,7 @@ static	int		check_files
 			nsfiles = nrfiles;
 			nrfiles = 0;
 			}
+		hash_status(nsfiles, sfiles, stypes);
 
 		/* Now check modification times */
 		all_ready = TRUE;
@@ -825,9 +863,7 @@ static	int		check_files
 			nfiles = dirlist(Dirs[ipattern], Patterns[ipattern], &files);
 			for (ifile=0; ifile<nfiles; ifile++)
 				{
-				if (same(Dirs[ipattern], "."))
-					 file = pathname(WorkDir, files[ifile]);
-				else file = pathname(Dirs[ipattern], files[ifile]);
+				file   = monitor_file(ipattern, files[ifile]);
 				status = stat(file, &stat_buf);
 				if (status != 0) continue;
 				mtime  = stat_buf.st_mtime;
@@ -838,45 +874,51 @@ static	int		check_files
 				modified = TRUE;
 				ready    = FALSE;
 				ptime    = 0;
-				for (isf=0; isf<nsfiles; isf++)
+				isf      = find_status(file, type, sfiles, stypes);
+				if (isf >= 0)
 					{
-					if (same(sfiles[isf], file) && same(stypes[isf], type))
+					if (mtime > stimes[isf])
 						{
-						if (mtime > stimes[isf])
+						if (msize == ssizes[isf] || file_written(file))
 							{
-							if (msize == ssizes[isf])
-								{
-								code     = "updated";
-								modified = TRUE;
-								ready    = TRUE;
-								ptime    = mtime;
-								}
-							else
-								{
-								code     = "updated but not ready";
-								modified = TRUE;
-								ready    = FALSE;
-								ptime    = stimes[isf];
-								}
-							}
-						else if (mtime < stimes[isf])
-							{
-							code     = "backdated???";
-							modified = FALSE;
-							ready    = FALSE;
+							code     = "updated";
+							modified = TRUE;
+							ready    = TRUE;
 							ptime    = mtime;
 							}
 						else
 							{
-							code     = "unchanged";
-							modified = FALSE;
+							code     = "updated but not ready";
+							modified = TRUE;
 							ready    = FALSE;
-							ptime    = mtime;
+							ptime    = stimes[isf];
 							}
-						break;
+						}
+					else if (mtime < stimes[isf])
+						{
+						code     = "backdated???";
+						modified = FALSE;
+						ready    = FALSE;
+						ptime    = mtime;
+						}
+					else
+						{
+						code     = "unchanged";
+						modified = FALSE;
+						ready    = FALSE;
+						ptime    = mtime;
 						}
 					}
 
+				/* New files are ready once the writer has closed them */
+				else if (file_written(file))
+					{
+					code     = "new";
+					modified = TRUE;
+					ready    = TRUE;
+					ptime    = mtime;
+					}
+
 				/* Add to ingest run string if modified */
 				if (modified && !ready) all_ready = FALSE;
 				if (modified && ready)
@@ -963,11 +1005,289 @@ static	int		check_files
 
 		} while (keep_checking);
 
+	/* Files written since the last wait have now been checked */
+	clear_written();
+
 	if (!all_ready) (void) printf("%s Waiting for files to finish updating\n",
 									MyLab);
 	return all_ready;
 	}
 
+/*******************************************************************************
+*                                                                              *
+*   m o n i t o r _ f i l e                                                    *
+*                                                                              *
+*******************************************************************************/
+
+/* Full path of a file found with the given monitored pattern */
+/* (returned in the pathname() buffer) */
+static	STRING	monitor_file
+
+	(
+	int		ipattern,
+	STRING	name
+	)
+
+	{
+	if (same(Dirs[ipattern], ".")) return pathname(WorkDir, name);
+	else                           return pathname(Dirs[ipattern], name);
+	}
+
+/*******************************************************************************
+*                                                                              *
+*   h a s h _ s t a t u s                                                      *
+*   f i n d _ s t a t u s                                                      *
+*                                                                              *
+*******************************************************************************/
+
+static	unsigned long	status_key
+
+	(
+	STRING	file,
+	STRING	type
+	)
+
+	{
+	unsigned long	key = 5381;
+
+	while (*file) key = key*33 + (unsigned char) *file++;
+	key = key*33;
+	while (*type) key = key*33 + (unsigned char) *type++;
+	return key;
+	}
+
+/* Build the hash table for the given status list */
+static	void	hash_status
+
+	(
+	int		nfiles,
+	STRING	*files,
+	STRING	*types
+	)
+
+	{
+	int		ifile, ibucket, nbuckets;
+
+	/* Keep the table at most half full */
+	nbuckets = 64;
+	while (nbuckets < 2*nfiles) nbuckets *= 2;
+	if (nbuckets != StatBuckets)
+		{
+		StatBuckets = nbuckets;
+		StatHash    = GETMEM(StatHash, int, StatBuckets);
+		}
+	for (ibucket=0; ibucket<StatBuckets; ibucket++) StatHash[ibucket] = -1;
+	StatNext = GETMEM(StatNext, int, MAX(nfiles, 1));
+
+	/* Add in reverse order so the first matching entry is found first */
+	for (ifile=nfiles-1; ifile>=0; ifile--)
+		{
+		ibucket = (int) (status_key(files[ifile], types[ifile])
+						& (unsigned long) (StatBuckets-1));
+		StatNext[ifile]  = StatHash[ibucket];
+		StatHash[ibucket] = ifile;
+		}
+	}
+
+/* Find the given file and type in the hashed status list (-1 if not found) */
+static	int		find_status
+
+	(
+	STRING	file,
+	STRING	type,
+	STRING	*files,
+	STRING	*types
+	)
+
+	{
+	int		ifile;
+
+	if (StatBuckets <= 0) return -1;
+	ifile = StatHash[status_key(file, type) & (unsigned long) (StatBuckets-1)];
+	for ( ; ifile>=0; ifile=StatNext[ifile])
+		{
+		if (same(files[ifile], file) && same(types[ifile], type)) return ifile;
+		}
+	return -1;
+	}
+
+/*******************************************************************************
+*                                                                              *
+*   s t a r t _ w a t c h                                                      *
+*   w a i t _ f o r _ f i l e s                                                *
+*   f i l e _ w r i t t e n                                                    *
+*   c l e a r _ w r i t t e n                                                  *
+*                                                                              *
+*   Monitored directories are watched with inotify, so that files that are     *
+*   closed after writing (or moved into place) are dispatched right away,      *
+*   rather than on the next poll.  The regular poll is kept as a fallback.     *
+*                                                                              *
+*   The watcher is controlled by the environment variable FPA_INGEST_WATCH     *
+*   or the "Ingest.Watch" advanced feature:                                    *
+*                                                                              *
+*     "inotify"  watch the monitored directories (default)                     *
+*     "poll"     check the monitored directories at regular intervals only     *
+*                                                                              *
+*******************************************************************************/
+
+static	void	start_watch(void)
+
+	{
+#	ifdef WATCH_FILES
+	int		ipattern;
+	STRING	mode, dir;
+
+	mode = getenv("FPA_INGEST_WATCH");
+	if (blank(mode)) mode = get_feature_mode("Ingest.Watch");
+	if (same_ic(mode, "poll"))
+		{
+		(void) printf("%s Polling monitored files\n", MyLab);
+		return;
+		}
+	else if (!blank(mode) && !same_ic(mode, "inotify"))
+		{
+		(void) printf("%s Unknown watch mode '%s' - using inotify\n",
+				MyLab, mode);
+		}
+
+	WatchFd = inotify_init();
+	if (WatchFd < 0)
+		{
+		(void) perror("inotify_init");
+		(void) printf("%s Polling monitored files\n", MyLab);
+		return;
+		}
+
+	/* Watch the directory of each pattern (identical directories */
+	/* share the same watch descriptor) */
+	WatchDescs = INITMEM(int, NumPatterns);
+	WatchRegs  = INITMEM(regex_t, NumPatterns);
+	for (ipattern=0; ipattern<NumPatterns; ipattern++)
+		{
+		WatchDescs[ipattern] = -1;
+		if (regcomp(&WatchRegs[ipattern], Patterns[ipattern], REG_NOSUB) != 0)
+			{
+			(void) printf("%s Cannot watch pattern '%s'\n",
+					MyLab, Patterns[ipattern]);
+			continue;
+			}
+
+		dir = (same(Dirs[ipattern], "."))? WorkDir: Dirs[ipattern];
+		WatchDescs[ipattern] = inotify_add_watch(WatchFd, dir,
+												IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (WatchDescs[ipattern] < 0)
+			{
+			(void) printf("%s Cannot watch directory '%s'\n", MyLab, dir);
+			regfree(&WatchRegs[ipattern]);
+			continue;
+			}
+		dprintf("%s Watching: %s %s\n", MyLab, dir, Patterns[ipattern]);
+		}
+	(void) printf("%s Watching monitored files\n", MyLab);
+#	endif /* WATCH_FILES */
+	}
+
+/* Wait for the given time, or until a monitored file has been written */
+/* (or a signal has been received) */
+static	void	wait_for_files
+
+	(
+	UNSIGN	wtime
+	)
+
+	{
+#	ifdef WATCH_FILES
+	int						ipattern, nbytes, offset, status;
+	LOGICAL					found;
+	STRING					path;
+	time_t					tend, tnow;
+	fd_set					fds;
+	struct timeval			tv;
+	struct inotify_event	*event;
+	static	char			ebuf[16384];
+
+	if (WatchFd < 0)
+		{
+		(void) sleep(wtime);
+		return;
+		}
+
+	tend  = time(NULL) + wtime;
+	found = FALSE;
+	while (!found)
+		{
+		tnow = time(NULL);
+		if (tnow >= tend) return;
+
+		FD_ZERO(&fds);
+		FD_SET(WatchFd, &fds);
+		tv.tv_sec  = (long) (tend - tnow);
+		tv.tv_usec = 0;
+		status = select(WatchFd+1, &fds, NULL, NULL, &tv);
+
+		/* Time is up or interrupted by a signal */
+		if (status <= 0) return;
+
+		nbytes = (int) read(WatchFd, ebuf, sizeof(ebuf));
+		if (nbytes <= 0) return;
+
+		/* Keep the monitored files that have been written */
+		for (offset=0; offset<nbytes;
+				offset += offsetof(struct inotify_event, name) + event->len)
+			{
+			event = (struct inotify_event *) (ebuf + offset);
+
+			/* Events have been lost - do a full check */
+			if (event->mask & IN_Q_OVERFLOW) return;
+			if (event->len <= 0) continue;
+
+			for (ipattern=0; ipattern<NumPatterns; ipattern++)
+				{
+				if (WatchDescs[ipattern] != event->wd) continue;
+				if (regexec(&WatchRegs[ipattern], event->name,
+						(size_t) 0, NULL, 0) != 0) continue;
+
+				path = monitor_file(ipattern, event->name);
+				if (!file_written(path))
+					{
+					NumWritten++;
+					Written = GETMEM(Written, STRING, NumWritten);
+					Written[NumWritten-1] = strdup(path);
+					}
+				found = TRUE;
+				}
+			}
+		}
+
+#	else
+	(void) sleep(wtime);
+#	endif /* WATCH_FILES */
+	}
+
+/* Has the given file been written since the last check? */
+static	LOGICAL	file_written
+
+	(
+	STRING	file
+	)
+
+	{
+	int		iw;
+
+	for (iw=0; iw<NumWritten; iw++)
+		{
+		if (same(Written[iw], file)) return TRUE;
+		}
+	return FALSE;
+	}
+
+static	void	clear_written(void)
+
+	{
+	FREELIST(Written, NumWritten);
+	NumWritten = 0;
+	}
+
 /*******************************************************************************
 *                                                                              *
 *   g e t _ s m o d e                                                          *
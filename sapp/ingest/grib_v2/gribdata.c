@@ -80,20 +80,10 @@ void gribfield_to_data
 	 float			offset
 	)
 	{
-	short 	*cfld;
 	STRING  fname;
-	FILE  	*DataFile;
-	size_t	npts;
 
 	if ( IsNull(gribfld) || IsNull(fdesc) ) return;
 
-	if ( !reorder_data(gribfld, &cfld, gribfld->data, precision, offset) )
-		{
-		(void) fprintf(stderr, 
-					   "[gribfield_to_data] Problem preparing field for datafile\n");
-		return;
-		}
-
 	/* Get data file name */
 	fname = construct_meta_filename(fdesc);
 	if ( blank(fname) ) fname = build_meta_filename(fdesc);
@@ -105,6 +95,44 @@ void gribfield_to_data
 		(void) fprintf(stderr, "%s\n", fdesc->ldef->name);
 		return;
 		}
+
+	/* Format and output datafile */
+	gribfield_to_data_file(gribfld, fname, precision, offset);
+	}
+
+/*******************************************************************************/
+/** Translate from GRIB data to gridded data for FPA, and write it to the
+ *  given file.
+ *
+ *  This is the same as gribfield_to_data(), except that the output file
+ *  name is given rather than built from a field descriptor.
+ *
+ * @param[in]	*gribfld	DECODEDFIELD Object with decoded GRIB data.
+ * @param[in]	fname		Output file name.
+ * @param[in]	precision	Amount to scale data values by.
+ * @param[in]	offset		Amount to offset data values by.
+ *******************************************************************************/
+void gribfield_to_data_file
+	(
+	 DECODEDFIELD	*gribfld,	/* DECODEDFIELD Object with decoded GRIB data */
+	 STRING			fname,		/* output file name */
+	 float			precision,
+	 float			offset
+	)
+	{
+	short 	*cfld;
+	FILE  	*DataFile;
+	size_t	npts;
+
+	if ( IsNull(gribfld) || blank(fname) ) return;
+
+	if ( !reorder_data(gribfld, &cfld, gribfld->data, precision, offset) )
+		{
+		(void) fprintf(stderr, 
+					   "[gribfield_to_data] Problem preparing field for datafile\n");
+		return;
+		}
+
 	/* Check if file is open */
 	if ( !(DataFile = fopen(fname,"wb")) )
 		{
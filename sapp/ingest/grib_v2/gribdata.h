@@ -47,6 +47,7 @@
 ***********************************************************************/
 
 void gribfield_to_data( DECODEDFIELD *, FLD_DESCRIPT *, STRING, float, float);
+void gribfield_to_data_file( DECODEDFIELD *, STRING, float, float);
 
 /* Now it has been included */
 #endif
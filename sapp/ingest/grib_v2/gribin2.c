@@ -44,11 +44,16 @@
 #include "rgrib.h"
 #include "gribmeta.h"
 #include "gribdata.h"
+#include "gribindex.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <signal.h>
+#include <errno.h>
+#include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 #undef DEBUG
 
@@ -64,12 +69,16 @@
 static	void	error_trap(int);
 
 /* Internal static functions to extract and output metafiles from GRIB data */
+static	void	process_entry(int, GRIBINDEX *, int, FLD_DESCRIPT *);
+static	void	process_field(int, DECODEDFIELD *, FLD_DESCRIPT *, STRING, STRING,
+						STRING, STRING, STRING, STRING, STRING);
 static	LOGICAL	process_gribfield(DECODEDFIELD *, FLD_DESCRIPT *, STRING);
 static	LOGICAL	process_gribfield_xycomp(DECODEDFIELD *, FLD_DESCRIPT *, STRING);
 static	LOGICAL	process_gribfield_default(DECODEDFIELD *, FLD_DESCRIPT *, STRING);
 static	LOGICAL	process_datafile(DECODEDFIELD *, FLD_DESCRIPT *, STRING, float, float);
 static	LOGICAL	process_datafile_xycomp(DECODEDFIELD *, FLD_DESCRIPT *, STRING, float, float);
 static	LOGICAL	process_datafile_default(DECODEDFIELD *, FLD_DESCRIPT *, STRING, float, float);
+static	LOGICAL	output_metafile(STRING, STRING, STRING, MAP_PROJ *, METAFILE);
 int				determine_edition_number ( STRING );
 char *	print_field_detail ( FLD_DESCRIPT *, STRING, STRING, STRING, STRING, STRING, STRING, LOGICAL);
 
@@ -83,6 +92,100 @@ static	char	LockDir[MAX_BCHRS]   = "";
 static	char	LockVtime[MAX_BCHRS] = "";
 static	int		Locked               = FALSE;
 
+/* Batched merging of output metafiles */
+/*  ... new metafiles for each output metafile are held in memory and  */
+/*  merged in the order they were decoded, with one locked read and    */
+/*  write of each output metafile at the end of each GRIB file (or     */
+/*  whenever the memory limit is reached)                              */
+typedef	struct
+	{
+	STRING		fname;		/* output metafile name */
+	STRING		lockdir;	/* base directory for file lock */
+	STRING		vtime;		/* valid time for file lock */
+	MAP_PROJ	mproj;		/* map projection for output metafile */
+	int			nmeta;		/* number of new metafiles to merge */
+	METAFILE	*metas;		/* new metafiles (in order decoded) */
+	} PENDING_META;
+
+static	LOGICAL			BatchMerge  = FALSE;
+static	long			BatchLimit  = 256;	/* megabytes */
+static	long			BatchSize   = 0;	/* bytes */
+static	int				NumPending  = 0;
+static	PENDING_META	*Pending    = NullPtr(PENDING_META *);
+
+static	void	set_merge_mode(void);
+static	void	queue_metafile(STRING, STRING, STRING, MAP_PROJ *, METAFILE);
+static	void	flush_metafiles(void);
+static	void	flush_pending(PENDING_META *);
+static	long	metafile_size(METAFILE);
+
+/* Pipelined decoding of GRIB fields */
+/*  ... wanted fields are unpacked and converted to new metafiles and  */
+/*  datafiles by worker processes, which save the results and their    */
+/*  messages in a spool directory.  The main process then takes each   */
+/*  field in the order of the GRIB file and processes it as usual with */
+/*  the saved results, so the data directories are only changed by    */
+/*  the main process, in the same order as without workers             */
+typedef	struct
+	{
+	pid_t			pid;		/* worker process (0 if none) */
+	int				edition;	/* GRIB edition number */
+	GRIBINDEX		*gindex;	/* index of fields in GRIB file */
+	int				ientry;		/* index entry for field */
+	FLD_DESCRIPT	*fdesc;		/* field descriptor for files */
+	} PIPE_JOB;
+
+typedef	struct
+	{
+	LOGICAL		isdata;			/* datafile (rather than metafile)? */
+	LOGICAL		saved;			/* was the result saved? */
+	long		outbeg, outend;	/* messages to stdout */
+	long		errbeg, errend;	/* messages to stderr */
+	} PIPE_RESULT;
+
+#define	PipeNone		0	/* field was not converted by a worker */
+#define	PipeReady		1	/* field was converted by a worker */
+#define	PipeUnreadable	2	/* field could not be unpacked by a worker */
+
+static	int				PipeWorkers = 1;
+static	char			PipeDir[MAX_BCHRS] = "";
+static	int				NumJobs     = 0;
+static	int				MaxJobs     = 0;
+static	int				NumRunning  = 0;
+static	PIPE_JOB		*Jobs       = NullPtr(PIPE_JOB *);
+static	LOGICAL			InWorker    = FALSE;
+static	FILE			*ResultFile = NullPtr(FILE *);
+static	PIPE_RESULT		Result;
+static	int				PipeStatus  = PipeNone;
+static	GRIBINDEX		*PipeIndex  = NullPtr(GRIBINDEX *);
+static	int				PipeEntry   = -1;
+static	DECODEDFIELD	*PipeField  = NullPtr(DECODEDFIELD *);
+static	int				NumResults  = 0;
+static	int				NextResult  = 0;
+static	PIPE_RESULT		*Results    = NullPtr(PIPE_RESULT *);
+
+static	void		set_pipe_mode(void);
+static	void		end_pipe_mode(void);
+static	LOGICAL		start_pipe_job(int, STRING, GRIBINDEX *, int, FLD_DESCRIPT *);
+static	void		run_pipe_job(PIPE_JOB *, STRING);
+static	void		finish_pipe_job(void);
+static	void		finish_pipe_jobs(void);
+static	METAFILE	pipe_metafile(DECODEDFIELD *, FLD_DESCRIPT *, STRING,
+						LOGICAL, COMPONENT, COMPONENT);
+static	void		pipe_datafile(DECODEDFIELD *, FLD_DESCRIPT *, STRING,
+						float, float);
+static	DECODEDFIELD	*pipe_gribfield(DECODEDFIELD *);
+static	int			next_pipe_result(LOGICAL);
+static	void		begin_pipe_result(void);
+static	void		end_pipe_result(LOGICAL, LOGICAL);
+static	void		replay_pipe_result(int);
+static	void		load_pipe_results(int);
+static	void		remove_pipe_results(int);
+static	STRING		pipe_file(int, STRING);
+static	STRING		pipe_result_file(int, int);
+static	LOGICAL		copy_pipe_file(STRING, long, long, FILE *);
+static	LOGICAL		open_gribfile(int, STRING);
+
 /***********************************************************************
 *                                                                      *
 *     m a i n                                                          *
@@ -100,21 +203,16 @@ int		main
 	int				status;
 	int				cyear, cjday, cmonth, cmday, chour, cmin, csec;
 	int				nslist, iarg, nflds;
-	LOGICAL			minutes_rqd;
 	STRING			sfile, *slist, dir;
 	char			home[MAX_BCHRS], work[MAX_BCHRS], gribname[MAX_BCHRS];
 	MAP_PROJ		*mproj;
-	FLD_DESCRIPT	fdesc, fdescin;
+	FLD_DESCRIPT	fdesc;
 	DECODEDFIELD	*gribfld;
 	STRING			model, rtime, btime, etime, element, level, units;
-	char			xrtime[GRIB_LABEL_LEN];
-	char			xbtime[GRIB_LABEL_LEN];
-	char			xetime[GRIB_LABEL_LEN];
 	int				edition;
-	LOGICAL			iret;
-
-	/* Datafile scale & offset */
-	float	precision, offset;
+	LOGICAL			iret, indexed;
+	GRIBINDEX		gindex;
+	int				ientry;
 
 	/* Ignore hangup, interrupt and quit signals so we can survive after */
 	/* logging off */
@@ -198,6 +296,10 @@ int		main
 	if ( !blank(dir) ) (void) strcpy(work, dir);
 	else               (void) strcpy(work, home);
 
+	/* Set the metafile merge mode and the number of worker processes */
+	set_merge_mode();
+	set_pipe_mode();
+
 	/* Initialize the field descriptor for files */
 	(void) init_fld_descript(&fdesc);
 	if ( !set_fld_descript(&fdesc,
@@ -225,16 +327,9 @@ int		main
 
 
 		/* Open Edition 0,1, or 2 GRIB file */
-		switch (edition)
-			{
-				case 1: iret = open_gribfile_edition1(gribname); break;
-				case 2: iret = open_gribfile_edition2(gribname); break;
-				default: /* If no edition number assume edition 0 */
-						iret = open_gribfile_edition0(gribname);
-						edition = 0;
-						break;
-			}
-		if (!iret)
+		/*  ... if no edition number assume edition 0 */
+		if ( edition != 1 && edition != 2 ) edition = 0;
+		if ( !open_gribfile(edition, gribname) )
 			{
 			(void) fprintf(stderr, "%s Cannot access GRIB file \"%s\"\n",
 				MyLabel, gribname);
@@ -244,9 +339,27 @@ int		main
 		(void) fprintf(stdout, "\n%s GRIB Edition %d decode\n",
 				MyLabel, edition);
 
+		/* Index the fields in the GRIB file from their headers */
+		indexed = build_grib_index(gribname, edition, &gindex);
+		ientry  = 0;
+
 		/* Edition 0,1 or 2 decode of each field in GRIB file */
 		while ( 1 )
 			{
+			if ( indexed )
+				{
+				if ( ientry >= gindex.nentry ) break;	/* End of index */
+
+				/* Reset number of decoded GRIB fields */
+				nflds++;
+
+				/* Process the field (in a worker process if pipelined) */
+				if ( !start_pipe_job(edition, gribname, &gindex, ientry, &fdesc) )
+					process_entry(edition, &gindex, ientry, &fdesc);
+				ientry++;
+				continue;
+				}
+
 			switch ( edition )
 				{
 				case 0: iret = next_gribfield_edition0(&gribfld); break;
@@ -283,226 +396,17 @@ int		main
 				continue;
 				}
 
-			/* reset field descriptor */
-			(void) copy_fld_descript(&fdescin, &fdesc);
-
-			/* Check for unwanted datafiles */
-			if ( skip_grib_datafile(edition, model, element, level) )
-				{
-
-				/* Don't turn these fields into datafiles */
-				(void) fprintf(stdout, "%s Skipping datafile: %s", MyPid,
-							   print_field_detail(&fdescin, model, rtime, btime, etime,
-								   element, level, TRUE));
-				}
-			else	/* Process Field into Datafile */
-				{
-
-				/* Set the field descriptor directory info */
-				/* Redirect Source if necessary */
-				if ( !set_fld_descript(&fdescin,
-							FpaF_SOURCE_NAME,    redirect_datafile(edition, model),
-							FpaF_END_OF_LIST) )
-					{
-					(void) fprintf(stderr, "%s Skipping non-FPA model \"%s\"\n",
-							MyPid, redirect_datafile(edition, model));
-					continue;
-					}
-
-				/* Make copies of the timestamps (depending on minutes required) */
-				minutes_rqd = fdescin.sdef->minutes_rqd;
-				if ( minutes_rqd )
-					{
-					(void) strcpy(xrtime, rtime);
-					(void) strcpy(xbtime, btime);
-					(void) strcpy(xetime, etime);
-					}
-				else
-					{
-					(void) strcpy(xrtime, tstamp_to_hours(rtime, TRUE, NullInt));
-					(void) strcpy(xbtime, tstamp_to_hours(btime, TRUE, NullInt));
-					(void) strcpy(xetime, tstamp_to_hours(etime, TRUE, NullInt));
-					}
-
-				/* Set the field descriptor file info with GRIB parameters */
-				if ( !set_fld_descript(&fdescin,
-										FpaF_RUN_TIME,     xrtime,
-										FpaF_VALID_TIME,   xetime,
-										FpaF_ELEMENT_NAME, element,
-										FpaF_LEVEL_NAME,   level,
-										FpaF_END_OF_LIST) )
-					{
-					/* Skip unrecognized fields */
-					(void) fprintf(stdout, "%s Skipping non-FPA field: %s", MyPid,
-								   print_field_detail(&fdescin, model, rtime, btime,
-									   etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Check for daily fields ... which should not be in GRIB files! */
-				if ( fdescin.edef->elem_tdep->time_dep == FpaC_DAILY )
-					{
-
-					/* Skip daily fields */
-					(void) fprintf(stdout, "%s Skipping Daily field: %s", MyPid,
-								   print_field_detail(&fdescin, model, rtime, btime,
-									   etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Prepare data directory for GRIB field */
-				if ( blank(prepare_source_directory(&fdescin)) )
-					{
-
-					/* Skip fields if directory cannot be created */
-					(void) fprintf(stdout, "%s Cannot create directory for: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Check that metafile name can be created for field */
-				if ( blank(construct_meta_filename(&fdescin))
-						&& blank(build_meta_filename(&fdescin)) )
-					{
-
-					/* Skip fields if metafile name cannot be created */
-					(void) fprintf(stdout,
-							"%s Cannot create metafile name for: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-
-				/* There were no objections so go ahead and process datafile */
-				(void) fprintf(stdout, "%s Extracting datafile: %s",
-							   MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								   etime, element, level, TRUE));
-
-				/* Lookup precision and scale factor from Ingest config */
-				rescale_datafile(edition, element, level, &precision, &offset);
-				/* Extract and output datafile from GRIB field */
-				if ( !process_datafile(gribfld, &fdescin, units, precision, offset) )
-					{
-					/* Error processing field */
-					(void) fprintf(stdout,
-							"%s Error while processing gribfield to datafile: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-				}
-
-			/* reset field descriptor */
-			(void) copy_fld_descript(&fdescin, &fdesc);
-
-			/* Check for unwanted fields */
-			if ( skip_grib_field(edition, model, element, level) )
-				{
+			/* Process the decoded field */
+			process_field(edition, gribfld, &fdesc, model, rtime, btime, etime,
+					element, level, units);
+			}
 
-				/* Skip unwanted fields */
-				(void) fprintf(stdout, "%s Skipping field: %s",
-							   MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								   etime, element, level, TRUE));
-				}
-			else	/* Process Field into Metafile */
-				{
-				/* Set the field descriptor directory info */
-				/* Redirect Source if necessary */
-				if ( !set_fld_descript(&fdescin,
-										FpaF_SOURCE_NAME,    redirect_field(edition, model),
-										FpaF_END_OF_LIST) )
-					{
-					(void) fprintf(stderr, "%s Skipping non-FPA model \"%s\"\n",
-							MyPid, redirect_field(edition, model));
-					continue;
-					}
-
-
-				/* Make copies of the timestamps (depending on minutes required) */
-				minutes_rqd = fdescin.sdef->minutes_rqd;
-				if ( minutes_rqd )
-					{
-					(void) strcpy(xrtime, rtime);
-					(void) strcpy(xbtime, btime);
-					(void) strcpy(xetime, etime);
-					}
-				else
-					{
-					(void) strcpy(xrtime, tstamp_to_hours(rtime, TRUE, NullInt));
-					(void) strcpy(xbtime, tstamp_to_hours(btime, TRUE, NullInt));
-					(void) strcpy(xetime, tstamp_to_hours(etime, TRUE, NullInt));
-					}
-
-				/* Set the field descriptor file info with GRIB parameters */
-				if ( !set_fld_descript(&fdescin,
-										FpaF_RUN_TIME,     xrtime,
-										FpaF_VALID_TIME,   xetime,
-										FpaF_ELEMENT_NAME, element,
-										FpaF_LEVEL_NAME,   level,
-										FpaF_END_OF_LIST) )
-					{
-					/* Skip unrecognized fields */
-					(void) fprintf(stdout, "%s Skipping non-FPA field: %s", MyPid,
-								   print_field_detail(&fdescin, model, rtime, btime,
-									   etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Check for daily fields ... which should not be in GRIB files! */
-				if ( fdescin.edef->elem_tdep->time_dep == FpaC_DAILY )
-					{
-
-					/* Skip daily fields */
-					(void) fprintf(stdout, "%s Skipping Daily field: %s", MyPid,
-								   print_field_detail(&fdescin, model, rtime, btime,
-									   etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Prepare data directory for GRIB field */
-				if ( blank(prepare_source_directory(&fdescin)) )
-					{
-
-					/* Skip fields if directory cannot be created */
-					(void) fprintf(stdout, "%s Cannot create directory for: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-
-				/* Check that metafile name can be created for field */
-				if ( blank(construct_meta_filename(&fdescin))
-						&& blank(build_meta_filename(&fdescin)) )
-					{
-
-					/* Skip fields if metafile name cannot be created */
-					(void) fprintf(stdout,
-							"%s Cannot create datafile name for: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-
-				/* There were no objections so go ahead and process field */
-				(void) fprintf(stdout, "%s Extracting field:  %s", MyPid,
-							   print_field_detail(&fdescin, model, rtime, btime, etime,
-								   element, level, FALSE));
-
-				/* Extract and output metafile from GRIB field */
-				if ( !process_gribfield(gribfld, &fdescin, units) )
-					{
-					/* Error processing field */
-					(void) fprintf(stdout,
-							"%s Error while processing gribfield to Metafile: %s",
-							MyPid, print_field_detail(&fdescin, model, rtime, btime,
-								etime, element, level, FALSE));
-					continue;
-					}
-				}
+		/* Wait for the worker processes for this GRIB file */
+		finish_pipe_jobs();
 
-			/* Process next field in current GRIB file */
-			}
+		/* Merge and output all metafiles from this GRIB file */
+		flush_metafiles();
+		free_grib_index(&gindex);
 
 		/* Close GRIB file and process next one */
 		switch ( edition )
@@ -524,6 +428,9 @@ int		main
 
 		}	/* Process next GRIB file */
 
+	/* Remove the spool directory for worker processes */
+	end_pipe_mode();
+
 	/* Shutdown message */
 	(void) systime(&cyear, &cjday, &chour, &cmin, &csec);
 	(void) mdate(&cyear, &cjday, &cmonth, &cmday);
@@ -533,6 +440,343 @@ int		main
 	return 0;
 	}
 
+/***********************************************************************
+*                                                                      *
+*     p r o c e s s _ e n t r y                                        *
+*     p r o c e s s _ f i e l d                                        *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Extract datafiles and metafiles from one field in the index of a GRIB
+ * file.  Unwanted fields are skipped without unpacking them.
+ *
+ * @param[in]	edition		GRIB edition number
+ * @param[in]	*gindex		index of fields in GRIB file
+ * @param[in]	ientry		index entry for field
+ * @param[in]	*fdesc		field descriptor for files
+ *******************************************************************************/
+static	void	process_entry
+
+	(
+	int				edition,	/* GRIB edition number */
+	GRIBINDEX		*gindex,	/* index of fields in GRIB file */
+	int				ientry,		/* index entry for field */
+	FLD_DESCRIPT	*fdesc		/* field descriptor for files */
+	)
+
+	{
+	GRIBINDEX_ENTRY	*gentry;
+	FLD_DESCRIPT	fdescin;
+	DECODEDFIELD	*gribfld;
+
+	gentry = &gindex->entries[ientry];
+
+	/* Skip unwanted fields without unpacking them */
+	if ( gentry->valid
+			&& skip_grib_datafile(edition, gentry->model,
+					gentry->element, gentry->level)
+			&& skip_grib_field(edition, gentry->model,
+					gentry->element, gentry->level) )
+		{
+		(void) copy_fld_descript(&fdescin, fdesc);
+		(void) fprintf(stdout, "%s Skipping datafile: %s", MyPid,
+					   print_field_detail(&fdescin, gentry->model,
+						   gentry->rtime, gentry->vtimeb, gentry->vtimee,
+						   gentry->element, gentry->level, TRUE));
+		(void) fprintf(stdout, "%s Skipping field: %s", MyPid,
+					   print_field_detail(&fdescin, gentry->model,
+						   gentry->rtime, gentry->vtimeb, gentry->vtimee,
+						   gentry->element, gentry->level, TRUE));
+		return;
+		}
+
+	/* Unpack the field (unless a worker process has already converted it) */
+	gribfld = NullPtr(DECODEDFIELD *);
+	if ( !gentry->valid || PipeStatus == PipeUnreadable
+			|| ( PipeStatus == PipeNone
+					&& !read_indexed_gribfield(gindex, ientry, &gribfld) ) )
+		{
+		(void) fprintf(stdout, "%s Skipping unrecognized field\n", MyPid);
+		return;
+		}
+
+	/* Keep track of the field in case it must be unpacked later */
+	PipeIndex = gindex;
+	PipeEntry = ientry;
+	PipeField = gribfld;
+
+	process_field(edition, gribfld, fdesc, gentry->model, gentry->rtime,
+			gentry->vtimeb, gentry->vtimee, gentry->element, gentry->level,
+			gentry->units);
+
+	PipeIndex = NullPtr(GRIBINDEX *);
+	PipeField = NullPtr(DECODEDFIELD *);
+	}
+
+/*******************************************************************************/
+/** Extract datafiles and metafiles from one decoded GRIB field.
+ *
+ * The decoded field may be missing if the field has already been
+ * converted by a worker process.
+ *
+ * @param[in]	edition		GRIB edition number
+ * @param[in]	*gribfld	DECODEDFIELD object with decoded GRIB data
+ * @param[in]	*fdesc		field descriptor for files
+ * @param[in]	model		model label for field
+ * @param[in]	rtime		run time label
+ * @param[in]	btime		begin valid time label
+ * @param[in]	etime		end valid time label
+ * @param[in]	element		element label
+ * @param[in]	level		level label
+ * @param[in]	units		units label
+ *******************************************************************************/
+static	void	process_field
+
+	(
+	int				edition,	/* GRIB edition number */
+	DECODEDFIELD	*gribfld,	/* GRIBFIELD Object with decoded GRIB data */
+	FLD_DESCRIPT	*fdesc,		/* field descriptor for files */
+	STRING			model,		/* GRIB field identifiers */
+	STRING			rtime,
+	STRING			btime,
+	STRING			etime,
+	STRING			element,
+	STRING			level,
+	STRING			units
+	)
+
+	{
+	LOGICAL			minutes_rqd;
+	FLD_DESCRIPT	fdescin;
+	char			xrtime[GRIB_LABEL_LEN];
+	char			xbtime[GRIB_LABEL_LEN];
+	char			xetime[GRIB_LABEL_LEN];
+
+	/* Datafile scale & offset */
+	float	precision, offset;
+
+	/* reset field descriptor */
+	(void) copy_fld_descript(&fdescin, fdesc);
+
+	/* Check for unwanted datafiles */
+	if ( skip_grib_datafile(edition, model, element, level) )
+		{
+
+		/* Don't turn these fields into datafiles */
+		(void) fprintf(stdout, "%s Skipping datafile: %s", MyPid,
+					   print_field_detail(&fdescin, model, rtime, btime, etime,
+						   element, level, TRUE));
+		}
+	else	/* Process Field into Datafile */
+		{
+
+		/* Set the field descriptor directory info */
+		/* Redirect Source if necessary */
+		if ( !set_fld_descript(&fdescin,
+					FpaF_SOURCE_NAME,    redirect_datafile(edition, model),
+					FpaF_END_OF_LIST) )
+			{
+			(void) fprintf(stderr, "%s Skipping non-FPA model \"%s\"\n",
+					MyPid, redirect_datafile(edition, model));
+			return;
+			}
+
+		/* Make copies of the timestamps (depending on minutes required) */
+		minutes_rqd = fdescin.sdef->minutes_rqd;
+		if ( minutes_rqd )
+			{
+			(void) strcpy(xrtime, rtime);
+			(void) strcpy(xbtime, btime);
+			(void) strcpy(xetime, etime);
+			}
+		else
+			{
+			(void) strcpy(xrtime, tstamp_to_hours(rtime, TRUE, NullInt));
+			(void) strcpy(xbtime, tstamp_to_hours(btime, TRUE, NullInt));
+			(void) strcpy(xetime, tstamp_to_hours(etime, TRUE, NullInt));
+			}
+
+		/* Set the field descriptor file info with GRIB parameters */
+		if ( !set_fld_descript(&fdescin,
+								FpaF_RUN_TIME,     xrtime,
+								FpaF_VALID_TIME,   xetime,
+								FpaF_ELEMENT_NAME, element,
+								FpaF_LEVEL_NAME,   level,
+								FpaF_END_OF_LIST) )
+			{
+			/* Skip unrecognized fields */
+			(void) fprintf(stdout, "%s Skipping non-FPA field: %s", MyPid,
+						   print_field_detail(&fdescin, model, rtime, btime,
+							   etime, element, level, FALSE));
+			return;
+			}
+
+		/* Check for daily fields ... which should not be in GRIB files! */
+		if ( fdescin.edef->elem_tdep->time_dep == FpaC_DAILY )
+			{
+
+			/* Skip daily fields */
+			(void) fprintf(stdout, "%s Skipping Daily field: %s", MyPid,
+						   print_field_detail(&fdescin, model, rtime, btime,
+							   etime, element, level, FALSE));
+			return;
+			}
+
+		/* Prepare data directory for GRIB field */
+		/*  ... only in the main process, and in field order */
+		if ( !InWorker && blank(prepare_source_directory(&fdescin)) )
+			{
+
+			/* Skip fields if directory cannot be created */
+			(void) fprintf(stdout, "%s Cannot create directory for: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+
+		/* Check that metafile name can be created for field */
+		if ( !InWorker && blank(construct_meta_filename(&fdescin))
+				&& blank(build_meta_filename(&fdescin)) )
+			{
+
+			/* Skip fields if metafile name cannot be created */
+			(void) fprintf(stdout,
+					"%s Cannot create metafile name for: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+
+		/* There were no objections so go ahead and process datafile */
+		(void) fprintf(stdout, "%s Extracting datafile: %s",
+					   MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						   etime, element, level, TRUE));
+
+		/* Lookup precision and scale factor from Ingest config */
+		rescale_datafile(edition, element, level, &precision, &offset);
+		/* Extract and output datafile from GRIB field */
+		if ( !process_datafile(gribfld, &fdescin, units, precision, offset) )
+			{
+			/* Error processing field */
+			(void) fprintf(stdout,
+					"%s Error while processing gribfield to datafile: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+		}
+
+	/* reset field descriptor */
+	(void) copy_fld_descript(&fdescin, fdesc);
+
+	/* Check for unwanted fields */
+	if ( skip_grib_field(edition, model, element, level) )
+		{
+
+		/* Skip unwanted fields */
+		(void) fprintf(stdout, "%s Skipping field: %s",
+					   MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						   etime, element, level, TRUE));
+		}
+	else	/* Process Field into Metafile */
+		{
+		/* Set the field descriptor directory info */
+		/* Redirect Source if necessary */
+		if ( !set_fld_descript(&fdescin,
+								FpaF_SOURCE_NAME,    redirect_field(edition, model),
+								FpaF_END_OF_LIST) )
+			{
+			(void) fprintf(stderr, "%s Skipping non-FPA model \"%s\"\n",
+					MyPid, redirect_field(edition, model));
+			return;
+			}
+
+
+		/* Make copies of the timestamps (depending on minutes required) */
+		minutes_rqd = fdescin.sdef->minutes_rqd;
+		if ( minutes_rqd )
+			{
+			(void) strcpy(xrtime, rtime);
+			(void) strcpy(xbtime, btime);
+			(void) strcpy(xetime, etime);
+			}
+		else
+			{
+			(void) strcpy(xrtime, tstamp_to_hours(rtime, TRUE, NullInt));
+			(void) strcpy(xbtime, tstamp_to_hours(btime, TRUE, NullInt));
+			(void) strcpy(xetime, tstamp_to_hours(etime, TRUE, NullInt));
+			}
+
+		/* Set the field descriptor file info with GRIB parameters */
+		if ( !set_fld_descript(&fdescin,
+								FpaF_RUN_TIME,     xrtime,
+								FpaF_VALID_TIME,   xetime,
+								FpaF_ELEMENT_NAME, element,
+								FpaF_LEVEL_NAME,   level,
+								FpaF_END_OF_LIST) )
+			{
+			/* Skip unrecognized fields */
+			(void) fprintf(stdout, "%s Skipping non-FPA field: %s", MyPid,
+						   print_field_detail(&fdescin, model, rtime, btime,
+							   etime, element, level, FALSE));
+			return;
+			}
+
+		/* Check for daily fields ... which should not be in GRIB files! */
+		if ( fdescin.edef->elem_tdep->time_dep == FpaC_DAILY )
+			{
+
+			/* Skip daily fields */
+			(void) fprintf(stdout, "%s Skipping Daily field: %s", MyPid,
+						   print_field_detail(&fdescin, model, rtime, btime,
+							   etime, element, level, FALSE));
+			return;
+			}
+
+		/* Prepare data directory for GRIB field */
+		/*  ... only in the main process, and in field order */
+		if ( !InWorker && blank(prepare_source_directory(&fdescin)) )
+			{
+
+			/* Skip fields if directory cannot be created */
+			(void) fprintf(stdout, "%s Cannot create directory for: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+
+		/* Check that metafile name can be created for field */
+		if ( !InWorker && blank(construct_meta_filename(&fdescin))
+				&& blank(build_meta_filename(&fdescin)) )
+			{
+
+			/* Skip fields if metafile name cannot be created */
+			(void) fprintf(stdout,
+					"%s Cannot create datafile name for: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+
+		/* There were no objections so go ahead and process field */
+		(void) fprintf(stdout, "%s Extracting field:  %s", MyPid,
+					   print_field_detail(&fdescin, model, rtime, btime, etime,
+						   element, level, FALSE));
+
+		/* Extract and output metafile from GRIB field */
+		if ( !process_gribfield(gribfld, &fdescin, units) )
+			{
+			/* Error processing field */
+			(void) fprintf(stdout,
+					"%s Error while processing gribfield to Metafile: %s",
+					MyPid, print_field_detail(&fdescin, model, rtime, btime,
+						etime, element, level, FALSE));
+			return;
+			}
+		}
+	}
+
 /***********************************************************************
 *                                                                      *
 *     p r o c e s s _ g r i b f i e l d                                *
@@ -619,9 +863,10 @@ static	LOGICAL	process_gribfield_xycomp
 	FpaConfigFieldStruct		*fdef;
 	FpaConfigElementStruct		*edefout;
 	COMPONENT					compin, compout;
-	STRING						dir, fname;
+	STRING						dir, name;
+	char						fname[MAX_BCHRS];
 	FLD_DESCRIPT				fdescin, fdescout;
-	METAFILE					meta[2], metanew;
+	METAFILE					meta;
 
 	/* Ensure that detailed field information has been read */
 	/*  and is entered back into field descriptor           */
@@ -656,55 +901,28 @@ static	LOGICAL	process_gribfield_xycomp
 			}
 
 		/* Convert GRIB field to component metafile */
-		meta[0] = gribfield_to_metafile_by_comp(gribfld, &fdescout, units,
+		meta = pipe_metafile(gribfld, &fdescout, units, TRUE,
 						compin, compout);
 
 		/* Error message if no metafile could be created */
-		if ( !meta[0] )
+		if ( !meta )
 			{
 			(void) fprintf(stderr, "%s   Unable to extract target field!\n",
 					MyPid);
 			return FALSE;
 			}
 
-		/* Set file lock in base directory while processing field */
-		dir = source_directory_by_name(fdescin.sdef->name, fdescin.subdef->name,
-				FpaCblank);
-		(void) strcpy(LockDir,   dir);
-		(void) strcpy(LockVtime, fdescin.vtime);
-		if ( !set_file_lock(LockDir, LockVtime) )
-			{
-			(void) fprintf(stderr, "%s   Unable to establish file lock!\n",
-					MyPid);
-			meta[0] = destroy_metafile(meta[0]);
-			return FALSE;
-			}
-		Locked = TRUE;
-
 		/* Construct new format (or old format) metafile name */
-		fname = construct_meta_filename(&fdescout);
-		if ( blank(fname) ) fname = build_meta_filename(&fdescout);
-
-		/* Read an existing metafile from the directory */
-		meta[1] = read_metafile(fname, &fdescout.mproj);
-
-		/* Now merge the new metafile with the existing metafile */
-		/*  ... and output the result to the output directory    */
-		metanew = merge_metafiles(2, meta);
-		(void) write_metafile(fname, metanew, MaxDigits);
-
-		/* Determine coverage for extracted field */
-		(void) fprintf(stdout, "%s   Current coverage: %.0f%%\n",
-				MyPid, coverage_mf_source_proj(metanew));
-
-		/* Free space used by METAFILE Objects */
-		meta[0] = destroy_metafile(meta[0]);
-		meta[1] = destroy_metafile(meta[1]);
-		metanew = destroy_metafile(metanew);
+		/*  ... and save it before it is overwritten           */
+		name = construct_meta_filename(&fdescout);
+		if ( blank(name) ) name = build_meta_filename(&fdescout);
+		(void) safe_strcpy(fname, name);
 
-		/* Remove the current lock in the base directory */
-		(void) release_file_lock(LockDir, LockVtime);
-		Locked = FALSE;
+		/* Merge the new metafile with the existing metafile */
+		dir = source_directory_by_name(fdescin.sdef->name, fdescin.subdef->name,
+				FpaCblank);
+		if ( !output_metafile(fname, dir, fdescin.vtime, &fdescout.mproj,
+				meta) ) return FALSE;
 		}
 
 	/* Return when all components have been processed */
@@ -755,28 +973,81 @@ static	LOGICAL	process_gribfield_default
 	)
 
 	{
-	STRING					dir, fname;
+	STRING					dir, name;
+	char					fname[MAX_BCHRS];
 	FLD_DESCRIPT			fdescout;
-	METAFILE				meta[2], metanew;
+	METAFILE				meta;
 
 	/* Initialize field descriptor for output */
 	(void) copy_fld_descript(&fdescout, fdesc);
 
 	/* Convert GRIB field to metafile */
-	meta[0] = gribfield_to_metafile(gribfld, &fdescout, units);
+	meta = pipe_metafile(gribfld, &fdescout, units, FALSE,
+					No_Comp, No_Comp);
 
 	/* Error message if no metafile could be created */
-	if ( !meta[0] )
+	if ( !meta )
 		{
 		(void) fprintf(stderr, "%s   Unable to extract target field!\n", MyPid);
 		return FALSE;
 		}
 
-	/* Set file lock in base directory while processing field */
+	/* Construct new format (or old format) metafile name */
+	/*  ... and save it before it is overwritten           */
+	name = construct_meta_filename(&fdescout);
+	if ( blank(name) ) name = build_meta_filename(&fdescout);
+	(void) safe_strcpy(fname, name);
+
+	/* Merge the new metafile with the existing metafile */
 	dir = source_directory_by_name(fdesc->sdef->name, fdesc->subdef->name,
 			FpaCblank);
+	return output_metafile(fname, dir, fdesc->vtime, &fdescout.mproj, meta);
+	}
+
+/*******************************************************************************/
+/**  Merge a new metafile with the existing output metafile.
+ *
+ * In batch merge mode the new metafile is held until flush_metafiles()
+ * is called.  Otherwise the output metafile is locked, read, merged
+ * and written right away.  The new metafile is destroyed either way.
+ *
+ * @param[in]	fname		output metafile name
+ * @param[in]	dir			base directory for file lock
+ * @param[in]	vtime		valid time for file lock
+ * @param[in]	*mproj		map projection for output metafile
+ * @param[in]	metain		new metafile to merge
+ *******************************************************************************/
+static	LOGICAL	output_metafile
+
+	(
+	STRING			fname,		/* output metafile name */
+	STRING			dir,		/* base directory for file lock */
+	STRING			vtime,		/* valid time for file lock */
+	MAP_PROJ		*mproj,		/* map projection for output metafile */
+	METAFILE		metain		/* new metafile to merge */
+	)
+
+	{
+	METAFILE				meta[2], metanew;
+
+	/* Only the main process writes metafiles */
+	if ( InWorker )
+		{
+		metain = destroy_metafile(metain);
+		return TRUE;
+		}
+
+	/* Hold the new metafile until the end of the GRIB file */
+	if ( BatchMerge )
+		{
+		queue_metafile(fname, dir, vtime, mproj, metain);
+		return TRUE;
+		}
+	meta[0] = metain;
+
+	/* Set file lock in base directory while processing field */
 	(void) strcpy(LockDir,   dir);
-	(void) strcpy(LockVtime, fdesc->vtime);
+	(void) strcpy(LockVtime, vtime);
 	if ( !set_file_lock(LockDir, LockVtime) )
 		{
 		(void) fprintf(stderr, "%s   Unable to establish file lock!\n", MyPid);
@@ -785,12 +1056,8 @@ static	LOGICAL	process_gribfield_default
 		}
 	Locked = TRUE;
 
-	/* Construct new format (or old format) metafile name */
-	fname = construct_meta_filename(&fdescout);
-	if ( blank(fname) ) fname = build_meta_filename(&fdescout);
-
 	/* Read an existing metafile from the directory */
-	meta[1] = read_metafile(fname, &fdescout.mproj);
+	meta[1] = read_metafile(fname, mproj);
 
 	/* Now merge the new metafile with the existing metafile */
 	/*  ... and output the result to the output directory    */
@@ -836,6 +1103,13 @@ static	LOGICAL	process_datafile_default
 	{
 	STRING					dir;
 
+	/* Only the main process writes datafiles */
+	if ( InWorker )
+		{
+		pipe_datafile(gribfld, fdesc, units, precision, offset);
+		return TRUE;
+		}
+
 	/* Redirect source if requested */
 	/* Set file lock in base directory while processing field */
 	dir = source_directory_by_name(fdesc->sdef->name, fdesc->subdef->name,
@@ -852,7 +1126,7 @@ static	LOGICAL	process_datafile_default
 
 	/* Lookup */
 	/* Format and output datafile */
-	(void) gribfield_to_data(gribfld, fdesc, units, precision, offset);
+	pipe_datafile(gribfld, fdesc, units, precision, offset);
 
 	/* Remove the current lock in the base directory */
 	(void) release_file_lock(LockDir, LockVtime);
@@ -861,6 +1135,875 @@ static	LOGICAL	process_datafile_default
 	return TRUE;
 	}
 
+/***********************************************************************
+*                                                                      *
+*     s e t _ m e r g e _ m o d e                                      *
+*     q u e u e _ m e t a f i l e                                      *
+*     f l u s h _ m e t a f i l e s                                    *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Set the metafile merge mode from the environment variable FPA_INGEST_MERGE
+ * or the "Ingest.Merge" advanced feature, either "field" (the default) to
+ * merge and write each field as it is decoded, or "batch" to merge all the
+ * fields for each output metafile at the end of each GRIB file.  The memory
+ * limit (in megabytes) for batch mode is set by FPA_INGEST_MERGE_LIMIT or
+ * the "Ingest.MergeLimit" advanced feature.
+ *******************************************************************************/
+static	void	set_merge_mode(void)
+
+	{
+	STRING	mode;
+	long	limit;
+
+	mode = getenv("FPA_INGEST_MERGE");
+	if ( blank(mode) ) mode = get_feature_mode("Ingest.Merge");
+	if ( blank(mode) || same_ic(mode, "field") ) BatchMerge = FALSE;
+	else if ( same_ic(mode, "batch") )           BatchMerge = TRUE;
+	else
+		{
+		(void) fprintf(stderr, "%s Unknown merge mode \"%s\"\n", MyLabel, mode);
+		BatchMerge = FALSE;
+		}
+
+	mode = getenv("FPA_INGEST_MERGE_LIMIT");
+	if ( blank(mode) ) mode = get_feature_mode("Ingest.MergeLimit");
+	if ( !blank(mode) && sscanf(mode, "%ld", &limit) == 1 && limit > 0 )
+		BatchLimit = limit;
+
+	if ( BatchMerge )
+		(void) fprintf(stdout, "%s Batch merge of metafiles (limit %ld MB)\n",
+				MyLabel, BatchLimit);
+	}
+
+/*******************************************************************************/
+/** Hold a new metafile to be merged with the given output metafile.
+ *
+ * @param[in]	fname		output metafile name
+ * @param[in]	dir			base directory for file lock
+ * @param[in]	vtime		valid time for file lock
+ * @param[in]	*mproj		map projection for output metafile
+ * @param[in]	meta		new metafile to merge (now owned by the queue)
+ *******************************************************************************/
+static	void	queue_metafile
+
+	(
+	STRING			fname,		/* output metafile name */
+	STRING			dir,		/* base directory for file lock */
+	STRING			vtime,		/* valid time for file lock */
+	MAP_PROJ		*mproj,		/* map projection for output metafile */
+	METAFILE		meta		/* new metafile to merge */
+	)
+
+	{
+	int				ip;
+	PENDING_META	*pend;
+
+	/* Find the output metafile in the list (or add it) */
+	for ( ip=0; ip<NumPending; ip++ )
+		{
+		if ( same(Pending[ip].fname, fname) ) break;
+		}
+	if ( ip >= NumPending )
+		{
+		NumPending++;
+		Pending = GETMEM(Pending, PENDING_META, NumPending);
+		pend    = Pending + ip;
+		pend->fname   = strdup(fname);
+		pend->lockdir = strdup(dir);
+		pend->vtime   = strdup(vtime);
+		(void) copy_map_projection(&pend->mproj, mproj);
+		pend->nmeta   = 0;
+		pend->metas   = NullPtr(METAFILE *);
+		}
+	pend = Pending + ip;
+
+	/* Add the new metafile */
+	pend->nmeta++;
+	pend->metas = GETMEM(pend->metas, METAFILE, pend->nmeta);
+	pend->metas[pend->nmeta-1] = meta;
+	BatchSize  += metafile_size(meta);
+
+	(void) fprintf(stdout, "%s   Holding for merge (%d field(s))\n",
+			MyPid, pend->nmeta);
+
+	/* Flush everything now if the memory limit has been reached */
+	if ( BatchSize > BatchLimit * 1024 * 1024 )
+		{
+		(void) fprintf(stdout, "%s Merge limit reached ... flushing\n", MyPid);
+		flush_metafiles();
+		}
+	}
+
+/*******************************************************************************/
+/** Merge and output all held metafiles, taking each file lock only once
+ * for all the output metafiles that share it.
+ *******************************************************************************/
+static	void	flush_metafiles(void)
+
+	{
+	int				ip, jp;
+	PENDING_META	*pend;
+
+	for ( ip=0; ip<NumPending; ip++ )
+		{
+		pend = Pending + ip;
+		if ( IsNull(pend->fname) ) continue;
+
+		/* Set file lock in base directory for this valid time */
+		(void) strcpy(LockDir,   pend->lockdir);
+		(void) strcpy(LockVtime, pend->vtime);
+		if ( !set_file_lock(LockDir, LockVtime) )
+			{
+			(void) fprintf(stderr, "%s   Unable to establish file lock!\n",
+					MyPid);
+			}
+		else
+			{
+			Locked = TRUE;
+
+			/* Output all metafiles protected by this lock */
+			for ( jp=ip; jp<NumPending; jp++ )
+				{
+				if ( IsNull(Pending[jp].fname) )             continue;
+				if ( !same(Pending[jp].lockdir, LockDir) )   continue;
+				if ( !same(Pending[jp].vtime,   LockVtime) ) continue;
+				flush_pending(Pending + jp);
+				}
+
+			/* Remove the current lock in the base directory */
+			(void) release_file_lock(LockDir, LockVtime);
+			Locked = FALSE;
+			}
+
+		/* Discard anything that could not be output */
+		for ( jp=ip; jp<NumPending; jp++ )
+			{
+			if ( IsNull(Pending[jp].fname) )             continue;
+			if ( !same(Pending[jp].lockdir, LockDir) )   continue;
+			if ( !same(Pending[jp].vtime,   LockVtime) ) continue;
+			flush_pending(Pending + jp);
+			}
+		}
+
+	FREEMEM(Pending);
+	NumPending = 0;
+	BatchSize  = 0;
+	}
+
+/*******************************************************************************/
+/** Merge the held metafiles with one output metafile (in the order they were
+ * decoded) and write the result.  Unless the file lock is held, the held
+ * metafiles are simply discarded.
+ *
+ * @param[in]	*pend	held metafiles for one output metafile
+ *******************************************************************************/
+static	void	flush_pending
+
+	(
+	PENDING_META	*pend
+	)
+
+	{
+	int			im;
+	LOGICAL		changed;
+	METAFILE	meta[2], metanew;
+
+	if ( Locked )
+		{
+		/* Read an existing metafile from the directory */
+		meta[1] = read_metafile(pend->fname, &pend->mproj);
+
+		/* Merge each new metafile in turn, as if each had been written */
+		changed = FALSE;
+		for ( im=0; im<pend->nmeta; im++ )
+			{
+			meta[0] = pend->metas[im];
+			metanew = merge_metafiles(2, meta);
+			if ( IsNull(metanew) ) continue;
+			meta[1] = destroy_metafile(meta[1]);
+			meta[1] = metanew;
+			changed = TRUE;
+			}
+
+		/* Output the result to the output directory */
+		if ( changed )
+			{
+			(void) write_metafile(pend->fname, meta[1], MaxDigits);
+			(void) fprintf(stdout, "%s Merged %d field(s) into: %s\n",
+					MyPid, pend->nmeta, pend->fname);
+			(void) fprintf(stdout, "%s   Current coverage: %.0f%%\n",
+					MyPid, coverage_mf_source_proj(meta[1]));
+			}
+		meta[1] = destroy_metafile(meta[1]);
+		}
+
+	/* Free space used by held METAFILE Objects */
+	for ( im=0; im<pend->nmeta; im++ )
+		pend->metas[im] = destroy_metafile(pend->metas[im]);
+	FREEMEM(pend->metas);
+	FREEMEM(pend->fname);
+	FREEMEM(pend->lockdir);
+	FREEMEM(pend->vtime);
+	pend->nmeta = 0;
+	}
+
+/*******************************************************************************/
+/** Estimate the memory used by the surfaces in a metafile.
+ *
+ * @param[in]	meta	metafile
+ * @return	approximate size in bytes.
+ *******************************************************************************/
+static	long	metafile_size
+
+	(
+	METAFILE		meta
+	)
+
+	{
+	int		ifld;
+	long	size, ncv;
+	SURFACE	sfc;
+
+	if ( IsNull(meta) ) return 0;
+	size = sizeof(*meta);
+	for ( ifld=0; ifld<meta->numfld; ifld++ )
+		{
+		if ( IsNull(meta->fields[ifld]) )               continue;
+		if ( meta->fields[ifld]->ftype != FtypeSfc )    continue;
+		sfc = meta->fields[ifld]->data.sfc;
+		if ( IsNull(sfc) )                              continue;
+		ncv   = (long) sfc->sp.m * (long) sfc->sp.n;
+		size += ncv * sizeof(float) * ((sfc->sp.dim == DimVector2D)? 3: 1);
+		}
+	return size;
+	}
+
+/***********************************************************************
+*                                                                      *
+*     s e t _ p i p e _ m o d e                                        *
+*     e n d _ p i p e _ m o d e                                        *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Set the number of worker processes for pipelined decoding.
+ *
+ * The number of workers is set by FPA_INGEST_WORKERS or the
+ * "Ingest.Workers" advanced feature, as a number or "auto" to use one
+ * worker for each available processor.  The default of 1 decodes each
+ * field in the main process.  Pipelined decoding needs an index of the
+ * fields in each GRIB file, so it is not used if indexing is turned off.
+ *******************************************************************************/
+static	void	set_pipe_mode(void)
+
+	{
+	STRING	mode, dir;
+	int		nworkers;
+
+	mode = getenv("FPA_INGEST_WORKERS");
+	if ( blank(mode) ) mode = get_feature_mode("Ingest.Workers");
+
+	nworkers = 1;
+	if ( same_ic(mode, "auto") )
+		nworkers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	else if ( !blank(mode) && sscanf(mode, "%d", &nworkers) != 1 )
+		{
+		(void) fprintf(stderr, "%s Unknown number of workers \"%s\"\n",
+				MyLabel, mode);
+		nworkers = 1;
+		}
+	PipeWorkers = MAX(nworkers, 1);
+	if ( PipeWorkers <= 1 ) return;
+
+	/* Create a private spool directory for the worker processes */
+	dir = tempnam(NullString, "gribin");
+	if ( blank(dir) || !create_directory(dir, S_IRWXU, NullLogicalPtr) )
+		{
+		(void) fprintf(stderr,
+				"%s Cannot create spool directory for workers\n", MyLabel);
+		if ( NotNull(dir) ) free(dir);
+		PipeWorkers = 1;
+		return;
+		}
+	(void) strcpy(PipeDir, dir);
+	free(dir);
+
+	(void) fprintf(stdout, "%s Pipelined decode with %d workers\n",
+			MyLabel, PipeWorkers);
+	}
+
+/*******************************************************************************/
+/** Remove the spool directory for pipelined decoding.
+ *******************************************************************************/
+static	void	end_pipe_mode(void)
+
+	{
+	if ( blank(PipeDir) ) return;
+
+	(void) remove_directory(PipeDir, NullLogicalPtr);
+	(void) strcpy(PipeDir, "");
+	FREEMEM(Jobs);
+	NumJobs    = 0;
+	MaxJobs    = 0;
+	NumRunning = 0;
+	}
+
+/***********************************************************************
+*                                                                      *
+*     s t a r t _ p i p e _ j o b                                      *
+*     r u n _ p i p e _ j o b                                          *
+*     f i n i s h _ p i p e _ j o b                                    *
+*     f i n i s h _ p i p e _ j o b s                                  *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Queue one field from the index of a GRIB file for pipelined decoding.
+ *
+ * A wanted field is unpacked and converted by a worker process.  If all
+ * of the workers are busy, the oldest fields are taken back first, so
+ * that no more than the given number of fields are held in the spool
+ * directory at once.
+ *
+ * @param[in]	edition		GRIB edition number
+ * @param[in]	gribname	GRIB file name
+ * @param[in]	*gindex		index of fields in GRIB file
+ * @param[in]	ientry		index entry for field
+ * @param[in]	*fdesc		field descriptor for files
+ * @return TRUE if the field was queued, FALSE if it should be processed
+ * 		   right away.
+ *******************************************************************************/
+static	LOGICAL	start_pipe_job
+
+	(
+	int				edition,	/* GRIB edition number */
+	STRING			gribname,	/* GRIB file name */
+	GRIBINDEX		*gindex,	/* index of fields in GRIB file */
+	int				ientry,		/* index entry for field */
+	FLD_DESCRIPT	*fdesc		/* field descriptor for files */
+	)
+
+	{
+	GRIBINDEX_ENTRY	*gentry;
+	PIPE_JOB		*job;
+	LOGICAL			wanted;
+
+	if ( PipeWorkers <= 1 || blank(PipeDir) ) return FALSE;
+
+	/* Unwanted fields need no worker */
+	gentry = &gindex->entries[ientry];
+	wanted = (LOGICAL) ( gentry->valid
+				&& !( skip_grib_datafile(edition, gentry->model,
+							gentry->element, gentry->level)
+						&& skip_grib_field(edition, gentry->model,
+							gentry->element, gentry->level) ) );
+	if ( !wanted && NumJobs <= 0 ) return FALSE;
+
+	/* Take back the oldest fields until a worker is free */
+	if ( wanted )
+		while ( NumRunning >= PipeWorkers ) finish_pipe_job();
+
+	/* Add the field to the queue */
+	if ( NumJobs >= MaxJobs )
+		{
+		MaxJobs += 16;
+		Jobs     = GETMEM(Jobs, PIPE_JOB, MaxJobs);
+		}
+	job = &Jobs[NumJobs++];
+	job->pid     = 0;
+	job->edition = edition;
+	job->gindex  = gindex;
+	job->ientry  = ientry;
+	job->fdesc   = fdesc;
+	if ( !wanted ) return TRUE;
+
+	/* Start a worker process for the field */
+	(void) fflush(stdout);
+	(void) fflush(stderr);
+	job->pid = fork();
+	if ( job->pid == 0 ) run_pipe_job(job, gribname);
+	if ( job->pid < 0 )
+		{
+		/* The main process will have to do it */
+		(void) fprintf(stderr, "%s Cannot start worker process\n", MyPid);
+		job->pid = 0;
+		return TRUE;
+		}
+	NumRunning++;
+	return TRUE;
+	}
+
+/*******************************************************************************/
+/** Unpack and convert one field in a worker process, and exit.
+ *
+ * @param[in]	*job		field to convert
+ * @param[in]	gribname	GRIB file name
+ *******************************************************************************/
+static	void	run_pipe_job
+
+	(
+	PIPE_JOB	*job,		/* field to convert */
+	STRING		gribname	/* GRIB file name */
+	)
+
+	{
+	GRIBINDEX_ENTRY	*gentry;
+	DECODEDFIELD	*gribfld;
+	int				status = 0;
+
+	InWorker   = TRUE;
+	PipeEntry  = job->ientry;
+	NumResults = 0;
+
+	/* Save messages and results in the spool directory */
+	if ( IsNull(freopen(pipe_file(job->ientry, "out"), "w", stdout))
+			|| IsNull(freopen(pipe_file(job->ientry, "err"), "w", stderr))
+			|| IsNull(ResultFile = fopen(pipe_file(job->ientry, "res"), "wb")) )
+		_exit(1);
+	(void) setvbuf(stdout, NullString, _IOLBF, 0);
+	(void) setvbuf(stderr, NullString, _IOLBF, 0);
+
+	/* Reopen the GRIB file so as not to share its file position */
+	if ( !open_gribfile(job->edition, gribname)
+			|| !read_indexed_gribfield(job->gindex, job->ientry, &gribfld) )
+		_exit(PipeUnreadable);
+
+	gentry = &job->gindex->entries[job->ientry];
+	process_field(job->edition, gribfld, job->fdesc, gentry->model,
+			gentry->rtime, gentry->vtimeb, gentry->vtimee, gentry->element,
+			gentry->level, gentry->units);
+
+	if ( fclose(ResultFile) != 0 ) status = 1;
+	(void) fflush(stdout);
+	(void) fflush(stderr);
+	_exit(status);
+	}
+
+/*******************************************************************************/
+/** Take back the oldest field in the queue and process it.
+ *******************************************************************************/
+static	void	finish_pipe_job(void)
+
+	{
+	PIPE_JOB	job;
+	int			ijob, status;
+
+	if ( NumJobs <= 0 ) return;
+
+	/* Remove the oldest field from the queue */
+	job = Jobs[0];
+	for ( ijob=1; ijob<NumJobs; ijob++ ) Jobs[ijob-1] = Jobs[ijob];
+	NumJobs--;
+
+	/* Wait for the worker process to finish */
+	PipeStatus = PipeNone;
+	if ( job.pid > 0 )
+		{
+		while ( waitpid(job.pid, &status, 0) < 0 && errno == EINTR )
+			continue;
+		NumRunning--;
+
+		if ( WIFEXITED(status) && WEXITSTATUS(status) == 0 )
+			{
+			load_pipe_results(job.ientry);
+			PipeStatus = PipeReady;
+			}
+		else if ( WIFEXITED(status) && WEXITSTATUS(status) == PipeUnreadable )
+			PipeStatus = PipeUnreadable;
+		else
+			(void) fprintf(stderr,
+					"%s Worker process failed for GRIB field %d\n",
+					MyPid, job.ientry+1);
+		}
+
+	/* Process the field with the results from the worker */
+	process_entry(job.edition, job.gindex, job.ientry, job.fdesc);
+	PipeStatus = PipeNone;
+
+	/* Clean up the spool directory */
+	if ( job.pid > 0 ) remove_pipe_results(job.ientry);
+	}
+
+/*******************************************************************************/
+/** Take back and process all fields in the queue, in order.
+ *******************************************************************************/
+static	void	finish_pipe_jobs(void)
+
+	{
+	while ( NumJobs > 0 ) finish_pipe_job();
+	}
+
+/***********************************************************************
+*                                                                      *
+*     p i p e _ m e t a f i l e                                        *
+*     p i p e _ d a t a f i l e                                        *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Convert a GRIB field to a new metafile.
+ *
+ * The main process takes the metafile converted by a worker process if
+ * there is one.  A worker process saves the metafile in binary form, so
+ * that the main process reads back exactly the same surfaces.
+ *
+ * @param[in]	*gribfld	DECODEDFIELD object with decoded GRIB data
+ * @param[in]	*fdesc		pointer to output field descriptor
+ * @param[in]	units		field units label
+ * @param[in]	bycomp		convert by component?
+ * @param[in]	compin		input components (if by component)
+ * @param[in]	compout		output component (if by component)
+ * @return new metafile (NullMeta if it could not be converted).
+ *******************************************************************************/
+static	METAFILE	pipe_metafile
+
+	(
+	DECODEDFIELD	*gribfld,	/* GRIBFIELD Object with decoded GRIB data */
+	FLD_DESCRIPT	*fdesc,		/* pointer to output field descriptor */
+	STRING			units,		/* field units label */
+	LOGICAL			bycomp,		/* convert by component? */
+	COMPONENT		compin,		/* input components */
+	COMPONENT		compout		/* output component */
+	)
+
+	{
+	int			iresult;
+	METAFILE	meta;
+
+	/* Take the metafile converted by a worker process */
+	iresult = next_pipe_result(FALSE);
+	if ( iresult >= 0 )
+		{
+		replay_pipe_result(iresult);
+		if ( !Results[iresult].saved ) return NullMeta;
+		return read_metafile(pipe_result_file(PipeEntry, iresult),
+					&fdesc->mproj);
+		}
+
+	/* Otherwise convert the field now */
+	gribfld = pipe_gribfield(gribfld);
+	if ( IsNull(gribfld) ) return NullMeta;
+	begin_pipe_result();
+	if ( bycomp )
+		meta = gribfield_to_metafile_by_comp(gribfld, fdesc, units,
+					compin, compout);
+	else
+		meta = gribfield_to_metafile(gribfld, fdesc, units);
+	if ( InWorker && NotNull(meta) )
+		write_metafile_special(pipe_result_file(PipeEntry, NumResults), meta,
+				MaxDigits, META_BINARY);
+	end_pipe_result(FALSE, NotNull(meta));
+	return meta;
+	}
+
+/*******************************************************************************/
+/** Convert a GRIB field and write it to the datafile for the given field
+ * descriptor.
+ *
+ * The main process copies the datafile converted by a worker process if
+ * there is one.
+ *
+ * @param[in]	*gribfld	DECODEDFIELD object with decoded GRIB data
+ * @param[in]	*fdesc		pointer to output field descriptor
+ * @param[in]	units		field units label
+ * @param[in]	precision	amount to scale output values by.
+ * @param[in]	offset		amount to offset output values by.
+ *******************************************************************************/
+static	void		pipe_datafile
+
+	(
+	DECODEDFIELD	*gribfld,	/* GRIBFIELD Object with decoded GRIB data */
+	FLD_DESCRIPT	*fdesc,		/* pointer to output field descriptor */
+	STRING			units,		/* field units label */
+	float			precision,
+	float			offset
+	)
+
+	{
+	int		iresult;
+	STRING	fname;
+	FILE	*fp;
+
+	/* Copy the datafile converted by a worker process */
+	iresult = next_pipe_result(TRUE);
+	if ( iresult >= 0 )
+		{
+		replay_pipe_result(iresult);
+		if ( !Results[iresult].saved ) return;
+		fname = construct_meta_filename(fdesc);
+		if ( blank(fname) ) fname = build_meta_filename(fdesc);
+		if ( blank(fname) ) return;
+		if ( IsNull(fp = fopen(fname, "wb")) )
+			{
+			(void) fprintf(stderr, "Cannot open output file \"%s\"\n", fname);
+			return;
+			}
+		(void) copy_pipe_file(pipe_result_file(PipeEntry, iresult), 0, -1, fp);
+		(void) fclose(fp);
+		return;
+		}
+
+	/* Otherwise convert the field now */
+	gribfld = pipe_gribfield(gribfld);
+	if ( IsNull(gribfld) ) return;
+	if ( !InWorker )
+		{
+		gribfield_to_data(gribfld, fdesc, units, precision, offset);
+		return;
+		}
+	begin_pipe_result();
+	gribfield_to_data_file(gribfld, pipe_result_file(PipeEntry, NumResults),
+			precision, offset);
+	end_pipe_result(TRUE, find_file(pipe_result_file(PipeEntry, NumResults)));
+	}
+
+/***********************************************************************
+*                                                                      *
+*     STATIC (LOCAL) ROUTINES FOR PIPELINED DECODING:                  *
+*                                                                      *
+***********************************************************************/
+
+/* Unpack the current field in the main process if it is needed again */
+static	DECODEDFIELD	*pipe_gribfield
+
+	(
+	DECODEDFIELD	*gribfld
+	)
+
+	{
+	if ( NotNull(gribfld) )   return gribfld;
+	if ( NotNull(PipeField) ) return PipeField;
+	if ( IsNull(PipeIndex) )  return NullPtr(DECODEDFIELD *);
+
+	if ( !read_indexed_gribfield(PipeIndex, PipeEntry, &PipeField) )
+		PipeField = NullPtr(DECODEDFIELD *);
+	return PipeField;
+	}
+
+/**********************************************************************/
+
+/* Find the next saved result of the given type from a worker process */
+static	int		next_pipe_result
+
+	(
+	LOGICAL	isdata
+	)
+
+	{
+	int		iresult;
+
+	if ( InWorker || PipeStatus != PipeReady ) return -1;
+
+	/* Results the main process does not ask for are passed over */
+	while ( NextResult < NumResults )
+		{
+		iresult = NextResult++;
+		if ( Results[iresult].isdata == isdata ) return iresult;
+		}
+	return -1;
+	}
+
+/**********************************************************************/
+
+/* Note where the messages for the next result begin in a worker process */
+static	void	begin_pipe_result(void)
+
+	{
+	if ( !InWorker ) return;
+
+	(void) fflush(stdout);
+	(void) fflush(stderr);
+	Result.outbeg = ftell(stdout);
+	Result.errbeg = ftell(stderr);
+	}
+
+/**********************************************************************/
+
+/* Save the next result in a worker process */
+static	void	end_pipe_result
+
+	(
+	LOGICAL	isdata,
+	LOGICAL	saved
+	)
+
+	{
+	if ( !InWorker ) return;
+
+	(void) fflush(stdout);
+	(void) fflush(stderr);
+	Result.outend = ftell(stdout);
+	Result.errend = ftell(stderr);
+	Result.isdata = isdata;
+	Result.saved  = saved;
+	if ( fwrite(&Result, sizeof(PIPE_RESULT), 1, ResultFile) != 1 ) _exit(1);
+	NumResults++;
+	}
+
+/**********************************************************************/
+
+/* Copy the messages for a result from a worker process */
+static	void	replay_pipe_result
+
+	(
+	int		iresult
+	)
+
+	{
+	PIPE_RESULT	*result;
+
+	result = &Results[iresult];
+	(void) copy_pipe_file(pipe_file(PipeEntry, "out"),
+			result->outbeg, result->outend, stdout);
+	(void) copy_pipe_file(pipe_file(PipeEntry, "err"),
+			result->errbeg, result->errend, stderr);
+	}
+
+/**********************************************************************/
+
+/* Read the list of results saved by a worker process */
+static	void	load_pipe_results
+
+	(
+	int		ientry
+	)
+
+	{
+	FILE	*fp;
+
+	NumResults = 0;
+	NextResult = 0;
+	PipeEntry  = ientry;
+	fp = fopen(pipe_file(ientry, "res"), "rb");
+	if ( IsNull(fp) ) return;
+
+	for ( ; ; )
+		{
+		Results = GETMEM(Results, PIPE_RESULT, NumResults+1);
+		if ( fread(&Results[NumResults], sizeof(PIPE_RESULT), 1, fp) != 1 )
+			break;
+		NumResults++;
+		}
+	(void) fclose(fp);
+	}
+
+/**********************************************************************/
+
+/* Remove the files saved by a worker process */
+static	void	remove_pipe_results
+
+	(
+	int		ientry
+	)
+
+	{
+	int		iresult;
+
+	for ( iresult=0; iresult<NumResults; iresult++ )
+		(void) remove_file(pipe_result_file(ientry, iresult), NullLogicalPtr);
+	(void) remove_file(pipe_file(ientry, "out"), NullLogicalPtr);
+	(void) remove_file(pipe_file(ientry, "err"), NullLogicalPtr);
+	(void) remove_file(pipe_file(ientry, "res"), NullLogicalPtr);
+	NumResults = 0;
+	NextResult = 0;
+	}
+
+/**********************************************************************/
+
+static	STRING	pipe_file
+
+	(
+	int		ientry,
+	STRING	suffix
+	)
+
+	{
+	static	char	name[MAX_BCHRS];
+
+	(void) sprintf(name, "%s/%d.%s", PipeDir, ientry, suffix);
+	return name;
+	}
+
+/**********************************************************************/
+
+static	STRING	pipe_result_file
+
+	(
+	int		ientry,
+	int		iresult
+	)
+
+	{
+	char	suffix[20];
+
+	(void) sprintf(suffix, "%d", iresult);
+	return pipe_file(ientry, suffix);
+	}
+
+/**********************************************************************/
+
+/* Copy part of a file (to the end if nend < 0) to the given stream */
+static	LOGICAL	copy_pipe_file
+
+	(
+	STRING	name,
+	long	nbeg,
+	long	nend,
+	FILE	*fpout
+	)
+
+	{
+	FILE	*fp;
+	char	buf[4096];
+	size_t	nbuf;
+	long	nleft;
+
+	if ( nend >= 0 && nend <= nbeg ) return TRUE;
+	fp = fopen(name, "rb");
+	if ( IsNull(fp) ) return FALSE;
+	if ( fseek(fp, nbeg, SEEK_SET) != 0 )
+		{
+		(void) fclose(fp);
+		return FALSE;
+		}
+
+	nleft = ( nend < 0 )? -1: nend - nbeg;
+	while ( nleft != 0 )
+		{
+		nbuf = sizeof(buf);
+		if ( nleft > 0 && nleft < (long) nbuf ) nbuf = (size_t) nleft;
+		nbuf = fread(buf, 1, nbuf, fp);
+		if ( nbuf <= 0 ) break;
+		if ( fwrite(buf, 1, nbuf, fpout) != nbuf ) break;
+		if ( nleft > 0 ) nleft -= (long) nbuf;
+		}
+
+	(void) fclose(fp);
+	(void) fflush(fpout);
+	return TRUE;
+	}
+
+/**********************************************************************/
+
+static	LOGICAL	open_gribfile
+
+	(
+	int		edition,
+	STRING	name
+	)
+
+	{
+	switch ( edition )
+		{
+		case 0:  return open_gribfile_edition0(name);
+		case 1:  return open_gribfile_edition1(name);
+		case 2:  return open_gribfile_edition2(name);
+		default: return FALSE;
+		}
+	}
+
 /**************************************************
 * d e t e r m i n e _ e d i t i o n _ n u m b e r *
 ***************************************************/
@@ -1120,5 +2263,6 @@ static	void	error_trap
 				MyPid);
 		(void) release_file_lock(LockDir, LockVtime);
 		}
+	if ( !InWorker ) end_pipe_mode();
 	(void) exit(1);
 	}
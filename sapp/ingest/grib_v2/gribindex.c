@@ -0,0 +1,428 @@
+/***********************************************************************/
+/** @file	gribindex.c
+ *
+ * Routines to index the fields in a GRIB file before decoding.
+ ***********************************************************************/
+/***********************************************************************
+*                                                                      *
+*    g r i b i n d e x . c                                             *
+*                                                                      *
+*    Routines to index the fields in a GRIB file before decoding.      *
+*                                                                      *
+*    The index holds the file position and translated identifiers of   *
+*    each field, from a scan that decodes only the product definition  *
+*    of each GRIB message.  The data of each field can then be         *
+*    unpacked only if the field is wanted by the ingest config.        *
+*                                                                      *
+*    The index may also be saved beside the GRIB file (with a ".idx"   *
+*    suffix) so that later runs on the same file can skip the scan.    *
+*                                                                      *
+*     Version 8 (c) Copyright 2011 Environment Canada                  *
+*                                                                      *
+*   This file is part of the Forecast Production Assistant (FPA).      *
+*   The FPA is free software: you can redistribute it and/or modify it *
+*   under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation, either version 3 of the License, or  *
+*   any later version.                                                 *
+*                                                                      *
+*   The FPA is distributed in the hope that it will be useful, but     *
+*   WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.               *
+*   See the GNU General Public License for more details.               *
+*                                                                      *
+*   You should have received a copy of the GNU General Public License  *
+*   along with the FPA.  If not, see <http://www.gnu.org/licenses/>.   *
+*                                                                      *
+***********************************************************************/
+
+#define GRIBINDEX_MAIN	/* To initialize defined constants and      */
+						/*  internal structures in gribindex.h file */
+
+/* We need FPA definitions */
+#include <fpa.h>
+
+/* We need definitions for GRIB data structures */
+#include "rgrib.h"
+
+#include "gribindex.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef DEBUG_GRIBINDEX
+	static int	DebugMode = TRUE;
+#else
+	static int	DebugMode = FALSE;
+#endif /* DEBUG_GRIBINDEX */
+
+#define dprintf (!DebugMode)? (void) 0: (void) fprintf
+
+/* Index modes */
+#define IndexNone	0	/* decode each field in turn (no index)   */
+#define IndexScan	1	/* scan the GRIB file for each run        */
+#define IndexFile	2	/* scan once and save the index beside it */
+
+static	int		IndexMode   = IndexScan;
+static	LOGICAL	IndexModeSet = FALSE;
+
+/* Index file suffix and header */
+static	const	STRING	IndexSuffix = ".idx";
+static	const	STRING	IndexHeader = "FPA GRIB index 1";
+
+/* Setup key for the ingest config file (FpaGIngestsFile in ingest_info.c) */
+static	const	STRING	IngestConfig = "ingest";
+
+/* Interface functions                   */
+/*  ... these are defined in gribindex.h */
+
+/* Internal static functions */
+static	int		grib_index_mode(void);
+static	void	scan_grib_index(int, GRIBINDEX *);
+static	LOGICAL	read_grib_index(STRING, int, GRIBINDEX *);
+static	void	write_grib_index(STRING, GRIBINDEX *);
+static	GRIBINDEX_ENTRY	*add_index_entry(GRIBINDEX *);
+
+/***********************************************************************
+*                                                                      *
+*    b u i l d _ g r i b _ i n d e x                                   *
+*    r e a d _ i n d e x e d _ g r i b f i e l d                       *
+*    f r e e _ g r i b _ i n d e x                                     *
+*                                                                      *
+***********************************************************************/
+
+/*******************************************************************************/
+/** Build an index of the fields in the currently open GRIB file.
+ *
+ * The index mode is set by the environment variable FPA_INGEST_INDEX or
+ * the "Ingest.Index" advanced feature:
+ *	- "scan"  scan the GRIB file before decoding (default)
+ *	- "file"  as for "scan", but save the index in a ".idx" file beside
+ *	          the GRIB file and re-use it on later runs
+ *	- "none"  do not build an index
+ *
+ * A saved index is only re-used if the GRIB file has not changed since
+ * it was written, and if the ingest config file is older than the
+ * index.  Changes to files included by the ingest config file are not
+ * detected, so remove the ".idx" files after such changes.
+ *
+ * @param[in]	gribname	GRIB file name
+ * @param[in]	edition		GRIB edition number
+ * @param[out]	*gindex		index of fields in GRIB file
+ * @return TRUE if an index was built.  If FALSE, the fields must be
+ * decoded in turn with next_gribfield_editionN().
+ *******************************************************************************/
+LOGICAL	build_grib_index
+	(
+	STRING		gribname,	/* GRIB file name */
+	int			edition,	/* GRIB edition number */
+	GRIBINDEX	*gindex		/* index of fields in GRIB file */
+	)
+	{
+	int		mode;
+
+	if ( IsNull(gindex) ) return FALSE;
+	gindex->edition = edition;
+	gindex->nentry  = 0;
+	gindex->entries = NullPtr(GRIBINDEX_ENTRY *);
+
+	mode = grib_index_mode();
+	if ( mode == IndexNone ) return FALSE;
+
+	/* Re-use a saved index if it is still valid */
+	if ( mode == IndexFile && read_grib_index(gribname, edition, gindex) )
+		{
+		(void) pr_diag("GRIB Index", "Using saved index for \"%s\"\n",
+				gribname);
+		return TRUE;
+		}
+
+	/* Otherwise scan the GRIB file (and save the index) */
+	scan_grib_index(edition, gindex);
+	if ( mode == IndexFile ) write_grib_index(gribname, gindex);
+	(void) pr_diag("GRIB Index", "Indexed %d fields in \"%s\"\n",
+			gindex->nentry, gribname);
+	return TRUE;
+	}
+
+/*******************************************************************************/
+/** Unpack one field from the currently open GRIB file, using the file
+ * position saved in the index.
+ *
+ * @param[in]	*gindex		index of fields in GRIB file
+ * @param[in]	ientry		field to unpack
+ * @param[out]	**gribfld	decoded GRIB field
+ * @return TRUE if successful.
+ *******************************************************************************/
+LOGICAL	read_indexed_gribfield
+	(
+	GRIBINDEX		*gindex,	/* index of fields in GRIB file */
+	int				ientry,		/* field to unpack */
+	DECODEDFIELD	**gribfld	/* decoded GRIB field */
+	)
+	{
+	GRIBINDEX_ENTRY	*entry;
+
+	if ( NotNull(gribfld) ) *gribfld = NullPtr(DECODEDFIELD *);
+	if ( IsNull(gindex) || IsNull(gribfld) )          return FALSE;
+	if ( ientry < 0 || ientry >= gindex->nentry )     return FALSE;
+
+	entry = &gindex->entries[ientry];
+	switch ( gindex->edition )
+		{
+		case 0: return read_gribfield_edition0(entry->offset, entry->field,
+								gribfld);
+		case 1: return read_gribfield_edition1(entry->offset, entry->field,
+								gribfld);
+		case 2: return read_gribfield_edition2(entry->offset, entry->field,
+								gribfld);
+		}
+	return FALSE;
+	}
+
+/*******************************************************************************/
+/** Free the memory used by an index.
+ *
+ * @param[in]	*gindex		index of fields in GRIB file
+ *******************************************************************************/
+void	free_grib_index
+	(
+	GRIBINDEX	*gindex		/* index of fields in GRIB file */
+	)
+	{
+	if ( IsNull(gindex) ) return;
+	FREEMEM(gindex->entries);
+	gindex->nentry = 0;
+	}
+
+/***********************************************************************
+*                                                                      *
+*    STATIC (LOCAL) ROUTINES:                                          *
+*                                                                      *
+***********************************************************************/
+
+/* Set the index mode from the environment or advanced feature */
+static	int		grib_index_mode(void)
+	{
+	STRING	mode;
+
+	if ( IndexModeSet ) return IndexMode;
+	IndexModeSet = TRUE;
+
+	mode = getenv("FPA_INGEST_INDEX");
+	if ( blank(mode) ) mode = get_feature_mode("Ingest.Index");
+
+	if ( blank(mode) || same_ic(mode, "scan") ) IndexMode = IndexScan;
+	else if ( same_ic(mode, "file") )           IndexMode = IndexFile;
+	else if ( same_ic(mode, "none") )           IndexMode = IndexNone;
+	else
+		{
+		(void) pr_warning("GRIB Index", "Unknown index mode \'%s\'.\n", mode);
+		IndexMode = IndexScan;
+		}
+	return IndexMode;
+	}
+
+/**********************************************************************/
+
+/* Scan the open GRIB file, decoding only the identifiers of each field */
+static	void	scan_grib_index
+	(
+	int			edition,
+	GRIBINDEX	*gindex
+	)
+	{
+	long			offset;
+	int				field;
+	LOGICAL			iret;
+	STRING			model, rtime, vtimeb, vtimee, element, level, units;
+	GRIBINDEX_ENTRY	*entry;
+
+	while ( 1 )
+		{
+		switch ( edition )
+			{
+			case 0: iret = next_gribheader_edition0(&offset, &field); break;
+			case 1: iret = next_gribheader_edition1(&offset, &field); break;
+			case 2: iret = next_gribheader_edition2(&offset, &field); break;
+			default: iret = FALSE; break;
+			}
+		if ( !iret ) break;	/* End of file reached */
+
+		switch ( edition )
+			{
+			case 0:
+				iret = gribfield_identifiers_edition0(&model, &rtime, &vtimeb,
+						&vtimee, &element, &level, &units);
+				break;
+			case 1:
+				iret = gribfield_identifiers_edition1(&model, &rtime, &vtimeb,
+						&vtimee, &element, &level, &units);
+				break;
+			case 2:
+				iret = gribfield_identifiers_edition2(&model, &rtime, &vtimeb,
+						&vtimee, &element, &level, &units);
+				break;
+			}
+
+		entry = add_index_entry(gindex);
+		entry->offset = offset;
+		entry->field  = field;
+		entry->valid  = iret;
+		if ( !iret ) continue;
+		(void) safe_strcpy(entry->model,   model);
+		(void) safe_strcpy(entry->rtime,   rtime);
+		(void) safe_strcpy(entry->vtimeb,  vtimeb);
+		(void) safe_strcpy(entry->vtimee,  vtimee);
+		(void) safe_strcpy(entry->element, element);
+		(void) safe_strcpy(entry->level,   level);
+		(void) safe_strcpy(entry->units,   units);
+		dprintf(stdout, "[scan_grib_index] %ld %d %s %s %s %s\n",
+				offset, field, model, element, level, vtimee);
+		}
+	}
+
+/**********************************************************************/
+
+/* Read a saved index, if it matches the GRIB file */
+static	LOGICAL	read_grib_index
+	(
+	STRING		gribname,
+	int			edition,
+	GRIBINDEX	*gindex
+	)
+	{
+	FILE			*fp;
+	STRING			cfgname;
+	char			iname[MAX_BCHRS], line[MAX_BCHRS];
+	struct stat		gstat, istat, cstat;
+	int				xedition, valid;
+	long			xsize, xtime;
+	LOGICAL			ok;
+	GRIBINDEX_ENTRY	*entry;
+
+	/* The index must be newer than the ingest config file, and must */
+	/*  describe the GRIB file as it is now                          */
+	(void) strcpy(iname, gribname);
+	(void) strcat(iname, IndexSuffix);
+	if ( stat(gribname, &gstat) != 0 ) return FALSE;
+	if ( stat(iname,    &istat) != 0 ) return FALSE;
+	cfgname = config_file_name(IngestConfig);
+	if ( !blank(cfgname) && stat(cfgname, &cstat) == 0
+			&& cstat.st_mtime > istat.st_mtime ) return FALSE;
+
+	if ( IsNull(fp = fopen(iname, "r")) ) return FALSE;
+	ok = FALSE;
+	if ( IsNull(fgets(line, MAX_BCHRS, fp)) )    goto Done;
+	if ( strncmp(line, IndexHeader, strlen(IndexHeader)) != 0 ) goto Done;
+	if ( IsNull(fgets(line, MAX_BCHRS, fp)) )    goto Done;
+	if ( sscanf(line, "edition %d size %ld mtime %ld",
+			&xedition, &xsize, &xtime) != 3 )   goto Done;
+	if ( xedition != edition
+			|| xsize != (long) gstat.st_size
+			|| xtime != (long) gstat.st_mtime ) goto Done;
+
+	/* Read the identifiers of each field ("-" for blank labels) */
+	while ( NotNull(fgets(line, MAX_BCHRS, fp)) )
+		{
+		entry = add_index_entry(gindex);
+		if ( sscanf(line, "%ld %d %d %31s %31s %31s %31s %31s %31s %31s",
+				&entry->offset, &entry->field, &valid,
+				entry->model, entry->rtime, entry->vtimeb, entry->vtimee,
+				entry->element, entry->level, entry->units) != 10 )
+			goto Done;
+		entry->valid = (LOGICAL) (valid != 0);
+		if ( same(entry->model,   "-") ) (void) strcpy(entry->model,   "");
+		if ( same(entry->rtime,   "-") ) (void) strcpy(entry->rtime,   "");
+		if ( same(entry->vtimeb,  "-") ) (void) strcpy(entry->vtimeb,  "");
+		if ( same(entry->vtimee,  "-") ) (void) strcpy(entry->vtimee,  "");
+		if ( same(entry->element, "-") ) (void) strcpy(entry->element, "");
+		if ( same(entry->level,   "-") ) (void) strcpy(entry->level,   "");
+		if ( same(entry->units,   "-") ) (void) strcpy(entry->units,   "");
+		}
+	ok = TRUE;
+
+Done:
+	(void) fclose(fp);
+	if ( !ok )
+		{
+		(void) pr_diag("GRIB Index", "Ignoring out of date index \"%s\"\n",
+				iname);
+		free_grib_index(gindex);
+		}
+	return ok;
+	}
+
+/**********************************************************************/
+
+/* Save the index beside the GRIB file */
+static	void	write_grib_index
+	(
+	STRING		gribname,
+	GRIBINDEX	*gindex
+	)
+	{
+	FILE			*fp;
+	char			iname[MAX_BCHRS], tname[MAX_BCHRS];
+	struct stat		gstat;
+	int				ii;
+	GRIBINDEX_ENTRY	*entry;
+
+	if ( stat(gribname, &gstat) != 0 ) return;
+
+	/* Write to a temporary file first, so that another process */
+	/*  never sees a partial index                              */
+	(void) strcpy(iname, gribname);
+	(void) strcat(iname, IndexSuffix);
+	(void) sprintf(tname, "%s.%d", iname, (int) getpid());
+	if ( IsNull(fp = fopen(tname, "w")) )
+		{
+		(void) pr_diag("GRIB Index", "Cannot write index \"%s\"\n", iname);
+		return;
+		}
+
+	(void) fprintf(fp, "%s\n", IndexHeader);
+	(void) fprintf(fp, "edition %d size %ld mtime %ld\n", gindex->edition,
+			(long) gstat.st_size, (long) gstat.st_mtime);
+	for ( ii=0; ii<gindex->nentry; ii++ )
+		{
+		entry = &gindex->entries[ii];
+		(void) fprintf(fp, "%ld %d %d %s %s %s %s %s %s %s\n",
+				entry->offset, entry->field, (entry->valid)? 1: 0,
+				blank(entry->model)?   "-": entry->model,
+				blank(entry->rtime)?   "-": entry->rtime,
+				blank(entry->vtimeb)?  "-": entry->vtimeb,
+				blank(entry->vtimee)?  "-": entry->vtimee,
+				blank(entry->element)? "-": entry->element,
+				blank(entry->level)?   "-": entry->level,
+				blank(entry->units)?   "-": entry->units);
+		}
+
+	if ( fclose(fp) != 0 || rename(tname, iname) != 0 )
+		{
+		(void) pr_diag("GRIB Index", "Cannot write index \"%s\"\n", iname);
+		(void) unlink(tname);
+		}
+	}
+
+/**********************************************************************/
+
+/* Add an empty entry to the end of the index */
+static	GRIBINDEX_ENTRY	*add_index_entry
+	(
+	GRIBINDEX	*gindex
+	)
+	{
+	GRIBINDEX_ENTRY	*entry;
+
+	/* Allocate space in blocks */
+	if ( gindex->nentry % 64 == 0 )
+		gindex->entries = GETMEM(gindex->entries, GRIBINDEX_ENTRY,
+								gindex->nentry + 64);
+
+	entry = &gindex->entries[gindex->nentry++];
+	(void) memset(entry, 0, sizeof(GRIBINDEX_ENTRY));
+	return entry;
+	}
@@ -0,0 +1,79 @@
+/***********************************************************************
+*                                                                      *
+*   g r i b i n d e x . h                                              *
+*                                                                      *
+*   Routines to index the fields in a GRIB file before decoding        *
+*   (include file)                                                     *
+*                                                                      *
+*     Version 8 (c) Copyright 2011 Environment Canada                  *
+*                                                                      *
+*   This file is part of the Forecast Production Assistant (FPA).      *
+*   The FPA is free software: you can redistribute it and/or modify it *
+*   under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation, either version 3 of the License, or  *
+*   any later version.                                                 *
+*                                                                      *
+*   The FPA is distributed in the hope that it will be useful, but     *
+*   WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.               *
+*   See the GNU General Public License for more details.               *
+*                                                                      *
+*   You should have received a copy of the GNU General Public License  *
+*   along with the FPA.  If not, see <http://www.gnu.org/licenses/>.   *
+*                                                                      *
+***********************************************************************/
+
+/* See if already included */
+#ifndef GRIBINDEX_DEFS
+#define GRIBINDEX_DEFS
+
+
+/* We need FPA definitions */
+#include <fpa.h>
+
+/***********************************************************************
+*                                                                      *
+*  Initialize defined constants for gribindex routines                 *
+*                                                                      *
+***********************************************************************/
+
+#ifdef GRIBINDEX_MAIN
+
+
+#endif
+
+/* Identifiers of one field in a GRIB file */
+typedef struct
+	{
+	long	offset;		/* file position of GRIB message     */
+	int		field;		/* field number within GRIB message  */
+	LOGICAL	valid;		/* were all identifiers translated?  */
+	char	model[GRIB_LABEL_LEN];
+	char	rtime[GRIB_LABEL_LEN];
+	char	vtimeb[GRIB_LABEL_LEN];
+	char	vtimee[GRIB_LABEL_LEN];
+	char	element[GRIB_LABEL_LEN];
+	char	level[GRIB_LABEL_LEN];
+	char	units[GRIB_LABEL_LEN];
+	} GRIBINDEX_ENTRY;
+
+/* Index of all fields in a GRIB file (in file order) */
+typedef struct
+	{
+	int				edition;	/* GRIB edition number */
+	int				nentry;		/* number of fields    */
+	GRIBINDEX_ENTRY	*entries;	/* field identifiers   */
+	} GRIBINDEX;
+
+/***********************************************************************
+*                                                                      *
+*  Declare external functions in gribindex.c                           *
+*                                                                      *
+***********************************************************************/
+
+LOGICAL	build_grib_index(STRING, int, GRIBINDEX *);
+LOGICAL	read_indexed_gribfield(GRIBINDEX *, int, DECODEDFIELD **);
+void	free_grib_index(GRIBINDEX *);
+
+/* Now it has been included */
+#endif
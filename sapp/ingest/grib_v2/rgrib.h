@@ -70,6 +70,8 @@ typedef struct
 /* Declare interface functions in rgrib_edition0.c */
 LOGICAL	open_gribfile_edition0(STRING);
 LOGICAL	next_gribfield_edition0(DECODEDFIELD **);
+LOGICAL	next_gribheader_edition0(long *, int *);
+LOGICAL	read_gribfield_edition0(long, int, DECODEDFIELD **);
 LOGICAL	gribfield_identifiers_edition0(STRING *, STRING *, STRING *, STRING *,
 										STRING *, STRING *, STRING *);
 void	close_gribfile_edition0(void);
@@ -91,6 +93,8 @@ void 	print_block4_data_edition0 ( void );
 
 LOGICAL	open_gribfile_edition1(STRING);
 LOGICAL	next_gribfield_edition1(DECODEDFIELD **);
+LOGICAL	next_gribheader_edition1(long *, int *);
+LOGICAL	read_gribfield_edition1(long, int, DECODEDFIELD **);
 LOGICAL	gribfield_identifiers_edition1(STRING *, STRING *, STRING *, STRING *,
 										STRING *, STRING *, STRING *);
 void	close_gribfile_edition1(void);
@@ -112,6 +116,8 @@ void 	print_block4_data_edition1 ( void );
 
 LOGICAL	open_gribfile_edition2(STRING);
 LOGICAL	next_gribfield_edition2(DECODEDFIELD **);
+LOGICAL	next_gribheader_edition2(long *, int *);
+LOGICAL	read_gribfield_edition2(long, int, DECODEDFIELD **);
 LOGICAL	gribfield_identifiers_edition2(STRING *, STRING *, STRING *, STRING *,
 										STRING *, STRING *, STRING *);
 void	close_gribfile_edition2(void);
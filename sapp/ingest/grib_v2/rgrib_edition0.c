@@ -57,10 +57,12 @@ static	LOGICAL	E0_grib_levels(E1_Product_definition_data, STRING, STRING);
 static	LOGICAL	E0_grib_data_mapproj( GRIBFIELD *, MAP_PROJ *);
 static  int		E0_grib_data_component_flag( GRIBFIELD );
 static  LOGICAL	E0_extract_grib(void);
+static  LOGICAL	E0_extract_labels(void);
 
 /* Internal static functions (Section Decodes) */
 static	int		E0_section0decoder(FILE *, E1_Indicator_block *);
 static	int		E0_section1decoder(FILE *, E1_Product_definition_data *);
+static	int		E0_skip_sections(FILE *, E1_Product_definition_data *);
 static	int		E0_latlongdecoder(FILE *, E1_Grid_description_data *);
 static	int		E0_gaussdecoder(FILE *, E1_Grid_description_data *);
 static	int		E0_psdecoder(FILE *, E1_Grid_description_data *);
@@ -86,6 +88,8 @@ static	unsigned long	E0_extract_packed_datum(long, short, Octet *);
 *                                                                      *
 *    o p e n _ g r i b f i l e _ e d i t i o n 0                       *
 *    n e x t _ g r i b f i e l d _ e d i t i o n 0                     *
+*    n e x t _ g r i b h e a d e r _ e d i t i o n 0                   *
+*    r e a d _ g r i b f i e l d _ e d i t i o n 0                     *
 *    g r i b f i e l d _ i d e n t i f i e r s _ e d i t i o n 0       *
 *    c l o s e _ g r i b f i l e _ e d i t i o n 0                     *
 *                                                                      *
@@ -102,6 +106,12 @@ static	unsigned long	E0_extract_packed_datum(long, short, Octet *);
 *    GRIB file is closed, and further calls to this function return    *
 *    FALSE.                                                            *
 *                                                                      *
+*    next_gribheader_edition0() decodes only the product definition    *
+*    of the next field, and skips over the rest of the GRIB message    *
+*    without unpacking the data.  It returns the file position of the  *
+*    GRIB message, for a later call to read_gribfield_edition0().      *
+*    The GRIB file is not closed at the end of the file.               *
+*                                                                      *
 *    gribfield_identifiers_edition0() extracts model, timestamp,       *
 *    element, level, and unit identifiers from the local GRIBFIELD     *
 *    object.                                                           *
@@ -113,6 +123,7 @@ static	unsigned long	E0_extract_packed_datum(long, short, Octet *);
 /* Internal file pointers */
 static	FILE		*GribFile    = NullPtr(FILE *);
 static	long int	GribPosition = 0;
+static	long int	GribMessage  = -1;
 
 /* Internal GRIB field buffer */
 static	LOGICAL		GribDecoded = FALSE;
@@ -220,6 +231,7 @@ LOGICAL		next_gribfield_edition0
 			}
 		return next_gribfield_edition0(gribfld);
 		}
+	GribMessage = GribPosition - GRIB_HEADER_LENGTH;
 
 	/*** PRODUCT DEFINITION SECTION ***/
 	iret = E0_section1decoder(GribFile, &GribFld.Pdd);
@@ -358,6 +370,104 @@ LOGICAL		next_gribfield_edition0
 	}
 
 
+LOGICAL		next_gribheader_edition0
+
+	(
+	long		*offset,	/* file position of GRIB message */
+	int			*field		/* field number (always 1) */
+	)
+
+	{
+	int		iret;
+
+	/* Set default for no local GRIBFIELD */
+	GribDecoded = FALSE;
+	GribValid   = FALSE;
+
+	/* Return now if no current GRIB file */
+	if ( IsNull(GribFile) ) return FALSE;
+
+	/* Keep looking until a product definition is decoded without errors */
+	while ( 1 )
+		{
+		/*** INDICATOR SECTION ***/
+		iret = E0_section0decoder(GribFile, &GribFld.Isb);
+		if ( iret != 0 && feof(GribFile) ) return FALSE;
+		else if ( iret != 0 )
+			{
+			/* Reset position due to error in GRIB message */
+			if ( fseek(GribFile, GribPosition, SEEK_SET) != 0 ) return FALSE;
+			continue;
+			}
+		GribMessage = GribPosition - GRIB_HEADER_LENGTH;
+
+		/*** PRODUCT DEFINITION SECTION ***/
+		iret = E0_section1decoder(GribFile, &GribFld.Pdd);
+		if ( iret == 0 )
+			{
+			/* Fix for CMC error in coding of surface parameters */
+			if ( GribFld.Pdd.layer.type == 100
+					&& ((GribFld.Pdd.layer.top << 8)
+							+ GribFld.Pdd.layer.bottom) == 0 )
+				GribFld.Pdd.layer.type = 1;
+
+			/*** SKIP REMAINING SECTIONS ***/
+			iret = E0_skip_sections(GribFile, &GribFld.Pdd);
+			}
+		if ( iret != 0 )
+			{
+			/* Reset position due to error in GRIB message */
+			if ( fseek(GribFile, GribPosition, SEEK_SET) != 0 ) return FALSE;
+			continue;
+			}
+
+		/* Extract GRIB identifiers only */
+		/*  ... return TRUE even if they cannot be translated */
+		if ( NotNull(offset) )	*offset = GribMessage;
+		if ( NotNull(field) )	*field  = 1;
+		GribDecoded = TRUE;
+		GribDecoded = E0_extract_labels();
+		return TRUE;
+		}
+	}
+
+
+
+LOGICAL		read_gribfield_edition0
+
+	(
+	long			offset,		/* file position of GRIB message */
+	int				field,		/* field number (always 1) */
+	DECODEDFIELD	**gribfld	/* pointer to local GRIBFIELD object */
+	)
+
+	{
+	/* Set default for no local GRIBFIELD */
+	GribDecoded = FALSE;
+	GribValid   = FALSE;
+	*gribfld    = NullPtr(DECODEDFIELD *);
+
+	/* Return now if no current GRIB file */
+	if ( IsNull(GribFile) || field != 1 ) return GribDecoded;
+
+	/* Decode the GRIB message at the given position */
+	if ( fseek(GribFile, offset, SEEK_SET) != 0 ) return GribDecoded;
+	if ( !next_gribfield_edition0(gribfld) ) return GribDecoded;
+
+	/* Make sure that a damaged message was not skipped */
+	if ( GribMessage != offset )
+		{
+		(void) fprintf(stderr, "[read_gribfield_edition0] No GRIB message");
+		(void) fprintf(stderr, " at position %ld\n", offset);
+		GribDecoded = FALSE;
+		GribValid   = FALSE;
+		*gribfld    = NullPtr(DECODEDFIELD *);
+		}
+	return GribDecoded;
+	}
+
+
+
 LOGICAL		gribfield_identifiers_edition0
 
 	(
@@ -763,6 +873,37 @@ void print_block4_data_edition0
  	)
 	{
 
+	/* Set model, timestamp, element and level labels */
+	if ( !E0_extract_labels() ) return GribValid;
+	GribValid                 = FALSE;
+
+	/* Set projection, map definition and grid definition */
+	if ( !E0_grib_data_mapproj(&GribFld, &MapProj) )
+		return GribValid;
+
+	/* Set GribValid to TRUE and return requested identifiers */
+	/*  if all identifiers were correctly translated          */
+	GribValid                 = TRUE;
+	DecodedFld.mproj_orig	  = DecodedFld.mproj = &MapProj;
+	DecodedFld.data_orig	  = DecodedFld.data	 = GribFld.PData;
+	DecodedFld.bmap	          = NullLogicalList;
+	DecodedFld.component_flag =	E0_grib_data_component_flag( GribFld );
+
+	/* Set flags for data processing */
+	DecodedFld.filled         = FALSE;
+	DecodedFld.reordered      = FALSE;
+	DecodedFld.wrapped        = FALSE;
+
+	return GribValid;
+	}
+
+static LOGICAL  E0_extract_labels
+	(
+	)
+	{
+	/* Set defaults for GRIB identifiers */
+	GribValid                 = FALSE;
+
 	/* Return now if no current GRIB file or no local GRIBFIELD object */
 	if ( IsNull(GribFile) || !GribDecoded ) return GribValid;
 
@@ -781,12 +922,7 @@ void print_block4_data_edition0
 	if ( !E0_grib_levels(GribFld.Pdd, GribModel, GribLevel) )
 			return GribValid;
 
-	/* Set projection, map definition and grid definition */
-	if ( !E0_grib_data_mapproj(&GribFld, &MapProj) )
-		return GribValid;
-
-	/* Set GribValid to TRUE and return requested identifiers */
-	/*  if all identifiers were correctly translated          */
+	/* Set GribValid to TRUE if all labels were correctly translated */
 	GribValid                 = TRUE;
 	DecodedFld.model	      = GribModel;
 	DecodedFld.rtime	      = GribRTime;
@@ -795,16 +931,6 @@ void print_block4_data_edition0
 	DecodedFld.element	      = GribElement;
 	DecodedFld.units	      = GribUnits;
 	DecodedFld.level	      = GribLevel;
-	DecodedFld.mproj_orig	  = DecodedFld.mproj = &MapProj;
-	DecodedFld.data_orig	  = DecodedFld.data	 = GribFld.PData;
-	DecodedFld.bmap	          = NullLogicalList;
-	DecodedFld.component_flag =	E0_grib_data_component_flag( GribFld );
-
-	/* Set flags for data processing */
-	DecodedFld.filled         = FALSE;
-	DecodedFld.reordered      = FALSE;
-	DecodedFld.wrapped        = FALSE;
-
 	return GribValid;
 	}
 
@@ -1747,6 +1873,51 @@ static	int			E0_section1decoder
 	return 0;
 	}
 
+/**********************************************************************/
+/***subroutine - E0_skip_sections()                                   */
+/*                                                                    */
+/*  Skip over the grid description, bit map and binary data sections  */
+/*  without decoding them, using the length at the start of each one. */
+/*  The trailer string is passed over in the search for the next GRIB */
+/*  header string.                                                    */
+/**********************************************************************/
+
+static	int			E0_skip_sections
+
+	(
+	FILE						*ip_file,
+	E1_Product_definition_data	*pdd
+	)
+
+	{
+	int		nsect, ii;
+	long	length;
+
+	/* Sections 2 and 3 are optional */
+	nsect = 1;
+	if ( pdd->block_flags.grid_description != 0 ) nsect++;
+	if ( pdd->block_flags.bit_map != 0 )          nsect++;
+
+	for ( ii = 0; ii < nsect; ii++ )
+		{
+		length = fget3c(ip_file);
+		if ( feof(ip_file) )
+			{
+			(void) fprintf(stderr, "\n  End-of-file in skipped section\n");
+			return 1;
+			}
+		if ( ferror(ip_file) || length < 3 )
+			{
+			(void) fprintf(stderr, "\n  Error in skipped section length\n");
+			return -1;
+			}
+		if ( fseek(ip_file, length - 3, SEEK_CUR) != 0 ) return -1;
+		}
+
+	dprintf(stderr, "  Skipped Sections 2 to 4\n");
+	return 0;
+	}
+
 /**********************************************************************/
 /***subroutine - E0_latlongdecoder()                                  */
 /**********************************************************************/
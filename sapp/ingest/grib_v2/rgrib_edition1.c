@@ -58,11 +58,14 @@ static	LOGICAL	E1_grib_levels(E1_Product_definition_data, const STRING, STRING);
 static	LOGICAL	E1_grib_data_mapproj( GRIBFIELD *, MAP_PROJ *, LOGICAL *, LOGICAL *);
 static  int		E1_grib_data_component_flag( GRIBFIELD );
 static  LOGICAL	E1_extract_grib(void);
+static  LOGICAL	E1_extract_labels(void);
 static  LOGICAL interpret_scan_mode ( LOGICAL *, LOGICAL *, LOGICAL *);
 
 /* Internal static functions (Section Decodes) */
 static	int		E1_section0decoder(FILE *, E1_Indicator_block *);
 static	int		E1_section1decoder(FILE *, E1_Product_definition_data *);
+static	void	E1_fix_product_definition(E1_Product_definition_data *, LOGICAL);
+static	int		E1_skip_sections(FILE *, E1_Product_definition_data *);
 static	int		E1_latlongdecoder(FILE *, E1_Grid_description_data *);
 static	int		E1_gaussdecoder(FILE *, E1_Grid_description_data *);
 static	int		E1_psdecoder(FILE *, E1_Grid_description_data *);
@@ -111,6 +114,8 @@ static	void	errtrap(int);
 *                                                                      *
 *    o p e n _ g r i b f i l e _ e d i t i o n 1                       *
 *    n e x t _ g r i b f i e l d _ e d i t i o n 1                     *
+*    n e x t _ g r i b h e a d e r _ e d i t i o n 1                   *
+*    r e a d _ g r i b f i e l d _ e d i t i o n 1                     *
 *    g r i b f i e l d _ i d e n t i f i e r s _ e d i t i o n 1       *
 *    c l o s e _ g r i b f i l e _ e d i t i o n 1                     *
 *                                                                      *
@@ -127,6 +132,12 @@ static	void	errtrap(int);
 *    GRIB file is closed, and further calls to this function return    *
 *    FALSE.                                                            *
 *                                                                      *
+*    next_gribheader_edition1() decodes only the product definition    *
+*    of the next field, and skips over the rest of the GRIB message    *
+*    without unpacking the data.  It returns the file position of the  *
+*    GRIB message, for a later call to read_gribfield_edition1().      *
+*    The GRIB file is not closed at the end of the file.               *
+*                                                                      *
 *    gribfield_identifiers_edition1() extracts model, timestamp,       *
 *    element, level, and unit identifiers from the local GRIBFIELD     *
 *    object.                                                           *
@@ -138,6 +149,7 @@ static	void	errtrap(int);
 /* Internal file pointers */
 static	FILE		*GribFile    = NullPtr(FILE *);
 static	long int	 GribPosition = 0;
+static	long int	 GribMessage  = -1;
 
 /* Internal GRIB field buffer */
 static	LOGICAL		 GribDecoded = FALSE;
@@ -258,6 +270,7 @@ LOGICAL				next_gribfield_edition1
 		(void) fprintf(stderr, "==============================\n");
 		return next_gribfield_edition1(gribfld);
 		}
+	GribMessage = GribPosition - GRIB_HEADER_LENGTH;
 
 	/*** PRODUCT DEFINITION SECTION ***/
 	iret = E1_section1decoder(GribFile, &GribFld.Pdd);
@@ -276,25 +289,8 @@ LOGICAL				next_gribfield_edition1
 		return next_gribfield_edition1(gribfld);
 		}
 
-	/* >>> Fix for CMC error in coding of surface parameters <<< */
-	if ( GribFld.Pdd.layer.type == 100
-			&& ((GribFld.Pdd.layer.top << 8) + GribFld.Pdd.layer.bottom) == 0 )
-		{
-		(void) fprintf(stderr, "  ...Correcting error in coding of");
-		(void) fprintf(stderr, " surface as isobaric level at 0 hPa\n");
-		GribFld.Pdd.layer.type = 1;
-		}
-	/* >>> End of fix <<< */
-
-	/* >>> Fix for NMC error in coding of msl pressure <<< */
-	if ( (GribFld.Pdd.parameter == 1)
-			&& (GribFld.Pdd.layer.type == 102 ) )
-		{
-		(void) fprintf(stderr, "  ...Correcting error in coding of");
-		(void) fprintf(stderr, " msl pressure as real_pressure at msl\n");
-		GribFld.Pdd.parameter = 2;
-		}
-	/* >>> End of fix <<< */
+	/* >>> Fix for CMC and NMC errors in coding of parameters <<< */
+	E1_fix_product_definition(&GribFld.Pdd, TRUE);
 
 	/*** GRID DESCRIPTION SECTION (OPTIONAL) ***/
 	if ( GribFld.Pdd.block_flags.grid_description != 0 )
@@ -534,6 +530,98 @@ LOGICAL				next_gribfield_edition1
 	return GribDecoded;
 	}
 
+LOGICAL				next_gribheader_edition1
+
+	(
+	long		*offset,	/* file position of GRIB message */
+	int			*field		/* field number (always 1) */
+	)
+
+	{
+	int		iret;
+
+	/* Set default for no local GRIBFIELD */
+	GribDecoded = FALSE;
+	GribValid   = FALSE;
+
+	/* Return now if no current GRIB file */
+	if ( IsNull(GribFile) ) return GribDecoded;
+
+	/* Keep looking until a product definition is decoded without errors */
+	while ( 1 )
+		{
+		/*** INDICATOR SECTION ***/
+		iret = E1_section0decoder(GribFile, &GribFld.Isb);
+		if ( iret != 0 && feof(GribFile) ) return GribDecoded;
+		else if ( iret != 0 )
+			{
+			/* Reset position due to error in GRIB message */
+			if ( fseek(GribFile, GribPosition, SEEK_SET) != 0 )
+				return GribDecoded;
+			continue;
+			}
+		GribMessage = GribPosition - GRIB_HEADER_LENGTH;
+
+		/*** PRODUCT DEFINITION SECTION ***/
+		iret = E1_section1decoder(GribFile, &GribFld.Pdd);
+		if ( iret == 0 )
+			{
+			/* Apply the same fixes as next_gribfield_edition1() */
+			E1_fix_product_definition(&GribFld.Pdd, FALSE);
+
+			/*** SKIP REMAINING SECTIONS ***/
+			iret = E1_skip_sections(GribFile, &GribFld.Pdd);
+			}
+		if ( iret != 0 )
+			{
+			/* Reset position due to error in GRIB message */
+			if ( fseek(GribFile, GribPosition, SEEK_SET) != 0 )
+				return GribDecoded;
+			continue;
+			}
+
+		/* Extract GRIB identifiers only */
+		if ( NotNull(offset) )	*offset = GribMessage;
+		if ( NotNull(field) )	*field  = 1;
+		GribDecoded = TRUE;
+		(void) E1_extract_labels();
+		return GribDecoded;
+		}
+	}
+
+LOGICAL				read_gribfield_edition1
+
+	(
+	long			offset,		/* file position of GRIB message */
+	int				field,		/* field number (always 1) */
+	DECODEDFIELD	**gribfld	/* pointer to local GRIBFIELD object */
+	)
+
+	{
+	/* Set default for no local GRIBFIELD */
+	GribDecoded = FALSE;
+	GribValid   = FALSE;
+	*gribfld    = NullPtr(DECODEDFIELD *);
+
+	/* Return now if no current GRIB file */
+	if ( IsNull(GribFile) || field != 1 ) return GribDecoded;
+
+	/* Decode the GRIB message at the given position */
+	if ( fseek(GribFile, offset, SEEK_SET) != 0 ) return GribDecoded;
+	if ( !next_gribfield_edition1(gribfld) ) return GribDecoded;
+
+	/* Make sure that a damaged message was not skipped */
+	if ( GribMessage != offset )
+		{
+		(void) fprintf(stderr, "[read_gribfield_edition1] No GRIB message");
+		(void) fprintf(stderr, " at position %ld\n", offset);
+		GribDecoded = FALSE;
+		GribValid   = FALSE;
+		*gribfld    = NullPtr(DECODEDFIELD *);
+		}
+	return GribDecoded;
+	}
+
 /* Grib Field Identifiers */
 LOGICAL		gribfield_identifiers_edition1
 	(
@@ -1208,6 +1296,44 @@ static LOGICAL	E1_extract_grib
 	{
 
 	LOGICAL left, bottom, west, north, isweep;
+
+	/* Set model, timestamp, element and level labels */
+	if ( !E1_extract_labels() ) return GribValid;
+	GribValid               = FALSE;
+
+	/* Set projection, map definition and grid definition */
+	if ( !E1_grib_data_mapproj(&GribFld, &MapProj, &left, &bottom) )
+		return GribValid;
+
+	/* Set scan mode bits */
+	if ( !interpret_scan_mode(&west, &north, &isweep) ) return GribValid;
+
+	/* Set GribValid to TRUE and return requested identifiers */
+	/*  if all identifiers were correctly translated          */
+	GribValid                 = TRUE;
+	DecodedFld.mproj_orig	  = DecodedFld.mproj = &MapProj;
+	DecodedFld.data_orig	  = DecodedFld.data	 = GribFld.PData;
+	DecodedFld.bmap	          = GribFld.PBit;
+	DecodedFld.component_flag =	E1_grib_data_component_flag( GribFld );
+	DecodedFld.west			  = west;
+	DecodedFld.north		  = north;
+	DecodedFld.left			  = left;
+	DecodedFld.bottom		  = bottom;
+	DecodedFld.isweep		  = isweep;
+	DecodedFld.rsweep		  = FALSE;
+
+	/* Set flags for data processing */
+	DecodedFld.filled         = FALSE;
+	DecodedFld.reordered      = FALSE;
+	DecodedFld.wrapped        = FALSE;
+
+	return GribValid;
+	}
+
+static LOGICAL	E1_extract_labels
+	(
+	)
+	{
 	/* Set defaults for GRIB identifiers */
 	GribValid               = FALSE;
 
@@ -1229,15 +1355,7 @@ static LOGICAL	E1_extract_grib
 	if ( !E1_grib_levels(GribFld.Pdd, GribModel, GribLevel) )
 			return GribValid;
 
-	/* Set projection, map definition and grid definition */
-	if ( !E1_grib_data_mapproj(&GribFld, &MapProj, &left, &bottom) )
-		return GribValid;
-
-	/* Set scan mode bits */
-	if ( !interpret_scan_mode(&west, &north, &isweep) ) return GribValid;
-
-	/* Set GribValid to TRUE and return requested identifiers */
-	/*  if all identifiers were correctly translated          */
+	/* Set GribValid to TRUE if all labels were correctly translated */
 	GribValid                 = TRUE;
 	DecodedFld.model	      = GribModel;
 	DecodedFld.rtime	      = GribRTime;
@@ -1246,22 +1364,6 @@ static LOGICAL	E1_extract_grib
 	DecodedFld.element	      = GribElement;
 	DecodedFld.units	      = GribUnits;
 	DecodedFld.level	      = GribLevel;
-	DecodedFld.mproj_orig	  = DecodedFld.mproj = &MapProj;
-	DecodedFld.data_orig	  = DecodedFld.data	 = GribFld.PData;
-	DecodedFld.bmap	          = GribFld.PBit;
-	DecodedFld.component_flag =	E1_grib_data_component_flag( GribFld );
-	DecodedFld.west			  = west;
-	DecodedFld.north		  = north;
-	DecodedFld.left			  = left;
-	DecodedFld.bottom		  = bottom;
-	DecodedFld.isweep		  = isweep;
-	DecodedFld.rsweep		  = FALSE;
-
-	/* Set flags for data processing */
-	DecodedFld.filled         = FALSE;
-	DecodedFld.reordered      = FALSE;
-	DecodedFld.wrapped        = FALSE;
-
 	return GribValid;
 	}
 
@@ -2383,6 +2485,110 @@ static	int			E1_section1decoder
 	return 0;
 	}
 
+/**********************************************************************/
+/*                                                                    */
+/***subroutine - E1_fix_product_definition()                          */
+/*                                                                    */
+/***language   - c language                                           */
+/*                                                                    */
+/***purpose    - to correct known errors in the coding of the         */
+/*               product definition section by some centres           */
+/*                                                                    */
+/***usage      - E1_fix_product_definition(pdd, report);              */
+/*               pdd is a Product_definition_data structure           */
+/*               report is TRUE to print a message for each fix       */
+/*                                                                    */
+/**********************************************************************/
+
+static	void		E1_fix_product_definition
+
+	(
+	E1_Product_definition_data	*pdd,
+	LOGICAL						report
+	)
+
+	{
+	/* >>> Fix for CMC error in coding of surface parameters <<< */
+	if ( pdd->layer.type == 100
+			&& ((pdd->layer.top << 8) + pdd->layer.bottom) == 0 )
+		{
+		if ( report )
+			{
+			(void) fprintf(stderr, "  ...Correcting error in coding of");
+			(void) fprintf(stderr, " surface as isobaric level at 0 hPa\n");
+			}
+		pdd->layer.type = 1;
+		}
+	/* >>> End of fix <<< */
+
+	/* >>> Fix for NMC error in coding of msl pressure <<< */
+	if ( (pdd->parameter == 1)
+			&& (pdd->layer.type == 102 ) )
+		{
+		if ( report )
+			{
+			(void) fprintf(stderr, "  ...Correcting error in coding of");
+			(void) fprintf(stderr, " msl pressure as real_pressure at msl\n");
+			}
+		pdd->parameter = 2;
+		}
+	/* >>> End of fix <<< */
+	}
+
+/**********************************************************************/
+/*                                                                    */
+/***subroutine - E1_skip_sections()                                   */
+/*                                                                    */
+/***language   - c language                                           */
+/*                                                                    */
+/***purpose    - to skip over the grid description, bit map and       */
+/*               binary data sections without decoding them, using    */
+/*               the length at the start of each section              */
+/*                                                                    */
+/***usage      - E1_skip_sections(ip_file, pdd);                      */
+/*               ip_file is a file pointer                            */
+/*               pdd is a Product_definition_data structure           */
+/*                                                                    */
+/**********************************************************************/
+
+static	int			E1_skip_sections
+
+	(
+	FILE						*ip_file,
+	E1_Product_definition_data	*pdd
+	)
+
+	{
+	int		nsect, ii;
+	long	length;
+
+	/* Sections 2 and 3 are optional */
+	nsect = 1;
+	if ( pdd->block_flags.grid_description != 0 ) nsect++;
+	if ( pdd->block_flags.bit_map != 0 )          nsect++;
+
+	for ( ii = 0; ii < nsect; ii++ )
+		{
+		length = fget3c(ip_file);
+		if ( feof(ip_file) )
+			{
+			(void) fprintf(stderr, "\n  End-of-file in skipped section\n");
+			return 1;
+			}
+		if ( ferror(ip_file) || length < 3 )
+			{
+			(void) fprintf(stderr, "\n  Error in skipped section length\n");
+			return -1;
+			}
+		if ( fseek(ip_file, length - 3, SEEK_CUR) != 0 ) return -1;
+		}
+
+	/* The trailer string is passed over in the search for the next */
+	/*  GRIB header string                                          */
+	dprintf(stderr, "  Skipped Sections 2 to 4\n");
+	return 0;
+	}
+
 /**********************************************************************/
 /*                                                                    */
 /***subroutine - E1_latlongdecoder()                                  */
@@ -50,6 +50,7 @@
 
 	/* Internal static function (Identifier Translation) */
 static LOGICAL	E2_extract_grib( void );
+static LOGICAL	E2_extract_labels( void );
 static LOGICAL	E2_grib_models( STRING );
 static LOGICAL	E2_grib_tstamps( STRING, STRING, STRING );
 static LOGICAL	E2_grib_elements( const STRING, STRING, STRING );
@@ -62,6 +63,7 @@ static LOGICAL  interpret_scan_mode( LOGICAL *, LOGICAL *, LOGICAL *, LOGICAL *)
 /* Open Gribfile Edition 2 */ 
 static FILE		*GribFile		= NullPtr(FILE *);
 static long int GribPosition	= 0;
+static long int GribMessage		= -1;
 static long int GribPositionErr	= 0;
 static long int GribFieldNumber = 0;
 
@@ -95,11 +97,18 @@ static g2int	numfields = 0;
 *                                                                      *
 *    o p e n _ g r i b f i l e _ e d i t i o n 2                       *
 *    n e x t _ g r i b f i e l d _ e d i t i o n 2                     *
+*    n e x t _ g r i b h e a d e r _ e d i t i o n 2                   *
+*    r e a d _ g r i b f i e l d _ e d i t i o n 2                     *
 *    g r i b f i e l d _ i d e n t i f i e r s _ e d i t i o n 2       *
 *    c l o s e _ g r i b f i l e _ e d i t i o n 2                     *
 *                                                                      *
 *    open_gribfile_edition2()                                          *
 *    next_gribfield_edition2()                                         *
+*    next_gribheader_edition2() decodes only the identifiers of the    *
+*      next field, without unpacking the data, and returns the file    *
+*      position of its message and the field number in the message.   *
+*    read_gribfield_edition2() unpacks the field at a position         *
+*      returned by next_gribheader_edition2().                         *
 *    gribfield_identifiers_edition2()                                  *
 *    close_gribfile_edition2()                                         *
 *                                                                      *
@@ -144,6 +153,7 @@ LOGICAL open_gribfile_edition2
 	GribPosition = 0;
 	GribPositionErr = 0;
 	GribFieldNumber = 0;
+	GribMessage = -1;
 	return TRUE;
 	}
 
@@ -175,6 +185,7 @@ LOGICAL		next_gribmessage
 		(void) fread(cgrib, sizeof(unsigned char), (size_t)lgrib, GribFile);
 
 		/* Reset file, point to the end of the current grib message */
+		GribMessage  = lskip;
 		GribPosition = lskip + lgrib;
 		/* If we encounter an error only andvance past the GRIB marker */
 		GribPositionErr = lskip + 4;
@@ -184,6 +195,7 @@ LOGICAL		next_gribmessage
 		if ( ierr != 0 )
 			{
 			(void) pr_error("[next_gribmessage_edition2]", "%s\n", g2_infoErrors[ierr]);
+			GribMessage  = -1;
 			GribPosition = GribPositionErr;
 			continue; 
 			}
@@ -240,6 +252,109 @@ LOGICAL		next_gribfield_edition2
 		}
 	}
 
+/* Next Grib Field Identifiers (without unpacking the data) */
+LOGICAL		next_gribheader_edition2
+	(
+	long	*offset,	/* file position of GRIB message */
+	int		*field		/* field number within GRIB message */
+	)
+	{
+	int	ierr, unpack=0, expand=0;
+
+	/* Set default for no local GRIBFIELD */
+	GribDecoded	= FALSE;
+	GribValid	= FALSE;
+
+	/* Keep getting the next field until you get a field without errors */
+	while(1)
+		{
+		/* Free up GribFld in case it's already in use */
+		if ( NotNull(GribFld) )
+			{
+			g2_free(GribFld);
+			GribFld = NullPtr(gribfield *);
+			}
+
+		/* If there are no more fields in current message, get the next message */
+		if ( (GribFieldNumber > numfields) || GribFieldNumber < 1 )
+			if ( !next_gribmessage( ) ) return GribDecoded;
+
+		/* Return now if no current GRIB message */
+		if ( IsNull(cgrib) )	return GribDecoded;
+
+		/* Extract product definition of next field and increment counter */
+		if ( NotNull(offset) )	*offset = GribMessage;
+		if ( NotNull(field) )	*field  = GribFieldNumber;
+		ierr = g2_getfld(cgrib, GribFieldNumber++, unpack, expand, &GribFld);
+		if ( ierr != 0 )
+			{
+			(void) pr_error("[next_gribheader_edition2]", "%s\n", g2_getfldErrors[ierr]);
+			GribPosition = GribPositionErr;
+			continue;
+			}
+
+		/* Extract GRIB identifiers only */
+		GribDecoded = TRUE;
+		(void) E2_extract_labels();
+		return GribDecoded;
+		}
+	}
+
+/* Unpack Grib Field at a position returned by next_gribheader_edition2() */
+LOGICAL		read_gribfield_edition2
+	(
+	long			offset,	/* file position of GRIB message */
+	int				field,	/* field number within GRIB message */
+ 	DECODEDFIELD	**ffld	/* pointer to local DECODEDFIELD object */
+	)
+	{
+	int	ierr, unpack=1, expand=1;
+
+	/* Set default for no local GRIBFIELD */
+	GribDecoded	= FALSE;
+	GribValid	= FALSE;
+	*ffld       = NullPtr(DECODEDFIELD *);
+
+	/* Return now if no current GRIB file */
+	if ( IsNull(GribFile) ) return GribDecoded;
+
+	/* Free up GribFld in case it's already in use */
+	if ( NotNull(GribFld) )
+		{
+		g2_free(GribFld);
+		GribFld = NullPtr(gribfield *);
+		}
+
+	/* Read the GRIB message (unless it is the current one) */
+	if ( IsNull(cgrib) || offset != GribMessage )
+		{
+		GribPosition = offset;
+		if ( !next_gribmessage( ) )    return GribDecoded;
+		if ( offset != GribMessage )
+			{
+			(void) pr_error("[read_gribfield_edition2]",
+					"No GRIB message at position %ld\n", offset);
+			return GribDecoded;
+			}
+		}
+	if ( field < 1 || field > numfields ) return GribDecoded;
+
+	/* Extract the requested field */
+	GribFieldNumber = field;
+	ierr = g2_getfld(cgrib, GribFieldNumber++, unpack, expand, &GribFld);
+	if ( ierr != 0 )
+		{
+		(void) pr_error("[read_gribfield_edition2]", "%s\n", g2_getfldErrors[ierr]);
+		return GribDecoded;
+		}
+
+	/* Extract GRIB info into DECODEDFIELD object */
+	GribDecoded = TRUE;
+	(void) E2_extract_grib();
+	*ffld = &DecodedFld;
+	return GribDecoded;
+	}
+
 /* Grib Field Identifiers */
 LOGICAL		gribfield_identifiers_edition2
 	(
@@ -302,6 +417,7 @@ void	close_gribfile_edition2
 	/* Set position to start of file */
 	GribPosition = 0;
 	GribFieldNumber = 0;
+	GribMessage = -1;
 	}
 
 /***********************************************************************
@@ -1037,28 +1153,10 @@ static LOGICAL		E2_extract_grib
 	{
 
 	LOGICAL	left, bottom, west, north, isweep, rsweep;
-	/* Set defaults for GRIB identifiers */
-	GribValid		= FALSE;
 
-	strcpy(GribModel, "");
-	strcpy(GribRTime, "");
-	strcpy(GribVTimeb, "");
-	strcpy(GribVTimee, "");
-	strcpy(GribElement, "");
-	strcpy(GribUnits, "");
-	strcpy(GribLevel, "");
-
-	/* Set model label from originating center and model */
-	if ( !E2_grib_models(GribModel) ) return GribValid;
-
-	/* Set run and valid timestamps from date and time information */
-	if ( !E2_grib_tstamps(GribRTime, GribVTimeb, GribVTimee) ) return GribValid;
-
-	/* Set element and units labels from element code */
-	if ( !E2_grib_elements(GribModel, GribElement, GribUnits) ) return GribValid;
-
-	/* Set level label from level code and values */
-	if ( !E2_grib_levels(GribModel, GribLevel) ) return GribValid;
+	/* Set model, timestamp, element and level labels */
+	if ( !E2_extract_labels() ) return GribValid;
+	GribValid		= FALSE;
 
 	/* Set projection, map definition and grid definition */
 	if ( !E2_grib_data_mapproj(&MapProj, &ComponentFlag, &left, &bottom) ) return GribValid;
@@ -1075,13 +1173,6 @@ static LOGICAL		E2_extract_grib
 	/* Set GribValid to TRUE and return decoded field */
 	/*	if entire field was correctly translated	  */
 	GribValid			      = TRUE;
-	DecodedFld.model	      = GribModel;
-	DecodedFld.rtime	      = GribRTime;
-	DecodedFld.vtimeb	      = GribVTimeb;
-	DecodedFld.vtimee	      = GribVTimee;
-	DecodedFld.element	      = GribElement;
-	DecodedFld.units	      = GribUnits;
-	DecodedFld.level	      = GribLevel;
 	DecodedFld.mproj_orig	  = DecodedFld.mproj = &MapProj;
 	DecodedFld.data_orig	  = DecodedFld.data	 = DataGrid;
 	DecodedFld.projection     = GribFld->igdtnum;
@@ -1102,6 +1193,50 @@ static LOGICAL		E2_extract_grib
 	return GribValid;
 	}
 
+/*********************************************************************/
+/** Translate the identifiers of the current field into model,      **/
+/** timestamp, element, units and level labels.  This needs only    **/
+/** the product definition, so the data need not be unpacked.       **/
+/*********************************************************************/
+static LOGICAL		E2_extract_labels
+	(
+	)
+	{
+	/* Set defaults for GRIB identifiers */
+	GribValid		= FALSE;
+
+	strcpy(GribModel, "");
+	strcpy(GribRTime, "");
+	strcpy(GribVTimeb, "");
+	strcpy(GribVTimee, "");
+	strcpy(GribElement, "");
+	strcpy(GribUnits, "");
+	strcpy(GribLevel, "");
+
+	/* Set model label from originating center and model */
+	if ( !E2_grib_models(GribModel) ) return GribValid;
+
+	/* Set run and valid timestamps from date and time information */
+	if ( !E2_grib_tstamps(GribRTime, GribVTimeb, GribVTimee) ) return GribValid;
+
+	/* Set element and units labels from element code */
+	if ( !E2_grib_elements(GribModel, GribElement, GribUnits) ) return GribValid;
+
+	/* Set level label from level code and values */
+	if ( !E2_grib_levels(GribModel, GribLevel) ) return GribValid;
+
+	/* Set GribValid to TRUE if all labels were correctly translated */
+	GribValid			      = TRUE;
+	DecodedFld.model	      = GribModel;
+	DecodedFld.rtime	      = GribRTime;
+	DecodedFld.vtimeb	      = GribVTimeb;
+	DecodedFld.vtimee	      = GribVTimee;
+	DecodedFld.element	      = GribElement;
+	DecodedFld.units	      = GribUnits;
+	DecodedFld.level	      = GribLevel;
+	return GribValid;
+	}
+
 /*********************************************************************
 ***                                                                ***
 *** E 2 _ g r i b _ m o d e l s                                    ***
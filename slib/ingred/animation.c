@@ -43,6 +43,34 @@ static	void	show_movie_frame(LOGICAL *);
 static	void	show_next_frame(XtPointer, XtIntervalId *);
 static	void	report_mem(STRING, STRING, LOGICAL);
 
+/* Frame cache - each frame is captured once it has been drawn, and */
+/* copied back to the map on later loops while the frame is unchanged */
+typedef	struct
+	{
+	int				iframe;		/* frame index */
+	unsigned long	key;		/* signature of what the frame shows */
+	Snapshot		snap;		/* captured image of the map */
+	long			size;		/* approximate size of image in bytes */
+	unsigned long	used;		/* when the frame was last shown */
+	} MOVIE_FRAME;
+
+static	MOVIE_FRAME	*MovieFrames  = NullPtr(MOVIE_FRAME *);
+static	int			NumFrames     = 0;
+static	int			MaxFrames     = 0;
+static	long		FrameMem      = 0;
+static	long		FrameMemLimit = -1;
+static	unsigned long	FrameUsed = 0;
+
+static	FIELD		*FrameFlds    = NullFldList;
+static	SET			*FrameLbls    = NullSetPtr;
+static	int			MaxFrameFlds  = 0;
+
+static	unsigned long	movie_frame_key(unsigned long, const void *, size_t);
+static	Snapshot	find_movie_frame(int, unsigned long);
+static	void		save_movie_frame(int, unsigned long);
+static	void		drop_movie_frame(int);
+static	long		movie_frame_limit(void);
+
 /***********************************************************************
 *                                                                      *
 *     i n i t _ a n i m a t i o n                                      *
@@ -89,6 +117,9 @@ LOGICAL	suspend_animation(void)
 	{
 	suspend = TRUE;
 
+	/* Zooming changes every frame */
+	clear_movie_frames();
+
 	return TRUE;
 	}
 
@@ -100,6 +131,7 @@ LOGICAL	exit_animation(void)
 
 	MovieShown = FALSE;
 	erase_movie_frame();
+	clear_movie_frames();
 	present_node(DnMap);
 
 	/* Restore visibility of fields to their normal viewing states */
@@ -593,6 +625,8 @@ static	void	show_movie_frame
 	int			pyear, pjday, phour, pminute, pmonth, pmday;
 	STRING		tstamp, elem, levl, ftype;
 	POINTER		fdata;
+	unsigned long	key;
+	Snapshot	snap;
 
 	/* Empty the previous frame */
 	erase_movie_frame();
@@ -612,15 +646,20 @@ static	void	show_movie_frame
 			return;
 		}
 
-	/* Build the current frame */
-	if (contoured) *contoured = FALSE;
+	/* Find the fields and labels that make up the current frame */
+	if (NumDfld > MaxFrameFlds)
+		{
+		MaxFrameFlds = NumDfld;
+		FrameFlds    = GETMEM(FrameFlds, FIELD, MaxFrameFlds);
+		FrameLbls    = GETMEM(FrameLbls, SET, MaxFrameFlds);
+		}
 	for (idfld=0; idfld<NumDfld; idfld++)
 		{
 		dfld = DfldList + idfld;
-		elem = dfld->element;
-		levl = dfld->level;
 		fld  = NullFld;
 		lbls = NullSet;
+		FrameFlds[idfld] = NullFld;
+		FrameLbls[idfld] = NullSet;
 		switch (MovieMode)
 			{
 			case MOVIE_DEPICT:
@@ -681,11 +720,32 @@ static	void	show_movie_frame
 					}
 				break;
 			}
+		FrameFlds[idfld] = fld;
+		FrameLbls[idfld] = lbls;
+		}
 
+	/* See if this frame has already been drawn as it appears now */
+	key  = movie_frame_key(0, &MovieMode, sizeof(MovieMode));
+	key  = movie_frame_key(key, &DnMap->viewport, sizeof(BOX));
+	key  = movie_frame_key(key, &DnMap->window, sizeof(BOX));
+	key  = movie_frame_key(key, FrameFlds, NumDfld*sizeof(FIELD));
+	key  = movie_frame_key(key, FrameLbls, NumDfld*sizeof(SET));
+	snap = find_movie_frame(Iframe, key);
+
+	/* Build the current frame */
+	if (contoured) *contoured = FALSE;
+	for (idfld=0; idfld<NumDfld; idfld++)
+		{
+		dfld = DfldList + idfld;
+		elem = dfld->element;
+		levl = dfld->level;
+		fld  = FrameFlds[idfld];
+		lbls = FrameLbls[idfld];
 		if (IsNull(fld)) continue;
 
 		/* Contour the current field if necessary */
-		if (fld->ftype == FtypeSfc)
+		/* (not needed if the frame is already drawn) */
+		if (fld->ftype == FtypeSfc && snap <= 0)
 			{
 			sfc = fld->data.sfc;
 			if	( NotNull(sfc)
@@ -763,7 +823,18 @@ static	void	show_movie_frame
 	showing_chart(tstamp);
 
 	/* Display the current frame */
-	present_node(DnMap);
+	/* Copy it from the frame cache, or draw it and add it to the cache */
+	if (snap > 0)
+		{
+		glPutSnapshot(snap);
+		glFlush();
+		}
+	else
+		{
+		update_map(DnMap);
+		save_movie_frame(Iframe, key);
+		}
+	(void) sync_display();
 	}
 
 /**********************************************************************/
@@ -790,6 +861,177 @@ static	void	erase_movie_frame(void)
 	}
 
 
+/***********************************************************************
+*                                                                      *
+*     c l e a r _ m o v i e _ f r a m e s                              *
+*     m o v i e _ f r a m e _ k e y                                    *
+*     f i n d _ m o v i e _ f r a m e                                  *
+*     s a v e _ m o v i e _ f r a m e                                  *
+*     d r o p _ m o v i e _ f r a m e                                  *
+*     m o v i e _ f r a m e _ l i m i t                                *
+*                                                                      *
+*     Keep the captured image of each frame that has been shown, up    *
+*     to a memory limit, discarding the least recently shown frames    *
+*     first.  A frame is found by its index and by a key built from    *
+*     the map geometry and the fields and labels it shows, so hiding   *
+*     a field or zooming the map will not find the old images.         *
+*                                                                      *
+*     The memory limit (in Mb) is given by the FPA_MOVIE_CACHE         *
+*     environment variable or the "Movie.Cache" advanced feature.      *
+*     The default is 64.  A limit of 0 turns off the frame cache.      *
+*                                                                      *
+***********************************************************************/
+
+void	clear_movie_frames(void)
+
+	{
+	while (NumFrames > 0) drop_movie_frame(NumFrames-1);
+	}
+
+/**********************************************************************/
+
+static	unsigned long	movie_frame_key
+
+	(
+	unsigned long	key,
+	const void		*buf,
+	size_t			nbuf
+	)
+
+	{
+	const unsigned char	*cbuf = (const unsigned char *) buf;
+	size_t				ibuf;
+
+	if (key == 0) key = 2166136261UL;
+	for (ibuf=0; ibuf<nbuf; ibuf++)
+		{
+		key ^= cbuf[ibuf];
+		key *= 16777619UL;
+		}
+	return key;
+	}
+
+/**********************************************************************/
+
+static	Snapshot	find_movie_frame
+
+	(
+	int				iframe,
+	unsigned long	key
+	)
+
+	{
+	int			ifrm;
+	MOVIE_FRAME	*frame;
+
+	for (ifrm=0; ifrm<NumFrames; ifrm++)
+		{
+		frame = MovieFrames + ifrm;
+		if (frame->iframe != iframe) continue;
+		if (frame->key != key)       continue;
+		frame->used = ++FrameUsed;
+		return frame->snap;
+		}
+	return (Snapshot) 0;
+	}
+
+/**********************************************************************/
+
+static	void	save_movie_frame
+
+	(
+	int				iframe,
+	unsigned long	key
+	)
+
+	{
+	int			nx, ny, ifrm, iold;
+	long		size, limit;
+	Snapshot	snap;
+	MOVIE_FRAME	*frame;
+
+	limit = movie_frame_limit();
+	if (limit <= 0) return;
+
+	/* Estimate the size of the image (assume 32 bits for deeper screens) */
+	glGetWindowSize(&nx, &ny);
+	size = (long) nx * (long) ny;
+	if (glGetPlanes() > 16)     size *= 4;
+	else if (glGetPlanes() > 8) size *= 2;
+	if (size > limit) return;
+
+	/* Make room by discarding the least recently shown frames */
+	while (NumFrames > 0 && FrameMem + size > limit)
+		{
+		iold = 0;
+		for (ifrm=1; ifrm<NumFrames; ifrm++)
+			{
+			if (MovieFrames[ifrm].used < MovieFrames[iold].used) iold = ifrm;
+			}
+		drop_movie_frame(iold);
+		}
+
+	/* Capture the map as it was just drawn */
+	gxSetupTransform(DnMap);
+	snap = glGetSnapshot(glSERVER_SIDE_PREFERENCE);
+	if (snap <= 0) return;
+
+	if (NumFrames >= MaxFrames)
+		{
+		MaxFrames  += 16;
+		MovieFrames = GETMEM(MovieFrames, MOVIE_FRAME, MaxFrames);
+		}
+	frame = MovieFrames + NumFrames++;
+	frame->iframe = iframe;
+	frame->key    = key;
+	frame->snap   = snap;
+	frame->size   = size;
+	frame->used   = ++FrameUsed;
+	FrameMem     += size;
+	}
+
+/**********************************************************************/
+
+static	void	drop_movie_frame
+
+	(
+	int		ifrm
+	)
+
+	{
+	if (ifrm < 0 || ifrm >= NumFrames) return;
+
+	glClearSnapshot(MovieFrames[ifrm].snap);
+	FrameMem -= MovieFrames[ifrm].size;
+	MovieFrames[ifrm] = MovieFrames[--NumFrames];
+	}
+
+/**********************************************************************/
+
+static	long	movie_frame_limit(void)
+
+	{
+	STRING	mode;
+	int		mbytes;
+
+	if (FrameMemLimit < 0)
+		{
+		mode = getenv("FPA_MOVIE_CACHE");
+		if (blank(mode)) mode = get_feature_mode("Movie.Cache");
+
+		mbytes = 64;
+		if (!blank(mode) && sscanf(mode, "%d", &mbytes) != 1)
+			{
+			pr_warning("Animation", "Unknown Movie.Cache size \'%s\'.\n", mode);
+			mbytes = 64;
+			}
+		FrameMemLimit = (long) MAX(mbytes, 0) * 1024L * 1024L;
+		pr_diag("Animation", "Frame cache: %d Mb\n", MAX(mbytes, 0));
+		}
+
+	return FrameMemLimit;
+	}
+
 /***********************************************************************
 *                                                                      *
 *     r e p o r t _ m e m                                              *
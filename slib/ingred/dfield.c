@@ -488,6 +488,7 @@ void	init_dfields(void)
 		dfld->slabs    = NullSetPtr;
 		dfld->tweens   = NullFldList;
 		dfld->tlabs    = NullSetPtr;
+		dfld->tstamps  = NULL;
 		dfld->linkto   = NULL;
 		dfld->nchain   = 0;
 		dfld->chains   = NULL;
@@ -550,6 +551,7 @@ void	init_dfields(void)
 		dfld->slabs    = NullSetPtr;
 		dfld->tweens   = NullFldList;
 		dfld->tlabs    = NullSetPtr;
+		dfld->tstamps  = NULL;
 		dfld->linkto   = NULL;
 		dfld->nchain   = 0;
 		dfld->chains   = NULL;
@@ -1889,6 +1889,7 @@ GEREPLY GESequence
 
 		status = read_sequence(rmode, vtime, ttime, save);
 		if (!Spawned) capture_dn_raster(DnBgnd);
+		clear_movie_frames();
 		/*
 		SequenceReady = TRUE;
 		show_depiction();
@@ -194,6 +194,8 @@ typedef	struct	DFLISTst
 	SET			*slabs;		/* .. corresponding generic labels */
 	FIELD		*tweens;	/* interpolated sequence of regular fields */
 	SET			*tlabs;		/* .. corresponding generic labels */
+	unsigned long
+				*tstamps;	/* .. revision stamps of interpolation inputs */
 	struct DFLISTst
 				*linkto;	/* pointer to another DFLIST for borrowing links */
 	int			nchain;		/* number of link chains */
@@ -772,6 +774,7 @@ typedef enum
 	LOGICAL		animation_mode(STRING, STRING, STRING);
 	LOGICAL		animation_delay(int);
 	LOGICAL		animation_dfield_state(STRING, STRING, STRING);
+	void		clear_movie_frames(void);
 
 	/* Functions provided in depiction.c */
 	LOGICAL			insert_depiction(STRING, STRING, STRING, STRING, int);
@@ -1167,6 +1170,8 @@ typedef enum
 	extern	LINE		bridge_lines(LINE, LINE, float, float);
 	extern	LOGICAL		spot_list_translate(int, SPOT *, float, float);
 	extern	LOGICAL		spot_list_rotate(int, SPOT *, POINT, float);
+	extern	void		respline_tweens(int, double **, double **, int, int,
+						float, float, LOGICAL, LINE *, int *);
 
 	/* External functions from other FPA libraries */
 	/* These should all be available in appropriate header files */
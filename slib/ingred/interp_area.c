@@ -184,7 +184,7 @@ LOGICAL	interp_area
 	int			dformat;
 	STRING		ent, elem, lev;
 	float		len, minlen=0.0, res;
-	float		x, y, dss, dse;
+	float		dss, dse;
 	int			nseg, iseg, jseg, ips, ipe, ipseg;
 	ALINK		*alink, *blink;
 	ALKEY		*aikey, *ajkey, *bikey, *bjkey, *areakey, *divkey;
@@ -214,6 +214,8 @@ LOGICAL	interp_area
 	double		*kbufy2, **keyy2;
 	double		*subpts, *dspts;
 	double		*dxsubs, *dysubs, *dxpts, *dypts;
+	LINE		*tlines;
+	int			*tnum;
 
 	/* See if we can or even need to interpolate */
 	if (!dfld)          return FALSE;
@@ -1221,6 +1223,12 @@ LOGICAL	interp_area
 				}
 			}
 
+		/* Re-spline the boundary in each inbetween frame in parallel */
+		tlines = INITMEM(LINE, extween-sxtween+1);
+		tnum   = INITMEM(int, extween-sxtween+1);
+		respline_tweens(nspts, tweenx, tweeny, sxtween, extween,
+						res, 0.0, closed, tlines, tnum);
+
 		/* Generate new area for each inbetween frame */
 		/* using the new spatial spline coefficients  */
 		toshow = FALSE;
@@ -1262,22 +1270,8 @@ LOGICAL	interp_area
 				}
 			genset = genlist[itween]->data.set;
 
-			/* Set up spline operation */
-			reset_pipe();
-			enable_filter(res, 0.0);
-			enable_spline(res, closed, 0.0, 0.0, 0.0);
-			enable_save();
-
-			/* Re-spline splined line to desired resolution */
-			/* Possibly area may be totally outside         */
-			for (isp=0; isp<nspts; isp++)
-				{
-				x = tweenx[isp][itween];
-				y = tweeny[isp][itween];
-				put_pipe(x, y);
-				}
-			flush_pipe();
-			nlines = recall_save(&lines);
+			/* Take the area re-splined for this frame */
+			nlines = tnum[itween-sxtween];
 			if (nlines <= 0)
 				{
 				pr_warning("Interp.Areas", " No area after resplining!\n");
@@ -1299,7 +1293,7 @@ LOGICAL	interp_area
 			jkey  = MIN(jkey, ekey);
 			ajkey = alink->key + jkey;
 
-			line  = lines[0];
+			line  = tlines[itween-sxtween];
 
 			line_properties(line, NullLogical, &cw, NullFloat, NullFloat);
 			if (ajkey->cw && !cw || !ajkey->cw && cw) reverse_line(line);
@@ -1492,6 +1486,12 @@ LOGICAL	interp_area
 			if (toshow) present_blank(TRUE);
 #		endif /* EFF */
 
+		/* Free the re-splined lines */
+		for (itween=sxtween; itween<=extween; itween++)
+			tlines[itween-sxtween] = destroy_line(tlines[itween-sxtween]);
+		FREEMEM(tlines);
+		FREEMEM(tnum);
+
 		/* Free space for temporal spline parameters */
 		FREEMEM(npseg);
 		FREEMEM(dxseg);
@@ -2122,6 +2122,12 @@ LOGICAL	interp_area
 				}
 			}
 
+		/* Re-spline the dividing line in each inbetween frame in parallel */
+		tlines = INITMEM(LINE, extween-sxtween+1);
+		tnum   = INITMEM(int, extween-sxtween+1);
+		respline_tweens(nspts, tweenx, tweeny, sxtween, extween,
+						res, 0.0, closed, tlines, tnum);
+
 		/* Generate new dividing line for each inbetween frame */
 		/* using the new spatial spline coefficients           */
 		ikey = 0;
@@ -2151,22 +2157,8 @@ LOGICAL	interp_area
 				}
 #			endif /* DEBUG_INTERP_DIV_POINTS */
 
-			/* Set up spline operation */
-			reset_pipe();
-			enable_filter(res, 0.0);
-			enable_spline(res, closed, 0.0, 0.0, 0.0);
-			enable_save();
-
-			/* Re-spline splined line to desired resolution  */
-			/* Possibly dividing line may be totally outside */
-			for (isp=0; isp<nspts; isp++)
-				{
-				x = tweenx[isp][itween];
-				y = tweeny[isp][itween];
-				put_pipe(x, y);
-				}
-			flush_pipe();
-			nlines = recall_save(&lines);
+			/* Take the dividing line re-splined for this frame */
+			nlines = tnum[itween-sxtween];
 			if (nlines <= 0)
 				{
 				pr_warning("Interp.Areas",
@@ -2190,7 +2182,7 @@ LOGICAL	interp_area
 			jkey  = MIN(jkey, ekey);
 			ajkey = alink->key + jkey;
 
-			line  = lines[0];
+			line  = tlines[itween-sxtween];
 			if (ajkey->flip) reverse_line(line);
 			jarea = ajkey->iarea;
 
@@ -2244,6 +2236,12 @@ LOGICAL	interp_area
 #			endif /* DEBUG_INTERP_DIV_POINTS */
 			}
 
+		/* Free the re-splined lines */
+		for (itween=sxtween; itween<=extween; itween++)
+			tlines[itween-sxtween] = destroy_line(tlines[itween-sxtween]);
+		FREEMEM(tlines);
+		FREEMEM(tnum);
+
 		/* Free space for temporal spline parameters */
 		FREEMEM(npseg);
 		FREEMEM(dxseg);
@@ -2910,6 +2908,12 @@ LOGICAL	interp_area
 				}
 			}
 
+		/* Re-spline the hole in each inbetween frame in parallel */
+		tlines = INITMEM(LINE, extween-sxtween+1);
+		tnum   = INITMEM(int, extween-sxtween+1);
+		respline_tweens(nspts, tweenx, tweeny, sxtween, extween,
+						res, 0.0, closed, tlines, tnum);
+
 		/* Generate new hole for each inbetween frame */
 		/* using the new spatial spline coefficients  */
 		ikey = 0;
@@ -2939,22 +2943,8 @@ LOGICAL	interp_area
 				}
 #			endif /* DEBUG_INTERP_HOLE_POINTS */
 
-			/* Set up spline operation */
-			reset_pipe();
-			enable_filter(res, 0.0);
-			enable_spline(res, closed, 0.0, 0.0, 0.0);
-			enable_save();
-
-			/* Re-spline splined line to desired resolution */
-			/* Possibly hole may be totally outside         */
-			for (isp=0; isp<nspts; isp++)
-				{
-				x = tweenx[isp][itween];
-				y = tweeny[isp][itween];
-				put_pipe(x, y);
-				}
-			flush_pipe();
-			nlines = recall_save(&lines);
+			/* Take the hole re-splined for this frame */
+			nlines = tnum[itween-sxtween];
 			if (nlines <= 0)
 				{
 				pr_warning("Interp.Areas",
@@ -2978,7 +2968,7 @@ LOGICAL	interp_area
 			jkey  = MIN(jkey, ekey);
 			ajkey = alink->key + jkey;
 
-			line  = lines[0];
+			line  = tlines[itween-sxtween];
 
 			line_properties(line, NullLogical, &hcw, NullFloat, NullFloat);
 			if (ajkey->hcw && !hcw || !ajkey->hcw && hcw) reverse_line(line);
@@ -3045,6 +3035,12 @@ LOGICAL	interp_area
 #			endif /* DEBUG_INTERP_HOLE_POINTS */
 			}
 
+		/* Free the re-splined lines */
+		for (itween=sxtween; itween<=extween; itween++)
+			tlines[itween-sxtween] = destroy_line(tlines[itween-sxtween]);
+		FREEMEM(tlines);
+		FREEMEM(tnum);
+
 		/* Free space for temporal spline parameters */
 		FREEMEM(npseg);
 		FREEMEM(dxseg);
@@ -119,7 +119,7 @@ LOGICAL	interp_line
 	LINE    line;
 	STRING	ent, elem, lev;
 	float	len, minlen=0.0, res, minres;
-	float	x, y, dss, dse;
+	float	dss, dse;
 	int		nseg, iseg, ips, ipe, ipseg;
 	LOGICAL	closed;
 	CLINK	*clink;
@@ -140,6 +140,8 @@ LOGICAL	interp_line
 	double  *kbufy2, **keyy2;
 	double	*subpts, *dspts;
 	double	*dxsubs, *dysubs, *dxpts, *dypts;
+	LINE	*tlines;
+	int		*tnum;
 
 	/* See if we can or even need to interpolate */
 	if (!dfld)         return FALSE;
@@ -892,6 +894,12 @@ LOGICAL	interp_line
 				}
 			}
 
+		/* Re-spline the curve in each inbetween frame in parallel */
+		tlines = INITMEM(LINE, extween-sxtween+1);
+		tnum   = INITMEM(int, extween-sxtween+1);
+		respline_tweens(nspts, tweenx, tweeny, sxtween, extween,
+						res, minres, closed, tlines, tnum);
+
 		/* Generate new curve in each inbetween frame using the */
 		/* new spatial spline coefficients                      */
 		ikey   = 0;
@@ -920,45 +928,14 @@ LOGICAL	interp_line
 				}
 			genset = genlist[itween]->data.set;
 
-			/* Set up spline operation */
-			reset_pipe();
-			enable_filter(res, 0.0);
-			enable_spline(res, closed, 0.0, 0.0, 0.0);
-			enable_save();
-
 #			ifdef DEBUG_INTERP_POINTS
 			pr_diag("Interp.Points", "  Points in curve: %d\n", nspts);
 #			endif /* DEBUG_INTERP_POINTS */
 
-			/* Re-spline splined line to desired resolution */
-			/* Possibly line may be totally outside */
-			for (isp=0; isp<nspts; isp++)
-				{
-				x = tweenx[isp][itween];
-				y = tweeny[isp][itween];
-
-				/* Condense line for duplicate points */
-				if (isp > 0 &&
-						fabs(x - tweenx[isp-1][itween]) < minres &&
-						fabs(y - tweeny[isp-1][itween]) < minres) continue;
-
-#				ifdef DEBUG_INTERP_POINTS
-				if (isp==0)
-					pr_diag("Interp.Points",
-						"Interp curve: %.3d %.2f %.2f\n", isp, x, y);
-				else
-					pr_diag("Interp.Points",
-						"Interp curve: %.3d %.2f %.2f (%.2f %.2f %.2f)\n",
-						isp, x, y,
-						x-tweenx[isp-1][itween], y-tweeny[isp-1][itween],
-						hypot((double) x - tweenx[isp-1][itween],
-								(double) y - tweeny[isp-1][itween]));
-#				endif /* DEBUG_INTERP_POINTS */
-
-				put_pipe(x, y);
-				}
-			flush_pipe();
-			nlines = recall_save(&lines);
+			/* Take the line re-splined for this frame */
+			nlines = tnum[itween-sxtween];
+			line   = tlines[itween-sxtween];
+			tlines[itween-sxtween] = NullLine;
 			if (nlines <= 0)
 				{
 				pr_warning("Interp.Curves", " No line after resplining!\n");
@@ -981,8 +958,6 @@ LOGICAL	interp_line
 			jkey  = MIN(jkey, ekey);
 			cjkey = clink->key + jkey;
 
-			line = copy_line(lines[0]);
-
 #			ifdef DEBUG_INTERP
 			pr_diag("Interp", " Segment: %X Points: %d\n", line, line->numpts);
 #			endif /* DEBUG_INTERP */
@@ -1154,6 +1129,12 @@ LOGICAL	interp_line
 		FREEMEM(slist);
 		nsl = 0;
 
+		/* Free any re-splined curves that were not used */
+		for (itween=sxtween; itween<=extween; itween++)
+			tlines[itween-sxtween] = destroy_line(tlines[itween-sxtween]);
+		FREEMEM(tlines);
+		FREEMEM(tnum);
+
 		if (show) present_blank(TRUE);
 
 		/* Free space for temporal spline parameters */
@@ -28,6 +28,62 @@
 
 #define ltime my_ltime
 
+/***********************************************************************
+*                                                                      *
+*    The tween frames between each pair of key frames are independent, *
+*    so they are generated in batches on the worker threads (see       *
+*    workers.c), one frame to each worker.  Each batch is then         *
+*    delivered frame by frame, with labels and progress reports, on    *
+*    the calling thread.                                               *
+*                                                                      *
+***********************************************************************/
+
+/* Data shared by each tween frame generated in parallel */
+typedef	struct
+	{
+	LOGICAL	vector;		/* are these vector surfaces? */
+	int		nx, ny;		/* number of grid points in each direction */
+	float	glen;		/* grid length */
+	float	xlim, ylim;	/* extent of grid */
+	int		nwork;		/* maximum number of frames in each batch */
+	double	*dxg, *dyg;	/* displacement at each grid point */
+	SURFACE	lsfc, rsfc;	/* key frames at either end of key window */
+	SURFACE	*lsfcs;		/* copy of start key frame for each worker */
+	SURFACE	*rsfcs;		/* copy of end key frame for each worker */
+	int		lmplus;		/* time of start key frame */
+	float	tlen;		/* length of key window */
+	int		*tplus;		/* time of each frame in batch */
+	SURFACE	*tsfcs;		/* surface generated for each frame in batch */
+	} TWEEN_JOB;
+
+static	void	init_tween_job(TWEEN_JOB *, LOGICAL, int, int, float);
+static	void	free_tween_job(TWEEN_JOB *);
+static	void	start_tween_window(TWEEN_JOB *, SURFACE, SURFACE,
+						SURFACE, SURFACE, int, int);
+static	void	end_tween_window(TWEEN_JOB *);
+static	int		generate_tweens(TWEEN_JOB *, int, int);
+static	void	generate_tween(int, int, POINTER);
+
+/***********************************************************************
+*                                                                      *
+*    Each output frame is stamped with a signature of everything that  *
+*    went into it: the key frames and labels at either end of its key  *
+*    window, and the timelink chain nodes across the window.  Frames   *
+*    whose stamp still matches are kept when the field is interpolated *
+*    again, so only the key windows next to an edited key frame or     *
+*    timelink are rebuilt.                                             *
+*                                                                      *
+***********************************************************************/
+
+static	unsigned long	keyframe_stamp(SURFACE, SET, int);
+static	unsigned long	window_stamp(DFLIST *, int, int,
+							unsigned long, unsigned long, int, int, float);
+static	unsigned long	stamp_bytes(unsigned long, const void *, size_t);
+static	unsigned long	stamp_string(unsigned long, STRING);
+static	LOGICAL	same_tween_window(FIELD *, unsigned long *, unsigned long,
+							int, int, int);
+static	void	present_tween(FIELD, SET);
+
 /***********************************************************************
 *                                                                      *
 *    i n t e r p _ s p l i n e                                         *
@@ -56,17 +112,21 @@ LOGICAL	interp_spline
 	LOGICAL	valid;
 	int		mfirst;
 	float	tlen, tstep, lfact, rfact, glen;
-	float	xlim, ylim, dxbar, dybar, dx, dy, mx, my;
+	float	dxbar, dybar, dx, dy, mx, my;
 	float	gtol, step, fact, ds, s, ddx, ddy;
-	double	dxval, dyval, lval, rval;
+	double	dxval, dyval;
 	int		ns;
 	POINT	*dpos, *dspl, gpos, lpos, rpos, pos;
-	float	**gridx, **gridy, **gridf, *gbufx, *gbufy, *gbuff;
+	float	**gridx, **gridy, *gbufx, *gbufy;
 	SURFACE	dxsfc, dysfc, lsfc, rsfc, sfc, tsfc;
 	FIELD	*keylist, *genlist, fld;
 	SET		*keylabs, *genlabs, rlabs, llabs, labs;
 	SPOT	spot;
 	LCHAIN	chain;
+	int		ibatch, nbatch;
+	int		ifirst, ilast, nreuse, nbuild;
+	unsigned long	*genstmp, lkey, rkey, wkey;
+	TWEEN_JOB	job;
 
 	if (!dfld)                           return FALSE;
 	if (!dfld->dolink)                   return FALSE;
@@ -107,6 +167,7 @@ LOGICAL	interp_spline
 	keylabs = dfld->flabs;
 	genlist = dfld->tweens;
 	genlabs = dfld->tlabs;
+	genstmp = dfld->tstamps;
 
 	/* Find the first active keyframe */
 	for (ltime=0; ltime<NumTime; ltime++)
@@ -119,8 +180,6 @@ LOGICAL	interp_spline
 	nx   = sfc->sp.m - 2;
 	ny   = sfc->sp.n - 2;
 	glen = sfc->sp.gridlen;
-	xlim = glen*(nx-1);
-	ylim = glen*(ny-1);
 
 	/* Allocate temporary buffers */
 	mdspl = nchain*2;
@@ -128,30 +187,25 @@ LOGICAL	interp_spline
 	dspl  = INITMEM(POINT, mdspl);
 	gbufx = INITMEM(float, nx*ny);
 	gbufy = INITMEM(float, nx*ny);
-	gbuff = INITMEM(float, nx*ny);
 	gridx = INITMEM(float *, ny);
 	gridy = INITMEM(float *, ny);
-	gridf = INITMEM(float *, ny);
 	for (iy=0; iy<ny; iy++)
 		{
 		gridx[iy] = gbufx + iy*nx;
 		gridy[iy] = gbufy + iy*nx;
-		gridf[iy] = gbuff + iy*nx;
 		}
 
 	/* Create displacement surfaces */
 	dxsfc = create_surface();
 	dysfc = create_surface();
 
-	/* Allocate output fields */
+	/* Set up for generating frames in parallel */
+	init_tween_job(&job, FALSE, nx, ny, glen);
+
+	/* Output fields are only rebuilt where their key window has changed */
 	ent  = "a";
 	elem = dfld->element;
 	lev  = dfld->level;
-	for (itween=0; itween<NumTween; itween++)
-		{
-		genlist[itween] = destroy_field(genlist[itween]);
-		genlabs[itween] = destroy_set(genlabs[itween]);
-		}
 
 	/* Loop through the key frame sequence */
 	mfirst = TimeList[first_depict_time()].mplus;
@@ -160,6 +214,10 @@ LOGICAL	interp_spline
 	rlabs  = keylabs[rtime];
 	rmplus = TimeList[rtime].mplus;
 	tmplus = rmplus;
+	rkey   = keyframe_stamp(rsfc, rlabs, rmplus);
+	ifirst = (tmplus - mfirst)/DTween;
+	nreuse = 0;
+	nbuild = 0;
 	for ( ; ltime<NumTime; ltime=rtime)
 		{
 		/* Duplicate keyframe if it coincides with a target time */
@@ -185,11 +243,25 @@ LOGICAL	interp_spline
 			/* Use the key frame in the corresponding output frame */
 			itween = (tmplus - mfirst)/DTween;
 			interp_progress(dfld, itween, NumTween, -1, -1);
-			sfc    = copy_surface(rsfc, TRUE);
-			labs   = copy_set(rlabs);
-			genlist[itween] = create_field(ent, elem, lev);
-			define_fld_data(genlist[itween], "surface", (POINTER)sfc);
-			genlabs[itween] = labs;
+			if (NotNull(genlist[itween]) && genstmp[itween] == rkey)
+				{
+				/* Key frame has not changed since it was last copied */
+				sfc  = genlist[itween]->data.sfc;
+				labs = genlabs[itween];
+				nreuse++;
+				}
+			else
+				{
+				genlist[itween] = destroy_field(genlist[itween]);
+				genlabs[itween] = destroy_set(genlabs[itween]);
+				sfc    = copy_surface(rsfc, TRUE);
+				labs   = copy_set(rlabs);
+				genlist[itween] = create_field(ent, elem, lev);
+				define_fld_data(genlist[itween], "surface", (POINTER)sfc);
+				genlabs[itween] = labs;
+				genstmp[itween] = rkey;
+				nbuild++;
+				}
 			if (show)
 				{
 				if	( NotNull(sfc)
@@ -218,6 +290,7 @@ LOGICAL	interp_spline
 		lsfc   = rsfc;
 		llabs  = rlabs;
 		lmplus = rmplus;
+		lkey   = rkey;
 
 		/* Find the next active keyframe */
 		for (rtime=ltime+1; rtime<NumTime; rtime++)
@@ -228,6 +301,30 @@ LOGICAL	interp_spline
 		rsfc   = keylist[rtime]->data.sfc;
 		rlabs  = keylabs[rtime];
 		rmplus = TimeList[rtime].mplus;
+		rkey   = keyframe_stamp(rsfc, rlabs, rmplus);
+
+		/* Keep the existing output frames if nothing that went into */
+		/* them has changed since they were generated */
+		wkey = window_stamp(dfld, ltime, rtime, lkey, rkey, nx, ny, glen);
+		if (same_tween_window(genlist, genstmp, wkey, tmplus, rmplus, mfirst))
+			{
+			for ( ; tmplus<rmplus; tmplus+=DTween)
+				{
+				if (minutes_in_depictions())
+					put_message("spline-interp-mins",
+								lev, elem, hour_minute_string(0, tmplus));
+				else
+					put_message("spline-interp",
+								lev, elem, tmplus/60);
+
+				itween = (tmplus - mfirst)/DTween;
+				interp_progress(dfld, itween, NumTween, -1, -1);
+				if (showtween)
+					present_tween(genlist[itween], genlabs[itween]);
+				nreuse++;
+				}
+			continue;
+			}
 
 		/* Set up displacements across key window */
 		ndspl = 0;
@@ -340,10 +437,19 @@ LOGICAL	interp_spline
 			}
 
 		/* Interpolate output frames between current and next key frames */
+		/* Frames are generated in batches, then delivered in order */
 		tlen = (float) (rmplus - lmplus);
+		start_tween_window(&job, dxsfc, dysfc, lsfc, rsfc, lmplus, rmplus);
+		ibatch = 0;
+		nbatch = 0;
 
 		for ( ; tmplus<rmplus; tmplus+=DTween)
 			{
+			if (ibatch >= nbatch)
+				{
+				nbatch = generate_tweens(&job, tmplus, rmplus);
+				ibatch = 0;
+				}
 
 #			ifdef DEBUG_INTERP
 			if (minutes_in_depictions())
@@ -367,35 +473,14 @@ LOGICAL	interp_spline
 			lfact  = tstep / tlen;
 			rfact  = 1 - lfact;
 
-			/* Fill grid with weighted average of forward and backward */
-			/* displaced values */
-			for (ix=0; ix<nx; ix++)
-				{
-				gpos[X] = ix * glen;
-				for (iy=0; iy<ny; iy++)
-					{
-					gpos[Y] = iy * glen;
-					valid   = eval_sfc(dxsfc, gpos, &dxval);
-					valid   = eval_sfc(dysfc, gpos, &dyval);
-					lpos[X] = gpos[X] - dxval*lfact;
-					lpos[Y] = gpos[Y] - dyval*lfact;
-					rpos[X] = gpos[X] + dxval*rfact;
-					rpos[Y] = gpos[Y] + dyval*rfact;
-					lpos[X] = MAX(lpos[X], 0.);	lpos[X] = MIN(lpos[X], xlim);
-					lpos[Y] = MAX(lpos[Y], 0.);	lpos[Y] = MIN(lpos[Y], ylim);
-					rpos[X] = MAX(rpos[X], 0.);	rpos[X] = MIN(rpos[X], xlim);
-					rpos[Y] = MAX(rpos[Y], 0.);	rpos[Y] = MIN(rpos[Y], ylim);
-					valid   = eval_sfc(lsfc, lpos, &lval);
-					valid   = eval_sfc(rsfc, rpos, &rval);
-					gridf[iy][ix] = (float) (rfact*lval + lfact*rval);
-					}
-				}
-
-			/* Fit new surface to the grid */
-			sfc = copy_surface(lsfc, FALSE);
-			grid_surface(sfc, glen, nx, ny, gridf);
+			/* Take the surface generated for this frame */
+			sfc = job.tsfcs[ibatch++];
+			genlist[itween] = destroy_field(genlist[itween]);
+			genlabs[itween] = destroy_set(genlabs[itween]);
 			genlist[itween] = create_field(ent, elem, lev);
 			define_fld_data(genlist[itween], "surface", (POINTER)sfc);
+			genstmp[itween] = wkey;
+			nbuild++;
 
 			/* Interpolate labels ahead from previous frame */
 			/* or back from following frame */
@@ -458,19 +543,33 @@ LOGICAL	interp_spline
 
 			}   /* Next output frame (tmplus) */
 
+		end_tween_window(&job);
+
 		}	/* Next key frame (ltime) */
 
+	/* Discard any output frames outside the key frame sequence */
+	ilast = (tmplus - mfirst)/DTween;
+	for (itween=0; itween<NumTween; itween++)
+		{
+		if (itween >= ifirst && itween < ilast) continue;
+		genlist[itween] = destroy_field(genlist[itween]);
+		genlabs[itween] = destroy_set(genlabs[itween]);
+		genstmp[itween] = 0;
+		}
+	put_message("spline-interp-done", lev, elem, nreuse, nbuild);
+	pr_diag("Interp", "%s %s: %d frames reused, %d rebuilt\n",
+			lev, elem, nreuse, nbuild);
+
 	/* Free temporary buffers */
 	dxsfc = destroy_surface(dxsfc);
 	dysfc = destroy_surface(dysfc);
+	free_tween_job(&job);
 	FREEMEM(dpos);
 	FREEMEM(dspl);
 	FREEMEM(gbufx);
 	FREEMEM(gbufy);
-	FREEMEM(gbuff);
 	FREEMEM(gridx);
 	FREEMEM(gridy);
-	FREEMEM(gridf);
 
 #	ifdef DEVELOPMENT
 	if (dfld->reported)
@@ -534,17 +633,21 @@ LOGICAL	interp_spline_2D
 	LOGICAL	valid;
 	int		mfirst;
 	float	tlen, tstep, lfact, rfact, glen;
-	float	xlim, ylim, dxbar, dybar, dx, dy, mx, my;
+	float	dxbar, dybar, dx, dy, mx, my;
 	float	gtol, step, fact, ds, s, ddx, ddy;
-	double	dxval, dyval, luval, lvval, ruval, rvval;
+	double	dxval, dyval;
 	int		ns;
 	POINT	*dpos, *dspl, gpos, lpos, rpos, pos;
-	float	**gridx, **gridy, **gridu, **gridv, *gbufx, *gbufy, *gbufu, *gbufv;
+	float	**gridx, **gridy, *gbufx, *gbufy;
 	SURFACE	dxsfc, dysfc, lsfc, rsfc, sfc, tsfc;
 	FIELD	*keylist, *genlist, fld;
 	SET		*keylabs, *genlabs, rlabs, llabs, labs;
 	SPOT	spot;
 	LCHAIN	chain;
+	int		ibatch, nbatch;
+	int		ifirst, ilast, nreuse, nbuild;
+	unsigned long	*genstmp, lkey, rkey, wkey;
+	TWEEN_JOB	job;
 
 	if (!dfld)                        return FALSE;
 	if (!dfld->dolink)                return FALSE;
@@ -587,6 +690,7 @@ LOGICAL	interp_spline_2D
 	keylabs = dfld->flabs;
 	genlist = dfld->tweens;
 	genlabs = dfld->tlabs;
+	genstmp = dfld->tstamps;
 
 	/* Find the first active keyframe */
 	for (ltime=0; ltime<NumTime; ltime++)
@@ -599,8 +703,6 @@ LOGICAL	interp_spline_2D
 	nx   = sfc->sp.m - 2;
 	ny   = sfc->sp.n - 2;
 	glen = sfc->sp.gridlen;
-	xlim = glen*(nx-1);
-	ylim = glen*(ny-1);
 
 	/* Allocate temporary buffers */
 	mdspl = nchain*2;
@@ -608,33 +710,25 @@ LOGICAL	interp_spline_2D
 	dspl  = INITMEM(POINT, mdspl);
 	gbufx = INITMEM(float, nx*ny);
 	gbufy = INITMEM(float, nx*ny);
-	gbufu = INITMEM(float, nx*ny);
-	gbufv = INITMEM(float, nx*ny);
 	gridx = INITMEM(float *, ny);
 	gridy = INITMEM(float *, ny);
-	gridu = INITMEM(float *, ny);
-	gridv = INITMEM(float *, ny);
 	for (iy=0; iy<ny; iy++)
 		{
 		gridx[iy] = gbufx + iy*nx;
 		gridy[iy] = gbufy + iy*nx;
-		gridu[iy] = gbufu + iy*nx;
-		gridv[iy] = gbufv + iy*nx;
 		}
 
 	/* Create displacement surfaces */
 	dxsfc = create_surface();
 	dysfc = create_surface();
 
-	/* Allocate output fields */
+	/* Set up for generating frames in parallel */
+	init_tween_job(&job, TRUE, nx, ny, glen);
+
+	/* Output fields are only rebuilt where their key window has changed */
 	ent  = "v";
 	elem = dfld->element;
 	lev  = dfld->level;
-	for (itween=0; itween<NumTween; itween++)
-		{
-		genlist[itween] = destroy_field(genlist[itween]);
-		genlabs[itween] = destroy_set(genlabs[itween]);
-		}
 
 	/* Loop through the key frame sequence */
 	mfirst = TimeList[first_depict_time()].mplus;
@@ -643,6 +737,10 @@ LOGICAL	interp_spline_2D
 	rlabs  = keylabs[rtime];
 	rmplus = TimeList[rtime].mplus;
 	tmplus = rmplus;
+	rkey   = keyframe_stamp(rsfc, rlabs, rmplus);
+	ifirst = (tmplus - mfirst)/DTween;
+	nreuse = 0;
+	nbuild = 0;
 	for ( ; ltime<NumTime; ltime=rtime)
 		{
 		/* Duplicate keyframe if it coincides with a target time */
@@ -668,11 +766,25 @@ LOGICAL	interp_spline_2D
 			/* Use the key frame in the corresponding output frame */
 			itween = (tmplus - mfirst)/DTween;
 			interp_progress(dfld, itween, NumTween, -1, -1);
-			sfc    = copy_surface(rsfc, TRUE);
-			labs   = copy_set(rlabs);
-			genlist[itween] = create_field(ent, elem, lev);
-			define_fld_data(genlist[itween], "surface", (POINTER)sfc);
-			genlabs[itween] = labs;
+			if (NotNull(genlist[itween]) && genstmp[itween] == rkey)
+				{
+				/* Key frame has not changed since it was last copied */
+				sfc  = genlist[itween]->data.sfc;
+				labs = genlabs[itween];
+				nreuse++;
+				}
+			else
+				{
+				genlist[itween] = destroy_field(genlist[itween]);
+				genlabs[itween] = destroy_set(genlabs[itween]);
+				sfc    = copy_surface(rsfc, TRUE);
+				labs   = copy_set(rlabs);
+				genlist[itween] = create_field(ent, elem, lev);
+				define_fld_data(genlist[itween], "surface", (POINTER)sfc);
+				genlabs[itween] = labs;
+				genstmp[itween] = rkey;
+				nbuild++;
+				}
 			if (show)
 				{
 				if	( NotNull(sfc)
@@ -701,6 +813,7 @@ LOGICAL	interp_spline_2D
 		lsfc   = rsfc;
 		llabs  = rlabs;
 		lmplus = rmplus;
+		lkey   = rkey;
 
 		/* Find the next active keyframe */
 		for (rtime=ltime+1; rtime<NumTime; rtime++)
@@ -711,6 +824,30 @@ LOGICAL	interp_spline_2D
 		rsfc   = keylist[rtime]->data.sfc;
 		rlabs  = keylabs[rtime];
 		rmplus = TimeList[rtime].mplus;
+		rkey   = keyframe_stamp(rsfc, rlabs, rmplus);
+
+		/* Keep the existing output frames if nothing that went into */
+		/* them has changed since they were generated */
+		wkey = window_stamp(dfld, ltime, rtime, lkey, rkey, nx, ny, glen);
+		if (same_tween_window(genlist, genstmp, wkey, tmplus, rmplus, mfirst))
+			{
+			for ( ; tmplus<rmplus; tmplus+=DTween)
+				{
+				if (minutes_in_depictions())
+					put_message("spline-interp-mins",
+								lev, elem, hour_minute_string(0, tmplus));
+				else
+					put_message("spline-interp",
+								lev, elem, tmplus/60);
+
+				itween = (tmplus - mfirst)/DTween;
+				interp_progress(dfld, itween, NumTween, -1, -1);
+				if (showtween)
+					present_tween(genlist[itween], genlabs[itween]);
+				nreuse++;
+				}
+			continue;
+			}
 
 		/* Set up displacements across key window */
 		ndspl = 0;
@@ -823,10 +960,19 @@ LOGICAL	interp_spline_2D
 			}
 
 		/* Interpolate output frames between current and next key frames */
+		/* Frames are generated in batches, then delivered in order */
 		tlen = (float) (rmplus - lmplus);
+		start_tween_window(&job, dxsfc, dysfc, lsfc, rsfc, lmplus, rmplus);
+		ibatch = 0;
+		nbatch = 0;
 
 		for ( ; tmplus<rmplus; tmplus+=DTween)
 			{
+			if (ibatch >= nbatch)
+				{
+				nbatch = generate_tweens(&job, tmplus, rmplus);
+				ibatch = 0;
+				}
 
 #			ifdef DEBUG_INTERP
 			if (minutes_in_depictions())
@@ -850,36 +996,14 @@ LOGICAL	interp_spline_2D
 			lfact  = tstep / tlen;
 			rfact  = 1 - lfact;
 
-			/* Fill grid with weighted average of forward and backward */
-			/* displaced values */
-			for (ix=0; ix<nx; ix++)
-				{
-				gpos[X] = ix * glen;
-				for (iy=0; iy<ny; iy++)
-					{
-					gpos[Y] = iy * glen;
-					valid   = eval_sfc(dxsfc, gpos, &dxval);
-					valid   = eval_sfc(dysfc, gpos, &dyval);
-					lpos[X] = gpos[X] - dxval*lfact;
-					lpos[Y] = gpos[Y] - dyval*lfact;
-					rpos[X] = gpos[X] + dxval*rfact;
-					rpos[Y] = gpos[Y] + dyval*rfact;
-					lpos[X] = MAX(lpos[X], 0.);	lpos[X] = MIN(lpos[X], xlim);
-					lpos[Y] = MAX(lpos[Y], 0.);	lpos[Y] = MIN(lpos[Y], ylim);
-					rpos[X] = MAX(rpos[X], 0.);	rpos[X] = MIN(rpos[X], xlim);
-					rpos[Y] = MAX(rpos[Y], 0.);	rpos[Y] = MIN(rpos[Y], ylim);
-					valid   = eval_sfc_UV(lsfc, lpos, &luval, &lvval);
-					valid   = eval_sfc_UV(rsfc, rpos, &ruval, &rvval);
-					gridu[iy][ix] = (float) (rfact*luval + lfact*ruval);
-					gridv[iy][ix] = (float) (rfact*lvval + lfact*rvval);
-					}
-				}
-
-			/* Fit new surface to the grid */
-			sfc = copy_surface(lsfc, FALSE);
-			grid_surface_2D(sfc, glen, nx, ny, gridu, gridv);
+			/* Take the surface generated for this frame */
+			sfc = job.tsfcs[ibatch++];
+			genlist[itween] = destroy_field(genlist[itween]);
+			genlabs[itween] = destroy_set(genlabs[itween]);
 			genlist[itween] = create_field(ent, elem, lev);
 			define_fld_data(genlist[itween], "surface", (POINTER)sfc);
+			genstmp[itween] = wkey;
+			nbuild++;
 
 			/* Interpolate labels ahead from previous frame */
 			/* or back from following frame */
@@ -942,21 +1066,33 @@ LOGICAL	interp_spline_2D
 
 			}   /* Next output frame (tmplus) */
 
+		end_tween_window(&job);
+
 		}	/* Next key frame (ltime) */
 
+	/* Discard any output frames outside the key frame sequence */
+	ilast = (tmplus - mfirst)/DTween;
+	for (itween=0; itween<NumTween; itween++)
+		{
+		if (itween >= ifirst && itween < ilast) continue;
+		genlist[itween] = destroy_field(genlist[itween]);
+		genlabs[itween] = destroy_set(genlabs[itween]);
+		genstmp[itween] = 0;
+		}
+	put_message("spline-interp-done", lev, elem, nreuse, nbuild);
+	pr_diag("Interp", "%s %s: %d frames reused, %d rebuilt\n",
+			lev, elem, nreuse, nbuild);
+
 	/* Free temporary buffers */
 	dxsfc = destroy_surface(dxsfc);
 	dysfc = destroy_surface(dysfc);
+	free_tween_job(&job);
 	FREEMEM(dpos);
 	FREEMEM(dspl);
 	FREEMEM(gbufx);
 	FREEMEM(gbufy);
-	FREEMEM(gbufu);
-	FREEMEM(gbufv);
 	FREEMEM(gridx);
 	FREEMEM(gridy);
-	FREEMEM(gridu);
-	FREEMEM(gridv);
 
 #	ifdef DEVELOPMENT
 	if (dfld->reported)
@@ -991,3 +1127,495 @@ LOGICAL	interp_spline_2D
 	busy_cursor(FALSE);
 	return TRUE;
 	}
+
+/***********************************************************************
+*                                                                      *
+*    k e y f r a m e _ s t a m p                                       *
+*    w i n d o w _ s t a m p                                           *
+*    s t a m p _ b y t e s                                             *
+*    s t a m p _ s t r i n g                                           *
+*                                                                      *
+*    Compute the revision stamp of a key frame, or of the output       *
+*    frames in a key window.  A stamp of zero is never returned, so    *
+*    that it can be used to mark output frames that have no stamp.     *
+*                                                                      *
+***********************************************************************/
+
+#define StampStart 2166136261UL
+#define StampPrime 16777619UL
+
+static	unsigned long	keyframe_stamp
+
+	(
+	SURFACE	sfc,	/* key frame surface */
+	SET		labs,	/* key frame labels */
+	int		mplus	/* time of key frame */
+	)
+
+	{
+	unsigned long	stamp;
+	int				iu, imem, iatt;
+	SPLINE			*sp;
+	SPOT			spot;
+	ATTRIB			*att;
+
+	stamp = stamp_bytes(StampStart, &mplus, sizeof(int));
+
+	/* Surface spline */
+	if (NotNull(sfc))
+		{
+		sp    = &sfc->sp;
+		stamp = stamp_string(stamp, sfc->units.name);
+		stamp = stamp_bytes(stamp, &sp->m,       sizeof(int));
+		stamp = stamp_bytes(stamp, &sp->n,       sizeof(int));
+		stamp = stamp_bytes(stamp, &sp->dim,     sizeof(SPDIM));
+		stamp = stamp_bytes(stamp, sp->origin,   sizeof(POINT));
+		stamp = stamp_bytes(stamp, &sp->orient,  sizeof(float));
+		stamp = stamp_bytes(stamp, &sp->gridlen, sizeof(float));
+		for (iu=0; iu<sp->m; iu++)
+			{
+			if (NotNull(sp->cvs))
+				stamp = stamp_bytes(stamp, sp->cvs[iu], sp->n*sizeof(float));
+			if (NotNull(sp->cvx))
+				stamp = stamp_bytes(stamp, sp->cvx[iu], sp->n*sizeof(float));
+			if (NotNull(sp->cvy))
+				stamp = stamp_bytes(stamp, sp->cvy[iu], sp->n*sizeof(float));
+			}
+		}
+
+	/* Labels */
+	if (NotNull(labs))
+		{
+		stamp = stamp_string(stamp, labs->type);
+		stamp = stamp_bytes(stamp, &labs->num, sizeof(int));
+		for (imem=0; imem<labs->num; imem++)
+			{
+			if (!same(labs->type, "spot"))
+				{
+				stamp = stamp_bytes(stamp, &labs->list[imem], sizeof(ITEM));
+				continue;
+				}
+			spot = (SPOT) labs->list[imem];
+			if (IsNull(spot)) continue;
+			stamp = stamp_bytes(stamp, spot->anchor, sizeof(POINT));
+			stamp = stamp_bytes(stamp, &spot->feature, sizeof(SPFEAT));
+			stamp = stamp_string(stamp, spot->mclass);
+			if (IsNull(spot->attrib)) continue;
+			for (iatt=0; iatt<spot->attrib->nattribs; iatt++)
+				{
+				att   = spot->attrib->attribs + iatt;
+				stamp = stamp_string(stamp, att->name);
+				stamp = stamp_string(stamp, att->value);
+				}
+			}
+		}
+
+	return (stamp == 0)? 1: stamp;
+	}
+
+/**********************************************************************/
+
+static	unsigned long	window_stamp
+
+	(
+	DFLIST			*dfld,	/* field being interpolated */
+	int				ltime,	/* start key frame */
+	int				rtime,	/* end key frame */
+	unsigned long	lkey,	/* stamp of start key frame */
+	unsigned long	rkey,	/* stamp of end key frame */
+	int				nx,		/* number of grid points in each direction */
+	int				ny,
+	float			glen	/* grid length */
+	)
+
+	{
+	unsigned long	stamp;
+	int				ichain, lnode, rnode;
+	LCHAIN			chain;
+
+	stamp = stamp_bytes(StampStart, &lkey, sizeof(unsigned long));
+	stamp = stamp_bytes(stamp, &rkey,   sizeof(unsigned long));
+	stamp = stamp_bytes(stamp, &DTween, sizeof(int));
+	stamp = stamp_bytes(stamp, &nx,     sizeof(int));
+	stamp = stamp_bytes(stamp, &ny,     sizeof(int));
+	stamp = stamp_bytes(stamp, &glen,   sizeof(float));
+
+	/* Chain nodes that define the displacements across the key window */
+	for (ichain=0; ichain<dfld->nchain; ichain++)
+		{
+		chain = dfld->chains[ichain];
+		lnode = which_lchain_node(chain, LchainNode, TimeList[ltime].mplus);
+		rnode = which_lchain_node(chain, LchainNode, TimeList[rtime].mplus);
+		if (lnode < 0 || rnode < 0)      continue;
+		if (!chain->nodes[lnode]->there) continue;
+		if (!chain->nodes[rnode]->there) continue;
+		stamp = stamp_bytes(stamp, &ichain, sizeof(int));
+		stamp = stamp_bytes(stamp, chain->nodes[lnode]->node, sizeof(POINT));
+		stamp = stamp_bytes(stamp, chain->nodes[rnode]->node, sizeof(POINT));
+		}
+
+	return (stamp == 0)? 1: stamp;
+	}
+
+/**********************************************************************/
+
+static	unsigned long	stamp_bytes
+
+	(
+	unsigned long	stamp,
+	const void		*buf,
+	size_t			nbuf
+	)
+
+	{
+	const unsigned char	*cbuf = (const unsigned char *) buf;
+	size_t				ibuf;
+
+	for (ibuf=0; ibuf<nbuf; ibuf++)
+		{
+		stamp ^= cbuf[ibuf];
+		stamp *= StampPrime;
+		}
+	return stamp;
+	}
+
+/**********************************************************************/
+
+static	unsigned long	stamp_string
+
+	(
+	unsigned long	stamp,
+	STRING			str
+	)
+
+	{
+	if (IsNull(str)) return stamp_bytes(stamp, "", 1);
+	return stamp_bytes(stamp, str, strlen(str)+1);
+	}
+
+/***********************************************************************
+*                                                                      *
+*    s a m e _ t w e e n _ w i n d o w                                 *
+*    p r e s e n t _ t w e e n                                         *
+*                                                                      *
+*    Check whether the output frames in a key window can be kept, and  *
+*    display a kept output frame.                                      *
+*                                                                      *
+***********************************************************************/
+
+static	LOGICAL	same_tween_window
+
+	(
+	FIELD			*genlist,	/* output frames */
+	unsigned long	*genstmp,	/* revision stamp of each output frame */
+	unsigned long	wkey,		/* revision stamp of key window */
+	int				tmplus,		/* time of first output frame in window */
+	int				rmplus,		/* time of end key frame */
+	int				mfirst		/* time of first output frame */
+	)
+
+	{
+	int		itween;
+
+	for ( ; tmplus<rmplus; tmplus+=DTween)
+		{
+		itween = (tmplus - mfirst)/DTween;
+		if (IsNull(genlist[itween]))  return FALSE;
+		if (genstmp[itween] != wkey) return FALSE;
+		}
+	return TRUE;
+	}
+
+/**********************************************************************/
+
+static	void	present_tween
+
+	(
+	FIELD	gfld,	/* output frame */
+	SET		labs	/* output frame labels */
+	)
+
+	{
+	FIELD	fld;
+	SURFACE	sfc;
+
+	sfc = gfld->data.sfc;
+	contour_surface(sfc);
+	fld = create_field(gfld->entity, gfld->element, gfld->level);
+	define_fld_data(fld, "surface", (POINTER)sfc);
+	add_field_to_metafile(BlankMeta, fld);
+	if (labs)
+		{
+		fld = create_field("d", gfld->element, gfld->level);
+		define_fld_data(fld, "set", (POINTER)labs);
+		add_field_to_metafile(BlankMeta, fld);
+		}
+	present_blank(TRUE);
+	}
+
+/***********************************************************************
+*                                                                      *
+*    i n i t _ t w e e n _ j o b                                       *
+*    f r e e _ t w e e n _ j o b                                       *
+*    s t a r t _ t w e e n _ w i n d o w                               *
+*    e n d _ t w e e n _ w i n d o w                                   *
+*    g e n e r a t e _ t w e e n s                                     *
+*    g e n e r a t e _ t w e e n                                       *
+*                                                                      *
+*    Generate batches of tween frames in parallel.                     *
+*                                                                      *
+***********************************************************************/
+
+static	void	init_tween_job
+
+	(
+	TWEEN_JOB	*job,
+	LOGICAL		vector,
+	int			nx,
+	int			ny,
+	float		glen
+	)
+
+	{
+	int		iwork;
+
+	job->vector = vector;
+	job->nx     = nx;
+	job->ny     = ny;
+	job->glen   = glen;
+	job->xlim   = glen*(nx-1);
+	job->ylim   = glen*(ny-1);
+	job->nwork  = MAX(get_worker_threads(), 1);
+	job->dxg    = INITMEM(double, nx*ny);
+	job->dyg    = INITMEM(double, nx*ny);
+	job->lsfc   = NullSfc;
+	job->rsfc   = NullSfc;
+	job->lsfcs  = INITMEM(SURFACE, job->nwork);
+	job->rsfcs  = INITMEM(SURFACE, job->nwork);
+	job->tplus  = INITMEM(int, job->nwork);
+	job->tsfcs  = INITMEM(SURFACE, job->nwork);
+	for (iwork=0; iwork<job->nwork; iwork++)
+		{
+		job->lsfcs[iwork] = NullSfc;
+		job->rsfcs[iwork] = NullSfc;
+		job->tsfcs[iwork] = NullSfc;
+		}
+	}
+
+/**********************************************************************/
+
+static	void	free_tween_job
+
+	(
+	TWEEN_JOB	*job
+	)
+
+	{
+	end_tween_window(job);
+	FREEMEM(job->dxg);
+	FREEMEM(job->dyg);
+	FREEMEM(job->lsfcs);
+	FREEMEM(job->rsfcs);
+	FREEMEM(job->tplus);
+	FREEMEM(job->tsfcs);
+	}
+
+/**********************************************************************/
+
+static	void	start_tween_window
+
+	(
+	TWEEN_JOB	*job,
+	SURFACE		dxsfc,	/* x displacement across key window */
+	SURFACE		dysfc,	/* y displacement across key window */
+	SURFACE		lsfc,	/* key frame at start of key window */
+	SURFACE		rsfc,	/* key frame at end of key window */
+	int			lmplus,	/* time of start key frame */
+	int			rmplus	/* time of end key frame */
+	)
+
+	{
+	int		ix, iy, nx, ny, iwork;
+	POINT	*gpos;
+
+	nx = job->nx;
+	ny = job->ny;
+
+	/* The displacements at each grid point are the same for every */
+	/* frame in the key window */
+	gpos = INITMEM(POINT, nx*ny);
+	for (iy=0; iy<ny; iy++)
+		for (ix=0; ix<nx; ix++)
+			{
+			gpos[iy*nx + ix][X] = ix * job->glen;
+			gpos[iy*nx + ix][Y] = iy * job->glen;
+			}
+	(void) eval_sfc_many(dxsfc, nx*ny, gpos, job->dxg, NullLogicalList);
+	(void) eval_sfc_many(dysfc, nx*ny, gpos, job->dyg, NullLogicalList);
+	FREEMEM(gpos);
+
+	/* Each worker evaluates its own copy of the key frames, since */
+	/* evaluating a surface defines its patches as it goes */
+	end_tween_window(job);
+	job->lsfc   = lsfc;
+	job->rsfc   = rsfc;
+	job->lmplus = lmplus;
+	job->tlen   = (float) (rmplus - lmplus);
+	for (iwork=0; iwork<job->nwork; iwork++)
+		{
+		job->lsfcs[iwork] = copy_surface(lsfc, FALSE);
+		job->rsfcs[iwork] = copy_surface(rsfc, FALSE);
+		}
+	}
+
+/**********************************************************************/
+
+static	void	end_tween_window
+
+	(
+	TWEEN_JOB	*job
+	)
+
+	{
+	int		iwork;
+
+	for (iwork=0; iwork<job->nwork; iwork++)
+		{
+		job->lsfcs[iwork] = destroy_surface(job->lsfcs[iwork]);
+		job->rsfcs[iwork] = destroy_surface(job->rsfcs[iwork]);
+		}
+	job->lsfc = NullSfc;
+	job->rsfc = NullSfc;
+	}
+
+/**********************************************************************/
+
+static	int		generate_tweens
+
+	(
+	TWEEN_JOB	*job,
+	int			tmplus,	/* time of first frame in batch */
+	int			rmplus	/* time of end key frame */
+	)
+
+	{
+	int		nbatch;
+
+	/* Generate the next batch of frames before the end key frame */
+	for (nbatch=0; nbatch<job->nwork; nbatch++)
+		{
+		if (tmplus >= rmplus) break;
+		job->tplus[nbatch] = tmplus;
+		job->tsfcs[nbatch] = NullSfc;
+		tmplus += DTween;
+		}
+	(void) run_worker_jobs(nbatch, generate_tween, (POINTER) job);
+	return nbatch;
+	}
+
+/**********************************************************************/
+
+static	void	generate_tween
+
+	(
+	int		ibatch,		/* frame in batch to generate */
+	int		worker,		/* worker generating this frame */
+	POINTER	data		/* TWEEN_JOB shared by all frames */
+	)
+
+	{
+	int			ix, iy, nx, ny, ig, ng;
+	float		tstep, lfact, rfact;
+	POINT		gpos, *lpos, *rpos;
+	double		*luval, *lvval, *ruval, *rvval;
+	float		**gridu, **gridv, *gbufu, *gbufv;
+	SURFACE		sfc;
+	TWEEN_JOB	*job;
+
+	job   = (TWEEN_JOB *) data;
+	nx    = job->nx;
+	ny    = job->ny;
+	ng    = nx*ny;
+	tstep = (float) (job->tplus[ibatch] - job->lmplus);
+	lfact = tstep / job->tlen;
+	rfact = 1 - lfact;
+
+	/* Allocate temporary buffers */
+	lpos  = INITMEM(POINT, ng);
+	rpos  = INITMEM(POINT, ng);
+	luval = INITMEM(double, ng);
+	ruval = INITMEM(double, ng);
+	lvval = (job->vector)? INITMEM(double, ng): NullDouble;
+	rvval = (job->vector)? INITMEM(double, ng): NullDouble;
+	gbufu = INITMEM(float, ng);
+	gbufv = (job->vector)? INITMEM(float, ng): NullFloat;
+	gridu = INITMEM(float *, ny);
+	gridv = (job->vector)? INITMEM(float *, ny): NullPtr(float **);
+	for (iy=0; iy<ny; iy++)
+		{
+		gridu[iy] = gbufu + iy*nx;
+		if (job->vector) gridv[iy] = gbufv + iy*nx;
+		}
+
+	/* Find the forward and backward displaced locations */
+	for (iy=0; iy<ny; iy++)
+		{
+		gpos[Y] = iy * job->glen;
+		for (ix=0; ix<nx; ix++)
+			{
+			gpos[X] = ix * job->glen;
+			ig      = iy*nx + ix;
+			lpos[ig][X] = gpos[X] - job->dxg[ig]*lfact;
+			lpos[ig][Y] = gpos[Y] - job->dyg[ig]*lfact;
+			rpos[ig][X] = gpos[X] + job->dxg[ig]*rfact;
+			rpos[ig][Y] = gpos[Y] + job->dyg[ig]*rfact;
+			lpos[ig][X] = MAX(lpos[ig][X], 0.);
+			lpos[ig][X] = MIN(lpos[ig][X], job->xlim);
+			lpos[ig][Y] = MAX(lpos[ig][Y], 0.);
+			lpos[ig][Y] = MIN(lpos[ig][Y], job->ylim);
+			rpos[ig][X] = MAX(rpos[ig][X], 0.);
+			rpos[ig][X] = MIN(rpos[ig][X], job->xlim);
+			rpos[ig][Y] = MAX(rpos[ig][Y], 0.);
+			rpos[ig][Y] = MIN(rpos[ig][Y], job->ylim);
+			}
+		}
+
+	/* Fill grid with weighted average of forward and backward */
+	/* displaced values, then fit a new surface to the grid */
+	sfc = copy_surface(job->lsfc, FALSE);
+	if (job->vector)
+		{
+		(void) eval_sfc_UV_many(job->lsfcs[worker], ng, lpos, luval, lvval,
+								NullLogicalList);
+		(void) eval_sfc_UV_many(job->rsfcs[worker], ng, rpos, ruval, rvval,
+								NullLogicalList);
+		for (ig=0; ig<ng; ig++)
+			{
+			gbufu[ig] = (float) (rfact*luval[ig] + lfact*ruval[ig]);
+			gbufv[ig] = (float) (rfact*lvval[ig] + lfact*rvval[ig]);
+			}
+		grid_surface_2D(sfc, job->glen, nx, ny, gridu, gridv);
+		}
+	else
+		{
+		(void) eval_sfc_many(job->lsfcs[worker], ng, lpos, luval,
+								NullLogicalList);
+		(void) eval_sfc_many(job->rsfcs[worker], ng, rpos, ruval,
+								NullLogicalList);
+		for (ig=0; ig<ng; ig++)
+			gbufu[ig] = (float) (rfact*luval[ig] + lfact*ruval[ig]);
+		grid_surface(sfc, job->glen, nx, ny, gridu);
+		}
+	job->tsfcs[ibatch] = sfc;
+
+	FREEMEM(lpos);
+	FREEMEM(rpos);
+	FREEMEM(luval);
+	FREEMEM(ruval);
+	FREEMEM(lvval);
+	FREEMEM(rvval);
+	FREEMEM(gbufu);
+	FREEMEM(gbufv);
+	FREEMEM(gridu);
+	FREEMEM(gridv);
+	}
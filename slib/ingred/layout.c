@@ -102,6 +102,7 @@ LOGICAL	reset_panels(void)
 
 	/* Re-capture the map background */
 	if (SequenceReady && !Spawned) capture_dn_raster(DnBgnd);
+	clear_movie_frames();
 
 	return TRUE;
 	}
@@ -329,6 +330,7 @@ LOGICAL	map_background
 	/* Construct all modules to fit */
 	(void) reset_modules();
 	if (SequenceReady && !Spawned) capture_dn_raster(DnBgnd);
+	clear_movie_frames();
 	(void) present_all();
 
 	return TRUE;
@@ -406,6 +408,7 @@ LOGICAL	map_overlay
 		/* Turn the dispnode off to force a redisplay */
 		define_dn_vis(dn, FALSE);
 		if (under && SequenceReady && !Spawned) capture_dn_raster(DnBgnd);
+		clear_movie_frames();
 		(void) present_all();
 		}
 
@@ -415,6 +418,7 @@ LOGICAL	map_overlay
 	if (!shown && !show) return TRUE;
 	define_dn_vis(dn, show);
 	if (under && SequenceReady && !Spawned) capture_dn_raster(DnBgnd);
+	clear_movie_frames();
 	(void) present_all();
 
 	return TRUE;
@@ -643,6 +647,7 @@ LOGICAL	map_palette
 							llcolour, facolour, fbcolour);
 		}
 	if (SequenceReady && !Spawned) capture_dn_raster(DnBgnd);
+	clear_movie_frames();
 	(void) present_all();
 
 	return TRUE;
@@ -1577,6 +1577,7 @@ LOGICAL	revise_depict_time
 	LOGICAL	depict;
 	FIELD	*oldtweens;
 	SET		*oldlabs;
+	unsigned long	*oldstamps;
 	int		itween, jtween, dtween, oldntween;
 
 	if (ivt < 0)        return FALSE;
@@ -1632,8 +1633,10 @@ LOGICAL	revise_depict_time
 		/* Keep a copy of the old interpolations */
 		oldtweens = dfld->tweens;
 		oldlabs   = dfld->tlabs;
+		oldstamps = dfld->tstamps;
 		dfld->tweens  = NullFldList;
 		dfld->tlabs   = NullSetPtr;
+		dfld->tstamps = NULL;
 
 		/* Allocate a new buffer and fill in with the matching ones */
 		if (NumTween > 0)
@@ -1649,6 +1652,7 @@ LOGICAL	revise_depict_time
 
 				if (oldtweens) dfld->tweens[itween] = oldtweens[jtween];
 				if (oldlabs)   dfld->tlabs[itween]  = oldlabs[jtween];
+				if (oldstamps) dfld->tstamps[itween] = oldstamps[jtween];
 
 				if (oldtweens) oldtweens[jtween] = NullFld;
 				if (oldlabs)   oldlabs[jtween]   = NullSet;
@@ -1663,6 +1667,7 @@ LOGICAL	revise_depict_time
 			}
 		FREEMEM(oldtweens);
 		FREEMEM(oldlabs);
+		FREEMEM(oldstamps);
 		}
 
 	return TRUE;
@@ -4152,6 +4152,7 @@ LOGICAL	release_dfield_tweens
 		}
 	FREEMEM(dfld->tweens);
 	FREEMEM(dfld->tlabs);
+	FREEMEM(dfld->tstamps);
 
 	return TRUE;
 	}
@@ -4411,8 +4412,9 @@ LOGICAL	acquire_dfield_tweens
 	setup_set_presentation(labels, elem, levl, "FPA");
 	highlight_field(fld, 0);
 	highlight_set(labels, 0);
-	dfld->tweens[itween] = fld;
-	dfld->tlabs[itween]  = labels;
+	dfld->tweens[itween]  = fld;
+	dfld->tlabs[itween]   = labels;
+	dfld->tstamps[itween] = 0;
 
 	return TRUE;
 	}
@@ -4498,12 +4500,14 @@ LOGICAL	prepare_dfield_tweens
 	if (!tdep_normal(dfld->tdep)) return TRUE;
 	if (dfld->tweens)             return TRUE;
 
-	dfld->tweens = INITMEM(FIELD, NumTween);
-	dfld->tlabs  = INITMEM(SET, NumTween);
+	dfld->tweens  = INITMEM(FIELD, NumTween);
+	dfld->tlabs   = INITMEM(SET, NumTween);
+	dfld->tstamps = INITMEM(unsigned long, NumTween);
 	for (itween=0; itween<NumTween; itween++)
 		{
-		dfld->tweens[itween] = NullFld;
-		dfld->tlabs[itween]  = NullSet;
+		dfld->tweens[itween]  = NullFld;
+		dfld->tlabs[itween]   = NullSet;
+		dfld->tstamps[itween] = 0;
 		}
 
 	return TRUE;
@@ -5705,7 +5709,10 @@ LOGICAL	interpolate_dfield
 	active_field_info(elem, levl, "depict", NULL, NULL, NULL);
 
 	/* Clear out old interpolated fields */
-	(void) release_dfield_interp(dfld);
+	/* Spline fields keep any tweens whose key window has not changed */
+	if (tdep_special(dfld->tdep)
+			|| (dfld->editor != FpaC_CONTINUOUS && dfld->editor != FpaC_VECTOR))
+		(void) release_dfield_interp(dfld);
 
 	/* Interpolate this field */
 	put_message("interp-fld", levl, elem);
@@ -5744,6 +5751,9 @@ LOGICAL	interpolate_dfield
 	/* Clear internal buffers in the "luke-warm" database */
 	clear_equation_database();
 
+	/* Forget any animation frames drawn from the old interpolations */
+	clear_movie_frames();
+
 	/* Now output the results */
 	busy_cursor(TRUE);
 	put_message("interp-out", levl, elem);
@@ -87,6 +87,7 @@ LOGICAL	trunc_line
 			}
 		}
 	line->numpts = np;
+	touch_line(line);
 	return TRUE;
 	}
 
@@ -260,6 +261,7 @@ LINE	smclose_line
 	if (np>1)
 		{
 		copy_point(line->points[0], line->points[1]);
+		touch_line(line);
 		condense_line(line);
 		}
 	close_line(line);
@@ -388,3 +390,130 @@ LOGICAL	spot_list_rotate
 		}
 	return TRUE;
 	}
+
+/***********************************************************************
+*                                                                      *
+*     r e s p l i n e _ t w e e n s   - Re-spline an interpolated line *
+*                                       in each of a range of tweens.  *
+*                                                                      *
+*     The tweens are independent, so they are re-splined in parallel  *
+*     on the worker threads (see workers.c), each with its own         *
+*     graphics pipe.  The first line from each is returned in tlines   *
+*     (or NullLine if there was none) and the number of lines in       *
+*     tnum.  The caller must destroy the returned lines.               *
+*                                                                      *
+***********************************************************************/
+
+/* Data shared by each tween when re-splining in parallel */
+typedef	struct
+	{
+	int				nspts;		/* number of interpolated points */
+	double			**tweenx;	/* x-coordinate of each point in each tween */
+	double			**tweeny;	/* y-coordinate of each point in each tween */
+	int				stween;		/* first tween to re-spline */
+	float			res;		/* resolution for graphics pipe */
+	float			minres;		/* tolerance for condensing duplicate points */
+	LOGICAL			closed;		/* is the line closed? */
+	LINE			*tlines;	/* resulting line in each tween */
+	int				*tnum;		/* number of resulting lines in each tween */
+	PIPE_CONTEXT	*pipes;		/* graphics pipe for each worker */
+	} RESPLINE_JOB;
+
+static	void	respline_tween(int, int, POINTER);
+
+void	respline_tweens
+
+	(
+	int		nspts,
+	double	**tweenx,
+	double	**tweeny,
+	int		stween,
+	int		etween,
+	float	res,
+	float	minres,
+	LOGICAL	closed,
+	LINE	*tlines,
+	int		*tnum
+	)
+
+	{
+	int				ntween, npipe, ipipe;
+	RESPLINE_JOB	job;
+
+	ntween = etween - stween + 1;
+	if (ntween <= 0)    return;
+	if (IsNull(tlines)) return;
+	if (IsNull(tnum))   return;
+
+	/* Set up a graphics pipe for each worker */
+	npipe = MIN(get_worker_threads(), ntween);
+	npipe = MAX(npipe, 1);
+	job.pipes = INITMEM(PIPE_CONTEXT, npipe);
+	for (ipipe=0; ipipe<npipe; ipipe++)
+		job.pipes[ipipe] = create_pipe_context();
+
+	job.nspts  = nspts;
+	job.tweenx = tweenx;
+	job.tweeny = tweeny;
+	job.stween = stween;
+	job.res    = res;
+	job.minres = minres;
+	job.closed = closed;
+	job.tlines = tlines;
+	job.tnum   = tnum;
+	(void) run_worker_jobs(ntween, respline_tween, (POINTER) &job);
+
+	for (ipipe=0; ipipe<npipe; ipipe++)
+		job.pipes[ipipe] = destroy_pipe_context(job.pipes[ipipe]);
+	FREEMEM(job.pipes);
+	}
+
+/**********************************************************************/
+
+static	void	respline_tween
+
+	(
+	int		jtween,		/* tween to re-spline (from stween) */
+	int		worker,		/* worker re-splining this tween */
+	POINTER	data		/* RESPLINE_JOB shared by all tweens */
+	)
+
+	{
+	int				itween, isp, nlines;
+	float			x, y;
+	LINE			*lines;
+	PIPE_CONTEXT	prev;
+	RESPLINE_JOB	*job;
+
+	job    = (RESPLINE_JOB *) data;
+	itween = job->stween + jtween;
+	prev   = set_pipe_context(job->pipes[worker]);
+
+	/* Set up spline operation */
+	reset_pipe();
+	enable_filter(job->res, 0.0);
+	enable_spline(job->res, job->closed, 0.0, 0.0, 0.0);
+	enable_save();
+
+	/* Re-spline splined line to desired resolution */
+	/* Possibly line may be totally outside */
+	for (isp=0; isp<job->nspts; isp++)
+		{
+		x = job->tweenx[isp][itween];
+		y = job->tweeny[isp][itween];
+
+		/* Condense line for duplicate points */
+		if (isp > 0 &&
+				fabs(x - job->tweenx[isp-1][itween]) < job->minres &&
+				fabs(y - job->tweeny[isp-1][itween]) < job->minres) continue;
+
+		put_pipe(x, y);
+		}
+	flush_pipe();
+	nlines = recall_save(&lines);
+
+	job->tnum[jtween]   = nlines;
+	job->tlines[jtween] = (nlines > 0)? copy_line(lines[0]): NullLine;
+
+	(void) set_pipe_context(prev);
+	}